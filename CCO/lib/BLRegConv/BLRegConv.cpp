@@ -1,50 +1,74 @@
 #include <BLRegConv.h>
 
-// 为电流转换预先计算的系数
-// 公式: Vref / (12875.0 * GAIN_I * RL_mOhm)
-const double CURRENT_CONVERSION_COEFFICIENT = BL0906_VREF / (12875.0 * BL0906_GAIN_I * BL0906_RL_MOHM);
-
-// 为功率转换预先计算的系数
-// 公式: (Vref^2 * (Rf+Rv)_kOhm) / (40.4125 * RL_mOhm * Gain_I * RV_kOhm * Gain_V * 1000.0)
-const double POWER_CONVERSION_COEFFICIENT = (BL0906_VREF * BL0906_VREF * BL0906_RF_PLUS_RV_KOHM) / (40.4125 * BL0906_RL_MOHM * BL0906_GAIN_I * BL0906_RV_KOHM * BL0906_GAIN_V * 1000.0);
-
 /**
- * @brief 将 24 位无符号电流寄存器值转换为实际电流 (A)
+ * @brief 将 24 位无符号电流寄存器值转换为实际电流 (mA)
  * @param current_reg_val 从电流 RMS 寄存器读取的 24 位无符号值
- * @return float 计算得到的实际电流 (A)
+ * @return uint32_t 计算得到的实际电流 (mA)，四舍五入
  */
-float BL_currentRegister2ActualCurrent(uint32_t current_reg_val)
+uint32_t BL_currentRegister2MilliAmps(uint32_t current_reg_val)
 {
     // 电流寄存器是 24 位无符号数。确保仅使用低 24 位。
     uint32_t val = current_reg_val & 0x00FFFFFF;
-    return (float)(val * CURRENT_CONVERSION_COEFFICIENT);
+    // Q32 定点乘法，加 0.5 LSB 后右移实现四舍五入
+    return (uint32_t)(((uint64_t)val * BL0906_CURRENT_MA_Q32 + (1ULL << 31)) >> 32);
 }
 
 /**
- * @brief 将 24 位有符号 (补码) 有功功率寄存器值转换为实际有功功率 (W)
+ * @brief 将 24 位有符号 (补码) 有功功率寄存器值转换为实际有功功率 (mW)
  * @param power_reg_val 从有功功率寄存器读取的 24 位值，补码，Bit 23 是符号位
- * @return float 计算得到的实际有功功率 (W)
+ * @return uint32_t 计算得到的实际有功功率绝对值 (mW)，四舍五入
  */
-float BL_powerRegister2ActualPower(uint32_t power_reg_val)
+uint32_t BL_powerRegister2MilliWatts(uint32_t power_reg_val)
 {
     // 有功功率寄存器是 24 位有符号数，补码表示。Bit 23 是符号位。
-    int32_t signed_power_reg_val;
-
-    // 考虑原始值的低 24 位
     uint32_t raw_val_24bit = power_reg_val & 0x00FFFFFF;
+    uint32_t magnitude;
 
     // 检查第 24 位 (符号位，索引为 23) 是否被设置
     if (raw_val_24bit & 0x00800000)
     {
-        // 负值，执行从 24 位到 32 位的符号扩展
-        signed_power_reg_val = raw_val_24bit | 0xFF000000;
+        // 负值，取 24 位补码的绝对值
+        magnitude = (~raw_val_24bit + 1) & 0x00FFFFFF;
     }
     else
     {
         // 正值 (或零)
-        signed_power_reg_val = raw_val_24bit;
+        magnitude = raw_val_24bit;
     }
 
-    // 返回绝对值
-    return fabsf((float)(signed_power_reg_val * POWER_CONVERSION_COEFFICIENT));
+    // Q32 定点乘法，加 0.5 LSB 后右移实现四舍五入
+    return (uint32_t)(((uint64_t)magnitude * BL0906_POWER_MW_Q32 + (1ULL << 31)) >> 32);
+}
+
+/**
+ * @brief 将累计的有功电能脉冲数 (CF_CNT) 转换为电能 (Wh)
+ * @param pulses 累计的 CF 脉冲数
+ * @return uint32_t 计算得到的电能 (Wh)，四舍五入
+ */
+uint32_t BL_energyPulses2WattHours(uint32_t pulses)
+{
+    // Q24 定点乘法，加 0.5 LSB 后右移实现四舍五入
+    return (uint32_t)(((uint64_t)pulses * BL0906_ENERGY_WH_Q24 + (1ULL << 23)) >> 24);
+}
+
+/**
+ * @brief 将 24 位无符号电流寄存器值转换为实际电流 (A)
+ * @param current_reg_val 从电流 RMS 寄存器读取的 24 位无符号值
+ * @return float 计算得到的实际电流 (A)
+ */
+float BL_currentRegister2ActualCurrent(uint32_t current_reg_val)
+{
+    // 基于定点转换结果，仅做一次单精度除法
+    return BL_currentRegister2MilliAmps(current_reg_val) / 1000.0f;
+}
+
+/**
+ * @brief 将 24 位有符号 (补码) 有功功率寄存器值转换为实际有功功率 (W)
+ * @param power_reg_val 从有功功率寄存器读取的 24 位值，补码，Bit 23 是符号位
+ * @return float 计算得到的实际有功功率 (W)
+ */
+float BL_powerRegister2ActualPower(uint32_t power_reg_val)
+{
+    // 基于定点转换结果，仅做一次单精度除法 (结果为绝对值)
+    return BL_powerRegister2MilliWatts(power_reg_val) / 1000.0f;
 }
\ No newline at end of file
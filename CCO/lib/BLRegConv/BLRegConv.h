@@ -4,25 +4,71 @@
 #include <Arduino.h>
 
 // Vref: 芯片参考电压(V)
-const double BL0906_VREF = 1.097;
+constexpr double BL0906_VREF = 1.097;
 
 // GAIN_I: 电流通道增益
-const double BL0906_GAIN_I = 16.0;
+constexpr double BL0906_GAIN_I = 16.0;
 
 // GAIN_V: 电压通道增益
-const double BL0906_GAIN_V = 1.0;
+constexpr double BL0906_GAIN_V = 1.0;
 
 // RL_MOHM: 电流采样电阻值(毫欧)
-const double BL0906_RL_MOHM = 1.0;
+constexpr double BL0906_RL_MOHM = 1.0;
 
 // RF_KOHM: Rf分压电阻(千欧)
-const double BL0906_RF_KOHM = 300.0 * 5;
+constexpr double BL0906_RF_KOHM = 300.0 * 5;
 
 // RV_KOHM: Rv分压电阻(千欧)
-const double BL0906_RV_KOHM = 1.0;
+constexpr double BL0906_RV_KOHM = 1.0;
 
 // RF_PLUS_RV_KOHM: 电压分压电阻之和(Rf + Rv)(千欧)
-const double BL0906_RF_PLUS_RV_KOHM = BL0906_RF_KOHM + BL0906_RV_KOHM;
+constexpr double BL0906_RF_PLUS_RV_KOHM = BL0906_RF_KOHM + BL0906_RV_KOHM;
+
+// 电流转换系数(A/LSB)
+// 公式: Vref / (12875.0 * GAIN_I * RL_mOhm)
+constexpr double BL0906_CURRENT_COEFFICIENT = BL0906_VREF / (12875.0 * BL0906_GAIN_I * BL0906_RL_MOHM);
+
+// 功率转换系数(W/LSB)
+// 公式: (Vref^2 * (Rf+Rv)_kOhm) / (40.4125 * RL_mOhm * Gain_I * RV_kOhm * Gain_V * 1000.0)
+constexpr double BL0906_POWER_COEFFICIENT = (BL0906_VREF * BL0906_VREF * BL0906_RF_PLUS_RV_KOHM) / (40.4125 * BL0906_RL_MOHM * BL0906_GAIN_I * BL0906_RV_KOHM * BL0906_GAIN_V * 1000.0);
+
+// 定点数(Q32)转换系数: 寄存器值 * 系数 >> 32 = 毫安/毫瓦
+// 在编译期由上面的浮点系数计算得到，运行时只需一次 64 位整数乘法和移位
+constexpr uint64_t BL0906_CURRENT_MA_Q32 = (uint64_t)(BL0906_CURRENT_COEFFICIENT * 1000.0 * 4294967296.0 + 0.5);
+constexpr uint64_t BL0906_POWER_MW_Q32 = (uint64_t)(BL0906_POWER_COEFFICIENT * 1000.0 * 4294967296.0 + 0.5);
+
+// 24 位寄存器最大值乘以系数不能超出 64 位整数范围
+static_assert(BL0906_CURRENT_MA_Q32 < (1ULL << 40), "BL0906 电流定点系数溢出");
+static_assert(BL0906_POWER_MW_Q32 < (1ULL << 40), "BL0906 功率定点系数溢出");
+
+// 有功电能脉冲当量(Wh/脉冲)，CF_CNT 每计 1 个脉冲对应的电能
+// 公式: 功率系数(W/LSB) * 4194304 * 0.032768 * 16 / 3600 (WA_CFDIV 为默认值 0x010)
+constexpr double BL0906_ENERGY_PER_PULSE_WH = BL0906_POWER_COEFFICIENT * 4194304.0 * 0.032768 * 16.0 / 3600.0;
+
+// 定点数(Q24)电能系数: 脉冲数 * 系数 >> 24 = 瓦时 (32 位脉冲数乘以系数不会超出 64 位)
+constexpr uint64_t BL0906_ENERGY_WH_Q24 = (uint64_t)(BL0906_ENERGY_PER_PULSE_WH * 16777216.0 + 0.5);
+static_assert(BL0906_ENERGY_WH_Q24 < (1ULL << 32), "BL0906 电能定点系数溢出");
+
+/**
+ * @brief 将 24 位无符号电流寄存器值转换为实际电流 (mA)
+ * @param current_reg_val 从电流 RMS 寄存器读取的 24 位无符号值
+ * @return uint32_t 计算得到的实际电流 (mA)，四舍五入
+ */
+uint32_t BL_currentRegister2MilliAmps(uint32_t current_reg_val);
+
+/**
+ * @brief 将 24 位有符号 (补码) 有功功率寄存器值转换为实际有功功率 (mW)
+ * @param power_reg_val 从有功功率寄存器读取的 24 位值，补码，Bit 23 是符号位
+ * @return uint32_t 计算得到的实际有功功率绝对值 (mW)，四舍五入
+ */
+uint32_t BL_powerRegister2MilliWatts(uint32_t power_reg_val);
+
+/**
+ * @brief 将累计的有功电能脉冲数 (CF_CNT) 转换为电能 (Wh)
+ * @param pulses 累计的 CF 脉冲数
+ * @return uint32_t 计算得到的电能 (Wh)，四舍五入
+ */
+uint32_t BL_energyPulses2WattHours(uint32_t pulses);
 
 /**
  * @brief 将 24 位无符号电流寄存器值转换为实际电流 (A)
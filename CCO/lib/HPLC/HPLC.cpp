@@ -1,26 +1,130 @@
 #include <HPLC.h>
+#include <Metrics.h>
+#include <Log.h>
+#include <MpscQueue.h>
 
-// ACK机制的全局变量，指示是否已接收并验证ACK
-volatile bool ackReceived = false;
 // 最大重试次数
 static int MAX_RETRIES = 3;
 // ACK超时时间（毫秒）
 static long ACK_TIMEOUT_MS = 1000;
 
 // 通用请求/应答帧头
-static uint8_t FRAME_HEAD[5] = {
+static const uint8_t FRAME_HEAD[5] = {
     FRAME_LEAD_BYTE, FRAME_LEAD_BYTE, FRAME_LEAD_BYTE, FRAME_LEAD_BYTE, // 前导字节
     FRAME_HEADER                                                        // 帧起始符
 };
 
-// 通用请求/应答帧尾
-static uint8_t FRAME_TAIL[2] = {
-    0x00,     // 校验码占位符
-    FRAME_END // 帧结束符
-};
+// [AT命令]前缀 "AT+SEND=" 的长度
+#define AT_SEND_HEAD_LEN 8
+// [AT命令]前缀 "AT+SEND=<MAC>," 的长度
+#define AT_SEND_PREFIX_LEN (AT_SEND_HEAD_LEN + MAC_HEX_LEN + 1)
+// 完整[AT命令]的最大长度
+#define AT_SEND_MAX_LEN HPLC_AT_SEND_MAX_LEN
+static_assert(AT_SEND_MAX_LEN == AT_SEND_PREFIX_LEN + 3 + 1 + MAX_FRAME_LEN + 2, "AT命令最大长度与前缀长度不一致");
+
+// 定义[AT命令前缀缓存项]
+typedef struct
+{
+    uint8_t macAddress[6];           // 目标 MAC 地址
+    char prefix[AT_SEND_PREFIX_LEN]; // 已编码的 "AT+SEND=<MAC>," (不含结束符)
+    bool valid;                      // 是否有效
+} PrefixCacheEntry;
+
+// 创建[AT命令前缀缓存] (按MAC地址直接映射)
+static PrefixCacheEntry prefixCache[HPLC_PREFIX_CACHE_SIZE];
+// 保护[AT命令前缀缓存]的自旋锁
+static portMUX_TYPE prefixCacheMux = portMUX_INITIALIZER_UNLOCKED;
+
+/**
+ * 计算只有控制码、数据域为空的帧的校验和 (编译期常量)
+ */
+static constexpr uint8_t empty_frame_checksum(uint8_t ctrl_code)
+{
+    return (uint8_t)(FRAME_HEADER + ctrl_code + 0x00);
+}
+
+// 预先编码的心跳包帧 (含校验和)
+static const uint8_t HEART_BEAT_FRAME[] = {
+    FRAME_LEAD_BYTE, FRAME_LEAD_BYTE, FRAME_LEAD_BYTE, FRAME_LEAD_BYTE, FRAME_HEADER,
+    0x66, 0x00, empty_frame_checksum(0x66), FRAME_END};
+
+// 预先编码的心跳包应答帧 (含校验和)
+static const uint8_t HEART_BEAT_REPLY_FRAME[] = {
+    FRAME_LEAD_BYTE, FRAME_LEAD_BYTE, FRAME_LEAD_BYTE, FRAME_LEAD_BYTE, FRAME_HEADER,
+    0x88, 0x00, empty_frame_checksum(0x88), FRAME_END};
+
+// [AT应答]成功行的前缀
+static const char AT_OK_PREFIX[] = "\r+ok=";
+
+// 创建[帧解析器] (两个交替使用: 回调正在使用上一帧时，新收到的字节写入另一个，无需拷贝)
+static FrameParser frameParsers[2];
+// 当前正在接收的[帧解析器]
+static FrameParser *frameParser = &frameParsers[0];
+
+// 请求类型
+#define REQUEST_ACK 0 // 写出[AT命令]并等待ACK帧，超时重发
+#define REQUEST_AT 1  // 写出AT查询命令并开始转发AT应答行，由请求方读取应答行后结束
+
+// 定义[请求]: 需要应答的请求由发送方在栈上创建，交给串口任务执行，执行完毕前发送方阻塞
+typedef struct
+{
+    uint8_t kind;            // 请求类型 (REQUEST_ACK / REQUEST_AT)
+    const uint8_t *command;  // 要写出的命令 (重发时直接复用)
+    size_t commandLength;    // 命令长度
+    uint8_t ctrlCode;        // 发送帧的控制码 (计数用)
+    uint8_t expectedAckCode; // 期望的ACK控制码
+    FrameParser *response;   // 用于保存ACK帧内容 (NULL 表示不需要)
+    bool acked;              // 是否收到ACK (由串口任务填写)
+    bool done;               // 是否已执行完毕 (由串口任务最后置位，置位后串口任务不再访问该请求)
+    TaskHandle_t requester;  // 发送方任务 (执行完毕时通知)
+    uint32_t sentAtUs;       // 最近一次写出的时间 (us，由串口任务填写，发送方据此计算ACK延迟)
+} HPLCRequest;
+
+// 定义[发送命令]: 不需要应答的命令按值放入发送队列
+typedef struct
+{
+    uint8_t length;                 // 命令长度
+    uint8_t bytes[AT_SEND_MAX_LEN]; // 命令内容
+} HPLCCommand;
+
+// 定义[AT应答行]
+typedef struct
+{
+    char text[HPLC_AT_LINE_SIZE]; // "\r+ok=" 之后、行尾之前的内容 (以 '\0' 结尾)
+} AtLine;
+
+// 串口任务 -> loop(): 等待分发的完整帧
+static MpscQueue<FrameBytes, HPLC_RX_QUEUE_SIZE> rxFrameQueue;
+// 串口任务 -> 查询拓扑的任务: AT应答行
+static MpscQueue<AtLine, HPLC_LINE_QUEUE_SIZE> atLineQueue;
+// 各任务 -> 串口任务: 不需要应答的命令
+static MpscQueue<HPLCCommand, HPLC_TX_QUEUE_SIZE> txQueue;
+// 各任务 -> 串口任务: 需要ACK的请求
+static MpscQueue<HPLCRequest *, HPLC_REQUEST_QUEUE_SIZE> requestQueue;
+// 查询拓扑的任务 -> 串口任务: AT查询 (与ACK请求分开排队，互不阻塞)
+static MpscQueue<HPLCRequest *, HPLC_AT_QUEUE_SIZE> atRequestQueue;
+// 是否正在进行AT查询 (由串口任务开始、请求方结束，期间串口任务转发AT应答行且不开始新的AT查询)
+static bool atLineWanted = false;
+// AT查询是否暂停ACK请求 (由串口任务开始、请求方收到节点数量后结束，避免其它命令的应答行被当作节点数量)
+static bool atQueryExclusive = false;
+// 串口任务的任务句柄
+static TaskHandle_t ownerTaskHandle = NULL;
 
-// 创建[帧解析器]
-static FrameParser frameParser;
+// 请求执行状态 (仅串口任务使用)
+static HPLCRequest *ackRequest = NULL;   // 正在等待ACK的请求 (ACK按控制码匹配，同一时间只等待一个)
+static uint32_t ackSentAtMs = 0;         // 最近一次写出的时间 (ms，判断超时)
+static int ackRetryCount = 0;            // 已重发次数
+static TaskHandle_t atLineReader = NULL; // 正在读取AT应答行的任务 (放入应答行时通知)
+static HPLCCommand ownerCommand;         // 从发送队列取出的命令 (放在静态区以免占用任务栈)
+static uint8_t ownerRxChunk[64];         // 从串口一次取出的字节 (放在静态区以免占用任务栈)
+
+// AT应答行解析状态 (仅串口任务使用)
+static AtLine atLine;         // 正在接收的应答行
+static int atLineMatched = 0; // 已匹配的 "\r+ok=" 前缀长度
+static int atLineLength = 0;  // 已写入的内容长度
+
+// 创建[控制码处理表] (以控制码为下标)
+static HPLCHandlerEntry handlerTable[256];
 
 /**
  * 加入解析器
@@ -28,12 +132,12 @@ static FrameParser frameParser;
 static void add_parser(uint8_t data)
 {
     // 加入[帧内容缓冲区]
-    frameParser.buffer[frameParser.index++] = data;
+    frameParser->buffer[frameParser->index++] = data;
     // 前导字节不计入校验和
-    if (frameParser.state != WAIT_LEAD_BYTE)
+    if (frameParser->state != WAIT_LEAD_BYTE)
     {
         // 加入[校验和]
-        frameParser.checksum += data;
+        frameParser->checksum += data;
     }
 }
 
@@ -42,15 +146,29 @@ static void add_parser(uint8_t data)
  */
 static void reset_parser()
 {
-    frameParser.state = WAIT_LEAD_BYTE;           // [状态]回到初始
-    memset(frameParser.buffer, 0, MAX_FRAME_LEN); // [帧内容缓冲区]数组清零
-    frameParser.index = 0;                        // [帧内容缓冲区下标]归零
-    frameParser.dataFieldEndIndex = 0;            // [数据域结束下标]归零
-    frameParser.checksum = 0;                     // [校验和]归零
+    frameParser->state = WAIT_LEAD_BYTE; // [状态]回到初始
+    frameParser->index = 0;              // [帧内容缓冲区下标]归零 (缓冲区按下标写入，无需清零)
+    frameParser->dataFieldEndIndex = 0;  // [数据域结束下标]归零
+    frameParser->checksum = 0;           // [校验和]归零
+}
+
+static void process_frame(uint8_t data, FrameCallbackFunc callback, void *context);
+static void owner_task(void *pvParameters);
+
+/**
+ * 唤醒串口任务 (有新的命令或请求，或串口收到数据)
+ */
+static void notify_owner()
+{
+    if (ownerTaskHandle != NULL)
+    {
+        xTaskNotifyGive(ownerTaskHandle);
+    }
 }
 
 /**
  * @brief 初始化HPLC模块
+ * @details 启动串口任务，此后串口只由串口任务读写
  */
 void HPLC_init()
 {
@@ -58,23 +176,53 @@ void HPLC_init()
     HPLC.begin(115200, SERIAL_8E1, HPLC_RX, HPLC_TX);
     // 初始化[帧解析器]
     reset_parser();
+    // 登记协议规定的应答控制码
+    HPLC_register_handler(MsgHeartBeat::CTRL, NULL, HPLC_LEN_ANY, MsgHeartBeatAck::CTRL);
+    HPLC_register_handler(MsgSetSocketState::CTRL, NULL, HPLC_LEN_ANY, MsgSetSocketStateAck::CTRL);
+    HPLC_register_handler(MsgSetMaxPower::CTRL, NULL, HPLC_LEN_ANY, MsgSetMaxPowerAck::CTRL);
+    HPLC_register_handler(MsgSetPush::CTRL, NULL, HPLC_LEN_ANY, MsgSetPushAck::CTRL); // 与超功率通知 (STA -> CCO) 共用 0x93
+    HPLC_register_handler(MsgCurrentReport::CTRL, NULL, HPLC_LEN_ANY, MsgCurrentReportAck::CTRL);
+    HPLC_register_handler(MsgPowerReport::CTRL, NULL, HPLC_LEN_ANY, MsgPowerReportAck::CTRL);
+    HPLC_register_handler(MsgEnergyQuery::CTRL, NULL, HPLC_LEN_ANY, MsgEnergyReply::CTRL);
+    HPLC_register_handler(MsgHistoryQuery::CTRL, NULL, HPLC_LEN_ANY, MsgHistoryReply::CTRL);
+
+    // 创建并启动串口任务 (优先级高于 loop() 和监控任务，不固定核心)
+    BaseType_t taskCreated = xTaskCreatePinnedToCore(
+        owner_task,           /* 任务函数 */
+        "HPLC",               /* 任务名称字符串 */
+        HPLC_TASK_STACK_SIZE, /* 堆栈大小（字节） */
+        NULL,                 /* 传递给任务的参数 */
+        HPLC_TASK_PRIORITY,   /* 任务优先级（0为最低） */
+        &ownerTaskHandle,     /* 任务句柄 */
+        tskNO_AFFINITY        /* 不固定核心 */
+    );
+    if (taskCreated != pdPASS)
+    {
+        Serial.println("初始化 -> HPLC串口任务 -> 创建并启动失败");
+    }
+    // 串口收到数据 (FIFO达到阈值或线路空闲) 时唤醒串口任务
+    HPLC.onReceive(notify_owner);
 }
 
 /**
- * @brief 处理接收到的数据帧
- * @param data 接收到的数据
- * @param callback 回调函数
+ * 处理接收到的数据帧 (仅串口任务调用)
+ * 收到完整帧时调用 callback，帧视图仅在回调期间有效
  */
-void HPLC_process_frame(uint8_t data, FrameCallbackFunc callback)
+static void process_frame(uint8_t data, FrameCallbackFunc callback, void *context)
 {
     // 校验码
     uint8_t calculatedCS;
-    switch (frameParser.state)
+    switch (frameParser->state)
     {
     case WAIT_LEAD_BYTE: // [前导字节检测]状态: 4个 FE（4字节）
         // Serial.println("WAIT_LEAD_BYTE");
         if (data != FRAME_LEAD_BYTE)
         {
+            // 前导字节收到一半被打断，记为失步
+            if (frameParser->index > 0)
+            {
+                METRICS_count(METRIC_HPLC_RESYNC);
+            }
             // 没收到前导字节就重置解析器
             reset_parser();
         }
@@ -82,10 +230,10 @@ void HPLC_process_frame(uint8_t data, FrameCallbackFunc callback)
         {
             // 解析器装入新数据
             add_parser(data);
-            if (frameParser.index == 4)
+            if (frameParser->index == 4)
             {
                 // 前导字节读完后进入下一个状态
-                frameParser.state = WAIT_HEADER;
+                frameParser->state = WAIT_HEADER;
             }
         }
         break;
@@ -95,6 +243,7 @@ void HPLC_process_frame(uint8_t data, FrameCallbackFunc callback)
         if (data != FRAME_HEADER)
         {
             // 没收到起始符就重置解析器
+            METRICS_count(METRIC_HPLC_RESYNC);
             reset_parser();
         }
         else
@@ -102,7 +251,7 @@ void HPLC_process_frame(uint8_t data, FrameCallbackFunc callback)
             // 解析器装入新数据
             add_parser(data);
             // 进入下一个状态
-            frameParser.state = READING_CTRL;
+            frameParser->state = READING_CTRL;
         }
         break;
 
@@ -111,24 +260,31 @@ void HPLC_process_frame(uint8_t data, FrameCallbackFunc callback)
         // 解析器装入新数据
         add_parser(data);
         // 进入下一个状态
-        frameParser.state = READING_DATA_LEN;
+        frameParser->state = READING_DATA_LEN;
         break;
 
     case READING_DATA_LEN: // [数据域长度读取]状态: 数据域长度（1字节）
         // Serial.println("READING_DATA_LEN");
+        if (data > PROTOCOL_MAX_DATA_LEN)
+        {
+            // 数据域长度超过单帧容量 (线路噪声或错误帧)，丢弃该帧，避免写出缓冲区
+            METRICS_count(METRIC_HPLC_RESYNC);
+            reset_parser();
+            break;
+        }
         // 解析器装入新数据
         add_parser(data);
         // 设置[数据域结束下标] = 通用请求/应答帧头长度 + 1位控制码 + 数据域长度
-        frameParser.dataFieldEndIndex = ARRAY_LENGTH(FRAME_HEAD) + 1 + data;
+        frameParser->dataFieldEndIndex = ARRAY_LENGTH(FRAME_HEAD) + 1 + data;
         if (data == 0x00)
         {
             // 没有数据，跳过下一个状态，直接进入下下一个状态
-            frameParser.state = READING_CHECKSUM;
+            frameParser->state = READING_CHECKSUM;
         }
         else
         {
             // 有数据，进入下一个状态
-            frameParser.state = READING_DATA;
+            frameParser->state = READING_DATA;
         }
         break;
 
@@ -136,20 +292,21 @@ void HPLC_process_frame(uint8_t data, FrameCallbackFunc callback)
         // Serial.println("READING_DATA");
         // 解析器装入新数据
         add_parser(data);
-        if (frameParser.index > frameParser.dataFieldEndIndex)
+        if (frameParser->index > frameParser->dataFieldEndIndex)
         {
             // 读完数据域进入下一个状态
-            frameParser.state = READING_CHECKSUM;
+            frameParser->state = READING_CHECKSUM;
         }
         break;
 
     case READING_CHECKSUM: // [校验和验证]状态:
         // Serial.println("READING_CHECKSUM");
         // 计算缓冲区的校验码
-        calculatedCS = frameParser.checksum % 256;
+        calculatedCS = frameParser->checksum % 256;
         if (data != calculatedCS)
         {
             // 校验失败就重置解析器
+            METRICS_count(METRIC_HPLC_CHECKSUM_FAIL);
             reset_parser();
         }
         else
@@ -157,7 +314,7 @@ void HPLC_process_frame(uint8_t data, FrameCallbackFunc callback)
             // 解析器装入新数据
             add_parser(data);
             // 校验通过进入下一个状态
-            frameParser.state = WAIT_EOF;
+            frameParser->state = WAIT_EOF;
         }
         break;
 
@@ -167,14 +324,23 @@ void HPLC_process_frame(uint8_t data, FrameCallbackFunc callback)
         {
             // 解析器装入新数据
             add_parser(data);
+            // 切换到另一个解析器继续接收，回调期间新收到的字节不会覆盖当前帧
+            const FrameParser *complete = frameParser;
+            frameParser = (frameParser == &frameParsers[0]) ? &frameParsers[1] : &frameParsers[0];
+            reset_parser();
+            METRICS_count_rx(complete->buffer[FRAME_CTRL_OFFSET]);
             // 收到完整帧并校验通过 -> 执行回调（检查空指针避免崩溃）
             if (callback)
             {
-                callback(frameParser);
+                callback(frame_view(*complete), context);
             }
         }
-        // 重置解析器
-        reset_parser();
+        else
+        {
+            // 没收到结束符，重置解析器
+            METRICS_count(METRIC_HPLC_RESYNC);
+            reset_parser();
+        }
         break;
     }
 }
@@ -182,124 +348,526 @@ void HPLC_process_frame(uint8_t data, FrameCallbackFunc callback)
 /**
  * 根据发送的控制码返回期望的应答控制码
  */
-uint8_t get_expected_ack_code(uint8_t sent_ctrl_code)
+static inline uint8_t get_expected_ack_code(uint8_t sent_ctrl_code)
 {
-    switch (sent_ctrl_code)
+    return handlerTable[sent_ctrl_code].ackCode;
+}
+
+/**
+ * @brief 注册控制码的处理函数
+ * @param ctrl_code 控制码
+ * @param handler 处理函数 (NULL 表示只登记应答控制码)
+ * @param expected_len 期望的数据域长度，长度不符的帧不会交给处理函数 (HPLC_LEN_ANY 表示不校验)
+ * @param ack_code 发送该控制码时期望的应答控制码 (0x00 表示保持默认)
+ */
+void HPLC_register_handler(uint8_t ctrl_code, HPLCFrameHandler handler, uint8_t expected_len, uint8_t ack_code)
+{
+    HPLCHandlerEntry &entry = handlerTable[ctrl_code];
+    entry.handler = handler;
+    entry.expectedLen = expected_len;
+    if (ack_code != 0x00)
     {
-    case 0x66:
-        // 心跳包
-        return 0x88;
-    case 0x11:
-        // STA接收CCO -> 设置插孔通断状态
-        return 0x91;
-    case 0x12:
-        // STA接收CCO -> 设置插孔最大功率
-        return 0x92;
-    case 0x13:
-        // CCO接收STA -> 功率超限通知
-        return 0x93;
-    case 0x14:
-        // CCO接收STA -> 插孔电流
-        return 0x94;
-    case 0x15:
-        // CCO接收STA -> 插孔功率
-        return 0x95;
-    default:
-        return 0x00;
+        entry.ackCode = ack_code;
     }
 }
 
 /**
- * @brief 发送数据帧
- * @param target_address 目标地址
- * @param frame 数据帧
- * @param frame_length 数据帧长度
- * @param is_ack_needed 是否需要ACK
- * @return true 发送成功
- * @return false 发送失败
+ * @brief 将完整帧分发给已注册的处理函数
+ * @details 按控制码查表，校验数据域长度后调用处理函数，未注册或长度不符的帧被丢弃
+ * @param frame 完整帧
+ * @param context 未使用 (与[帧回调函数]类型一致，可直接传给 HPLC_poll)
  */
-bool HPLC_send_frame(uint8_t target_address[], uint8_t frame[], int frame_length, bool is_ack_needed)
+void HPLC_dispatch_frame(const FrameView &frame, void *context)
 {
-    // 校验和
-    uint8_t cs = FRAME_HEADER;
+    const HPLCHandlerEntry &entry = handlerTable[frame.ctrlCode];
+    if (entry.handler == NULL)
+    {
+        return;
+    }
+    if (entry.expectedLen != HPLC_LEN_ANY && entry.expectedLen != frame.dataLen)
+    {
+        LOG_WARN("HPLC -> 控制码 %02X 数据域长度 %d 不符 (期望 %d)，已丢弃", frame.ctrlCode, frame.dataLen, entry.expectedLen);
+        return;
+    }
+    entry.handler(frame);
+}
+
+/**
+ * 将 "AT+SEND=<MAC>," 前缀写入缓冲区，同一目标地址只编码一次
+ */
+static void copy_at_send_prefix(const uint8_t target_address[], uint8_t out[AT_SEND_PREFIX_LEN])
+{
+    // 用MAC地址末字节直接映射缓存位置 (STA地址末字节分布较均匀)
+    PrefixCacheEntry &entry = prefixCache[target_address[5] % HPLC_PREFIX_CACHE_SIZE];
+
+    portENTER_CRITICAL(&prefixCacheMux);
+    bool hit = entry.valid && memcmp(entry.macAddress, target_address, 6) == 0;
+    if (hit)
+    {
+        memcpy(out, entry.prefix, AT_SEND_PREFIX_LEN);
+    }
+    portEXIT_CRITICAL(&prefixCacheMux);
+    if (hit)
+    {
+        return;
+    }
+
+    // 未命中，编码前缀
+    char mac_hex[MAC_HEX_LEN + 1];
+    mac_to_hex(target_address, mac_hex);
+    memcpy(out, "AT+SEND=", AT_SEND_HEAD_LEN);
+    memcpy(out + AT_SEND_HEAD_LEN, mac_hex, MAC_HEX_LEN);
+    out[AT_SEND_PREFIX_LEN - 1] = ',';
+
+    // 写回缓存
+    portENTER_CRITICAL(&prefixCacheMux);
+    memcpy(entry.macAddress, target_address, 6);
+    memcpy(entry.prefix, out, AT_SEND_PREFIX_LEN);
+    entry.valid = true;
+    portEXIT_CRITICAL(&prefixCacheMux);
+}
+
+/**
+ * 将帧内容编码为完整的帧 (帧头 + 帧内容 + 校验和 + 帧结束符)，返回编码后的长度
+ */
+static size_t encode_frame(const uint8_t frame[], int frame_length, uint8_t out[])
+{
+    size_t n = 0;
+    // 通用请求/应答帧头
+    memcpy(out, FRAME_HEAD, ARRAY_LENGTH(FRAME_HEAD));
+    n += ARRAY_LENGTH(FRAME_HEAD);
+    // 帧内容
+    memcpy(out + n, frame, frame_length);
+    n += frame_length;
     // 计算帧内容[校验和]（从第一个FRAME_HEADER到校验码前的所有字节和）
+    uint8_t cs = FRAME_HEADER;
     for (int i = 0; i < frame_length; i++)
     {
         cs += frame[i];
     }
-    // 填充最终[校验和]
-    FRAME_TAIL[0] = cs % 256;
-    // 计算数据总长度
-    uint8_t len = (ARRAY_LENGTH(FRAME_HEAD) + frame_length + ARRAY_LENGTH(FRAME_TAIL));
-
-    // frame[0] 是发送帧的控制码，通过该控制码获取期望的ACK控制码
-    uint8_t expected_ack_ctrl_code = get_expected_ack_code(frame[0]);
-
-    // 重试次数
-    int retry_count = 0;
-    // 重试逻辑
-    do
-    {
-        // [AT命令]发送完整帧("AT+SEND=0013D7632202,30,FEFEFEFE6899063555960A4633AA16\r\n")
-        HPLC.print("AT+SEND=");
-        HPLC.print(mac_to_string(target_address)); // 目标 MAC 地址
-        HPLC.print(",");
-        HPLC.printf("%d", len); // 数据长度
-        HPLC.print(",");
-        HPLC.write(FRAME_HEAD, ARRAY_LENGTH(FRAME_HEAD)); // 通用请求/应答帧头
-        HPLC.write(frame, frame_length);                  // 帧内容
-        HPLC.write(FRAME_TAIL, ARRAY_LENGTH(FRAME_TAIL)); // 通用请求/应答帧尾
-        HPLC.print("\r\n");
-
-        if (!is_ack_needed)
+    out[n++] = cs;
+    // 帧结束符
+    out[n++] = FRAME_END;
+    return n;
+}
+
+/**
+ * 将完整的帧组装为一条[AT命令]("AT+SEND=0013D7632202,30,<帧>\r\n")，返回命令长度
+ */
+static size_t build_at_send(const uint8_t target_address[], const uint8_t encoded[], size_t encoded_length, uint8_t out[AT_SEND_MAX_LEN])
+{
+    size_t n = AT_SEND_PREFIX_LEN;
+    // 目标 MAC 地址
+    copy_at_send_prefix(target_address, out);
+    // 数据长度 (十进制，不超过 MAX_FRAME_LEN)
+    if (encoded_length >= 100)
+    {
+        out[n++] = '0' + encoded_length / 100;
+    }
+    if (encoded_length >= 10)
+    {
+        out[n++] = '0' + encoded_length / 10 % 10;
+    }
+    out[n++] = '0' + encoded_length % 10;
+    out[n++] = ',';
+    // 帧
+    memcpy(out + n, encoded, encoded_length);
+    n += encoded_length;
+    out[n++] = '\r';
+    out[n++] = '\n';
+    return n;
+}
+
+/**
+ * 将帧视图的有效部分拷贝到解析器缓冲区，供回调之外使用
+ */
+static void copy_frame(const FrameView &frame, FrameParser &out)
+{
+    memcpy(out.buffer, frame.bytes, frame.length);
+    out.index = frame.length;
+}
+
+/**
+ * 将请求标记为执行完毕并唤醒请求方 (仅串口任务调用)
+ */
+static void complete_request(HPLCRequest *request)
+{
+    // 置位前取出任务句柄: 请求方看到置位后即可返回，请求所在的栈随之失效
+    TaskHandle_t requester = request->requester;
+    __atomic_store_n(&request->done, true, __ATOMIC_RELEASE);
+    xTaskNotifyGive(requester);
+}
+
+/**
+ * 结束正在等待ACK的请求并唤醒请求方 (仅串口任务调用)
+ */
+static void finish_request(bool acked)
+{
+    HPLCRequest *request = ackRequest;
+    ackRequest = NULL;
+    if (!acked)
+    {
+        // 超过最大重试次数，发送失败
+        METRICS_count(METRIC_HPLC_SEND_FAIL);
+    }
+    request->acked = acked;
+    complete_request(request);
+}
+
+/**
+ * 串口任务的帧回调: 期望的ACK交给等待中的请求，其它帧排队等待 loop() 分发
+ */
+static void on_frame(const FrameView &frame, void *context)
+{
+    if (ackRequest != NULL && frame.ctrlCode == ackRequest->expectedAckCode)
+    {
+        if (ackRequest->response)
         {
-            // 如果不需要ACK，直接返回true
-            return true;
+            copy_frame(frame, *ackRequest->response);
         }
+        // 同一个请求只接收一次ACK，重复的ACK按普通帧处理
+        finish_request(true);
+        return;
+    }
 
-        // 重置应答接收标志
-        ackReceived = false;
+    // 直接拷贝到队列槽位，loop() 在槽位上原地分发
+    uint32_t pos;
+    FrameBytes *slot = rxFrameQueue.reserve(pos);
+    if (slot == NULL)
+    {
+        // loop() 处理不过来，丢弃该帧
+        METRICS_count(METRIC_HPLC_RX_DROPPED);
+        return;
+    }
+    memcpy(slot->bytes, frame.bytes, frame.length);
+    slot->length = frame.length;
+    rxFrameQueue.commit(pos);
+}
 
-        // 记录发送时间
-        long send_time = millis();
-        // 在超时时间内等待ACK应答
-        while (millis() - send_time < ACK_TIMEOUT_MS)
+/**
+ * 逐字节匹配 "\r+ok=<内容>\r\n" 形式的AT应答，AT查询期间将<内容>放入应答行队列
+ * 前缀之前的字节被跳过，超出容量的内容被截断
+ */
+static void process_at_line(uint8_t data)
+{
+    const int prefix_len = sizeof(AT_OK_PREFIX) - 1;
+    char c = (char)data;
+    if (atLineMatched < prefix_len)
+    {
+        // 逐字节匹配前缀，失配时从当前字节重新匹配
+        atLineMatched = (c == AT_OK_PREFIX[atLineMatched]) ? atLineMatched + 1 : (c == AT_OK_PREFIX[0] ? 1 : 0);
+        return;
+    }
+    if (c == '\n')
+    {
+        // 去掉行尾的 '\r'
+        if (atLineLength > 0 && atLine.text[atLineLength - 1] == '\r')
         {
-            if (HPLC.available())
-            {
-                // 假设 HPLC_process_frame 会在收到完整帧后设置 ackReceived 和填充 ackFrameParser
-                HPLC_process_frame(HPLC.read(), [expected_ack_ctrl_code](FrameParser frameParser) { // 使用 lambda 表达式捕获期望的ACK控制码
-                    // 提取控制码
-                    uint8_t ctrlCode = frameParser.buffer[5];
-                    if (ctrlCode == expected_ack_ctrl_code)
-                    {
-                        // 收到了正确的ACK，设置全局标志
-                        ackReceived = true;
-                    }
-                });
-            }
-            // 如果收到了正确的ACK，返回true
-            if (ackReceived)
-            {
-                return true;
-            }
-            // 任务延时，防止看门狗超时导致重启
-            vTaskDelay(pdMS_TO_TICKS(10));
+            atLineLength--;
+        }
+        atLine.text[atLineLength] = '\0';
+        if (__atomic_load_n(&atLineWanted, __ATOMIC_ACQUIRE) && atLineQueue.push(atLine))
+        {
+            xTaskNotifyGive(atLineReader);
         }
+        atLineMatched = 0;
+        atLineLength = 0;
+        return;
+    }
+    if (atLineLength < HPLC_AT_LINE_SIZE - 1)
+    {
+        atLine.text[atLineLength++] = c;
+    }
+}
 
-        // 上面没有返回，证明ACK超时
-        Serial.print("等待ACK超时，正在重试... (");
-        Serial.print(retry_count + 1);
-        Serial.print("/");
-        Serial.print(MAX_RETRIES);
-        Serial.println(")");
-        // 增加重试次数
-        retry_count++;
+/**
+ * 写出正在等待ACK的请求 (首次发送或重发)
+ */
+static void write_ack_request()
+{
+    ackRequest->sentAtUs = micros();
+    ackSentAtMs = millis();
+    // 一次写出整条[AT命令]
+    HPLC.write(ackRequest->command, ackRequest->commandLength);
+    METRICS_count_tx(ackRequest->ctrlCode);
+    if (ackRetryCount > 0)
+    {
+        METRICS_count(METRIC_HPLC_RETRY);
+    }
+}
 
-    } while (!ackReceived && retry_count < MAX_RETRIES);
+/**
+ * 开始执行请求队列中取出的请求
+ */
+static void start_request(HPLCRequest *request)
+{
+    if (request->kind == REQUEST_AT)
+    {
+        // 先开始转发应答行再写出命令，避免应答在此之前到达；请求方读取应答行后结束查询
+        atLineReader = request->requester;
+        __atomic_store_n(&atQueryExclusive, true, __ATOMIC_RELEASE);
+        __atomic_store_n(&atLineWanted, true, __ATOMIC_RELEASE);
+        HPLC.write(request->command, request->commandLength);
+        complete_request(request);
+        return;
+    }
+    ackRequest = request;
+    ackRetryCount = 0;
+    write_ack_request();
+}
 
-    // 超过最大重试次数，发送失败
-    return false;
+/**
+ * 检查正在等待的ACK是否超时，超时则重发，重试用尽后结束请求
+ */
+static void check_ack_timeout()
+{
+    if (millis() - ackSentAtMs < (uint32_t)ACK_TIMEOUT_MS)
+    {
+        return;
+    }
+    // ACK超时
+    METRICS_count(METRIC_HPLC_ACK_TIMEOUT);
+    LOG_WARN("等待ACK超时，正在重试... (%d/%d)", ackRetryCount + 1, MAX_RETRIES);
+    if (++ackRetryCount < MAX_RETRIES)
+    {
+        write_ack_request();
+    }
+    else
+    {
+        finish_request(false);
+    }
+}
+
+/**
+ * 串口任务: 唯一读写HPLC串口的任务，解析帧和AT应答行，写出发送队列中的命令并执行请求，不执行任何处理函数
+ */
+static void owner_task(void *pvParameters)
+{
+    HPLCRequest *request;
+    while (1)
+    {
+        // 先读取，超时判断前到达的ACK不会被误判为超时
+        METRICS_queue_depth(METRIC_QUEUE_HPLC_RX, HPLC.available());
+        size_t received;
+        while ((received = HPLC.read(ownerRxChunk, sizeof(ownerRxChunk))) > 0)
+        {
+            HPLC_parse(ownerRxChunk, received, on_frame, NULL);
+        }
+
+        METRICS_queue_depth(METRIC_QUEUE_HPLC_TX, txQueue.size());
+        while (txQueue.pop(ownerCommand))
+        {
+            HPLC.write(ownerCommand.bytes, ownerCommand.length);
+        }
+
+        if (ackRequest != NULL)
+        {
+            check_ack_timeout();
+        }
+        // 没有等待中的ACK时优先开始排队的AT查询 (上一次AT查询结束后才开始下一次，应答行只转发给一个任务)
+        if (ackRequest == NULL && !__atomic_load_n(&atLineWanted, __ATOMIC_ACQUIRE) && atRequestQueue.pop(request))
+        {
+            start_request(request);
+        }
+        // 再开始下一个需要ACK的请求 (逐行读取拓扑信息期间也照常执行)
+        if (ackRequest == NULL && !__atomic_load_n(&atQueryExclusive, __ATOMIC_ACQUIRE) && requestQueue.pop(request))
+        {
+            start_request(request);
+        }
+
+        // 等待串口数据、新的命令或请求 (由接收回调和入队方通知)，最多休眠 HPLC_TASK_MAX_SLEEP_MS 后检查ACK超时
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(HPLC_TASK_MAX_SLEEP_MS));
+    }
+}
+
+/**
+ * @brief 将收到的字节依次送入帧解析器和AT应答行匹配
+ * @details 由串口任务调用；串口任务未启动时 (如 native 环境的基准测试) 也可直接调用，
+ *          解析器状态不加锁，不能与串口任务同时调用
+ * @param data 收到的字节
+ * @param length 字节数
+ * @param callback 回调函数，每个完整帧调用一次 (帧视图仅在回调期间有效)
+ * @param context 传给回调函数的上下文
+ */
+void HPLC_parse(const uint8_t data[], size_t length, FrameCallbackFunc callback, void *context)
+{
+    for (size_t i = 0; i < length; i++)
+    {
+        // print_to_serial_monitor("HPLC", data[i]);
+        process_at_line(data[i]);
+        process_frame(data[i], callback, context);
+    }
+}
+
+/**
+ * @brief 分发串口任务已解析的帧
+ * @details 在 loop() 中调用 (同一时间只能由一个任务调用)，不等待串口，也不会被其它任务的请求阻塞
+ * @param callback 回调函数，每个帧调用一次 (帧视图仅在回调期间有效)
+ * @param context 传给回调函数的上下文
+ */
+void HPLC_poll(FrameCallbackFunc callback, void *context)
+{
+    METRICS_queue_depth(METRIC_QUEUE_HPLC_FRAMES, rxFrameQueue.size());
+    // 帧视图直接指向队列槽位，回调结束后才交还槽位
+    const FrameBytes *frame;
+    while ((frame = rxFrameQueue.front()) != NULL)
+    {
+        if (callback)
+        {
+            callback(frame_view(*frame), context);
+        }
+        rxFrameQueue.pop_front();
+    }
+}
+
+/**
+ * 将不需要应答的命令放入发送队列，队列已满时返回 false
+ */
+static bool enqueue_command(const HPLCCommand &command)
+{
+    if (!txQueue.push(command))
+    {
+        METRICS_count(METRIC_HPLC_TX_DROPPED);
+        LOG_WARN("HPLC -> 发送队列已满，取消发送");
+        return false;
+    }
+    notify_owner();
+    return true;
+}
+
+/**
+ * 将请求交给串口任务并等待执行完毕，请求队列已满时返回 false
+ */
+static bool run_request(HPLCRequest &request)
+{
+    request.requester = xTaskGetCurrentTaskHandle();
+    HPLCRequest *pointer = &request;
+    bool queued = (request.kind == REQUEST_AT) ? atRequestQueue.push(pointer) : requestQueue.push(pointer);
+    if (!queued)
+    {
+        METRICS_count(METRIC_HPLC_TX_DROPPED);
+        LOG_WARN("HPLC -> 请求队列已满，取消发送");
+        return false;
+    }
+    notify_owner();
+    // 阻塞到串口任务通知 (之前残留的通知只会让这里多检查一次)
+    while (!__atomic_load_n(&request.done, __ATOMIC_ACQUIRE))
+    {
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(HPLC_WAIT_GUARD_MS));
+    }
+    return true;
+}
+
+/**
+ * 发送已编码的完整帧，需要ACK时可选地取回ACK帧内容
+ */
+static bool send_encoded_frame(const uint8_t target_address[], const uint8_t encoded[], size_t encoded_length, bool is_ack_needed, FrameParser *response)
+{
+    if (!is_ack_needed)
+    {
+        // 不需要ACK，组装后放入发送队列直接返回
+        HPLCCommand command;
+        command.length = build_at_send(target_address, encoded, encoded_length, command.bytes);
+        if (!enqueue_command(command))
+        {
+            return false;
+        }
+        METRICS_count_tx(encoded[FRAME_CTRL_OFFSET]);
+        return true;
+    }
+
+    // 组装完整的[AT命令]，重发时由串口任务直接复用
+    uint8_t command[AT_SEND_MAX_LEN];
+    size_t command_length = build_at_send(target_address, encoded, encoded_length, command);
+
+    // encoded[5] 是发送帧的控制码，通过该控制码获取期望的ACK控制码
+    uint8_t ctrl_code = encoded[FRAME_CTRL_OFFSET];
+    HPLCRequest request = {REQUEST_ACK, command, command_length, ctrl_code, get_expected_ack_code(ctrl_code), response, false, false, NULL, 0};
+
+    // 等待串口任务完成发送、等待ACK和重发 (接收和分发不受影响)
+    if (!run_request(request))
+    {
+        return false;
+    }
+    if (request.acked)
+    {
+        // 从最后一次写出到本任务被唤醒，即发送方实际等待的ACK延迟
+        METRICS_record_ack_rtt(target_address, micros() - request.sentAtUs);
+    }
+    return request.acked;
+}
+
+/**
+ * 帧内容能否放入一帧
+ */
+static inline bool frame_length_valid(int frame_length)
+{
+    return frame_length >= 1 && frame_length <= MAX_FRAME_LEN - (int)ARRAY_LENGTH(FRAME_HEAD) - 2;
+}
+
+/**
+ * 发送数据帧，需要ACK时可选地取回ACK帧内容
+ */
+static bool send_frame(uint8_t target_address[], uint8_t frame[], int frame_length, bool is_ack_needed, FrameParser *response)
+{
+    if (!frame_length_valid(frame_length))
+    {
+        LOG_ERROR("HPLC -> 帧内容长度 %d 非法，取消发送", frame_length);
+        return false;
+    }
+
+    // 在栈上编码完整的帧
+    uint8_t encoded[MAX_FRAME_LEN];
+    size_t encoded_length = encode_frame(frame, frame_length, encoded);
+
+    return send_encoded_frame(target_address, encoded, encoded_length, is_ack_needed, response);
+}
+
+/**
+ * @brief 发送数据帧
+ * @param target_address 目标地址
+ * @param frame 数据帧
+ * @param frame_length 数据帧长度
+ * @param is_ack_needed 是否需要ACK
+ * @return true 发送成功
+ * @return false 发送失败
+ */
+bool HPLC_send_frame(uint8_t target_address[], uint8_t frame[], int frame_length, bool is_ack_needed)
+{
+    return send_frame(target_address, frame, frame_length, is_ack_needed, nullptr);
+}
+
+/**
+ * @brief 将帧内容组装为完整的[AT命令] (与 HPLC_send_frame 写出的内容相同)
+ * @param target_address 目标地址
+ * @param frame 数据帧
+ * @param frame_length 数据帧长度
+ * @param out 输出缓冲区，至少 HPLC_AT_SEND_MAX_LEN 字节
+ * @return size_t 命令长度，数据帧长度非法时返回 0
+ */
+size_t HPLC_build_command(const uint8_t target_address[], const uint8_t frame[], int frame_length, uint8_t out[HPLC_AT_SEND_MAX_LEN])
+{
+    if (!frame_length_valid(frame_length))
+    {
+        return 0;
+    }
+    uint8_t encoded[MAX_FRAME_LEN];
+    size_t encoded_length = encode_frame(frame, frame_length, encoded);
+    return build_at_send(target_address, encoded, encoded_length, out);
+}
+
+/**
+ * @brief 发送请求帧并取回携带数据的ACK应答帧
+ * @param target_address 目标地址
+ * @param frame 数据帧
+ * @param frame_length 数据帧长度
+ * @param response 用于接收ACK应答帧的输出参数
+ * @return true 收到应答
+ * @return false 发送失败或应答超时
+ */
+bool HPLC_send_request(uint8_t target_address[], uint8_t frame[], int frame_length, FrameParser &response)
+{
+    return send_frame(target_address, frame, frame_length, true, &response);
 }
 
 /**
@@ -310,14 +878,8 @@ bool HPLC_send_frame(uint8_t target_address[], uint8_t frame[], int frame_length
  */
 bool HPLC_send_heart_beat(uint8_t target_address[])
 {
-    // 心跳包数据帧
-    uint8_t test_frame[2] = {
-        0x66, // 控制码
-        0x00  // 数据域长度
-    };
-
-    // 发送帧并返回结果
-    return HPLC_send_frame(target_address, test_frame, ARRAY_LENGTH(test_frame), true);
+    // 发送预先编码的心跳包并返回结果
+    return send_encoded_frame(target_address, HEART_BEAT_FRAME, ARRAY_LENGTH(HEART_BEAT_FRAME), true, nullptr);
 }
 
 /**
@@ -326,76 +888,73 @@ bool HPLC_send_heart_beat(uint8_t target_address[])
  */
 void HPLC_reply_heart_beat(uint8_t target_address[])
 {
-    // 心跳包数据帧
-    uint8_t test_frame[2] = {
-        0x88, // 控制码
-        0x00  // 数据域长度
-    };
+    // 发送预先编码的心跳包应答
+    send_encoded_frame(target_address, HEART_BEAT_REPLY_FRAME, ARRAY_LENGTH(HEART_BEAT_REPLY_FRAME), false, nullptr);
+}
 
-    // 发送帧
-    HPLC_send_frame(target_address, test_frame, ARRAY_LENGTH(test_frame), false);
+/**
+ * 在超时时间内从应答行队列取出一行AT应答的<内容> (以 '\0' 结尾)
+ * @return int <内容>的长度，超时返回 -1
+ */
+static int read_ok_line(char line[], int line_size, uint32_t timeout_ms)
+{
+    uint32_t start = millis();
+    AtLine item;
+    while (true)
+    {
+        if (atLineQueue.pop(item))
+        {
+            strncpy(line, item.text, line_size - 1);
+            line[line_size - 1] = '\0';
+            return strlen(line);
+        }
+        uint32_t elapsed = millis() - start;
+        if (elapsed >= timeout_ms)
+        {
+            return -1;
+        }
+        // 阻塞到串口任务放入应答行时通知
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(timeout_ms - elapsed));
+    }
 }
 
 /**
- * @brief 获取网络拓扑中STA设备的MAC地址列表
- * @param sta_mac_list 存储STA设备MAC地址的数组
- * @param sta_count 存储STA设备数量的指针
- * @return true 获取成功
- * @return false 获取失败
+ * 查询网络拓扑 (AT查询由调用方在返回后结束)
  */
-bool HPLC_get_topo_sta_mac_list(uint8_t sta_mac_list[][6], uint8_t *sta_count)
+static bool query_topology(uint8_t sta_mac_list[][6], uint16_t max_count, uint16_t *sta_count)
 {
-    String response = ""; // 串口响应的字符串
-    long startTime;       // 超时开始时间
-    char c;               // 串口字符Buffer
-    int node_count = 0;   // 网络中的节点数量
+    char line[HPLC_AT_LINE_SIZE]; // AT应答行Buffer
+    char *end;                    // 数字解析结束位置
+    long node_count;              // 网络中的节点数量
 
     // 初始化STA设备数量为0
     *sta_count = 0;
 
-    // 1. 发送 AT+TOPONUM? 指令获取网络中的节点数量
-    HPLC.print("AT+TOPONUM?\r\n");
-
-    bool topoNumOk = false; // 是否成功获取TOPONUM响应
-    // 等待500ms超时
-    startTime = millis();
-    response = "";
-    while (millis() - startTime < 500)
+    // 1. 发送 AT+TOPONUM? 指令获取网络中的节点数量 (由串口任务写出，并开始转发应答行)
+    static const char TOPONUM_COMMAND[] = "AT+TOPONUM?\r\n";
+    HPLCRequest request = {REQUEST_AT, (const uint8_t *)TOPONUM_COMMAND, sizeof(TOPONUM_COMMAND) - 1, 0x00, 0x00, NULL, false, false, NULL, 0};
+    if (!run_request(request))
     {
-        if (HPLC.available())
-        {
-            // 读取一个字符，追加到响应字符串
-            c = HPLC.read();
-            response += c;
-            // 检查是否收到以 "\r+ok=" 开始并以 "\r\n" 结束的完整行
-            if (response.indexOf("\r+ok=") != -1 && response.indexOf("\r\n") != -1)
-            {
-                topoNumOk = true;
-                break;
-            }
-        }
-        // 任务延时，防止看门狗超时导致重启
-        vTaskDelay(pdMS_TO_TICKS(10));
+        return false;
     }
-
-    // 如果成功获取到TOPONUM响应
-    if (topoNumOk)
+    int line_length = read_ok_line(line, sizeof(line), 500);
+    // 已等到节点数量，此后的拓扑信息行可按格式区分，唤醒串口任务开始排队的ACK请求
+    __atomic_store_n(&atQueryExclusive, false, __ATOMIC_RELEASE);
+    notify_owner();
+    if (line_length < 0)
     {
-        // 找到 "\r+ok=" 的位置
-        int ok_index = response.indexOf("\r+ok=");
-        // 从 "\r+ok=" 之后找到第一个 "\r\n" 的位置
-        int rn_index = response.indexOf("\r\n", ok_index);
-        // 提取 "\r+ok=" 和 "\r\n" 之间的数字字符串
-        String num_str = response.substring(ok_index + strlen("\r+ok="), rn_index);
-        // 将数字字符串转换为整数
-        node_count = num_str.toInt();
-        Serial.printf("HPLC -> STA节点数量: %d\n", node_count);
+        LOG_WARN("HPLC -> 获取TOPONUM超时或错误");
+        return false;
     }
-    else
+    // 节点数量必须是非负整数
+    node_count = strtol(line, &end, 10);
+    if (end == line || *end != '\0' || node_count < 0)
     {
-        Serial.println("HPLC -> 获取TOPONUM超时或错误");
+        // 应答行在栈上，不能交给延迟日志，只记录其长度
+        LOG_WARN("HPLC -> TOPONUM应答无效 (长度 %d)", strlen(line));
         return false;
     }
+    LOG_DEBUG("HPLC -> STA节点数量: %ld", node_count);
 
     // 如果节点数量为0
     if (node_count == 0)
@@ -403,77 +962,83 @@ bool HPLC_get_topo_sta_mac_list(uint8_t sta_mac_list[][6], uint8_t *sta_count)
         return true;
     }
 
-    // 2. 发送 AT+TOPOINFO=1,node_count 指令获取指定数量的节点信息
-    HPLC.print("AT+TOPOINFO=1,"); // 从第1个节点开始查询
-    HPLC.print(node_count);       // 要查询的节点数量
-    HPLC.print("\r\n");
+    // 节点数量超过数组容量时只查询前 max_count 个，避免越界写入
+    if (node_count > max_count)
+    {
+        LOG_WARN("HPLC -> STA节点数量超过上限 %d，多余节点将被忽略", max_count);
+        node_count = max_count;
+    }
 
-    // 3. 解析响应，提取STA设备的MAC地址
-    int parsed_mac_count = 0; // 已成功解析的MAC地址数量
-    for (int i = 0; i < node_count; ++i)
+    // 2. 发送 AT+TOPOINFO=1,node_count 指令获取指定数量的节点信息 (从第1个节点开始查询)
+    // 应答行已在转发，直接放入发送队列
+    HPLCCommand command;
+    command.length = snprintf((char *)command.bytes, sizeof(command.bytes), "AT+TOPOINFO=1,%ld\r\n", node_count);
+    if (!enqueue_command(command))
     {
-        bool lineOk = false; // 标记当前行是否成功接收
+        return false;
+    }
 
-        // 每行响应等待500ms超时
-        response = "";
-        startTime = millis();
-        while (millis() - startTime < 500)
+    // 3. 解析响应，提取STA设备的MAC地址
+    long row_count = 0; // 已收到的拓扑信息行数
+    while (row_count < node_count)
+    {
+        // 每行响应等待500ms超时，任何一行失败则整体失败
+        if (read_ok_line(line, sizeof(line), 500) < 0)
         {
-            if (HPLC.available())
-            {
-                // 读取一个字符，追加到响应字符串
-                c = HPLC.read();
-                response += c;
-                // 检查是否收到以 "\r+ok=" 开始并以 "\r\n" 结束的完整行
-                if (response.startsWith("\r+ok=") && response.endsWith("\r\n"))
-                {
-                    lineOk = true;
-                    break;
-                }
-            }
-            // 任务延时，防止看门狗超时导致重启
-            vTaskDelay(pdMS_TO_TICKS(10));
+            LOG_WARN("HPLC -> 获取TOPOINFO行超时或错误");
+            return false;
         }
-
-        // 如果成功接收到当前节点的响应行
-        if (lineOk)
+        // 拓扑信息行由逗号分隔，没有逗号的是同时执行的其它命令的应答，跳过
+        const char *comma = strchr(line, ',');
+        if (comma == NULL)
         {
-            // 提取MAC地址: MAC地址位于 "\r+ok=" 之后，到第一个逗号 ',' 之前
-            // MAC地址字符串的起始位置
-            int mac_start_index = strlen("\r+ok=");
-            // MAC地址字符串的结束位置(第一个逗号)
-            int mac_end_index = response.indexOf(',', mac_start_index);
-            // 如果找到了逗号
-            if (mac_end_index != -1)
-            {
-                // 提取MAC地址字符串
-                String mac_str = response.substring(mac_start_index, mac_end_index);
-                // 将12字符的MAC地址字符串转换为6字节的uint8_t数组
-                string_to_mac(mac_str, sta_mac_list[*sta_count]);
-                // STA设备数量加1
-                (*sta_count)++;
-                // 已解析的MAC地址数量加1
-                parsed_mac_count++;
-            }
-            else
-            {
-                Serial.println("HPLC -> 在TOPOINFO行中找不到MAC地址");
-            }
+            continue;
+        }
+        row_count++;
+        // MAC地址位于行首，到第一个逗号 ',' 之前，且为12个十六进制字符
+        if (comma - line == MAC_HEX_LEN && hex_to_mac(line, sta_mac_list[*sta_count]))
+        {
+            // STA设备数量加1
+            (*sta_count)++;
         }
         else
         {
-            Serial.println("HPLC -> 获取TOPOINFO行超时或错误");
-            // 任何一行失败，则整体失败
-            return false;
+            LOG_WARN("HPLC -> 在TOPOINFO行中找不到有效的MAC地址");
         }
     }
 
-    if (parsed_mac_count > 0)
+    if (*sta_count > 0)
     {
         // 成功解析到至少一个MAC地址
         return true;
     }
 
-    Serial.println("HPLC -> 未能从TOPOINFO响应中解析出任何MAC地址");
+    LOG_WARN("HPLC -> 未能从TOPOINFO响应中解析出任何MAC地址");
     return false;
+}
+
+/**
+ * @brief 获取网络拓扑中STA设备的MAC地址列表
+ * @param sta_mac_list 存储STA设备MAC地址的数组
+ * @param max_count sta_mac_list 数组的容量，超出的节点会被忽略
+ * @param sta_count 存储STA设备数量的指针
+ * @return true 获取成功
+ * @return false 获取失败
+ */
+bool HPLC_get_topo_sta_mac_list(uint8_t sta_mac_list[][6], uint16_t max_count, uint16_t *sta_count)
+{
+    // 丢弃之前残留的应答行
+    AtLine stale;
+    while (atLineQueue.pop(stale))
+    {
+    }
+
+    // 查询期间串口任务照常执行需要ACK的请求，接收和分发不受影响
+    bool result = query_topology(sta_mac_list, max_count, sta_count);
+
+    // 结束AT查询，唤醒串口任务开始排队的请求
+    __atomic_store_n(&atQueryExclusive, false, __ATOMIC_RELEASE);
+    __atomic_store_n(&atLineWanted, false, __ATOMIC_RELEASE);
+    notify_owner();
+    return result;
 }
\ No newline at end of file
@@ -0,0 +1,223 @@
+#include <Log.h>
+#include <MpscQueue.h>
+#include <Metrics.h>
+
+// 定义[日志条目]
+typedef struct
+{
+    const char *format;           // 格式字符串 (字符串常量)
+    uint32_t timestamp;           // 写入时间 (millis)
+    uint8_t level;                // 日志级别
+    uint8_t argc;                 // 参数个数
+    uintptr_t args[LOG_MAX_ARGS]; // 参数的原始值
+} LogEntry;
+
+// 日志级别标记 (与 LOG_LEVEL_* 顺序一致)
+static const char LEVEL_TAGS[] = {'D', 'I', 'W', 'E'};
+
+// 创建[日志队列]
+static MpscQueue<LogEntry, LOG_QUEUE_SIZE> logQueue;
+
+// 日志任务的任务句柄
+static TaskHandle_t logTaskHandle = NULL;
+
+// 单个转换说明的最大长度 (如 "%-08lX")
+#define LOG_SPEC_SIZE 16
+
+/**
+ * 按转换说明输出一个参数
+ * @details 参数以指针宽度保存，这里按转换字符和长度修饰转换回格式要求的类型再交给 printf，
+ *          不把 uintptr_t 直接传给 %d 等格式 (64位的 native 环境下类型不符)
+ * @param spec 转换说明 ('%' 到转换字符)
+ * @param length 长度修饰 ("", "h", "hh", "l", "ll", "z")
+ * @param conversion 转换字符
+ * @param value 参数的原始值
+ * @return true 输出成功
+ * @return false 不支持的转换 (如浮点数)
+ */
+static bool print_arg(const char *spec, const char *length, char conversion, uintptr_t value)
+{
+    bool isLong = strcmp(length, "l") == 0;
+    bool isLongLong = strcmp(length, "ll") == 0;
+    bool isSize = strcmp(length, "z") == 0;
+    switch (conversion)
+    {
+    case 'd':
+    case 'i':
+        if (isLongLong)
+        {
+            Serial.printf(spec, (long long)(intptr_t)value);
+        }
+        else if (isLong || isSize)
+        {
+            Serial.printf(spec, (long)(intptr_t)value);
+        }
+        else
+        {
+            Serial.printf(spec, (int)(intptr_t)value);
+        }
+        return true;
+    case 'u':
+    case 'x':
+    case 'X':
+    case 'o':
+        if (isLongLong)
+        {
+            Serial.printf(spec, (unsigned long long)value);
+        }
+        else if (isLong || isSize)
+        {
+            Serial.printf(spec, (unsigned long)value);
+        }
+        else
+        {
+            Serial.printf(spec, (unsigned int)value);
+        }
+        return true;
+    case 'c':
+        Serial.printf(spec, (int)value);
+        return true;
+    case 's':
+        Serial.printf(spec, value != 0 ? (const char *)value : "(null)");
+        return true;
+    case 'p':
+        Serial.printf(spec, (void *)value);
+        return true;
+    default:
+        return false;
+    }
+}
+
+/**
+ * 格式化并输出一条日志
+ * @details 逐个转换说明输出，参数个数不足或转换不支持时原样输出转换说明
+ */
+static void print_entry(const LogEntry &entry)
+{
+    Serial.printf("[%lu] %c ", (unsigned long)entry.timestamp, LEVEL_TAGS[entry.level]);
+    uint8_t argIndex = 0;
+    const char *p = entry.format;
+    while (*p != '\0')
+    {
+        // 普通文本原样输出
+        const char *text = p;
+        while (*p != '\0' && *p != '%')
+        {
+            p++;
+        }
+        Serial.write((const uint8_t *)text, p - text);
+        if (*p == '\0')
+        {
+            break;
+        }
+        if (p[1] == '%')
+        {
+            Serial.write('%');
+            p += 2;
+            continue;
+        }
+
+        // 转换说明: '%' + 标志/宽度/精度 + 长度修饰 + 转换字符
+        const char *start = p++;
+        while (*p != '\0' && strchr("-+ #0123456789.", *p) != NULL)
+        {
+            p++;
+        }
+        const char *lengthStart = p;
+        while (*p == 'h' || *p == 'l' || *p == 'z')
+        {
+            p++;
+        }
+        char length[3] = {0};
+        memcpy(length, lengthStart, min<size_t>(p - lengthStart, 2));
+        char conversion = *p;
+        if (conversion != '\0')
+        {
+            p++;
+        }
+        char spec[LOG_SPEC_SIZE];
+        size_t specLen = min<size_t>(p - start, sizeof(spec) - 1);
+        memcpy(spec, start, specLen);
+        spec[specLen] = '\0';
+
+        if (argIndex >= entry.argc || !print_arg(spec, length, conversion, entry.args[argIndex]))
+        {
+            Serial.write((const uint8_t *)start, p - start);
+            continue;
+        }
+        argIndex++;
+    }
+    Serial.println();
+}
+
+/**
+ * 日志任务: 取出队列中的日志并输出，队列为空时休眠
+ */
+static void logTask(void *pvParameters)
+{
+    LogEntry entry;
+    while (1)
+    {
+        METRICS_queue_depth(METRIC_QUEUE_LOG, logQueue.size());
+        while (logQueue.pop(entry))
+        {
+            print_entry(entry);
+        }
+        vTaskDelay(pdMS_TO_TICKS(LOG_IDLE_DELAY_MS));
+    }
+}
+
+/**
+ * @brief 启动日志任务
+ * @details 启动前写入的日志会保留在队列中，启动后依次输出
+ */
+void LOG_init()
+{
+    if (logTaskHandle != NULL)
+    {
+        return;
+    }
+    // 最低优先级且不固定核心，哪个核心空闲就在哪个核心上输出
+    BaseType_t taskCreated = xTaskCreatePinnedToCore(
+        logTask,             /* 任务函数 */
+        "LogTask",           /* 任务名称字符串 */
+        LOG_TASK_STACK_SIZE, /* 堆栈大小（字节） */
+        NULL,                /* 传递给任务的参数 */
+        tskIDLE_PRIORITY,    /* 任务优先级（0为最低） */
+        &logTaskHandle,      /* 任务句柄 */
+        tskNO_AFFINITY       /* 不固定核心 */
+    );
+    if (taskCreated != pdPASS)
+    {
+        Serial.println("初始化 -> 日志任务 -> 创建并启动失败");
+    }
+}
+
+/**
+ * @brief 写入一条日志 (不格式化，不阻塞)
+ * @details 请使用 LOG_DEBUG / LOG_INFO / LOG_WARN / LOG_ERROR 宏，不要直接调用
+ * @param level 日志级别
+ * @param format 格式字符串 (字符串常量)
+ * @param args 参数的原始值
+ * @param argc 参数个数
+ * @return true 写入成功
+ * @return false 队列已满，日志被丢弃
+ */
+bool LOG_push(uint8_t level, const char *format, const uintptr_t args[], uint8_t argc)
+{
+    LogEntry entry;
+    entry.format = format;
+    entry.timestamp = millis();
+    entry.level = level;
+    entry.argc = argc;
+    for (uint8_t i = 0; i < LOG_MAX_ARGS; i++)
+    {
+        entry.args[i] = i < argc ? args[i] : 0;
+    }
+    if (!logQueue.push(entry))
+    {
+        METRICS_count(METRIC_LOG_DROPPED);
+        return false;
+    }
+    return true;
+}
\ No newline at end of file
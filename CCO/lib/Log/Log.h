@@ -0,0 +1,127 @@
+#ifndef LOG_H
+#define LOG_H
+
+#include <Arduino.h>
+#include <Global.h>
+#include <type_traits> // 编译期检查日志参数类型
+
+/*
+ * 延迟日志 (CCO 与 STA 共用)
+ *
+ * 调用处只把格式字符串指针和参数的原始值 (指针宽度) 写入无锁队列，不格式化、不等待串口，
+ * 由最低优先级的日志任务取出后格式化并写到串口监视器。
+ * 格式化在设备上的日志任务中完成，串口输出的是可直接阅读的文本，不需要主机端解码工具；
+ * 热路径的开销只有写入队列，与输出二进制记录相同。
+ *
+ * 限制:
+ * - 格式字符串必须是字符串常量 (只保存指针)
+ * - 参数只支持整数和字符串常量 (%s 只保存指针，不能传入 String::c_str() 等临时字符串)
+ * - 整数参数按指针宽度保存 (ESP32 上为32位)，输出时按转换说明 (d/i/u/x/X/o/c 及长度修饰 h/l/ll/z) 转换回对应类型
+ * - 不支持浮点数，不支持的转换说明原样输出
+ */
+
+// 日志级别
+#define LOG_LEVEL_DEBUG 0
+#define LOG_LEVEL_INFO 1
+#define LOG_LEVEL_WARN 2
+#define LOG_LEVEL_ERROR 3
+#define LOG_LEVEL_NONE 4
+
+// 编译期日志级别，低于该级别的日志连同参数求值一起被移除 (可在 build_flags 中用 -DLOG_LEVEL=... 覆盖)
+#ifndef LOG_LEVEL
+#define LOG_LEVEL LOG_LEVEL_INFO
+#endif
+
+// 日志队列容量 (条，必须是2的幂)
+#define LOG_QUEUE_SIZE 64
+// 单条日志最多的参数个数
+#define LOG_MAX_ARGS 6
+// 日志任务堆栈大小 (字节)
+#define LOG_TASK_STACK_SIZE 3072
+// 日志任务在队列为空时的休眠时间 (ms)
+#define LOG_IDLE_DELAY_MS 10
+
+// MAC地址的日志格式和参数 (6字节地址拆成两个32位参数)
+#define LOG_MAC_FORMAT "%04X%08X"
+#define LOG_MAC_ARGS(mac) ((uint32_t)(mac)[0] << 8 | (mac)[1]), ((uint32_t)(mac)[2] << 24 | (uint32_t)(mac)[3] << 16 | (uint32_t)(mac)[4] << 8 | (mac)[5])
+
+/**
+ * @brief 启动日志任务
+ * @details 启动前写入的日志会保留在队列中，启动后依次输出
+ */
+void LOG_init();
+
+/**
+ * @brief 写入一条日志 (不格式化，不阻塞)
+ * @details 请使用 LOG_DEBUG / LOG_INFO / LOG_WARN / LOG_ERROR 宏，不要直接调用
+ * @param level 日志级别
+ * @param format 格式字符串 (字符串常量)
+ * @param args 参数的原始值
+ * @param argc 参数个数
+ * @return true 写入成功
+ * @return false 队列已满，日志被丢弃
+ */
+bool LOG_push(uint8_t level, const char *format, const uintptr_t args[], uint8_t argc);
+
+/**
+ * 将日志参数转换为原始值 (整数)
+ */
+template <typename T>
+inline uintptr_t log_arg(T value)
+{
+    static_assert(std::is_integral<T>::value || std::is_enum<T>::value, "日志参数只支持整数和字符串常量");
+    return (uintptr_t)value;
+}
+
+/**
+ * 将日志参数转换为原始值 (字符串常量，在 native 环境下指针为64位)
+ */
+inline uintptr_t log_arg(const char *value)
+{
+    return (uintptr_t)value;
+}
+
+/**
+ * 写入一条没有参数的日志
+ */
+inline void log_write(uint8_t level, const char *format)
+{
+    LOG_push(level, format, NULL, 0);
+}
+
+/**
+ * 写入一条带参数的日志
+ */
+template <typename... Args>
+inline void log_write(uint8_t level, const char *format, Args... args)
+{
+    static_assert(sizeof...(Args) <= LOG_MAX_ARGS, "日志参数过多");
+    const uintptr_t values[] = {log_arg(args)...};
+    LOG_push(level, format, values, sizeof...(Args));
+}
+
+#if LOG_LEVEL <= LOG_LEVEL_DEBUG
+#define LOG_DEBUG(...) log_write(LOG_LEVEL_DEBUG, __VA_ARGS__)
+#else
+#define LOG_DEBUG(...) ((void)0)
+#endif
+
+#if LOG_LEVEL <= LOG_LEVEL_INFO
+#define LOG_INFO(...) log_write(LOG_LEVEL_INFO, __VA_ARGS__)
+#else
+#define LOG_INFO(...) ((void)0)
+#endif
+
+#if LOG_LEVEL <= LOG_LEVEL_WARN
+#define LOG_WARN(...) log_write(LOG_LEVEL_WARN, __VA_ARGS__)
+#else
+#define LOG_WARN(...) ((void)0)
+#endif
+
+#if LOG_LEVEL <= LOG_LEVEL_ERROR
+#define LOG_ERROR(...) log_write(LOG_LEVEL_ERROR, __VA_ARGS__)
+#else
+#define LOG_ERROR(...) ((void)0)
+#endif
+
+#endif
\ No newline at end of file
@@ -6,6 +6,16 @@ static std::vector<PowerStrip> powerStrips;
 static const char *nvsNamespace = "powerstrips";
 // 存储排插MAC地址列表的[键名]
 static const char *indexKey = "index";
+// 保护[排插列表]的互斥锁 (STA监控任务和 loop() 都会读写排插列表)
+static SemaphoreHandle_t stripsMutex = NULL;
+
+// 在作用域内持有[排插列表]互斥锁
+class StripsLock
+{
+public:
+    StripsLock() { xSemaphoreTake(stripsMutex, portMAX_DELAY); }
+    ~StripsLock() { xSemaphoreGive(stripsMutex); }
+};
 
 /**
  * @brief 从持久化存储（NVS）加载所有排插数据到内存中的 powerStrips 向量
@@ -87,18 +97,21 @@ static bool save_to_persistence(const PowerStrip &strip)
     // 确保持久化存储已初始化
     persistence_init(nvsNamespace);
     // 获取[MAC 地址字符串]
-    String macStr = mac_to_string(strip.macAddress);
+    char macStr[MAC_HEX_LEN + 1];
+    mac_to_hex(strip.macAddress, macStr);
     // 构造用于存储数据的键名
-    String dataKey = macStr;
-    String nameKey = macStr + "_n";
-    String socketsKey = macStr + "_s";
+    const char *dataKey = macStr;
+    char nameKey[MAC_HEX_LEN + 3];
+    char socketsKey[MAC_HEX_LEN + 3];
+    snprintf(nameKey, sizeof(nameKey), "%s_n", macStr);
+    snprintf(socketsKey, sizeof(socketsKey), "%s_s", macStr);
 
     // 标记保存操作是否成功
     bool success = true;
     // 将排插的各个字段分别存入持久化存储
-    success &= persistence_put_bytes(dataKey.c_str(), strip.macAddress, 6);                     // 存储 MAC 地址字节
-    success &= persistence_put_string(nameKey.c_str(), strip.name);                             // 存储名称
-    success &= persistence_put_bytes(socketsKey.c_str(), strip.sockets, sizeof(strip.sockets)); // 存储[插孔信息]
+    success &= persistence_put_bytes(dataKey, strip.macAddress, 6);                     // 存储 MAC 地址字节
+    success &= persistence_put_string(nameKey, strip.name);                             // 存储名称
+    success &= persistence_put_bytes(socketsKey, strip.sockets, sizeof(strip.sockets)); // 存储[插孔信息]
 
     // persistence_end();
     return success;
@@ -114,18 +127,21 @@ static bool remove_from_persistence(const uint8_t macAddress[6])
     // 确保持久化存储已初始化
     persistence_init(nvsNamespace);
     // 获取[MAC 地址字符串]
-    String macStr = mac_to_string(macAddress);
+    char macStr[MAC_HEX_LEN + 1];
+    mac_to_hex(macAddress, macStr);
     // 构造要删除的键名
-    String dataKey = macStr;
-    String nameKey = macStr + "_n";
-    String socketsKey = macStr + "_s";
+    const char *dataKey = macStr;
+    char nameKey[MAC_HEX_LEN + 3];
+    char socketsKey[MAC_HEX_LEN + 3];
+    snprintf(nameKey, sizeof(nameKey), "%s_n", macStr);
+    snprintf(socketsKey, sizeof(socketsKey), "%s_s", macStr);
 
     // 标记删除操作是否成功
     bool success = true;
     // 从持久化存储中移除与该排插相关的键值对
-    success &= persistence_remove(dataKey.c_str());
-    success &= persistence_remove(nameKey.c_str());
-    success &= persistence_remove(socketsKey.c_str());
+    success &= persistence_remove(dataKey);
+    success &= persistence_remove(nameKey);
+    success &= persistence_remove(socketsKey);
 
     // persistence_end();
     return success;
@@ -141,11 +157,15 @@ static void update_persistence_index()
     persistence_init(nvsNamespace);
     // 初始化空的索引字符串
     String indexStr = "";
+    indexStr.reserve(powerStrips.size() * (MAC_HEX_LEN + 1));
+    // [MAC 地址字符串]缓冲区
+    char macStr[MAC_HEX_LEN + 1];
     // 遍历内存中的所有排插
     for (size_t i = 0; i < powerStrips.size(); ++i)
     {
         // 将每个排插的[MAC 地址字符串]添加到索引中
-        indexStr += mac_to_string(powerStrips[i].macAddress);
+        mac_to_hex(powerStrips[i].macAddress, macStr);
+        indexStr += macStr;
         // 如果不是最后一个排插，则添加逗号分隔符
         if (i < powerStrips.size() - 1)
         {
@@ -164,6 +184,9 @@ static void update_persistence_index()
  */
 void PowerStrip_init()
 {
+    // 创建[排插列表]互斥锁
+    stripsMutex = xSemaphoreCreateMutex();
+    StripsLock lock;
     // 调用内部函数从持久化存储加载数据
     load_from_persistence();
 }
@@ -175,6 +198,7 @@ void PowerStrip_init()
  */
 bool PowerStrip_add(const PowerStrip &strip)
 {
+    StripsLock lock;
     // 检查内存中是否已存在具有相同 MAC 地址的排插
     for (const auto &existingStrip : powerStrips)
     {
@@ -211,6 +235,7 @@ bool PowerStrip_add(const PowerStrip &strip)
  */
 bool PowerStrip_update(const PowerStrip &strip)
 {
+    StripsLock lock;
     // 遍历内存中的排插列表，查找匹配的 MAC 地址
     for (size_t i = 0; i < powerStrips.size(); ++i)
     {
@@ -238,6 +263,27 @@ bool PowerStrip_update(const PowerStrip &strip)
     return false;
 }
 
+/**
+ * @brief 根据MAC地址更新排插的在线状态
+ * @details 只修改内存中的在线状态 (在线状态不持久化)，不影响其它字段
+ * @param macAddress 排插的MAC地址
+ * @param isOnline 是否在线
+ * @return bool 更新成功返回 true，如果未找到对应MAC地址的排插则返回 false
+ */
+bool PowerStrip_set_online(const uint8_t macAddress[6], bool isOnline)
+{
+    StripsLock lock;
+    for (auto &existingStrip : powerStrips)
+    {
+        if (memcmp(existingStrip.macAddress, macAddress, 6) == 0)
+        {
+            existingStrip.isOnline = isOnline;
+            return true;
+        }
+    }
+    return false;
+}
+
 /**
  * @brief 根据MAC地址删除一个排插
  * @param macAddress 要删除的排插的MAC地址
@@ -245,6 +291,7 @@ bool PowerStrip_update(const PowerStrip &strip)
  */
 bool PowerStrip_delete(const uint8_t macAddress[6])
 {
+    StripsLock lock;
     // 使用迭代器遍历内存中的排插列表
     for (auto it = powerStrips.begin(); it != powerStrips.end(); ++it)
     {
@@ -281,6 +328,7 @@ bool PowerStrip_delete(const uint8_t macAddress[6])
  */
 bool PowerStrip_get(const uint8_t macAddress[6], PowerStrip &strip)
 {
+    StripsLock lock;
     // 遍历内存中的排插列表
     for (const auto &existingStrip : powerStrips)
     {
@@ -302,17 +350,69 @@ bool PowerStrip_get(const uint8_t macAddress[6], PowerStrip &strip)
  */
 std::vector<PowerStrip> PowerStrip_get_all()
 {
+    StripsLock lock;
     // 直接返回内存中 powerStrips 向量的副本
     // 返回副本可以防止外部代码直接修改内部状态，但会产生拷贝开销
     return powerStrips;
 }
 
+/**
+ * @brief 获取在线排插的数量
+ * @return size_t 在线排插数量
+ */
+size_t PowerStrip_count_online()
+{
+    StripsLock lock;
+    size_t count = 0;
+    for (const auto &strip : powerStrips)
+    {
+        if (strip.isOnline)
+        {
+            count++;
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief 按顺序获取在线排插中的一段 (用于分页显示)
+ * @details 只拷贝请求范围内的排插，不复制整个列表
+ * @param start 起始位置 (在线排插中的序号，从0开始)
+ * @param out 用于接收排插信息的数组
+ * @param max_count out 数组的最大容量
+ * @return size_t 实际获取的排插数量
+ */
+size_t PowerStrip_get_online_range(size_t start, PowerStrip out[], size_t max_count)
+{
+    StripsLock lock;
+    size_t position = 0; // 当前在线排插的序号
+    size_t count = 0;    // 已拷贝的数量
+    for (const auto &strip : powerStrips)
+    {
+        if (count >= max_count)
+        {
+            break;
+        }
+        if (!strip.isOnline)
+        {
+            continue;
+        }
+        if (position >= start)
+        {
+            out[count++] = strip;
+        }
+        position++;
+    }
+    return count;
+}
+
 /**
  * @brief 删除所有排插信息
  * @details 清除持久化存储中的所有排插数据，并清空内存中缓存的排插列表
  */
 void PowerStrip_delete_all()
 {
+    StripsLock lock;
     // 确保持久化存储已初始化到正确的命名空间
     persistence_init(nvsNamespace);
     // 清除该命名空间下的所有数据 (包括所有排插数据和索引)
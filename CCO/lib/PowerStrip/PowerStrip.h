@@ -42,6 +42,15 @@ bool PowerStrip_add(const PowerStrip &strip);
  */
 bool PowerStrip_update(const PowerStrip &strip);
 
+/**
+ * @brief 根据MAC地址更新排插的在线状态
+ * @details 只修改内存中的在线状态 (在线状态不持久化)，不影响其它字段
+ * @param macAddress 排插的MAC地址
+ * @param isOnline 是否在线
+ * @return bool 更新成功返回 true，如果未找到对应MAC地址的排插则返回 false
+ */
+bool PowerStrip_set_online(const uint8_t macAddress[6], bool isOnline);
+
 /**
  * @brief 根据MAC地址删除一个排插
  * @param macAddress 要删除的排插的MAC地址
@@ -63,6 +72,22 @@ bool PowerStrip_get(const uint8_t macAddress[6], PowerStrip &strip);
  */
 std::vector<PowerStrip> PowerStrip_get_all();
 
+/**
+ * @brief 获取在线排插的数量
+ * @return size_t 在线排插数量
+ */
+size_t PowerStrip_count_online();
+
+/**
+ * @brief 按顺序获取在线排插中的一段 (用于分页显示)
+ * @details 只拷贝请求范围内的排插，不复制整个列表
+ * @param start 起始位置 (在线排插中的序号，从0开始)
+ * @param out 用于接收排插信息的数组
+ * @param max_count out 数组的最大容量
+ * @return size_t 实际获取的排插数量
+ */
+size_t PowerStrip_get_online_range(size_t start, PowerStrip out[], size_t max_count);
+
 /**
  * @brief 删除所有排插信息
  * @details 清除持久化存储中的所有排插数据，并清空内存中缓存的排插列表
@@ -0,0 +1,278 @@
+#include <Profiler.h>
+
+// 主循环耗时统计
+static ProfilerLoopStats loops[PROFILER_MAX_LOOPS];
+// 已注册的主循环数量
+static uint8_t loopCount = 0;
+
+// 最近一次采样的任务统计 (由 statsMux 保护)
+static ProfilerTaskStats taskStats[PROFILER_MAX_TASKS];
+static uint8_t taskStatsCount = 0;
+static portMUX_TYPE statsMux = portMUX_INITIALIZER_UNLOCKED;
+
+// 剖析任务的任务句柄
+static TaskHandle_t profilerTaskHandle = NULL;
+
+#if configUSE_TRACE_FACILITY
+// 采样缓冲区 (仅剖析任务使用，较大，不放在任务栈上)
+static TaskStatus_t taskStatus[PROFILER_MAX_TASKS];
+
+#if configGENERATE_RUN_TIME_STATS
+// 定义[上一次采样的任务运行时间]
+typedef struct
+{
+    TaskHandle_t handle; // 任务句柄
+    uint32_t runTime;    // 累计运行时间
+} ProfilerRunTime;
+
+// 上一次采样的运行时间，用于计算采样周期内的增量
+static ProfilerRunTime previousRunTime[PROFILER_MAX_TASKS];
+static uint8_t previousCount = 0;
+static uint32_t previousTotalRunTime = 0;
+
+/**
+ * 查找任务上一次采样的累计运行时间
+ */
+static uint32_t find_previous_run_time(TaskHandle_t handle, uint32_t fallback)
+{
+    for (uint8_t i = 0; i < previousCount; i++)
+    {
+        if (previousRunTime[i].handle == handle)
+        {
+            return previousRunTime[i].runTime;
+        }
+    }
+    // 新任务从本次采样开始计算
+    return fallback;
+}
+
+/**
+ * 计算各任务在上一个采样周期内的CPU占用，并保存本次的累计运行时间
+ */
+static void update_cpu_usage(ProfilerTaskStats stats[], UBaseType_t count, uint32_t totalRunTime)
+{
+    uint32_t totalDelta = totalRunTime - previousTotalRunTime;
+    for (UBaseType_t i = 0; i < count; i++)
+    {
+        const TaskStatus_t &status = taskStatus[i];
+        // 各任务的运行时间按所在核心累计，占用率相对单个核心
+        uint32_t taskDelta = status.ulRunTimeCounter - find_previous_run_time(status.xHandle, status.ulRunTimeCounter);
+        stats[i].cpuPermille = totalDelta == 0 ? 0 : (uint16_t)min<uint64_t>((uint64_t)taskDelta * 1000 / totalDelta, 1000);
+    }
+
+    for (UBaseType_t i = 0; i < count; i++)
+    {
+        previousRunTime[i].handle = taskStatus[i].xHandle;
+        previousRunTime[i].runTime = taskStatus[i].ulRunTimeCounter;
+    }
+    previousCount = count;
+    previousTotalRunTime = totalRunTime;
+}
+#endif
+
+/**
+ * 采样一次所有任务的运行时间和堆栈余量
+ */
+static void sample_tasks()
+{
+    uint32_t totalRunTime = 0;
+    UBaseType_t count = uxTaskGetSystemState(taskStatus, PROFILER_MAX_TASKS, &totalRunTime);
+    if (count == 0)
+    {
+        return;
+    }
+
+    ProfilerTaskStats stats[PROFILER_MAX_TASKS];
+    for (UBaseType_t i = 0; i < count; i++)
+    {
+        const TaskStatus_t &status = taskStatus[i];
+        ProfilerTaskStats &s = stats[i];
+        strncpy(s.name, status.pcTaskName, sizeof(s.name) - 1);
+        s.name[sizeof(s.name) - 1] = '\0';
+        s.cpuPermille = PROFILER_CPU_UNAVAILABLE;
+        // ESP-IDF 中堆栈以字节为单位
+        s.stackFreeBytes = status.usStackHighWaterMark;
+#ifdef configTASKLIST_INCLUDE_COREID
+        s.core = status.xCoreID == tskNO_AFFINITY ? -1 : (int8_t)status.xCoreID;
+#else
+        s.core = -1;
+#endif
+        s.priority = status.uxCurrentPriority;
+    }
+
+#if configGENERATE_RUN_TIME_STATS
+    update_cpu_usage(stats, count, totalRunTime);
+#endif
+
+    // 发布采样结果
+    portENTER_CRITICAL(&statsMux);
+    memcpy(taskStats, stats, count * sizeof(ProfilerTaskStats));
+    taskStatsCount = count;
+    portEXIT_CRITICAL(&statsMux);
+}
+#endif
+
+/**
+ * 剖析任务: 定时采样所有任务
+ */
+static void profilerTask(void *pvParameters)
+{
+    while (1)
+    {
+#if configUSE_TRACE_FACILITY
+        sample_tasks();
+#endif
+        vTaskDelay(pdMS_TO_TICKS(PROFILER_SAMPLE_INTERVAL_MS));
+    }
+}
+
+/**
+ * @brief 启动剖析任务
+ */
+void PROFILER_init()
+{
+    if (profilerTaskHandle != NULL)
+    {
+        return;
+    }
+    BaseType_t taskCreated = xTaskCreatePinnedToCore(
+        profilerTask,             /* 任务函数 */
+        "Profiler",               /* 任务名称字符串 */
+        PROFILER_TASK_STACK_SIZE, /* 堆栈大小（字节） */
+        NULL,                     /* 传递给任务的参数 */
+        tskIDLE_PRIORITY,         /* 任务优先级（0为最低） */
+        &profilerTaskHandle,      /* 任务句柄 */
+        tskNO_AFFINITY            /* 不固定核心 */
+    );
+    if (taskCreated != pdPASS)
+    {
+        Serial.println("初始化 -> 剖析任务 -> 创建并启动失败");
+    }
+}
+
+/**
+ * @brief 注册一个需要记录耗时的主循环
+ * @param name 名称 (字符串常量)
+ * @return int8_t 主循环ID，注册已满时返回-1 (此后的记录会被忽略)
+ */
+int8_t PROFILER_register_loop(const char *name)
+{
+    // 各任务可能同时注册，先原子地占用一个位置
+    uint8_t index = __atomic_fetch_add(&loopCount, 1, __ATOMIC_RELAXED);
+    if (index >= PROFILER_MAX_LOOPS)
+    {
+        __atomic_store_n(&loopCount, PROFILER_MAX_LOOPS, __ATOMIC_RELAXED);
+        return -1;
+    }
+    __atomic_store_n(&loops[index].name, name, __ATOMIC_RELEASE);
+    return index;
+}
+
+/**
+ * @brief 记录一次主循环迭代的耗时
+ * @details 每个主循环只能由一个任务记录
+ * @param loop 主循环ID
+ * @param elapsed_us 本次迭代耗时 (us，不含迭代之间的主动延时)
+ */
+void PROFILER_record_loop(int8_t loop, uint32_t elapsed_us)
+{
+    if (loop < 0 || loop >= PROFILER_MAX_LOOPS)
+    {
+        return;
+    }
+    ProfilerLoopStats &s = loops[loop];
+    // 只有一个写者，读者可能看到各字段不完全一致的值，用于观察趋势足够
+    __atomic_store_n(&s.lastUs, elapsed_us, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&s.count, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&s.sumUs, elapsed_us, __ATOMIC_RELAXED);
+    uint32_t maxUs = __atomic_load_n(&s.maxUs, __ATOMIC_RELAXED);
+    while (elapsed_us > maxUs && !__atomic_compare_exchange_n(&s.maxUs, &maxUs, elapsed_us, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+    {
+    }
+}
+
+/**
+ * @brief 获取最近一次采样的任务统计
+ * @param stats 输出参数
+ * @param max_count stats 的容量
+ * @return uint8_t 实际写入的任务数量
+ */
+uint8_t PROFILER_get_tasks(ProfilerTaskStats stats[], uint8_t max_count)
+{
+    portENTER_CRITICAL(&statsMux);
+    uint8_t count = min(taskStatsCount, max_count);
+    memcpy(stats, taskStats, count * sizeof(ProfilerTaskStats));
+    portEXIT_CRITICAL(&statsMux);
+    return count;
+}
+
+/**
+ * @brief 获取主循环耗时统计
+ * @param loop 主循环ID
+ * @param stats 输出参数
+ * @return true 获取成功
+ * @return false 主循环ID无效
+ */
+bool PROFILER_get_loop(int8_t loop, ProfilerLoopStats &stats)
+{
+    if (loop < 0 || loop >= __atomic_load_n(&loopCount, __ATOMIC_RELAXED))
+    {
+        return false;
+    }
+    const ProfilerLoopStats &s = loops[loop];
+    stats.name = __atomic_load_n(&s.name, __ATOMIC_ACQUIRE);
+    stats.count = __atomic_load_n(&s.count, __ATOMIC_RELAXED);
+    stats.sumUs = __atomic_load_n(&s.sumUs, __ATOMIC_RELAXED);
+    stats.maxUs = __atomic_load_n(&s.maxUs, __ATOMIC_RELAXED);
+    stats.lastUs = __atomic_load_n(&s.lastUs, __ATOMIC_RELAXED);
+    return true;
+}
+
+/**
+ * @brief 将任务和主循环统计以文本形式输出
+ * @param out 输出目标 (如 Serial)
+ */
+void PROFILER_print(Print &out)
+{
+    ProfilerTaskStats stats[PROFILER_MAX_TASKS];
+    uint8_t count = PROFILER_get_tasks(stats, PROFILER_MAX_TASKS);
+    out.printf("==== 任务 (每 %u s 采样) ====\n", PROFILER_SAMPLE_INTERVAL_MS / 1000);
+    for (uint8_t i = 0; i < count; i++)
+    {
+        char cpu[8];
+        if (stats[i].cpuPermille == PROFILER_CPU_UNAVAILABLE)
+        {
+            strcpy(cpu, "  n/a");
+        }
+        else
+        {
+            snprintf(cpu, sizeof(cpu), "%3u.%u%%", stats[i].cpuPermille / 10, stats[i].cpuPermille % 10);
+        }
+        out.printf("%-16s CPU %s | 堆栈剩余 %5u B | 核心 %2d | 优先级 %u\n",
+                   stats[i].name, cpu, stats[i].stackFreeBytes, stats[i].core, stats[i].priority);
+    }
+    for (int8_t i = 0; i < PROFILER_MAX_LOOPS; i++)
+    {
+        ProfilerLoopStats loop;
+        if (PROFILER_get_loop(i, loop))
+        {
+            out.printf("循环 %s: n=%u 平均=%uus 最大=%uus 最近=%uus\n",
+                       loop.name ? loop.name : "?", loop.count,
+                       loop.count ? loop.sumUs / loop.count : 0, loop.maxUs, loop.lastUs);
+        }
+    }
+}
+
+/**
+ * @brief 清零主循环耗时统计 (任务采样在下一个周期自然刷新)
+ */
+void PROFILER_reset()
+{
+    for (int i = 0; i < PROFILER_MAX_LOOPS; i++)
+    {
+        __atomic_store_n(&loops[i].count, 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&loops[i].sumUs, 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&loops[i].maxUs, 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&loops[i].lastUs, 0, __ATOMIC_RELAXED);
+    }
+}
\ No newline at end of file
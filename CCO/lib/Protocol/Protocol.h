@@ -0,0 +1,277 @@
+#ifndef PROTOCOL_H
+#define PROTOCOL_H
+
+#include <Arduino.h>
+#include <Global.h>
+#include <type_traits> // 编译期判断空消息
+
+/*
+ * HPLC 载波通讯协议消息定义 (CCO 与 STA 共用)
+ *
+ * 发送时传给 HPLC_send_frame 的内容为: 控制码(1) + 数据域长度(1) + 数据域
+ * 接收时[帧视图]指向: 前导字节(4) + 帧起始符(1) + 控制码(1) + 数据域长度(1) + 数据域 + 校验和(1) + 帧结束符(1)
+ *
+ * 每条消息用一个紧凑结构体描述其数据域，结构体内的 CTRL 为控制码，数据域长度由结构体大小在编译期确定。
+ * 多字节字段均为小端序，与 ESP32 的字节序一致，可直接在帧缓冲区上读写。
+ */
+
+static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__, "协议字段按小端序直接映射，需要小端平台");
+
+// 发送帧中控制码、数据域长度、数据域的偏移
+#define PROTOCOL_TX_CTRL_OFFSET 0
+#define PROTOCOL_TX_LEN_OFFSET 1
+#define PROTOCOL_TX_DATA_OFFSET 2
+
+// 完整帧中除数据域以外的字节数 (前导字节 + 帧起始符 + 控制码 + 数据域长度 + 校验和 + 帧结束符)
+#define PROTOCOL_FRAME_OVERHEAD 9
+// 单帧数据域的最大长度
+#define PROTOCOL_MAX_DATA_LEN (MAX_FRAME_LEN - PROTOCOL_FRAME_OVERHEAD)
+// 每个排插的插孔数量 (插孔ID 1 ~ PROTOCOL_SOCKET_COUNT)
+#define PROTOCOL_SOCKET_COUNT 3
+
+// 定义[数据域为空的消息]类型 (心跳包、ACK应答等)
+template <uint8_t Code>
+struct MsgEmpty
+{
+    static constexpr uint8_t CTRL = Code;
+};
+
+// 定义[24位BL0906寄存器原始值]类型 (低字节在前)
+struct __attribute__((packed)) BLRegister24
+{
+    uint8_t bytes[3];
+
+    /**
+     * @brief 转换为32位整数
+     */
+    uint32_t value() const
+    {
+        return ((uint32_t)bytes[2] << 16) | ((uint32_t)bytes[1] << 8) | bytes[0];
+    }
+};
+
+/* ---------------------------- 心跳 ---------------------------- */
+
+// 心跳包 (CCO -> STA)
+typedef MsgEmpty<0x66> MsgHeartBeat;
+// 心跳包应答 (STA -> CCO)
+typedef MsgEmpty<0x88> MsgHeartBeatAck;
+
+/* ------------------------ CCO -> STA 请求 ------------------------ */
+
+// 设置插孔开关状态
+struct __attribute__((packed)) MsgSetSocketState
+{
+    static constexpr uint8_t CTRL = 0x11;
+    uint8_t socketId; // 插孔ID (1, 2, 3)
+    uint8_t state;    // 开关状态 (0x01: 通电, 0x00: 断电)
+};
+typedef MsgEmpty<0x91> MsgSetSocketStateAck;
+
+// 设置插孔最大功率
+struct __attribute__((packed)) MsgSetMaxPower
+{
+    static constexpr uint8_t CTRL = 0x12;
+    uint8_t socketId;  // 插孔ID (1, 2, 3)
+    uint16_t maxPower; // 最大功率 (W)
+};
+typedef MsgEmpty<0x92> MsgSetMaxPowerAck;
+
+// 设置电能参数推送开关
+struct __attribute__((packed)) MsgSetPush
+{
+    static constexpr uint8_t CTRL = 0x13;
+    uint8_t enabled; // 推送开关 (0x01: 开启, 0x00: 关闭)
+};
+typedef MsgEmpty<0x93> MsgSetPushAck;
+
+// 查询插孔累计电能
+typedef MsgEmpty<0x16> MsgEnergyQuery;
+
+// 查询插孔累计电能应答
+struct __attribute__((packed)) MsgEnergyReply
+{
+    static constexpr uint8_t CTRL = 0x96;
+    uint8_t macAddress[6]; // STA地址
+    uint32_t pulses[3];    // 各插孔累计有功脉冲数
+};
+
+// 查询插孔历史记录
+struct __attribute__((packed)) MsgHistoryQuery
+{
+    static constexpr uint8_t CTRL = 0x17;
+    uint8_t socketId; // 插孔ID (1, 2, 3)
+    uint8_t tier;     // 层级 (HISTORY_TIER_*)
+    uint16_t offset;  // 从最新一条开始向前的偏移
+    uint8_t count;    // 请求条数
+};
+
+// 查询插孔历史记录应答 (固定部分，后接 count 条记录)
+struct __attribute__((packed)) MsgHistoryReply
+{
+    static constexpr uint8_t CTRL = 0x97;
+    uint8_t socketId; // 插孔ID (1, 2, 3)
+    uint8_t tier;     // 层级 (HISTORY_TIER_*)
+    uint16_t offset;  // 偏移
+    uint8_t count;    // 实际条数
+};
+
+// 历史记录应答中的原始采样记录
+struct __attribute__((packed)) HistoryRawRecord
+{
+    uint32_t currentMilliAmps; // 电流 (mA)
+    uint32_t powerMilliWatts;  // 有功功率 (mW)
+};
+
+// 历史记录应答中的汇总记录
+struct __attribute__((packed)) HistoryRollupRecord
+{
+    uint32_t minPowerMilliWatts; // 周期内最小功率 (mW)
+    uint32_t maxPowerMilliWatts; // 周期内最大功率 (mW)
+    uint32_t avgPowerMilliWatts; // 周期内平均功率 (mW)
+};
+
+/* ------------------------ STA -> CCO 上报 ------------------------ */
+
+// 插孔超功率事件
+struct __attribute__((packed)) MsgPowerExceed
+{
+    static constexpr uint8_t CTRL = 0x13;
+    uint8_t macAddress[6]; // STA地址
+    uint8_t socketId;      // 插孔ID (1, 2, 3)
+};
+typedef MsgEmpty<0x93> MsgPowerExceedAck;
+
+// 插孔电流上报 (BL0906 原始寄存器值)
+struct __attribute__((packed)) MsgCurrentReport
+{
+    static constexpr uint8_t CTRL = 0x14;
+    uint8_t macAddress[6]; // STA地址
+    uint8_t socketId;      // 插孔ID (1, 2, 3)
+    BLRegister24 current;  // 电流寄存器
+};
+typedef MsgEmpty<0x94> MsgCurrentReportAck;
+
+// 插孔功率上报 (BL0906 原始寄存器值)
+struct __attribute__((packed)) MsgPowerReport
+{
+    static constexpr uint8_t CTRL = 0x15;
+    uint8_t macAddress[6]; // STA地址
+    uint8_t socketId;      // 插孔ID (1, 2, 3)
+    BLRegister24 power;    // 功率寄存器
+};
+typedef MsgEmpty<0x95> MsgPowerReportAck;
+
+/* ---------------------------- 编解码 ---------------------------- */
+
+/**
+ * @brief 检查插孔ID是否有效 (来自线路的插孔ID在用作数组下标前必须检查)
+ */
+inline bool protocol_socket_valid(uint8_t socket_id)
+{
+    return socket_id >= 1 && socket_id <= PROTOCOL_SOCKET_COUNT;
+}
+
+/**
+ * @brief 获取消息的数据域长度 (编译期常量)
+ */
+template <typename T>
+constexpr uint8_t protocol_data_len()
+{
+    return std::is_empty<T>::value ? 0 : sizeof(T);
+}
+
+/**
+ * @brief 获取发送消息所需的缓冲区大小 (控制码 + 数据域长度 + 数据域 + 附加记录)
+ * @param extra_len 消息结构体之后附加的变长数据长度
+ */
+template <typename T>
+constexpr size_t protocol_frame_size(size_t extra_len = 0)
+{
+    return PROTOCOL_TX_DATA_OFFSET + protocol_data_len<T>() + extra_len;
+}
+
+/**
+ * @brief 每帧最多可附加的记录条数 (用于变长应答)
+ */
+template <typename T, typename Record>
+constexpr uint8_t protocol_max_records()
+{
+    return (PROTOCOL_MAX_DATA_LEN - protocol_data_len<T>()) / sizeof(Record);
+}
+
+/**
+ * @brief 在发送缓冲区中就地构造消息
+ * @details 写入控制码和数据域长度，返回指向缓冲区内数据域的引用，调用方直接填写字段
+ * @param frame 发送缓冲区，至少 protocol_frame_size<T>(extra_len) 字节
+ * @param extra_len 消息结构体之后附加的变长数据长度
+ * @return T& 数据域
+ */
+template <typename T>
+T &protocol_encode(uint8_t *frame, uint8_t extra_len = 0)
+{
+    static_assert(protocol_data_len<T>() <= PROTOCOL_MAX_DATA_LEN, "消息数据域超过单帧最大长度");
+    static_assert(std::alignment_of<T>::value == 1, "消息结构体必须是紧凑结构体");
+    frame[PROTOCOL_TX_CTRL_OFFSET] = T::CTRL;
+    frame[PROTOCOL_TX_LEN_OFFSET] = protocol_data_len<T>() + extra_len;
+    return *reinterpret_cast<T *>(frame + PROTOCOL_TX_DATA_OFFSET);
+}
+
+/**
+ * @brief 获取发送缓冲区中消息之后的附加数据区
+ */
+template <typename T>
+uint8_t *protocol_encode_extra(uint8_t *frame)
+{
+    return frame + PROTOCOL_TX_DATA_OFFSET + protocol_data_len<T>();
+}
+
+/**
+ * @brief 直接在接收帧上查看消息，不拷贝数据
+ * @details 控制码不匹配或数据域长度与消息定义不一致时返回 nullptr
+ * @param frame 接收到的完整帧
+ * @param allow_extra 是否允许消息结构体之后附加变长数据
+ * @return const T* 指向帧缓冲区内数据域的指针，有效期与 frame 相同
+ */
+template <typename T>
+const T *protocol_view(const FrameView &frame, bool allow_extra = false)
+{
+    static_assert(protocol_data_len<T>() <= PROTOCOL_MAX_DATA_LEN, "消息数据域超过单帧最大长度");
+    static_assert(std::alignment_of<T>::value == 1, "消息结构体必须是紧凑结构体");
+    if (frame.ctrlCode != T::CTRL)
+    {
+        return nullptr;
+    }
+    if (allow_extra ? frame.dataLen < protocol_data_len<T>() : frame.dataLen != protocol_data_len<T>())
+    {
+        return nullptr;
+    }
+    return reinterpret_cast<const T *>(frame.data);
+}
+
+/**
+ * @brief 获取接收帧中消息之后的附加数据区及其长度
+ */
+template <typename T>
+const uint8_t *protocol_view_extra(const FrameView &frame, uint8_t *extra_len)
+{
+    *extra_len = frame.dataLen - protocol_data_len<T>();
+    return frame.data + protocol_data_len<T>();
+}
+
+// 编译期检查线上格式
+static_assert(protocol_data_len<MsgHeartBeat>() == 0, "心跳包数据域应为空");
+static_assert(protocol_data_len<MsgSetSocketState>() == 2, "0x11 数据域长度应为 2");
+static_assert(protocol_data_len<MsgSetMaxPower>() == 3, "0x12 数据域长度应为 3");
+static_assert(protocol_data_len<MsgSetPush>() == 1, "0x13 数据域长度应为 1");
+static_assert(protocol_data_len<MsgEnergyReply>() == 18, "0x96 数据域长度应为 18");
+static_assert(protocol_data_len<MsgHistoryQuery>() == 5, "0x17 数据域长度应为 5");
+static_assert(protocol_data_len<MsgHistoryReply>() == 5, "0x97 固定部分长度应为 5");
+static_assert(protocol_data_len<MsgPowerExceed>() == 7, "0x13 上报数据域长度应为 7");
+static_assert(protocol_data_len<MsgCurrentReport>() == 10, "0x14 数据域长度应为 10");
+static_assert(protocol_data_len<MsgPowerReport>() == 10, "0x15 数据域长度应为 10");
+static_assert(offsetof(MsgCurrentReport, current) == 7, "0x14 电流寄存器偏移应为 7");
+static_assert(protocol_max_records<MsgHistoryReply, HistoryRawRecord>() == 6, "0x97 每帧应可携带 6 条原始采样");
+static_assert(protocol_max_records<MsgHistoryReply, HistoryRollupRecord>() == 4, "0x97 每帧应可携带 4 条汇总记录");
+
+#endif
\ No newline at end of file
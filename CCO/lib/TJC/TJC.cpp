@@ -1,4 +1,8 @@
 #include <TJC.h>
+#include <Metrics.h>
+#include <Log.h>
+#include <MpscQueue.h>
+#include <stdarg.h>
 
 // 通用请求/应答帧头
 static uint8_t FRAME_HEAD[5] = {
@@ -11,8 +15,59 @@ static uint8_t FRAME_TAIL[1] = {
     FRAME_END // 帧结束符
 };
 
-// 创建[帧解析器]
-static FrameParser frameParser;
+// 创建[帧解析器] (两个交替使用: 回调正在使用上一帧时，新收到的字节写入另一个，无需拷贝)
+static FrameParser frameParsers[2];
+// 当前正在接收的[帧解析器]
+static FrameParser *frameParser = &frameParsers[0];
+
+// 定义[属性影子表项]: 记录最后一次发送给串口屏的属性值 (均以散列值保存，占用固定内存)
+typedef struct
+{
+    uint32_t pageHash;  // 页面名称散列值
+    uint32_t keyHash;   // "页面.控件.属性" 散列值 (0 表示空表项)
+    uint32_t valueHash; // 属性值散列值
+} ShadowEntry;
+
+// 创建[属性影子表]
+static ShadowEntry shadowTable[TJC_SHADOW_SIZE];
+
+// 创建[控制码处理表] (以控制码为下标)
+static TJCHandlerEntry handlerTable[256];
+
+// 命令块在批量写入中的位置 (串口任务据此统计整批写出的耗时)
+#define TJC_BATCH_FIRST 0x01 // 批量写入的第一块
+#define TJC_BATCH_LAST 0x02  // 批量写入的最后一块
+
+// 定义[命令块]: 一次写出的若干条完整命令，或一块曲线透传数据点
+typedef struct
+{
+    uint16_t length;             // 已用长度
+    const char *waveformControl; // 曲线控件名称 (NULL 表示命令块，否则 bytes 中是该控件的数据点)
+    uint8_t waveformChannel;     // 曲线通道号
+    uint8_t batchFlags;          // TJC_BATCH_FIRST / TJC_BATCH_LAST (不属于批量写入时为0)
+    char bytes[TJC_CHUNK_SIZE];  // 命令内容或数据点
+} TJCChunk;
+
+// 各任务 -> 串口任务: 等待写出的命令块和曲线透传 (同一队列，按入队顺序执行)
+static MpscQueue<TJCChunk, TJC_TX_QUEUE_SIZE> txQueue;
+// 串口任务 -> loop(): 等待分发的完整帧
+static MpscQueue<FrameBytes, TJC_RX_QUEUE_SIZE> rxFrameQueue;
+// 串口任务的任务句柄
+static TaskHandle_t ownerTaskHandle = NULL;
+// 从发送队列取出的命令块 (仅串口任务使用，放在静态区以免占用任务栈)
+static TJCChunk ownerChunk;
+// 从串口一次取出的字节 (仅串口任务使用，放在静态区以免占用任务栈)
+static uint8_t ownerRxChunk[64];
+// 正在写出的批量写入: 取出第一块的时间 (us) 和已写出的字节数 (仅串口任务使用)
+static uint32_t ownerBatchStartUs = 0;
+static size_t ownerBatchBytes = 0;
+
+// 批量命令块 (预分配，格式化过程不申请堆内存)
+static TJCChunk batchChunk;
+// 本次批量写入已交给串口任务的字节数
+static size_t batchQueued = 0;
+// 当前开启批量写入的任务 (NULL 表示未开启)，其它任务的命令直接发送，互不干扰
+static TaskHandle_t batchOwner = NULL;
 
 /**
  * 加入解析器
@@ -20,7 +75,7 @@ static FrameParser frameParser;
 static void add_parser(uint8_t data)
 {
     // 加入[帧内容缓冲区]
-    frameParser.buffer[frameParser.index++] = data;
+    frameParser->buffer[frameParser->index++] = data;
 }
 
 /**
@@ -28,38 +83,417 @@ static void add_parser(uint8_t data)
  */
 static void reset_parser()
 {
-    frameParser.state = WAIT_LEAD_BYTE;           // [状态]回到初始
-    memset(frameParser.buffer, 0, MAX_FRAME_LEN); // [帧内容缓冲区]数组清零
-    frameParser.index = 0;                        // [帧内容缓冲区下标]归零
-    frameParser.dataFieldEndIndex = 0;            // [数据域结束下标]归零
+    frameParser->state = WAIT_LEAD_BYTE; // [状态]回到初始
+    frameParser->index = 0;              // [帧内容缓冲区下标]归零 (缓冲区按下标写入，无需清零)
+    frameParser->dataFieldEndIndex = 0;  // [数据域结束下标]归零
+}
+
+/**
+ * FNV-1a 散列，可在已有散列值基础上继续累加
+ */
+static uint32_t fnv1a(const char *str, uint32_t hash = 2166136261u)
+{
+    while (*str)
+    {
+        hash = (hash ^ (uint8_t)*str++) * 16777619u;
+    }
+    return hash;
+}
+
+/**
+ * 计算 "页面.控件.属性" 的散列值 (保证非0)
+ */
+static uint32_t property_key_hash(const char *page_name, const char *control_name, const char *property_name)
+{
+    uint32_t hash = fnv1a(page_name);
+    hash = fnv1a(".", hash);
+    hash = fnv1a(control_name, hash);
+    hash = fnv1a(".", hash);
+    hash = fnv1a(property_name, hash);
+    return hash == 0 ? 1 : hash;
+}
+
+/**
+ * 在影子表中查找属性对应的表项，不存在时返回可用于写入的表项
+ */
+static ShadowEntry *shadow_lookup(uint32_t keyHash)
+{
+    uint32_t start = keyHash % TJC_SHADOW_SIZE;
+    for (uint32_t probe = 0; probe < TJC_SHADOW_PROBE_LIMIT; probe++)
+    {
+        ShadowEntry *entry = &shadowTable[(start + probe) % TJC_SHADOW_SIZE];
+        if (entry->keyHash == keyHash || entry->keyHash == 0)
+        {
+            return entry;
+        }
+    }
+    // 探测范围内已满，覆盖起始表项
+    return &shadowTable[start];
+}
+
+static void process_frame(uint8_t data, FrameCallbackFunc callback, void *context);
+static void owner_task(void *pvParameters);
+
+/**
+ * 唤醒串口任务 (有新的命令块或透传请求，或串口收到数据)
+ */
+static void notify_owner()
+{
+    if (ownerTaskHandle != NULL)
+    {
+        xTaskNotifyGive(ownerTaskHandle);
+    }
+}
+
+/**
+ * 将命令块放入发送队列，队列已满时短暂等待串口任务取走，超时丢弃
+ */
+static bool enqueue_chunk(const TJCChunk &chunk)
+{
+    uint32_t start = millis();
+    while (!txQueue.push(chunk))
+    {
+        if (millis() - start >= TJC_TX_WAIT_MS)
+        {
+            METRICS_count(METRIC_TJC_TX_DROPPED);
+            LOG_WARN("TJC -> 发送队列已满，丢弃 %u 字节命令", chunk.length);
+            // 丢弃的命令中可能有属性设置，清空影子表，之后全部重新发送
+            TJC_invalidate_all();
+            return false;
+        }
+        vTaskDelay(pdMS_TO_TICKS(1));
+    }
+    notify_owner();
+    return true;
+}
+
+/**
+ * 将批量命令块中已有的命令交给串口任务
+ * last 为 true 时标记为本次批量写入的最后一块 (已有命令都已交出时放入一个空块作为结束标记)
+ */
+static void enqueue_batch_chunk(bool last = false)
+{
+    if (batchChunk.length == 0 && (!last || batchQueued == 0))
+    {
+        return;
+    }
+    batchChunk.waveformControl = NULL;
+    batchChunk.batchFlags = (batchQueued == 0 ? TJC_BATCH_FIRST : 0) | (last ? TJC_BATCH_LAST : 0);
+    if (enqueue_chunk(batchChunk))
+    {
+        batchQueued += batchChunk.length;
+    }
+    batchChunk.length = 0;
+}
+
+/**
+ * 等待串口屏返回指定的4字节应答 (如 FE FF FF FF)
+ * 等待期间收到的其它字节按原顺序交给[帧解析器]，不会丢失
+ */
+static bool wait_for_reply(uint8_t code, FrameCallbackFunc callback, void *context)
+{
+    const uint8_t expected[4] = {code, 0xFF, 0xFF, 0xFF};
+    int matched = 0;
+    uint32_t start = millis();
+
+    while (millis() - start < TJC_WAVEFORM_TIMEOUT)
+    {
+        if (!TJC.available())
+        {
+            // 等待接收回调通知 (仅串口任务调用，其它通知只会让这里多检查一次)
+            ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(1));
+            continue;
+        }
+        uint8_t data = TJC.read();
+        if (data == expected[matched])
+        {
+            if (++matched == 4)
+            {
+                return true;
+            }
+            continue;
+        }
+        // 不是应答，已匹配的部分和当前字节交还给[帧解析器]
+        for (int i = 0; i < matched; i++)
+        {
+            process_frame(expected[i], callback, context);
+        }
+        if (data == expected[0])
+        {
+            matched = 1;
+        }
+        else
+        {
+            matched = 0;
+            process_frame(data, callback, context);
+        }
+    }
+
+    // 超时，已匹配的部分交还给[帧解析器]
+    for (int i = 0; i < matched; i++)
+    {
+        process_frame(expected[i], callback, context);
+    }
+    return false;
+}
+
+/**
+ * 格式化一条串口屏命令 (命令须以 \xff\xff\xff 结尾) 并交给串口任务
+ * 当前任务开启了批量写入时追加到批量命令块，否则在栈上的命令块中格式化后单独放入发送队列
+ * 返回命令是否已交给串口任务 (或已追加到批量命令块)
+ */
+static bool send_command(const char *format, ...)
+{
+    va_list args;
+    int len;
+
+    if (batchOwner != NULL && batchOwner == xTaskGetCurrentTaskHandle())
+    {
+        // 追加到批量命令块
+        va_start(args, format);
+        len = vsnprintf(batchChunk.bytes + batchChunk.length, sizeof(batchChunk.bytes) - batchChunk.length, format, args);
+        va_end(args);
+        if (len < 0)
+        {
+            return false;
+        }
+        if (batchChunk.length + len < sizeof(batchChunk.bytes))
+        {
+            batchChunk.length += len;
+            return true;
+        }
+        // 剩余空间不足，先交出已有命令，再在空的命令块中重新格式化
+        enqueue_batch_chunk();
+        if ((size_t)len < sizeof(batchChunk.bytes))
+        {
+            va_start(args, format);
+            vsnprintf(batchChunk.bytes, sizeof(batchChunk.bytes), format, args);
+            va_end(args);
+            batchChunk.length = len;
+            return true;
+        }
+    }
+    else
+    {
+        // 单独发送
+        TJCChunk chunk;
+        chunk.waveformControl = NULL;
+        chunk.batchFlags = 0;
+        va_start(args, format);
+        len = vsnprintf(chunk.bytes, sizeof(chunk.bytes), format, args);
+        va_end(args);
+        if (len <= 0)
+        {
+            return false;
+        }
+        if ((size_t)len < sizeof(chunk.bytes))
+        {
+            chunk.length = len;
+            return enqueue_chunk(chunk);
+        }
+    }
+
+    // 单条命令超过命令块大小 (罕见，如很长的文本)
+    LOG_WARN("TJC -> 命令长度 %d 超过命令块大小，已丢弃", len);
+    return false;
+}
+
+/**
+ * 探测串口屏是否在当前波特率下应答
+ * 发送 sendme 命令，屏幕应返回 66 <页面ID> FF FF FF
+ */
+static bool probe_screen()
+{
+    // 丢弃之前收到的数据 (切换波特率时可能有乱码)
+    while (TJC.available())
+    {
+        TJC.read();
+    }
+    TJC.write((const uint8_t *)"sendme\xff\xff\xff", 9);
+
+    uint8_t reply[5];
+    int index = 0;
+    uint32_t start = millis();
+    while (millis() - start < TJC_PROBE_TIMEOUT)
+    {
+        if (!TJC.available())
+        {
+            vTaskDelay(pdMS_TO_TICKS(1));
+            continue;
+        }
+        uint8_t data = TJC.read();
+        if (index == 0 && data != 0x66)
+        {
+            continue;
+        }
+        reply[index++] = data;
+        if (index == sizeof(reply))
+        {
+            if (reply[2] == 0xFF && reply[3] == 0xFF && reply[4] == 0xFF)
+            {
+                return true;
+            }
+            index = 0;
+        }
+    }
+    return false;
+}
+
+/**
+ * 切换串口屏和本机串口的波特率
+ * 使用 baud 命令 (不保存到屏幕)，屏幕重新上电后恢复默认波特率
+ */
+static void switch_baud_rate(uint32_t baud)
+{
+    char command[24];
+    int len = snprintf(command, sizeof(command), "baud=%lu\xff\xff\xff", (unsigned long)baud);
+    TJC.write((const uint8_t *)command, len);
+    // 等待命令发送完毕后再切换本机波特率
+    TJC.flush();
+    vTaskDelay(pdMS_TO_TICKS(TJC_BAUD_SWITCH_DELAY));
+    TJC.updateBaudRate(baud);
+    vTaskDelay(pdMS_TO_TICKS(TJC_BAUD_SWITCH_DELAY));
+}
+
+/**
+ * 协商与串口屏通讯的波特率
+ * 屏幕可能仍保持上次协商的高速波特率 (本机复位而屏幕未断电)，因此两种波特率都要探测
+ */
+static void negotiate_baud_rate()
+{
+    bool responded = false;
+    // 屏幕与本机同时上电时可能仍在启动，多探测几次
+    for (int attempt = 0; attempt < TJC_PROBE_RETRIES && !responded; attempt++)
+    {
+        TJC.updateBaudRate(TJC_DEFAULT_BAUD);
+        if (probe_screen())
+        {
+            responded = true;
+            break;
+        }
+        // 默认波特率无应答，尝试高速波特率
+        TJC.updateBaudRate(TJC_FAST_BAUD);
+        if (probe_screen())
+        {
+            Serial.printf("TJC -> 屏幕已处于 %d 波特率\n", TJC_FAST_BAUD);
+            return;
+        }
+    }
+    if (!responded)
+    {
+        // 都无应答 (屏幕未连接)，保持默认波特率
+        TJC.updateBaudRate(TJC_DEFAULT_BAUD);
+        Serial.printf("TJC -> 屏幕无应答，使用默认 %d 波特率\n", TJC_DEFAULT_BAUD);
+        return;
+    }
+
+    switch_baud_rate(TJC_FAST_BAUD);
+    if (probe_screen())
+    {
+        Serial.printf("TJC -> 波特率已切换到 %d\n", TJC_FAST_BAUD);
+        return;
+    }
+
+    // 高速波特率无应答，通知屏幕切回默认波特率
+    switch_baud_rate(TJC_DEFAULT_BAUD);
+    Serial.printf("TJC -> 高速波特率无应答，回退到 %d 波特率\n", TJC_DEFAULT_BAUD);
 }
 
 /**
  * @brief 初始化TJC串口屏模块
+
+ * @details 以默认波特率连接串口屏后尝试切换到高速波特率，屏幕无应答时保持默认波特率，然后启动串口任务
  */
 void TJC_init()
 {
     // 初始化串口
-    TJC.begin(115200, SERIAL_8N1, TJC_RX, TJC_TX);
+    TJC.begin(TJC_DEFAULT_BAUD, SERIAL_8N1, TJC_RX, TJC_TX);
+    // 协商高速波特率
+    negotiate_baud_rate();
     // 初始化[帧解析器]
     reset_parser();
+    // 串口屏状态未知，清空属性影子表
+    TJC_invalidate_all();
     // 发送命令让屏幕跳转到[主页面]
     TJC.printf("page Home\xff\xff\xff");
+
+    // 创建并启动串口任务 (不固定核心)，此后串口只由串口任务读写
+    BaseType_t taskCreated = xTaskCreatePinnedToCore(
+        owner_task,          /* 任务函数 */
+        "TJC",               /* 任务名称字符串 */
+        TJC_TASK_STACK_SIZE, /* 堆栈大小（字节） */
+        NULL,                /* 传递给任务的参数 */
+        TJC_TASK_PRIORITY,   /* 任务优先级（0为最低） */
+        &ownerTaskHandle,    /* 任务句柄 */
+        tskNO_AFFINITY       /* 不固定核心 */
+    );
+    if (taskCreated != pdPASS)
+    {
+        Serial.println("初始化 -> TJC串口任务 -> 创建并启动失败");
+    }
+    // 串口收到数据 (FIFO达到阈值或线路空闲) 时唤醒串口任务
+    TJC.onReceive(notify_owner);
 }
 
 /**
- * @brief 处理接收到的数据帧
- * @param data 接收到的数据
- * @param callback 回调函数
+ * @brief 获取当前与串口屏通讯的波特率
+ * @return uint32_t 波特率
  */
-void TJC_process_frame(uint8_t data, FrameCallbackFunc callback)
+uint32_t TJC_get_baud_rate()
 {
-    switch (frameParser.state)
+    return TJC.baudRate();
+}
+
+/**
+ * @brief 注册串口屏控制码的处理函数
+ * @param ctrl_code 控制码
+ * @param handler 处理函数
+ * @param expected_len 期望的数据域长度，长度不符的帧不会交给处理函数 (TJC_LEN_ANY 表示不校验)
+ */
+void TJC_register_handler(uint8_t ctrl_code, TJCFrameHandler handler, uint8_t expected_len)
+{
+    handlerTable[ctrl_code].handler = handler;
+    handlerTable[ctrl_code].expectedLen = expected_len;
+}
+
+/**
+ * @brief 将完整帧分发给已注册的处理函数
+ * @details 按控制码查表，校验数据域长度后调用处理函数，未注册或长度不符的帧被丢弃
+ * @param frame 完整帧
+ * @param context 未使用 (与[帧回调函数]类型一致，可直接传给 TJC_poll)
+ */
+void TJC_dispatch_frame(const FrameView &frame, void *context)
+{
+    const TJCHandlerEntry &entry = handlerTable[frame.ctrlCode];
+    if (entry.handler == NULL)
+    {
+        return;
+    }
+    if (entry.expectedLen != TJC_LEN_ANY && entry.expectedLen != frame.dataLen)
+    {
+        LOG_WARN("TJC -> 控制码 %02X 数据域长度 %d 不符 (期望 %d)，已丢弃", frame.ctrlCode, frame.dataLen, entry.expectedLen);
+        return;
+    }
+    entry.handler(frame);
+}
+
+/**
+ * 处理接收到的数据帧 (仅串口任务调用)
+ * 收到完整帧时调用 callback，帧视图仅在回调期间有效
+ */
+static void process_frame(uint8_t data, FrameCallbackFunc callback, void *context)
+{
+    switch (frameParser->state)
     {
     case WAIT_LEAD_BYTE: // [前导字节检测]状态: 4个 FE（4字节）
         // Serial.println("WAIT_LEAD_BYTE");
         if (data != FRAME_LEAD_BYTE)
         {
+            // 前导字节收到一半被打断，记为失步
+            if (frameParser->index > 0)
+            {
+                METRICS_count(METRIC_TJC_RESYNC);
+            }
             // 没收到前导字节就重置解析器
             reset_parser();
         }
@@ -67,10 +501,10 @@ void TJC_process_frame(uint8_t data, FrameCallbackFunc callback)
         {
             // 解析器装入新数据
             add_parser(data);
-            if (frameParser.index == 4)
+            if (frameParser->index == 4)
             {
                 // 前导字节读完后进入下一个状态
-                frameParser.state = WAIT_HEADER;
+                frameParser->state = WAIT_HEADER;
             }
         }
         break;
@@ -80,6 +514,7 @@ void TJC_process_frame(uint8_t data, FrameCallbackFunc callback)
         if (data != FRAME_HEADER)
         {
             // 没收到起始符就重置解析器
+            METRICS_count(METRIC_TJC_RESYNC);
             reset_parser();
         }
         else
@@ -87,7 +522,7 @@ void TJC_process_frame(uint8_t data, FrameCallbackFunc callback)
             // 解析器装入新数据
             add_parser(data);
             // 进入下一个状态
-            frameParser.state = READING_CTRL;
+            frameParser->state = READING_CTRL;
         }
         break;
 
@@ -96,24 +531,31 @@ void TJC_process_frame(uint8_t data, FrameCallbackFunc callback)
         // 解析器装入新数据
         add_parser(data);
         // 进入下一个状态
-        frameParser.state = READING_DATA_LEN;
+        frameParser->state = READING_DATA_LEN;
         break;
 
     case READING_DATA_LEN: // [数据域长度读取]状态: 数据域长度（1字节）
         // Serial.println("READING_DATA_LEN");
+        if (data > TJC_MAX_DATA_LEN)
+        {
+            // 数据域长度超过单帧容量 (线路噪声或错误帧)，丢弃该帧，避免写出缓冲区
+            METRICS_count(METRIC_TJC_RESYNC);
+            reset_parser();
+            break;
+        }
         // 解析器装入新数据
         add_parser(data);
         // 设置[数据域结束下标] = 通用请求/应答帧头长度 + 1位控制码 + 数据域长度
-        frameParser.dataFieldEndIndex = ARRAY_LENGTH(FRAME_HEAD) + 1 + data;
+        frameParser->dataFieldEndIndex = ARRAY_LENGTH(FRAME_HEAD) + 1 + data;
         if (data == 0x00)
         {
             // 没有数据，跳过下一个状态，直接进入下下一个状态
-            frameParser.state = WAIT_EOF;
+            frameParser->state = WAIT_EOF;
         }
         else
         {
             // 有数据，进入下一个状态
-            frameParser.state = READING_DATA;
+            frameParser->state = READING_DATA;
         }
         break;
 
@@ -121,10 +563,10 @@ void TJC_process_frame(uint8_t data, FrameCallbackFunc callback)
         // Serial.println("READING_DATA");
         // 解析器装入新数据
         add_parser(data);
-        if (frameParser.index > frameParser.dataFieldEndIndex)
+        if (frameParser->index > frameParser->dataFieldEndIndex)
         {
             // 读完数据域进入下一个状态
-            frameParser.state = WAIT_EOF;
+            frameParser->state = WAIT_EOF;
         }
         break;
 
@@ -134,25 +576,200 @@ void TJC_process_frame(uint8_t data, FrameCallbackFunc callback)
         {
             // 解析器装入新数据
             add_parser(data);
+            // 切换到另一个解析器继续接收，回调中可以继续处理新收到的字节而不覆盖当前帧
+            const FrameParser *complete = frameParser;
+            frameParser = (frameParser == &frameParsers[0]) ? &frameParsers[1] : &frameParsers[0];
+            reset_parser();
             // 收到完整帧并校验通过 -> 执行回调（检查空指针避免崩溃）
             if (callback)
             {
-                callback(frameParser);
+                callback(frame_view(*complete), context);
             }
         }
-        // 重置解析器
-        reset_parser();
+        else
+        {
+            // 没收到结束符，重置解析器
+            METRICS_count(METRIC_TJC_RESYNC);
+            reset_parser();
+        }
         break;
     }
 }
 
+/**
+ * @brief 将收到的字节依次送入帧解析器
+ * @details 由串口任务调用；串口任务未启动时 (如 native 环境的基准测试) 也可直接调用，
+ *          解析器状态不加锁，不能与串口任务同时调用
+ * @param data 收到的字节
+ * @param length 字节数
+ * @param callback 回调函数，每个完整帧调用一次 (帧视图仅在回调期间有效)
+ * @param context 传给回调函数的上下文
+ */
+void TJC_parse(const uint8_t data[], size_t length, FrameCallbackFunc callback, void *context)
+{
+    for (size_t i = 0; i < length; i++)
+    {
+        // print_to_serial_monitor("TJC", data[i]);
+        process_frame(data[i], callback, context);
+    }
+}
+
+/**
+ * 串口任务的帧回调: 拷贝完整帧，排队等待 loop() 分发
+ */
+static void on_frame(const FrameView &frame, void *context)
+{
+    // 直接拷贝到队列槽位，loop() 在槽位上原地分发
+    uint32_t pos;
+    FrameBytes *slot = rxFrameQueue.reserve(pos);
+    if (slot == NULL)
+    {
+        // loop() 处理不过来，丢弃该帧
+        METRICS_count(METRIC_TJC_RX_DROPPED);
+        return;
+    }
+    memcpy(slot->bytes, frame.bytes, frame.length);
+    slot->length = frame.length;
+    rxFrameQueue.commit(pos);
+}
+
+/**
+ * 执行一块曲线透传 (仅串口任务调用)，等待应答期间收到的其它帧照常排队
+ */
+static bool run_waveform(const TJCChunk &chunk)
+{
+    char command[64];
+    int len = snprintf(command, sizeof(command), "addt %s.id,%u,%u\xff\xff\xff", chunk.waveformControl, chunk.waveformChannel, chunk.length);
+    if (len <= 0 || (size_t)len >= sizeof(command))
+    {
+        return false;
+    }
+    TJC.write((const uint8_t *)command, len);
+    if (!wait_for_reply(TJC_REPLY_TRANSPARENT_READY, on_frame, NULL))
+    {
+        LOG_WARN("TJC -> 曲线透传 -> 屏幕未就绪");
+        return false;
+    }
+    TJC.write((const uint8_t *)chunk.bytes, chunk.length);
+    if (!wait_for_reply(TJC_REPLY_TRANSPARENT_DONE, on_frame, NULL))
+    {
+        LOG_WARN("TJC -> 曲线透传 -> 未收到完成应答");
+        return false;
+    }
+    return true;
+}
+
+/**
+ * 写出一个命令块 (仅串口任务调用)
+ * 批量写入从取出第一块开始计时，最后一块写出后等待发送缓冲区清空，记录整批写出的字节数、耗时和波特率
+ */
+static void write_chunk(const TJCChunk &chunk)
+{
+    if (chunk.batchFlags & TJC_BATCH_FIRST)
+    {
+        ownerBatchStartUs = micros();
+        ownerBatchBytes = 0;
+    }
+    TJC.write((const uint8_t *)chunk.bytes, chunk.length);
+    ownerBatchBytes += chunk.length;
+    if (chunk.batchFlags & TJC_BATCH_LAST)
+    {
+        // 等待发送完毕，整页刷新耗时随波特率变化
+        TJC.flush();
+        LOG_INFO("TJC -> 批量写出 %u 字节 @ %lu 波特率，耗时 %lu us", (unsigned)ownerBatchBytes, (unsigned long)TJC_get_baud_rate(),
+                 (unsigned long)(micros() - ownerBatchStartUs));
+    }
+}
+
+/**
+ * 串口任务: 唯一读写串口屏串口的任务，解析帧后排队，写出发送队列中的命令块并执行曲线透传，不执行任何处理函数
+ */
+static void owner_task(void *pvParameters)
+{
+    while (1)
+    {
+        METRICS_queue_depth(METRIC_QUEUE_TJC_RX, TJC.available());
+        size_t received;
+        while ((received = TJC.read(ownerRxChunk, sizeof(ownerRxChunk))) > 0)
+        {
+            TJC_parse(ownerRxChunk, received, on_frame, NULL);
+        }
+
+        // 按入队顺序写出命令块、执行曲线透传，透传前后的命令不会混入数据点
+        METRICS_queue_depth(METRIC_QUEUE_TJC_TX, txQueue.size());
+        while (txQueue.pop(ownerChunk))
+        {
+            if (ownerChunk.waveformControl == NULL)
+            {
+                write_chunk(ownerChunk);
+            }
+            else if (!run_waveform(ownerChunk))
+            {
+                // 调用方不等待透传结果，失败只计入指标
+                METRICS_count(METRIC_TJC_WAVEFORM_FAIL);
+            }
+        }
+
+        // 等待串口数据、新的命令块或透传请求 (由接收回调和入队方通知)
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(TJC_TASK_MAX_SLEEP_MS));
+    }
+}
+
+/**
+ * @brief 分发串口任务已解析的帧
+ * @details 在 loop() 中调用 (同一时间只能由一个任务调用)，不等待串口
+ * @param callback 回调函数，每个帧调用一次 (帧视图仅在回调期间有效)
+ * @param context 传给回调函数的上下文
+ */
+void TJC_poll(FrameCallbackFunc callback, void *context)
+{
+    METRICS_queue_depth(METRIC_QUEUE_TJC_FRAMES, rxFrameQueue.size());
+    // 帧视图直接指向队列槽位，回调结束后才交还槽位
+    const FrameBytes *frame;
+    while ((frame = rxFrameQueue.front()) != NULL)
+    {
+        if (callback)
+        {
+            callback(frame_view(*frame), context);
+        }
+        rxFrameQueue.pop_front();
+    }
+}
+
+/**
+ * @brief 开始批量写入
+ * @details 此后当前任务发出的命令都合并到预分配的命令块中，块满或调用 TJC_batch_flush() 时交给串口任务
+ */
+void TJC_batch_begin()
+{
+    batchOwner = xTaskGetCurrentTaskHandle();
+    batchChunk.length = 0;
+    batchQueued = 0;
+}
+
+/**
+ * @brief 结束批量写入，将剩余命令交给串口任务一次写出
+ * @details 串口任务从取出第一块开始计时，写完最后一块并等待发送缓冲区清空后，记录字节数、耗时和当前波特率
+ * @return size_t 本次批量写入交给串口任务的字节数
+ */
+size_t TJC_batch_flush()
+{
+    if (batchOwner != xTaskGetCurrentTaskHandle())
+    {
+        return 0;
+    }
+    enqueue_batch_chunk(true);
+    batchOwner = NULL;
+    return batchQueued;
+}
+
 /**
  * @brief 跳转到指定页面
  * @param page_name 页面名称
  */
 void TJC_goto_page(const char *page_name)
 {
-    TJC.printf("page %s\xff\xff\xff", page_name);
+    send_command("page %s\xff\xff\xff", page_name);
 }
 
 /**
@@ -160,32 +777,102 @@ void TJC_goto_page(const char *page_name)
  * @param control_name 控件名称
  * @param value 触发内容 ("0" - 弹起事件 或 "1" - 按下事件)
  */
-void TJC_click(const char *control_name, const String value)
+void TJC_click(const char *control_name, const String &value)
 {
-    TJC.printf("click %s,%s\xff\xff\xff", control_name, value);
+    send_command("click %s,%s\xff\xff\xff", control_name, value.c_str());
 }
 
 /**
  * @brief 设置指定页面控件的属性值
+ * @details 与影子表中最后一次发送的值相同时跳过发送
  * @param page_name 页面名称
  * @param control_name 控件名称
  * @param property_name 属性名称 ("val" 或 "txt" 或 "aph")
  * @param value 要设置的值
  */
-void TJC_set_property(const char *page_name, const char *control_name, const char *property_name, const String value)
+void TJC_set_property(const char *page_name, const char *control_name, const char *property_name, const String &value)
 {
+    // 查询影子表，值未变化则跳过
+    uint32_t keyHash = property_key_hash(page_name, control_name, property_name);
+    uint32_t valueHash = fnv1a(value.c_str());
+    // 0 保留为失效标记
+    valueHash = valueHash == 0 ? 1 : valueHash;
+    ShadowEntry *entry = shadow_lookup(keyHash);
+    if (entry->keyHash == keyHash && entry->valueHash == valueHash)
+    {
+        return;
+    }
+
+    bool sent;
     if (strcmp(property_name, "val") == 0 || strcmp(property_name, "aph") == 0 || strcmp(property_name, "y") == 0)
     {
         // 数字类型属性，不加双引号
-        TJC.printf("%s.%s.%s=%s\xff\xff\xff", page_name, control_name, property_name, value);
+        sent = send_command("%s.%s.%s=%s\xff\xff\xff", page_name, control_name, property_name, value.c_str());
         // Serial.printf("%s.%s.%s=%s\xff\xff\xff", page_name, control_name, property_name, value);
     }
     else if (strcmp(property_name, "txt") == 0)
     {
         // 字符串类型属性，加双引号
-        TJC.printf("%s.%s.%s=\"%s\"\xff\xff\xff", page_name, control_name, property_name, value);
+        sent = send_command("%s.%s.%s=\"%s\"\xff\xff\xff", page_name, control_name, property_name, value.c_str());
         // Serial.printf("%s.%s.%s=\"%s\"\xff\xff\xff", page_name, control_name, property_name, value);
     }
+    else
+    {
+        // 不支持的属性，不记录影子
+        return;
+    }
+    if (!sent)
+    {
+        // 命令被丢弃，不记录影子，下次设置时重新发送
+        return;
+    }
+
+    // 记录最后一次发送的值
+    entry->pageHash = fnv1a(page_name);
+    entry->keyHash = keyHash;
+    entry->valueHash = valueHash;
+}
+
+/**
+ * @brief 使指定页面控件属性的影子值失效，下次设置时必定发送
+ * @details 串口屏自身会修改的属性 (如用户拨动的按钮) 在需要回滚或改写前应先调用
+ * @param page_name 页面名称
+ * @param control_name 控件名称
+ * @param property_name 属性名称
+ */
+void TJC_invalidate_property(const char *page_name, const char *control_name, const char *property_name)
+{
+    uint32_t keyHash = property_key_hash(page_name, control_name, property_name);
+    ShadowEntry *entry = shadow_lookup(keyHash);
+    if (entry->keyHash == keyHash)
+    {
+        // 只清空值，保留表项以免打断其它键的探测链
+        entry->valueHash = 0;
+    }
+}
+
+/**
+ * @brief 使指定页面所有属性的影子值失效
+ * @param page_name 页面名称
+ */
+void TJC_invalidate_page(const char *page_name)
+{
+    uint32_t pageHash = fnv1a(page_name);
+    for (int i = 0; i < TJC_SHADOW_SIZE; i++)
+    {
+        if (shadowTable[i].keyHash != 0 && shadowTable[i].pageHash == pageHash)
+        {
+            shadowTable[i].valueHash = 0;
+        }
+    }
+}
+
+/**
+ * @brief 清空属性影子表
+ */
+void TJC_invalidate_all()
+{
+    memset(shadowTable, 0, sizeof(shadowTable));
 }
 
 /**
@@ -195,18 +882,20 @@ void TJC_set_property(const char *page_name, const char *control_name, const cha
  * @param property_name 属性名称 ("val" 或 "txt" 或 "y")
  * @param value 要加的值
  */
-void TJC_plus_property(const char *page_name, const char *control_name, const char *property_name, const String value)
+void TJC_plus_property(const char *page_name, const char *control_name, const char *property_name, const String &value)
 {
+    // 相对修改后影子值不再可知
+    TJC_invalidate_property(page_name, control_name, property_name);
     if (strcmp(property_name, "val") == 0 || strcmp(property_name, "aph") == 0 || strcmp(property_name, "y") == 0)
     {
         // 数字类型属性，不加双引号
-        TJC.printf("%s.%s.%s+=%s\xff\xff\xff", page_name, control_name, property_name, value);
+        send_command("%s.%s.%s+=%s\xff\xff\xff", page_name, control_name, property_name, value.c_str());
         // Serial.printf("%s.%s.%s+=%s\xff\xff\xff", page_name, control_name, property_name, value);
     }
     else if (strcmp(property_name, "txt") == 0)
     {
         // 字符串类型属性，加双引号
-        TJC.printf("%s.%s.%s+=\"%s\"\xff\xff\xff", page_name, control_name, property_name, value);
+        send_command("%s.%s.%s+=\"%s\"\xff\xff\xff", page_name, control_name, property_name, value.c_str());
         // Serial.printf("%s.%s.%s+=\"%s\"\xff\xff\xff", page_name, control_name, property_name, value);
     }
 }
@@ -218,18 +907,73 @@ void TJC_plus_property(const char *page_name, const char *control_name, const ch
  * @param property_name 属性名称 ("val" 或 "txt" 或 "y")
  * @param value 要减的值
  */
-void TJC_minus_property(const char *page_name, const char *control_name, const char *property_name, const String value)
+void TJC_minus_property(const char *page_name, const char *control_name, const char *property_name, const String &value)
 {
+    // 相对修改后影子值不再可知
+    TJC_invalidate_property(page_name, control_name, property_name);
     if (strcmp(property_name, "val") == 0 || strcmp(property_name, "aph") == 0 || strcmp(property_name, "y") == 0)
     {
         // 数字类型属性，不加双引号
-        TJC.printf("%s.%s.%s-=%s\xff\xff\xff", page_name, control_name, property_name, value);
+        send_command("%s.%s.%s-=%s\xff\xff\xff", page_name, control_name, property_name, value.c_str());
         // Serial.printf("%s.%s.%s+=%s\xff\xff\xff", page_name, control_name, property_name, value);
     }
     else if (strcmp(property_name, "txt") == 0)
     {
         // 字符串类型属性，加双引号
-        TJC.printf("%s.%s.%s-=\"%s\"\xff\xff\xff", page_name, control_name, property_name, value);
+        send_command("%s.%s.%s-=\"%s\"\xff\xff\xff", page_name, control_name, property_name, value.c_str());
         // Serial.printf("%s.%s.%s+=\"%s\"\xff\xff\xff", page_name, control_name, property_name, value);
     }
+}
+
+/**
+ * @brief 清除曲线控件指定通道的数据
+ * @param control_name 曲线控件名称
+ * @param channel 通道号 (255 表示全部通道)
+ */
+void TJC_waveform_clear(const char *control_name, uint8_t channel)
+{
+    send_command("cle %s.id,%u\xff\xff\xff", control_name, channel);
+}
+
+/**
+ * @brief 使用透传指令 (addt) 向曲线控件批量写入数据点
+ * @details 数据点按 TJC_WAVEFORM_BLOCK_MAX 分块拷贝到发送队列后立即返回，不等待屏幕应答。
+ *          串口任务按入队顺序对每块发送一条 addt 命令，等待屏幕就绪 (FE FF FF FF) 后一次写出该块数据点，
+ *          再等待透传完成 (FD FF FF FF)；屏幕未应答的块计入 METRIC_TJC_WAVEFORM_FAIL。曲线控件必须位于当前页面
+ * @param control_name 曲线控件名称 (字符串常量，串口任务执行透传时才读取)
+ * @param channel 通道号
+ * @param points 数据点 (0 - 255)
+ * @param count 数据点个数
+ * @return true 全部数据点已交给串口任务
+ * @return false 发送队列已满，未入队的数据点被丢弃
+ */
+bool TJC_waveform_add(const char *control_name, uint8_t channel, const uint8_t *points, uint16_t count)
+{
+    // 透传期间屏幕只接收数据点，先交出当前任务尚未发送的批量命令 (串口任务按入队顺序执行)
+    if (batchOwner != NULL && batchOwner == xTaskGetCurrentTaskHandle())
+    {
+        enqueue_batch_chunk();
+    }
+
+    TJCChunk chunk;
+    chunk.waveformControl = control_name;
+    chunk.waveformChannel = channel;
+    chunk.batchFlags = 0;
+    while (count > 0)
+    {
+        chunk.length = count > TJC_WAVEFORM_BLOCK_MAX ? TJC_WAVEFORM_BLOCK_MAX : count;
+        memcpy(chunk.bytes, points, chunk.length);
+        // 不等待串口任务取走，队列已满时丢弃剩余数据点
+        if (!txQueue.push(chunk))
+        {
+            METRICS_count(METRIC_TJC_WAVEFORM_FAIL);
+            LOG_WARN("TJC -> 曲线透传 -> 发送队列已满，丢弃 %u 个数据点", count);
+            notify_owner();
+            return false;
+        }
+        points += chunk.length;
+        count -= chunk.length;
+    }
+    notify_owner();
+    return true;
 }
\ No newline at end of file
@@ -9,17 +9,129 @@
 #define TJC_TX 17
 #define TJC_RX 18
 
+// 串口屏上电默认波特率
+#define TJC_DEFAULT_BAUD 115200
+// 启动时尝试协商的高速波特率
+#define TJC_FAST_BAUD 921600
+// 探测串口屏应答的超时时间 (ms)
+#define TJC_PROBE_TIMEOUT 100
+// 启动时探测串口屏的次数
+#define TJC_PROBE_RETRIES 5
+// 串口屏切换波特率后的稳定时间 (ms)
+#define TJC_BAUD_SWITCH_DELAY 50
+
+// 属性影子表容量 (表项数) 及线性探测上限
+#define TJC_SHADOW_SIZE 128
+#define TJC_SHADOW_PROBE_LIMIT 8
+
+// 命令块大小 (字节，一个命令块只包含完整的命令，批量写入时多条命令合并为一块)
+#define TJC_CHUNK_SIZE 512
+// 发送队列容量 (命令块或曲线透传块，必须是2的幂)
+#define TJC_TX_QUEUE_SIZE 8
+// 发送队列已满时等待串口任务取走的最长时间 (ms)，超时丢弃命令块
+#define TJC_TX_WAIT_MS 200
+// 接收帧队列容量 (帧，必须是2的幂，队列满时新收到的帧被丢弃)
+#define TJC_RX_QUEUE_SIZE 8
+// 串口任务堆栈大小 (字节)
+#define TJC_TASK_STACK_SIZE 3072
+// 串口任务优先级 (高于 loop()，低于HPLC串口任务)
+#define TJC_TASK_PRIORITY 2
+// 串口任务没有被唤醒时的最长休眠时间 (ms，收到串口数据或新的命令时立即唤醒，这里只是兜底轮询)
+#define TJC_TASK_MAX_SLEEP_MS 10
+
+// 曲线透传单条 addt 命令最多的数据点数
+#define TJC_WAVEFORM_BLOCK_MAX 128
+// 曲线透传等待屏幕应答的超时时间 (ms)
+#define TJC_WAVEFORM_TIMEOUT 100
+// 串口屏应答: 透传就绪
+#define TJC_REPLY_TRANSPARENT_READY 0xFE
+// 串口屏应答: 透传完成
+#define TJC_REPLY_TRANSPARENT_DONE 0xFD
+
+// 串口屏帧数据域的最大长度 (完整帧: 前导字节(4) + 帧起始符(1) + 控制码(1) + 数据域长度(1) + 数据域 + 帧结束符(1))
+#define TJC_MAX_DATA_LEN (MAX_FRAME_LEN - 8)
+
+// 处理函数表中表示"不校验数据域长度"的值 (变长帧由处理函数自行校验)
+#define TJC_LEN_ANY 0xFF
+
+// 定义[帧处理函数]类型
+typedef void (*TJCFrameHandler)(const FrameView &frame);
+
+// 定义[控制码处理表项]类型
+typedef struct
+{
+    TJCFrameHandler handler; // 处理函数 (NULL 表示未注册)
+    uint8_t expectedLen;     // 期望的数据域长度 (TJC_LEN_ANY 表示不校验)
+} TJCHandlerEntry;
+
+/*
+ * 串口只由串口任务读写，其它任务不加锁，只通过无锁队列与它交换消息:
+ * - 命令格式化为命令块后放入发送队列，由串口任务依次写出
+ * - 曲线透传的数据点拷贝到发送队列，由串口任务按入队顺序写出并等待屏幕应答，调用方不等待
+ * - 收到的帧放入接收帧队列，由 loop() 调用 TJC_poll 取出分发
+ * 串口接收回调和入队方用任务通知唤醒串口任务。
+ * 属性影子表和批量缓冲区不加锁，属性设置、影子失效和批量写入只在 loop() 中调用。
+ */
+
 /**
  * @brief 初始化TJC串口屏模块
+ * @details 以默认波特率连接串口屏后尝试切换到高速波特率，屏幕无应答时保持默认波特率，然后启动串口任务
  */
 void TJC_init();
 
 /**
- * @brief 处理接收到的数据帧
- * @param data 接收到的数据
- * @param callback 回调函数
+ * @brief 获取当前与串口屏通讯的波特率
+ * @return uint32_t 波特率
+ */
+uint32_t TJC_get_baud_rate();
+
+/**
+ * @brief 注册串口屏控制码的处理函数
+ * @param ctrl_code 控制码
+ * @param handler 处理函数
+ * @param expected_len 期望的数据域长度，长度不符的帧不会交给处理函数 (TJC_LEN_ANY 表示不校验)
+ */
+void TJC_register_handler(uint8_t ctrl_code, TJCFrameHandler handler, uint8_t expected_len);
+
+/**
+ * @brief 将完整帧分发给已注册的处理函数
+ * @details 按控制码查表，校验数据域长度后调用处理函数，未注册或长度不符的帧被丢弃
+ * @param frame 完整帧
+ * @param context 未使用 (与[帧回调函数]类型一致，可直接传给 TJC_poll)
+ */
+void TJC_dispatch_frame(const FrameView &frame, void *context);
+
+/**
+ * @brief 将收到的字节依次送入帧解析器
+ * @details 由串口任务调用；串口任务未启动时 (如 native 环境的基准测试) 也可直接调用，
+ *          解析器状态不加锁，不能与串口任务同时调用
+ * @param data 收到的字节
+ * @param length 字节数
+ * @param callback 回调函数，每个完整帧调用一次 (帧视图仅在回调期间有效)
+ * @param context 传给回调函数的上下文
+ */
+void TJC_parse(const uint8_t data[], size_t length, FrameCallbackFunc callback, void *context = NULL);
+
+/**
+ * @brief 分发串口任务已解析的帧
+ * @details 在 loop() 中调用 (同一时间只能由一个任务调用)，不等待串口
+ * @param callback 回调函数，每个帧调用一次 (帧视图仅在回调期间有效)
+ * @param context 传给回调函数的上下文
+ */
+void TJC_poll(FrameCallbackFunc callback, void *context = NULL);
+
+/**
+ * @brief 开始批量写入
+ * @details 此后当前任务发出的命令都合并到预分配的命令块中，块满或调用 TJC_batch_flush() 时交给串口任务
+ */
+void TJC_batch_begin();
+
+/**
+ * @brief 结束批量写入，将剩余命令交给串口任务一次写出
+ * @details 串口任务从取出第一块开始计时，写完最后一块并等待发送缓冲区清空后，记录字节数、耗时和当前波特率
+ * @return size_t 本次批量写入交给串口任务的字节数
  */
-void TJC_process_frame(uint8_t data, FrameCallbackFunc callback);
+size_t TJC_batch_flush();
 
 /**
  * @brief 跳转到指定页面
@@ -32,16 +144,37 @@ void TJC_goto_page(const char *page_name);
  * @param control_name 控件名称
  * @param value 触发内容 ("0" - 弹起事件 或 "1" - 按下事件)
  */
-void TJC_click(const char *control_name, const String value);
+void TJC_click(const char *control_name, const String &value);
 
 /**
  * @brief 设置指定页面控件的属性值
+ * @details 与影子表中最后一次发送的值相同时跳过发送
  * @param page_name 页面名称
  * @param control_name 控件名称
  * @param property_name 属性名称 ("val" 或 "txt" 或 "aph")
  * @param value 要设置的值
  */
-void TJC_set_property(const char *page_name, const char *control_name, const char *property_name, const String value);
+void TJC_set_property(const char *page_name, const char *control_name, const char *property_name, const String &value);
+
+/**
+ * @brief 使指定页面控件属性的影子值失效，下次设置时必定发送
+ * @details 串口屏自身会修改的属性 (如用户拨动的按钮) 在需要回滚或改写前应先调用
+ * @param page_name 页面名称
+ * @param control_name 控件名称
+ * @param property_name 属性名称
+ */
+void TJC_invalidate_property(const char *page_name, const char *control_name, const char *property_name);
+
+/**
+ * @brief 使指定页面所有属性的影子值失效
+ * @param page_name 页面名称
+ */
+void TJC_invalidate_page(const char *page_name);
+
+/**
+ * @brief 清空属性影子表
+ */
+void TJC_invalidate_all();
 
 /**
  * @brief 加指定页面控件的属性值
@@ -50,7 +183,7 @@ void TJC_set_property(const char *page_name, const char *control_name, const cha
  * @param property_name 属性名称 ("val" 或 "txt" 或 "y")
  * @param value 要加的值
  */
-void TJC_plus_property(const char *page_name, const char *control_name, const char *property_name, const String value);
+void TJC_plus_property(const char *page_name, const char *control_name, const char *property_name, const String &value);
 
 /**
  * @brief 减指定页面控件的属性值
@@ -59,6 +192,26 @@ void TJC_plus_property(const char *page_name, const char *control_name, const ch
  * @param property_name 属性名称 ("val" 或 "txt" 或 "y")
  * @param value 要减的值
  */
-void TJC_minus_property(const char *page_name, const char *control_name, const char *property_name, const String value);
+void TJC_minus_property(const char *page_name, const char *control_name, const char *property_name, const String &value);
+
+/**
+ * @brief 清除曲线控件指定通道的数据
+ * @param control_name 曲线控件名称
+ * @param channel 通道号 (255 表示全部通道)
+ */
+void TJC_waveform_clear(const char *control_name, uint8_t channel);
+
+/**
+ * @brief 使用透传指令 (addt) 向曲线控件批量写入数据点
+ * @details 数据点分块拷贝到发送队列后立即返回。串口任务对每块发送一条 addt 命令，等待屏幕就绪后一次写出该块数据点，
+ *          期间收到的帧照常放入接收帧队列；屏幕未应答的块计入 METRIC_TJC_WAVEFORM_FAIL。曲线控件必须位于当前页面
+ * @param control_name 曲线控件名称 (字符串常量)
+ * @param channel 通道号
+ * @param points 数据点 (0 - 255)
+ * @param count 数据点个数
+ * @return true 全部数据点已交给串口任务
+ * @return false 发送队列已满
+ */
+bool TJC_waveform_add(const char *control_name, uint8_t channel, const uint8_t *points, uint16_t count);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,399 @@
+#include <Telemetry.h>
+
+// 定义[单个插孔的遥测数据]
+struct TelemetrySocket
+{
+    TelemetryLatest latest;                              // 最新值
+    TelemetrySample recent[TELEMETRY_RECENT_CAPACITY];   // 最近实时采样 (环形缓冲区)
+    uint16_t recentHead, recentCount;                    // 实时采样 写入位置/有效条数
+    TelemetryRollup minute[TELEMETRY_MINUTE_CAPACITY];   // 1分钟汇总，下标即距最新一条的偏移
+    uint16_t minuteCount;                                // 1分钟汇总有效条数
+    TelemetryRollup quarter[TELEMETRY_QUARTER_CAPACITY]; // 15分钟汇总，下标即距最新一条的偏移
+    uint16_t quarterCount;                               // 15分钟汇总有效条数
+};
+
+// 定义[单个STA的遥测数据]
+struct TelemetryEntry
+{
+    uint8_t macAddress[6];                           // STA的MAC地址
+    TelemetrySocket sockets[TELEMETRY_SOCKET_COUNT]; // 各插孔数据
+};
+
+// STA索引表 (按MAC地址散列，线性探测)，表项在首次写入时分配
+static TelemetryEntry **entries = nullptr;
+// 遥测数据访问互斥锁 (写入来自HPLC处理，读取来自UI刷新)
+static SemaphoreHandle_t telemetryMutex = NULL;
+
+/**
+ * 根据MAC地址计算索引表的起始探测位置
+ */
+static uint16_t mac_hash(const uint8_t macAddress[6])
+{
+    // FNV-1a
+    uint32_t hash = 2166136261u;
+    for (int i = 0; i < 6; i++)
+    {
+        hash = (hash ^ macAddress[i]) * 16777619u;
+    }
+    return hash % TELEMETRY_MAX_STA;
+}
+
+/**
+ * 查找STA对应的遥测数据，需要时创建 (调用方需持有互斥锁)
+ */
+static TelemetryEntry *find_entry(const uint8_t macAddress[6], bool create)
+{
+    if (entries == nullptr)
+    {
+        return nullptr;
+    }
+    uint16_t index = mac_hash(macAddress);
+    for (int probe = 0; probe < TELEMETRY_MAX_STA; probe++)
+    {
+        TelemetryEntry *entry = entries[index];
+        if (entry == nullptr)
+        {
+            if (!create)
+            {
+                return nullptr;
+            }
+            // 优先分配到 PSRAM，失败时退回内部 RAM
+            entry = (TelemetryEntry *)heap_caps_calloc(1, sizeof(TelemetryEntry), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+            if (entry == nullptr)
+            {
+                entry = (TelemetryEntry *)calloc(1, sizeof(TelemetryEntry));
+            }
+            if (entry != nullptr)
+            {
+                memcpy(entry->macAddress, macAddress, 6);
+                entries[index] = entry;
+            }
+            return entry;
+        }
+        if (memcmp(entry->macAddress, macAddress, 6) == 0)
+        {
+            return entry;
+        }
+        index = (index + 1) % TELEMETRY_MAX_STA;
+    }
+    // 索引表已满
+    return nullptr;
+}
+
+/**
+ * 获取STA指定插孔的遥测数据 (调用方需持有互斥锁)
+ */
+static TelemetrySocket *find_socket(const uint8_t macAddress[6], uint8_t socket_num, bool create)
+{
+    if (socket_num < 1 || socket_num > TELEMETRY_SOCKET_COUNT)
+    {
+        return nullptr;
+    }
+    TelemetryEntry *entry = find_entry(macAddress, create);
+    return entry == nullptr ? nullptr : &entry->sockets[socket_num - 1];
+}
+
+/**
+ * @brief 初始化遥测数据存储
+ * @details 分配STA索引表，每个STA的数据在首次收到数据时按需分配到 PSRAM
+ * @return bool 初始化成功返回 true，失败返回 false
+ */
+bool TELEMETRY_init()
+{
+    if (entries != nullptr)
+    {
+        return true;
+    }
+    telemetryMutex = xSemaphoreCreateMutex();
+    if (telemetryMutex == NULL)
+    {
+        return false;
+    }
+    entries = (TelemetryEntry **)calloc(TELEMETRY_MAX_STA, sizeof(TelemetryEntry *));
+    return entries != nullptr;
+}
+
+/**
+ * @brief 记录插孔电流 (来自 0x14 推送)
+ * @param macAddress STA的MAC地址
+ * @param socket_num 插孔编号 (1, 2, 3)
+ * @param current_ma 电流 (mA)
+ */
+void TELEMETRY_record_current(const uint8_t macAddress[6], uint8_t socket_num, uint32_t current_ma)
+{
+    if (telemetryMutex == NULL || xSemaphoreTake(telemetryMutex, portMAX_DELAY) != pdTRUE)
+    {
+        return;
+    }
+    TelemetrySocket *socket = find_socket(macAddress, socket_num, true);
+    if (socket != nullptr)
+    {
+        socket->latest.currentMilliAmps = current_ma;
+        socket->latest.updatedAt = millis();
+    }
+    xSemaphoreGive(telemetryMutex);
+}
+
+/**
+ * @brief 记录插孔功率 (来自 0x15 推送)，并以最新电流生成一条实时采样
+ * @param macAddress STA的MAC地址
+ * @param socket_num 插孔编号 (1, 2, 3)
+ * @param power_mw 有功功率 (mW)
+ */
+void TELEMETRY_record_power(const uint8_t macAddress[6], uint8_t socket_num, uint32_t power_mw)
+{
+    if (telemetryMutex == NULL || xSemaphoreTake(telemetryMutex, portMAX_DELAY) != pdTRUE)
+    {
+        return;
+    }
+    TelemetrySocket *socket = find_socket(macAddress, socket_num, true);
+    if (socket != nullptr)
+    {
+        uint32_t now = millis();
+        socket->latest.powerMilliWatts = power_mw;
+        socket->latest.updatedAt = now;
+
+        // STA 每个周期先推送电流再推送功率，收到功率时生成一条完整采样
+        TelemetrySample &sample = socket->recent[socket->recentHead];
+        sample.timestamp = now;
+        sample.currentMilliAmps = socket->latest.currentMilliAmps;
+        sample.powerMilliWatts = power_mw;
+        socket->recentHead = (socket->recentHead + 1) % TELEMETRY_RECENT_CAPACITY;
+        if (socket->recentCount < TELEMETRY_RECENT_CAPACITY)
+        {
+            socket->recentCount++;
+        }
+    }
+    xSemaphoreGive(telemetryMutex);
+}
+
+/**
+ * @brief 记录插孔累计电能 (来自 0x16 查询)
+ * @param macAddress STA的MAC地址
+ * @param socket_num 插孔编号 (1, 2, 3)
+ * @param energy_wh 累计电能 (Wh)
+ */
+void TELEMETRY_record_energy(const uint8_t macAddress[6], uint8_t socket_num, uint32_t energy_wh)
+{
+    if (telemetryMutex == NULL || xSemaphoreTake(telemetryMutex, portMAX_DELAY) != pdTRUE)
+    {
+        return;
+    }
+    TelemetrySocket *socket = find_socket(macAddress, socket_num, true);
+    if (socket != nullptr)
+    {
+        socket->latest.energyWattHours = energy_wh;
+        socket->latest.updatedAt = millis();
+    }
+    xSemaphoreGive(telemetryMutex);
+}
+
+/**
+ * @brief 写入一批汇总记录 (来自 0x17 批量拉取)
+ * @param macAddress STA的MAC地址
+ * @param socket_num 插孔编号 (1, 2, 3)
+ * @param tier 汇总层级 (HISTORY_TIER_MINUTE 或 HISTORY_TIER_QUARTER)
+ * @param offset 第一条记录距最新一条的偏移 (0 表示最新一条)
+ * @param rollups 汇总记录数组，按从新到旧排列
+ * @param count 记录条数
+ */
+void TELEMETRY_store_rollups(const uint8_t macAddress[6], uint8_t socket_num, uint8_t tier, uint16_t offset, const TelemetryRollup *rollups, uint16_t count)
+{
+    if (telemetryMutex == NULL || xSemaphoreTake(telemetryMutex, portMAX_DELAY) != pdTRUE)
+    {
+        return;
+    }
+    TelemetrySocket *socket = find_socket(macAddress, socket_num, true);
+    if (socket != nullptr)
+    {
+        TelemetryRollup *target = nullptr;
+        uint16_t capacity = 0;
+        uint16_t *validCount = nullptr;
+        if (tier == HISTORY_TIER_MINUTE)
+        {
+            target = socket->minute;
+            capacity = TELEMETRY_MINUTE_CAPACITY;
+            validCount = &socket->minuteCount;
+        }
+        else if (tier == HISTORY_TIER_QUARTER)
+        {
+            target = socket->quarter;
+            capacity = TELEMETRY_QUARTER_CAPACITY;
+            validCount = &socket->quarterCount;
+        }
+
+        if (target != nullptr)
+        {
+            // 从最新一条开始拉取时，旧数据已整体后移，先作废
+            if (offset == 0)
+            {
+                *validCount = 0;
+            }
+            for (uint16_t i = 0; i < count && offset + i < capacity; i++)
+            {
+                target[offset + i] = rollups[i];
+            }
+            uint16_t end = min<uint16_t>(offset + count, capacity);
+            if (end > *validCount)
+            {
+                *validCount = end;
+            }
+        }
+    }
+    xSemaphoreGive(telemetryMutex);
+}
+
+/**
+ * @brief 获取插孔最新值
+ * @param macAddress STA的MAC地址
+ * @param socket_num 插孔编号 (1, 2, 3)
+ * @param latest 用于接收最新值的输出参数
+ * @return bool 存在该STA的数据返回 true，否则返回 false
+ */
+bool TELEMETRY_get_latest(const uint8_t macAddress[6], uint8_t socket_num, TelemetryLatest &latest)
+{
+    if (telemetryMutex == NULL || xSemaphoreTake(telemetryMutex, portMAX_DELAY) != pdTRUE)
+    {
+        return false;
+    }
+    TelemetrySocket *socket = find_socket(macAddress, socket_num, false);
+    if (socket != nullptr)
+    {
+        latest = socket->latest;
+    }
+    xSemaphoreGive(telemetryMutex);
+    return socket != nullptr;
+}
+
+/**
+ * @brief 读取插孔最近的实时采样
+ * @param macAddress STA的MAC地址
+ * @param socket_num 插孔编号 (1, 2, 3)
+ * @param offset 从最新一条开始向前的偏移 (0 表示最新一条)
+ * @param out 用于接收记录的数组，按从新到旧排列
+ * @param max_count out 数组的最大容量
+ * @return uint16_t 实际读取的记录条数
+ */
+uint16_t TELEMETRY_read_recent(const uint8_t macAddress[6], uint8_t socket_num, uint16_t offset, TelemetrySample *out, uint16_t max_count)
+{
+    if (telemetryMutex == NULL || xSemaphoreTake(telemetryMutex, portMAX_DELAY) != pdTRUE)
+    {
+        return 0;
+    }
+    uint16_t read = 0;
+    TelemetrySocket *socket = find_socket(macAddress, socket_num, false);
+    if (socket != nullptr)
+    {
+        while (read < max_count && offset + read < socket->recentCount)
+        {
+            // 最新一条位于 recentHead - 1
+            uint16_t index = (socket->recentHead + TELEMETRY_RECENT_CAPACITY - 1 - offset - read) % TELEMETRY_RECENT_CAPACITY;
+            out[read++] = socket->recent[index];
+        }
+    }
+    xSemaphoreGive(telemetryMutex);
+    return read;
+}
+
+/**
+ * @brief 读取插孔汇总记录
+ * @param macAddress STA的MAC地址
+ * @param socket_num 插孔编号 (1, 2, 3)
+ * @param tier 汇总层级 (HISTORY_TIER_MINUTE 或 HISTORY_TIER_QUARTER)
+ * @param offset 从最新一条开始向前的偏移 (0 表示最新一条)
+ * @param out 用于接收记录的数组，按从新到旧排列
+ * @param max_count out 数组的最大容量
+ * @return uint16_t 实际读取的记录条数
+ */
+uint16_t TELEMETRY_read_rollups(const uint8_t macAddress[6], uint8_t socket_num, uint8_t tier, uint16_t offset, TelemetryRollup *out, uint16_t max_count)
+{
+    if (telemetryMutex == NULL || xSemaphoreTake(telemetryMutex, portMAX_DELAY) != pdTRUE)
+    {
+        return 0;
+    }
+    uint16_t read = 0;
+    TelemetrySocket *socket = find_socket(macAddress, socket_num, false);
+    if (socket != nullptr)
+    {
+        const TelemetryRollup *source = tier == HISTORY_TIER_MINUTE ? socket->minute : socket->quarter;
+        uint16_t validCount = tier == HISTORY_TIER_MINUTE ? socket->minuteCount : socket->quarterCount;
+        while (read < max_count && offset + read < validCount)
+        {
+            out[read] = source[offset + read];
+            read++;
+        }
+    }
+    xSemaphoreGive(telemetryMutex);
+    return read;
+}
+
+/**
+ * @brief 通过 HPLC (0x17) 从STA批量拉取汇总记录并写入存储
+ * @details 每帧最多携带4条汇总记录，超过时自动分多次请求
+ * @param macAddress STA的MAC地址
+ * @param socket_num 插孔编号 (1, 2, 3)
+ * @param tier 汇总层级 (HISTORY_TIER_MINUTE 或 HISTORY_TIER_QUARTER)
+ * @param count 要拉取的记录条数 (从最新一条开始)
+ * @return uint16_t 实际拉取到的记录条数
+ */
+uint16_t TELEMETRY_fetch_rollups(const uint8_t macAddress[6], uint8_t socket_num, uint8_t tier, uint16_t count)
+{
+    // 每帧最多携带的汇总记录条数
+    constexpr uint8_t ROLLUPS_PER_FRAME = protocol_max_records<MsgHistoryReply, HistoryRollupRecord>();
+
+    uint8_t target[6];
+    memcpy(target, macAddress, 6);
+
+    uint16_t fetched = 0;
+    while (fetched < count)
+    {
+        uint8_t request = min<uint16_t>(count - fetched, ROLLUPS_PER_FRAME);
+        uint8_t frame[protocol_frame_size<MsgHistoryQuery>()];
+        MsgHistoryQuery &query = protocol_encode<MsgHistoryQuery>(frame);
+        query.socketId = socket_num;
+        query.tier = tier;
+        query.offset = fetched;
+        query.count = request;
+        FrameParser response;
+        if (!HPLC_send_request(target, frame, sizeof(frame), response))
+        {
+            break;
+        }
+
+        // 应答: 固定部分 + 实际条数的汇总记录
+        FrameView responseFrame = frame_view(response);
+        const MsgHistoryReply *reply = protocol_view<MsgHistoryReply>(responseFrame, true);
+        if (reply == nullptr)
+        {
+            break;
+        }
+        // 应答必须对应本次查询 (迟到的重发应答或其它查询的应答会写错位置)
+        if (reply->socketId != socket_num || reply->tier != tier || reply->offset != fetched)
+        {
+            break;
+        }
+        uint8_t read = reply->count;
+        uint8_t recordsLen;
+        const HistoryRollupRecord *records = reinterpret_cast<const HistoryRollupRecord *>(protocol_view_extra<MsgHistoryReply>(responseFrame, &recordsLen));
+        if (read > ROLLUPS_PER_FRAME || recordsLen != read * sizeof(HistoryRollupRecord))
+        {
+            break;
+        }
+        TelemetryRollup rollups[ROLLUPS_PER_FRAME];
+        for (uint8_t i = 0; i < read; i++)
+        {
+            rollups[i].minPowerMilliWatts = records[i].minPowerMilliWatts;
+            rollups[i].maxPowerMilliWatts = records[i].maxPowerMilliWatts;
+            rollups[i].avgPowerMilliWatts = records[i].avgPowerMilliWatts;
+        }
+        TELEMETRY_store_rollups(macAddress, socket_num, tier, fetched, rollups, read);
+        fetched += read;
+
+        // STA上没有更多记录
+        if (read < request)
+        {
+            break;
+        }
+    }
+    return fetched;
+}
\ No newline at end of file
@@ -0,0 +1,129 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <Arduino.h>
+#include <Global.h>
+#include <HPLC.h>     // 批量拉取STA历史记录
+#include <Protocol.h> // 历史记录查询消息定义
+
+// 可存储的STA最大数量
+#define TELEMETRY_MAX_STA STA_MAX_COUNT
+// 每个排插的插孔数量
+#define TELEMETRY_SOCKET_COUNT 3
+
+// 各类数据的存储容量 (条)
+#define TELEMETRY_RECENT_CAPACITY 32  // 最近实时采样
+#define TELEMETRY_MINUTE_CAPACITY 30  // 1分钟汇总 (最近30分钟)
+#define TELEMETRY_QUARTER_CAPACITY 48 // 15分钟汇总 (最近12小时)
+
+// 定义[遥测采样]
+struct TelemetrySample
+{
+    uint32_t timestamp;        // 接收时间 (millis)
+    uint32_t currentMilliAmps; // 电流 (mA)
+    uint32_t powerMilliWatts;  // 有功功率 (mW)
+};
+
+// 定义[遥测汇总记录]，与STA历史记录汇总格式一致
+struct TelemetryRollup
+{
+    uint32_t minPowerMilliWatts; // 周期内最小功率 (mW)
+    uint32_t maxPowerMilliWatts; // 周期内最大功率 (mW)
+    uint32_t avgPowerMilliWatts; // 周期内平均功率 (mW)
+};
+
+// 定义[插孔最新值]
+struct TelemetryLatest
+{
+    uint32_t currentMilliAmps; // 最新电流 (mA)
+    uint32_t powerMilliWatts;  // 最新有功功率 (mW)
+    uint32_t energyWattHours;  // 最新累计电能 (Wh)
+    uint32_t updatedAt;        // 最后更新时间 (millis)，0 表示从未更新
+};
+
+/**
+ * @brief 初始化遥测数据存储
+ * @details 分配STA索引表，每个STA的数据在首次收到数据时按需分配到 PSRAM
+ * @return bool 初始化成功返回 true，失败返回 false
+ */
+bool TELEMETRY_init();
+
+/**
+ * @brief 记录插孔电流 (来自 0x14 推送)
+ * @param macAddress STA的MAC地址
+ * @param socket_num 插孔编号 (1, 2, 3)
+ * @param current_ma 电流 (mA)
+ */
+void TELEMETRY_record_current(const uint8_t macAddress[6], uint8_t socket_num, uint32_t current_ma);
+
+/**
+ * @brief 记录插孔功率 (来自 0x15 推送)，并以最新电流生成一条实时采样
+ * @param macAddress STA的MAC地址
+ * @param socket_num 插孔编号 (1, 2, 3)
+ * @param power_mw 有功功率 (mW)
+ */
+void TELEMETRY_record_power(const uint8_t macAddress[6], uint8_t socket_num, uint32_t power_mw);
+
+/**
+ * @brief 记录插孔累计电能 (来自 0x16 查询)
+ * @param macAddress STA的MAC地址
+ * @param socket_num 插孔编号 (1, 2, 3)
+ * @param energy_wh 累计电能 (Wh)
+ */
+void TELEMETRY_record_energy(const uint8_t macAddress[6], uint8_t socket_num, uint32_t energy_wh);
+
+/**
+ * @brief 写入一批汇总记录 (来自 0x17 批量拉取)
+ * @param macAddress STA的MAC地址
+ * @param socket_num 插孔编号 (1, 2, 3)
+ * @param tier 汇总层级 (HISTORY_TIER_MINUTE 或 HISTORY_TIER_QUARTER)
+ * @param offset 第一条记录距最新一条的偏移 (0 表示最新一条)
+ * @param rollups 汇总记录数组，按从新到旧排列
+ * @param count 记录条数
+ */
+void TELEMETRY_store_rollups(const uint8_t macAddress[6], uint8_t socket_num, uint8_t tier, uint16_t offset, const TelemetryRollup *rollups, uint16_t count);
+
+/**
+ * @brief 获取插孔最新值
+ * @param macAddress STA的MAC地址
+ * @param socket_num 插孔编号 (1, 2, 3)
+ * @param latest 用于接收最新值的输出参数
+ * @return bool 存在该STA的数据返回 true，否则返回 false
+ */
+bool TELEMETRY_get_latest(const uint8_t macAddress[6], uint8_t socket_num, TelemetryLatest &latest);
+
+/**
+ * @brief 读取插孔最近的实时采样
+ * @param macAddress STA的MAC地址
+ * @param socket_num 插孔编号 (1, 2, 3)
+ * @param offset 从最新一条开始向前的偏移 (0 表示最新一条)
+ * @param out 用于接收记录的数组，按从新到旧排列
+ * @param max_count out 数组的最大容量
+ * @return uint16_t 实际读取的记录条数
+ */
+uint16_t TELEMETRY_read_recent(const uint8_t macAddress[6], uint8_t socket_num, uint16_t offset, TelemetrySample *out, uint16_t max_count);
+
+/**
+ * @brief 读取插孔汇总记录
+ * @param macAddress STA的MAC地址
+ * @param socket_num 插孔编号 (1, 2, 3)
+ * @param tier 汇总层级 (HISTORY_TIER_MINUTE 或 HISTORY_TIER_QUARTER)
+ * @param offset 从最新一条开始向前的偏移 (0 表示最新一条)
+ * @param out 用于接收记录的数组，按从新到旧排列
+ * @param max_count out 数组的最大容量
+ * @return uint16_t 实际读取的记录条数
+ */
+uint16_t TELEMETRY_read_rollups(const uint8_t macAddress[6], uint8_t socket_num, uint8_t tier, uint16_t offset, TelemetryRollup *out, uint16_t max_count);
+
+/**
+ * @brief 通过 HPLC (0x17) 从STA批量拉取汇总记录并写入存储
+ * @details 每帧最多携带4条汇总记录，超过时自动分多次请求
+ * @param macAddress STA的MAC地址
+ * @param socket_num 插孔编号 (1, 2, 3)
+ * @param tier 汇总层级 (HISTORY_TIER_MINUTE 或 HISTORY_TIER_QUARTER)
+ * @param count 要拉取的记录条数 (从最新一条开始)
+ * @return uint16_t 实际拉取到的记录条数
+ */
+uint16_t TELEMETRY_fetch_rollups(const uint8_t macAddress[6], uint8_t socket_num, uint8_t tier, uint16_t count);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,635 @@
+#include <HplcSim.h>
+#include <Global.h>
+#include <NativeShims.h>
+
+#include <algorithm>
+#include <dlfcn.h>
+#include <queue>
+#include <string>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#include <unordered_map>
+#include <vector>
+
+#define HPLC_SIM_AIR_PRIORITY (configMAX_PRIORITIES - 1) // 载波网络任务的优先级 (高于所有固件任务，帧按时送达)
+#define HPLC_SIM_AIR_STACK_SIZE 4096
+#define HPLC_SIM_CCO 0 // CCO的节点序号，STA从1开始
+
+// STA镜像导出的接口 (与 STA/native/SimStation/src/SimStation.h 一致)
+typedef void (*SimStationTxFunc)(const uint8_t *data, size_t length, void *context);
+typedef void (*SimStationAttachFunc)(SimStationTxFunc tx, void *context);
+typedef void (*SimStationReceiveFunc)(const uint8_t *data, size_t length);
+typedef void (*SimStationStartFunc)(const uint8_t local_address[6], const uint8_t cco_address[6], uint32_t loop_interval_ms);
+typedef bool (*SimStationReadyFunc)(void);
+typedef uint8_t (*SimStationSocketStateFunc)(uint8_t socket);
+
+// 定义[网络节点]类型 (CCO 或一个STA)
+typedef struct
+{
+    uint8_t macAddress[6];
+    uint32_t latencyUs;                    // 单向时延
+    uint32_t jitterUs;                     // 每个包的抖动上限
+    float loss;                            // 丢包率
+    std::string txPending;                 // 写往模块、尚未凑成完整命令的字节
+    uint64_t uartFreeAtUs;                 // 模块向本节点输出AT应答的串口空闲时间
+    SimStationReceiveFunc receive;         // STA镜像的接收接口 (CCO为NULL，直接写入 Serial2)
+    SimStationReadyFunc ready;             // STA镜像的 setup() 完成查询接口
+    SimStationSocketStateFunc socketState; // STA镜像的继电器状态接口
+    bool commandPending;                   // CCO发给本节点的命令正在等待应答
+    uint8_t commandCtrl;                   // 等待应答的命令的控制码
+    uint64_t commandStartUs;               // 命令第一次发出的时间
+} SimNode;
+
+// 定义[待送达数据]类型
+typedef struct
+{
+    uint64_t atUs;  // 送达时间
+    uint64_t seq;   // 同一时间按产生顺序送达
+    uint16_t node;  // 目标节点
+    int32_t from;   // 帧的源节点 (AT应答为 -1)
+    std::vector<uint8_t> bytes;
+} SimDelivery;
+
+struct SimDeliveryLater
+{
+    bool operator()(const SimDelivery &a, const SimDelivery &b) const
+    {
+        return a.atUs != b.atUs ? a.atUs > b.atUs : a.seq > b.seq;
+    }
+};
+
+// 定义[命令样本]类型
+typedef struct
+{
+    uint8_t ctrl;
+    bool failed;
+    uint32_t latencyUs;
+} SimCommandSample;
+
+static HplcSimConfig simConfig;
+static std::vector<SimNode> nodes;
+static std::unordered_map<uint64_t, uint16_t> nodeByAddress;
+static std::priority_queue<SimDelivery, std::vector<SimDelivery>, SimDeliveryLater> deliveries;
+static uint64_t deliverySeq = 0;
+// 每条有向链路上最后一帧的送达时间 (保证同一链路不乱序)
+static std::unordered_map<uint32_t, uint64_t> linkLastUs;
+static std::vector<SimCommandSample> commandSamples;
+static HplcSimStats stats;
+// CCO上一次查询拓扑的时间 (0 表示还没有查询)
+static uint64_t lastTopoQueryUs = 0;
+static uint32_t rngState = 1;
+// 等待对象: 有新的待送达数据
+static char airEvent;
+
+/**
+ * xorshift32 伪随机数 (固定种子，运行结果可复现)
+ */
+static uint32_t rng_next()
+{
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 17;
+    rngState ^= rngState << 5;
+    return rngState;
+}
+
+static uint32_t rng_between(uint32_t min, uint32_t max)
+{
+    return max > min ? min + rng_next() % (max - min + 1) : min;
+}
+
+static float rng_unit()
+{
+    return (rng_next() >> 8) / 16777216.0f;
+}
+
+static uint64_t address_key(const uint8_t macAddress[6])
+{
+    uint64_t key = 0;
+    for (int i = 0; i < 6; i++)
+    {
+        key = (key << 8) | macAddress[i];
+    }
+    return key;
+}
+
+// 模块串口输出 length 个字节所需的时间
+static uint64_t uart_us(size_t length)
+{
+    return (uint64_t)length * 11 * 1000000ULL / HPLC_SIM_BAUD;
+}
+
+static void schedule(uint16_t node, uint64_t atUs, int32_t from, const uint8_t *data, size_t length)
+{
+    SimDelivery delivery;
+    delivery.atUs = atUs;
+    delivery.seq = ++deliverySeq;
+    delivery.node = node;
+    delivery.from = from;
+    delivery.bytes.assign(data, data + length);
+    deliveries.push(delivery);
+    native_notify(&airEvent);
+}
+
+// ---------------------------------------------------------------- 命令时延
+
+static void command_sent(SimNode &node, uint8_t ctrl, uint64_t nowUs)
+{
+    // 窗口内同一控制码的命令视为重发
+    if (node.commandPending && node.commandCtrl == ctrl && nowUs - node.commandStartUs < HPLC_SIM_COMMAND_WINDOW_MS * 1000ULL)
+    {
+        return;
+    }
+    if (node.commandPending)
+    {
+        commandSamples.push_back({node.commandCtrl, true, 0});
+    }
+    node.commandPending = true;
+    node.commandCtrl = ctrl;
+    node.commandStartUs = nowUs;
+}
+
+static void command_answered(SimNode &node, uint64_t nowUs)
+{
+    if (!node.commandPending)
+    {
+        return;
+    }
+    commandSamples.push_back({node.commandCtrl, false, (uint32_t)(nowUs - node.commandStartUs)});
+    node.commandPending = false;
+}
+
+// ---------------------------------------------------------------- 监控周期
+
+/**
+ * CCO的STA监控任务每个周期先查询拓扑，以相邻两次 AT+TOPONUM? 的间隔作为一个周期的耗时
+ */
+static void sweep_started(uint64_t nowUs)
+{
+    if (lastTopoQueryUs != 0)
+    {
+        uint64_t elapsedUs = nowUs - lastTopoQueryUs;
+        stats.sweeps++;
+        stats.sweepSumUs += elapsedUs;
+        stats.sweepMaxUs = std::max(stats.sweepMaxUs, elapsedUs);
+        stats.sweepLastUs = elapsedUs;
+    }
+    lastTopoQueryUs = nowUs;
+}
+
+// ---------------------------------------------------------------- 载波模块
+
+/**
+ * 转发 AT+SEND 的帧: 每经过一个节点独立丢包，时延为两端节点的时延加抖动
+ */
+static void route_frame(uint16_t from, const char *mac_hex, const uint8_t *frame, size_t length)
+{
+    stats.framesSent++;
+    uint8_t address[6];
+    auto found = hex_to_mac(mac_hex, address) ? nodeByAddress.find(address_key(address)) : nodeByAddress.end();
+    if (found == nodeByAddress.end() || found->second == from)
+    {
+        stats.framesUnroutable++;
+        return;
+    }
+    uint16_t to = found->second;
+    uint64_t nowUs = native_time_us();
+    if (from == HPLC_SIM_CCO && length > FRAME_CTRL_OFFSET)
+    {
+        command_sent(nodes[to], frame[FRAME_CTRL_OFFSET], nowUs);
+    }
+
+    SimNode &source = nodes[from];
+    SimNode &destination = nodes[to];
+    if (rng_unit() < source.loss || rng_unit() < destination.loss)
+    {
+        stats.framesLost++;
+        return;
+    }
+    uint64_t arrivalUs = nowUs + source.latencyUs + destination.latencyUs + rng_between(0, source.jitterUs) + rng_between(0, destination.jitterUs) + uart_us(length);
+    uint64_t &lastUs = linkLastUs[((uint32_t)from << 16) | to];
+    arrivalUs = std::max(arrivalUs, lastUs);
+    lastUs = arrivalUs;
+    schedule(to, arrivalUs, from, frame, length);
+}
+
+/**
+ * 模块向节点输出一行AT应答 (同一节点的应答按串口速率依次输出)
+ */
+static void reply_line(uint16_t to, const char *text)
+{
+    SimNode &node = nodes[to];
+    size_t length = strlen(text);
+    uint64_t startUs = std::max<uint64_t>(native_time_us() + simConfig.atReplyMs * 1000ULL, node.uartFreeAtUs);
+    node.uartFreeAtUs = startUs + uart_us(length);
+    schedule(to, node.uartFreeAtUs, -1, (const uint8_t *)text, length);
+}
+
+static void handle_at_line(uint16_t from, const std::string &line)
+{
+    char reply[80];
+    int start, count;
+    if (line == "AT+TOPONUM?")
+    {
+        stats.atQueries++;
+        if (from == HPLC_SIM_CCO)
+        {
+            sweep_started(native_time_us());
+        }
+        snprintf(reply, sizeof(reply), "\r+ok=%u\r\n", (unsigned)(nodes.size() - 1));
+        reply_line(from, reply);
+    }
+    else if (sscanf(line.c_str(), "AT+TOPOINFO=%d,%d", &start, &count) == 2)
+    {
+        // 拓扑信息从第1个STA开始编号，TEI 1 是CCO
+        stats.atQueries++;
+        for (int i = std::max(start, 1); i < start + count && i < (int)nodes.size(); i++)
+        {
+            char mac_hex[MAC_HEX_LEN + 1];
+            mac_to_hex(nodes[i].macAddress, mac_hex);
+            snprintf(reply, sizeof(reply), "\r+ok=%s,%02x,01,1,STA,0,0,1 \r\n", mac_hex, i + 1);
+            reply_line(from, reply);
+            stats.topoRows++;
+        }
+    }
+}
+
+/**
+ * 解析节点写往模块的字节: "AT+SEND=<MAC>,<长度>,<帧>\r\n" 和以 "\r\n" 结尾的AT查询，不完整的命令留到下次
+ */
+static void module_receive(uint16_t from, const uint8_t *data, size_t length)
+{
+    std::string &pending = nodes[from].txPending;
+    pending.append((const char *)data, length);
+    for (;;)
+    {
+        size_t begin = pending.find("AT+");
+        if (begin == std::string::npos)
+        {
+            // 保留可能是下一条命令开头的 "AT"
+            pending.erase(0, pending.size() > 2 ? pending.size() - 2 : 0);
+            return;
+        }
+        pending.erase(0, begin);
+
+        if (pending.compare(0, 8, "AT+SEND=") == 0)
+        {
+            const size_t lengthStart = 8 + MAC_HEX_LEN + 1;
+            size_t lengthEnd = lengthStart;
+            while (lengthEnd < pending.size() && lengthEnd < lengthStart + 3 && isdigit((unsigned char)pending[lengthEnd]))
+            {
+                lengthEnd++;
+            }
+            if (lengthEnd >= pending.size())
+            {
+                return;
+            }
+            if (pending[lengthStart - 1] != ',' || lengthEnd == lengthStart || pending[lengthEnd] != ',')
+            {
+                // 格式错误，跳过这个 "AT+"
+                pending.erase(0, 3);
+                continue;
+            }
+            size_t frameLength = strtoul(pending.c_str() + lengthStart, NULL, 10);
+            size_t frameStart = lengthEnd + 1;
+            if (pending.size() < frameStart + frameLength + 2)
+            {
+                return;
+            }
+            route_frame(from, pending.c_str() + 8, (const uint8_t *)pending.data() + frameStart, frameLength);
+            pending.erase(0, frameStart + frameLength + 2);
+            continue;
+        }
+
+        size_t end = pending.find("\r\n");
+        if (end == std::string::npos)
+        {
+            return;
+        }
+        handle_at_line(from, pending.substr(0, end));
+        pending.erase(0, end + 2);
+    }
+}
+
+static void deliver(const SimDelivery &delivery)
+{
+    SimNode &node = nodes[delivery.node];
+    if (node.receive != NULL)
+    {
+        node.receive(delivery.bytes.data(), delivery.bytes.size());
+    }
+    else
+    {
+        Serial2.native_inject(delivery.bytes.data(), delivery.bytes.size());
+    }
+    if (delivery.from >= 0)
+    {
+        stats.framesDelivered++;
+        if (delivery.node == HPLC_SIM_CCO)
+        {
+            command_answered(nodes[delivery.from], delivery.atUs);
+        }
+    }
+}
+
+/**
+ * 载波网络任务: 按送达时间把帧和AT应答交给目标节点的串口
+ */
+static void air_task(void *pvParameters)
+{
+    (void)pvParameters;
+    for (;;)
+    {
+        uint64_t nowUs = native_time_us();
+        while (!deliveries.empty() && deliveries.top().atUs <= nowUs)
+        {
+            SimDelivery delivery = deliveries.top();
+            deliveries.pop();
+            deliver(delivery);
+        }
+        native_wait(&airEvent, deliveries.empty() ? NATIVE_WAIT_FOREVER : deliveries.top().atUs);
+    }
+}
+
+static void station_tx(const uint8_t *data, size_t length, void *context)
+{
+    module_receive((uint16_t)(uintptr_t)context, data, length);
+}
+
+static void cco_tx(HardwareSerial &serial, const uint8_t *data, size_t length, void *context)
+{
+    (void)serial;
+    (void)context;
+    module_receive(HPLC_SIM_CCO, data, length);
+}
+
+// ---------------------------------------------------------------- 配置
+
+static void env_uint(const char *name, uint32_t &value)
+{
+    const char *text = getenv(name);
+    if (text != NULL && text[0] != '\0')
+    {
+        value = strtoul(text, NULL, 10);
+    }
+}
+
+// "最小值-最大值" 或单个值
+static void env_range(const char *name, uint32_t &min, uint32_t &max)
+{
+    const char *text = getenv(name);
+    if (text != NULL && text[0] != '\0')
+    {
+        char *end;
+        min = strtoul(text, &end, 10);
+        max = *end == '-' ? strtoul(end + 1, NULL, 10) : min;
+    }
+}
+
+static void env_range(const char *name, float &min, float &max)
+{
+    const char *text = getenv(name);
+    if (text != NULL && text[0] != '\0')
+    {
+        char *end;
+        min = strtof(text, &end);
+        max = *end == '-' ? strtof(end + 1, NULL) : min;
+    }
+}
+
+void HPLC_SIM_config_from_env(HplcSimConfig &config)
+{
+    config.stationImage = "../STA/.pio/build/native_station/program";
+    config.stationCount = 200;
+    config.latencyMinMs = 20;
+    config.latencyMaxMs = 80;
+    config.jitterMinMs = 0;
+    config.jitterMaxMs = 20;
+    config.lossMin = 0;
+    config.lossMax = 0;
+    config.atReplyMs = 20;
+    config.stationLoopMs = 10;
+    config.seed = 1;
+
+    const char *image = getenv("HPLC_SIM_STATION_IMAGE");
+    if (image != NULL && image[0] != '\0')
+    {
+        config.stationImage = image;
+    }
+    uint32_t stationCount = config.stationCount;
+    env_uint("SIM_STATIONS", stationCount);
+    config.stationCount = (uint16_t)std::min<uint32_t>(stationCount, 0xFFFE);
+    env_range("SIM_LATENCY_MS", config.latencyMinMs, config.latencyMaxMs);
+    env_range("SIM_JITTER_MS", config.jitterMinMs, config.jitterMaxMs);
+    env_range("SIM_LOSS", config.lossMin, config.lossMax);
+    env_uint("SIM_AT_REPLY_MS", config.atReplyMs);
+    env_uint("SIM_STA_LOOP_MS", config.stationLoopMs);
+    env_uint("SIM_SEED", config.seed);
+}
+
+// ---------------------------------------------------------------- 接口
+
+/**
+ * 为一个STA加载一份独立的镜像副本: 每份副本写入各自的内存文件
+ * @details dlopen 按路径识别已加载的库，所有副本加载完之前不能关闭内存文件，否则下一份副本会复用同一个 /proc/self/fd/N 路径
+ * @param fd 输出: 内存文件 (加载失败时为 -1)
+ */
+static void *load_station_image(const std::vector<char> &image, int &fd)
+{
+    fd = memfd_create("sta-image", MFD_CLOEXEC);
+    if (fd < 0)
+    {
+        perror("[sim] memfd_create");
+        return NULL;
+    }
+    size_t written = 0;
+    while (written < image.size())
+    {
+        ssize_t n = write(fd, image.data() + written, image.size() - written);
+        if (n <= 0)
+        {
+            perror("[sim] 写入STA镜像");
+            return NULL;
+        }
+        written += n;
+    }
+    char path[32];
+    snprintf(path, sizeof(path), "/proc/self/fd/%d", fd);
+    void *handle = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+    if (handle == NULL)
+    {
+        fprintf(stderr, "[sim] 加载STA镜像失败: %s\n", dlerror());
+    }
+    return handle;
+}
+
+/**
+ * 加载期间每个STA占用一个文件描述符，需要时提高进程的上限
+ */
+static void reserve_file_descriptors(uint32_t count)
+{
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < count + 64)
+    {
+        limit.rlim_cur = std::min<rlim_t>(count + 64, limit.rlim_max);
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+}
+
+bool HPLC_SIM_init(const HplcSimConfig &config)
+{
+    simConfig = config;
+    rngState = config.seed != 0 ? config.seed : 1;
+
+    FILE *file = fopen(config.stationImage, "rb");
+    if (file == NULL)
+    {
+        fprintf(stderr, "[sim] 找不到STA镜像 %s (先在STA工程中执行 pio run -e native_station)\n", config.stationImage);
+        return false;
+    }
+    std::vector<char> image;
+    char chunk[4096];
+    size_t n;
+    while ((n = fread(chunk, 1, sizeof(chunk), file)) > 0)
+    {
+        image.insert(image.end(), chunk, chunk + n);
+    }
+    fclose(file);
+    stats.imageBytes = image.size();
+
+    const uint8_t ccoAddress[6] = HPLC_SIM_CCO_ADDRESS;
+    nodes.assign(config.stationCount + 1, SimNode());
+    for (uint32_t i = 0; i < nodes.size(); i++)
+    {
+        SimNode &node = nodes[i];
+        if (i == HPLC_SIM_CCO)
+        {
+            memcpy(node.macAddress, ccoAddress, 6);
+            node.latencyUs = 0;
+            node.jitterUs = 0;
+            node.loss = 0;
+        }
+        else
+        {
+            const uint8_t macAddress[6] = {0x00, 0x13, 0xd7, 0x64, (uint8_t)(i >> 8), (uint8_t)i};
+            memcpy(node.macAddress, macAddress, 6);
+            node.latencyUs = rng_between(config.latencyMinMs, config.latencyMaxMs) * 1000;
+            node.jitterUs = rng_between(config.jitterMinMs, config.jitterMaxMs) * 1000;
+            node.loss = config.lossMin + (config.lossMax - config.lossMin) * rng_unit();
+        }
+        nodeByAddress[address_key(node.macAddress)] = i;
+    }
+
+    Serial2.native_set_tx_hook(cco_tx, NULL);
+    xTaskCreate(air_task, "HPLCSim", HPLC_SIM_AIR_STACK_SIZE, NULL, HPLC_SIM_AIR_PRIORITY, NULL);
+
+    reserve_file_descriptors(config.stationCount);
+    std::vector<int> imageFiles;
+    bool loaded = true;
+    for (uint32_t i = 1; i < nodes.size(); i++)
+    {
+        int fd;
+        void *handle = load_station_image(image, fd);
+        if (fd >= 0)
+        {
+            imageFiles.push_back(fd);
+        }
+        if (handle == NULL)
+        {
+            loaded = false;
+            break;
+        }
+        SimStationAttachFunc attach = (SimStationAttachFunc)dlsym(handle, "SIM_STATION_attach");
+        SimStationStartFunc start = (SimStationStartFunc)dlsym(handle, "SIM_STATION_start");
+        nodes[i].receive = (SimStationReceiveFunc)dlsym(handle, "SIM_STATION_receive");
+        nodes[i].ready = (SimStationReadyFunc)dlsym(handle, "SIM_STATION_ready");
+        nodes[i].socketState = (SimStationSocketStateFunc)dlsym(handle, "SIM_STATION_socket_state");
+        if (attach == NULL || start == NULL || nodes[i].receive == NULL || nodes[i].ready == NULL || nodes[i].socketState == NULL)
+        {
+            fprintf(stderr, "[sim] STA镜像缺少 SimStation 接口 (需要 native_station 环境编译)\n");
+            loaded = false;
+            break;
+        }
+        attach(station_tx, (void *)(uintptr_t)i);
+        start(nodes[i].macAddress, ccoAddress, config.stationLoopMs);
+    }
+    // 镜像已映射，不再需要内存文件
+    for (int fd : imageFiles)
+    {
+        close(fd);
+    }
+    return loaded;
+}
+
+bool HPLC_SIM_wait_stations(uint32_t timeout_ms)
+{
+    uint64_t deadlineUs = native_time_us() + (uint64_t)timeout_ms * 1000;
+    for (uint32_t i = 1; i < nodes.size(); i++)
+    {
+        while (!nodes[i].ready())
+        {
+            if (native_time_us() >= deadlineUs)
+            {
+                return false;
+            }
+            vTaskDelay(pdMS_TO_TICKS(10));
+        }
+    }
+    return true;
+}
+
+void HPLC_SIM_station_address(uint16_t index, uint8_t macAddress[6])
+{
+    memcpy(macAddress, nodes[index + 1].macAddress, 6);
+}
+
+uint8_t HPLC_SIM_station_socket_state(uint16_t index, uint8_t socket)
+{
+    return nodes[index + 1].socketState(socket);
+}
+
+void HPLC_SIM_get_stats(HplcSimStats &out)
+{
+    out = stats;
+}
+
+void HPLC_SIM_command_latency(int ctrl_code, HplcSimLatency &latency)
+{
+    memset(&latency, 0, sizeof(latency));
+    std::vector<uint32_t> samples;
+    for (const SimCommandSample &sample : commandSamples)
+    {
+        if (ctrl_code != HPLC_SIM_ALL_COMMANDS && sample.ctrl != ctrl_code)
+        {
+            continue;
+        }
+        if (sample.failed)
+        {
+            latency.failed++;
+        }
+        else
+        {
+            samples.push_back(sample.latencyUs);
+        }
+    }
+    // 仍在等待、已超出重发窗口的命令也算失败
+    uint64_t nowUs = native_time_us();
+    for (const SimNode &node : nodes)
+    {
+        if (node.commandPending && (ctrl_code == HPLC_SIM_ALL_COMMANDS || node.commandCtrl == ctrl_code) &&
+            nowUs - node.commandStartUs >= HPLC_SIM_COMMAND_WINDOW_MS * 1000ULL)
+        {
+            latency.failed++;
+        }
+    }
+    if (samples.empty())
+    {
+        return;
+    }
+    std::sort(samples.begin(), samples.end());
+    latency.count = samples.size();
+    latency.p50Us = samples[(samples.size() - 1) * 50 / 100];
+    latency.p95Us = samples[(samples.size() - 1) * 95 / 100];
+    latency.p99Us = samples[(samples.size() - 1) * 99 / 100];
+    latency.maxUs = samples.back();
+}
\ No newline at end of file
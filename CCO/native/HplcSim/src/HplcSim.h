@@ -0,0 +1,116 @@
+#ifndef HPLC_SIM_H
+#define HPLC_SIM_H
+
+/*
+ * HPLC 载波网络模拟器 (只在 native 环境中存在)
+ * - 扮演载波模块: 解析CCO和各STA写往模块的 AT+SEND、AT+TOPONUM?、AT+TOPOINFO，按MAC地址转发帧、回复拓扑查询
+ * - 每个STA运行一份真实的STA固件 (STA工程 native_station 环境编译的STA镜像，见 STA/native/SimStation)
+ * - 每个节点的时延、抖动和丢包率在配置的区间内随机取定，每个包的抖动在 0 ~ 节点抖动之间随机；同一条链路上的帧不乱序
+ * - 所有时间都是虚拟时间，同一配置和种子的运行结果相同
+ */
+
+#include <Arduino.h>
+
+#define HPLC_SIM_CCO_ADDRESS {0x00, 0x13, 0xd7, 0x63, 0x22, 0x01} // CCO的载波地址 (与STA固件的默认目标地址相同)
+#define HPLC_SIM_BAUD 115200                                      // 模块串口波特率 (8E1，每字节11位)
+#define HPLC_SIM_COMMAND_WINDOW_MS 5000                           // 同一命令的重发窗口 (超过后未应答记为失败)
+#define HPLC_SIM_ALL_COMMANDS -1                                  // 统计所有控制码的命令
+
+// 定义[模拟器配置]类型
+typedef struct
+{
+    const char *stationImage; // STA镜像路径
+    uint16_t stationCount;    // STA数量
+    uint32_t latencyMinMs;    // 节点单向时延区间 (毫秒)
+    uint32_t latencyMaxMs;
+    uint32_t jitterMinMs;     // 节点抖动区间 (毫秒)
+    uint32_t jitterMaxMs;
+    float lossMin;            // 节点丢包率区间 (每个包每经过一个节点独立丢弃)
+    float lossMax;
+    uint32_t atReplyMs;       // 模块应答AT查询的时延 (毫秒)
+    uint32_t stationLoopMs;   // STA固件 loop() 的执行间隔 (毫秒)
+    uint32_t seed;            // 随机种子
+} HplcSimConfig;
+
+// 定义[模拟器计数]类型
+typedef struct
+{
+    uint32_t framesSent;       // 写往模块的 AT+SEND 帧
+    uint32_t framesDelivered;  // 送达目标的帧
+    uint32_t framesLost;       // 被丢弃的帧
+    uint32_t framesUnroutable; // 目标地址不在网络中的帧
+    uint32_t atQueries;        // AT+TOPONUM? 和 AT+TOPOINFO 查询
+    uint32_t topoRows;         // 回复的拓扑信息行
+    uint32_t imageBytes;       // 每份STA镜像的大小 (字节)
+    uint32_t sweeps;           // CCO完成的监控周期 (相邻两次 AT+TOPONUM? 查询之间为一个周期)
+    uint64_t sweepSumUs;       // 监控周期的总耗时 (含监控间隔，微秒)
+    uint64_t sweepMaxUs;       // 最长的监控周期
+    uint64_t sweepLastUs;      // 最近一个监控周期
+} HplcSimStats;
+
+// 定义[命令时延统计]类型: CCO第一次发出命令到收到该STA的应答帧 (含重发)
+typedef struct
+{
+    uint32_t count;  // 已应答的命令
+    uint32_t failed; // 重发窗口内未应答的命令
+    uint32_t p50Us;  // 时延分位数 (微秒)
+    uint32_t p95Us;
+    uint32_t p99Us;
+    uint32_t maxUs;
+} HplcSimLatency;
+
+/**
+ * @brief 按环境变量填写配置，未设置的项使用默认值
+ * @details SIM_STATIONS、SIM_LATENCY_MS (如 "20-80")、SIM_JITTER_MS、SIM_LOSS (如 "0-0.02")、SIM_AT_REPLY_MS、
+ *          SIM_STA_LOOP_MS、SIM_SEED、HPLC_SIM_STATION_IMAGE
+ * @param config 输出: 配置
+ */
+void HPLC_SIM_config_from_env(HplcSimConfig &config);
+
+/**
+ * @brief 加载STA镜像并启动模拟的载波网络
+ * @details 在任务中调用 (通常是测试的 loopTask)，此后 Serial2 接到模拟的载波模块。
+ *          每个STA加载一份独立的镜像副本并立即启动，之后在虚拟时钟推进时执行 setup()
+ * @param config 配置
+ * @return true 启动成功
+ * @return false 镜像加载失败 (原因输出到标准错误)
+ */
+bool HPLC_SIM_init(const HplcSimConfig &config);
+
+/**
+ * @brief 等待全部STA执行完 setup()
+ * @param timeout_ms 等待上限 (毫秒，虚拟时间)
+ * @return true 全部STA已就绪
+ * @return false 超时
+ */
+bool HPLC_SIM_wait_stations(uint32_t timeout_ms);
+
+/**
+ * @brief 读取STA的MAC地址
+ * @param index STA序号 (0 ~ stationCount-1，与拓扑信息的顺序相同)
+ * @param macAddress 输出: MAC地址
+ */
+void HPLC_SIM_station_address(uint16_t index, uint8_t macAddress[6]);
+
+/**
+ * @brief 读取STA的插孔继电器状态
+ * @param index STA序号
+ * @param socket 插孔ID (1 - 3)
+ * @return uint8_t 继电器状态 (0 断开, 1 吸合)
+ */
+uint8_t HPLC_SIM_station_socket_state(uint16_t index, uint8_t socket);
+
+/**
+ * @brief 读取模拟器计数
+ * @param stats 输出: 计数
+ */
+void HPLC_SIM_get_stats(HplcSimStats &stats);
+
+/**
+ * @brief 统计命令时延
+ * @param ctrl_code 命令的控制码 (HPLC_SIM_ALL_COMMANDS 统计所有命令)
+ * @param latency 输出: 时延统计
+ */
+void HPLC_SIM_command_latency(int ctrl_code, HplcSimLatency &latency);
+
+#endif
\ No newline at end of file
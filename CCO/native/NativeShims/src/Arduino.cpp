@@ -0,0 +1,87 @@
+#include <Arduino.h>
+#include <NativeShims.h>
+
+#define NATIVE_PIN_COUNT 49 // ESP32-S3 GPIO0~GPIO48
+
+static uint8_t pinModes[NATIVE_PIN_COUNT];
+static uint8_t pinLevels[NATIVE_PIN_COUNT];
+
+// 与 ESP32 一样按32位回绕
+unsigned long millis(void)
+{
+    return (uint32_t)(native_time_us() / 1000);
+}
+
+unsigned long micros(void)
+{
+    return (uint32_t)native_time_us();
+}
+
+void delay(uint32_t ms)
+{
+    vTaskDelay(pdMS_TO_TICKS(ms));
+}
+
+// 忙等待: 当前任务占用CPU推进虚拟时间，不让出
+void delayMicroseconds(uint32_t us)
+{
+    native_advance_time_us(us);
+}
+
+void yield(void)
+{
+    taskYIELD();
+}
+
+void pinMode(uint8_t pin, uint8_t mode)
+{
+    if (pin < NATIVE_PIN_COUNT)
+    {
+        pinModes[pin] = mode;
+    }
+}
+
+void digitalWrite(uint8_t pin, uint8_t val)
+{
+    if (pin < NATIVE_PIN_COUNT && pinModes[pin] == OUTPUT)
+    {
+        pinLevels[pin] = val ? HIGH : LOW;
+    }
+}
+
+int digitalRead(uint8_t pin)
+{
+    return pin < NATIVE_PIN_COUNT ? pinLevels[pin] : LOW;
+}
+
+bool psramFound(void)
+{
+    return true;
+}
+
+void *ps_malloc(size_t size)
+{
+    return malloc(size);
+}
+
+void *ps_calloc(size_t n, size_t size)
+{
+    return calloc(n, size);
+}
+
+void *heap_caps_malloc(size_t size, uint32_t caps)
+{
+    (void)caps;
+    return malloc(size);
+}
+
+void *heap_caps_calloc(size_t n, size_t size, uint32_t caps)
+{
+    (void)caps;
+    return calloc(n, size);
+}
+
+void heap_caps_free(void *ptr)
+{
+    free(ptr);
+}
\ No newline at end of file
@@ -0,0 +1,159 @@
+#include "HardwareSerial.h"
+
+#include <Arduino.h>
+#include <NativeShims.h>
+
+HardwareSerial Serial(0);
+HardwareSerial Serial1(1);
+HardwareSerial Serial2(2);
+
+HardwareSerial::HardwareSerial(uint8_t uartNum)
+    : uartNum(uartNum), currentBaud(0), started(false), echo(uartNum == 0), txHook(NULL), txHookContext(NULL)
+{
+}
+
+void HardwareSerial::begin(unsigned long baud, uint32_t config, int8_t rxPin, int8_t txPin, bool invert, unsigned long timeoutMs, uint8_t rxfifoFullThrhd)
+{
+    (void)config;
+    (void)rxPin;
+    (void)txPin;
+    (void)invert;
+    (void)timeoutMs;
+    (void)rxfifoFullThrhd;
+    currentBaud = baud;
+    started = true;
+}
+
+void HardwareSerial::end(void)
+{
+    started = false;
+    rx.clear();
+    onReceiveCb = NULL;
+}
+
+void HardwareSerial::onReceive(OnReceiveCb function, bool onlyOnTimeout)
+{
+    (void)onlyOnTimeout;
+    onReceiveCb = function;
+}
+
+int HardwareSerial::peek(void)
+{
+    return rx.empty() ? -1 : rx.front();
+}
+
+int HardwareSerial::read(void)
+{
+    if (rx.empty())
+    {
+        return -1;
+    }
+    uint8_t c = rx.front();
+    rx.pop_front();
+    return c;
+}
+
+size_t HardwareSerial::read(uint8_t *buffer, size_t size)
+{
+    size_t count = 0;
+    while (count < size && !rx.empty())
+    {
+        buffer[count++] = rx.front();
+        rx.pop_front();
+    }
+    return count;
+}
+
+/**
+ * @brief 读取指定数量的字节，不足时按虚拟时间阻塞等待到超时
+ * @param buffer 接收缓冲区
+ * @param length 期望读取的字节数
+ * @return size_t 实际读取的字节数
+ */
+size_t HardwareSerial::readBytes(uint8_t *buffer, size_t length)
+{
+    uint64_t deadlineUs = native_time_us() + (uint64_t)_timeout * 1000;
+    size_t count = 0;
+    while (count < length)
+    {
+        if (rx.empty())
+        {
+            if (!native_wait(&rx, deadlineUs) && rx.empty())
+            {
+                break;
+            }
+            continue;
+        }
+        buffer[count++] = rx.front();
+        rx.pop_front();
+    }
+    return count;
+}
+
+size_t HardwareSerial::write(const uint8_t *buffer, size_t size)
+{
+    if (echo)
+    {
+        fwrite(buffer, 1, size, stdout);
+    }
+    if (txHook != NULL)
+    {
+        txHook(*this, buffer, size, txHookContext);
+    }
+    else if (!echo)
+    {
+        tx.insert(tx.end(), buffer, buffer + size);
+    }
+    return size;
+}
+
+/**
+ * @brief 向接收管道注入字节 (相当于对端发来数据)
+ * @param data 数据
+ * @param length 数据长度
+ */
+void HardwareSerial::native_inject(const uint8_t *data, size_t length)
+{
+    if (length == 0)
+    {
+        return;
+    }
+    rx.insert(rx.end(), data, data + length);
+    if (onReceiveCb)
+    {
+        onReceiveCb();
+    }
+    native_notify(&rx);
+}
+
+void HardwareSerial::native_inject(const char *text)
+{
+    native_inject((const uint8_t *)text, strlen(text));
+}
+
+size_t HardwareSerial::native_take_tx(uint8_t *buffer, size_t size)
+{
+    size_t count = size < tx.size() ? size : tx.size();
+    memcpy(buffer, tx.data(), count);
+    tx.erase(tx.begin(), tx.begin() + count);
+    return count;
+}
+
+std::vector<uint8_t> HardwareSerial::native_take_tx(void)
+{
+    std::vector<uint8_t> taken;
+    taken.swap(tx);
+    return taken;
+}
+
+void HardwareSerial::native_clear(void)
+{
+    rx.clear();
+    tx.clear();
+}
+
+void HardwareSerial::native_set_tx_hook(NativeSerialTxHook hook, void *context)
+{
+    txHook = hook;
+    txHookContext = context;
+}
\ No newline at end of file
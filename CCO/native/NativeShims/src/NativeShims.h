@@ -0,0 +1,54 @@
+#ifndef NATIVE_SHIMS_H
+#define NATIVE_SHIMS_H
+
+/*
+ * native 仿真层的测试接口 (只在 native 环境中存在)
+ * - 虚拟时钟: 读取和推进
+ * - 等待/唤醒: 仿真外设 (串口、模拟器) 用来阻塞任务
+ * - 存储: 清空 Preferences
+ */
+
+#include <stdint.h>
+
+#define NATIVE_WAIT_FOREVER UINT64_MAX // 不超时
+
+/**
+ * @brief 读取虚拟时钟 (微秒)
+ * @return uint64_t 当前虚拟时间
+ */
+uint64_t native_time_us(void);
+
+/**
+ * @brief 推进虚拟时钟，相当于当前任务占用CPU这么久 (到期的任务随即就绪)
+ * @param us 推进的微秒数
+ */
+void native_advance_time_us(uint64_t us);
+
+/**
+ * @brief 阻塞当前任务，直到 native_notify(object) 或虚拟时间到达 deadlineUs
+ * @param object 等待对象 (任意地址，只作标识)
+ * @param deadlineUs 截止时间 (NATIVE_WAIT_FOREVER 不超时)
+ * @return true 被唤醒
+ * @return false 超时 (deadlineUs 已过时立即返回)
+ */
+bool native_wait(const void *object, uint64_t deadlineUs);
+
+/**
+ * @brief 唤醒所有在 object 上等待的任务 (优先级更高时立即切换过去)
+ * @param object 等待对象
+ */
+void native_notify(const void *object);
+
+/**
+ * @brief 读取任务数量和所有任务声明的栈大小之和 (模拟器统计内存使用)
+ * @param stackBytes 输出: 栈大小之和 (字节)
+ * @return uint32_t 任务数量
+ */
+uint32_t native_task_usage(uint32_t *stackBytes);
+
+/**
+ * @brief 清空 Preferences 的全部命名空间
+ */
+void native_preferences_reset(void);
+
+#endif
\ No newline at end of file
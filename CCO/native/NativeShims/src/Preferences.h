@@ -0,0 +1,45 @@
+#ifndef NATIVE_PREFERENCES_H
+#define NATIVE_PREFERENCES_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+
+#include "WString.h"
+
+/*
+ * Preferences (NVS) 的 native 仿真: 进程内的 map
+ * - 命名空间和键名最长15字符，字符串最长3999字节 (与 NVS 一致)
+ * - 只读打开时写入失败；字节和字符串类型不互通
+ * - 所有实例共享同一份存储，native_preferences_reset() 清空
+ */
+class Preferences
+{
+public:
+    Preferences();
+    ~Preferences();
+
+    bool begin(const char *name, bool readOnly = false, const char *partition_label = NULL);
+    void end();
+
+    bool clear();
+    bool remove(const char *key);
+    bool isKey(const char *key);
+
+    size_t putBytes(const char *key, const void *value, size_t len);
+    size_t getBytes(const char *key, void *buf, size_t maxLen);
+    size_t getBytesLength(const char *key);
+
+    size_t putString(const char *key, const char *value);
+    size_t putString(const char *key, String value);
+    size_t getString(const char *key, char *value, size_t maxLen);
+    String getString(const char *key, String defaultValue = String());
+
+private:
+    bool writable(const char *key);
+    bool started;
+    bool readOnly;
+    std::string name;
+};
+
+#endif
\ No newline at end of file
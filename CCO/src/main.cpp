@@ -4,67 +4,169 @@
 #include <TJC.h>
 #include <PowerStrip.h>
 #include <BLRegConv.h>
+#include <Telemetry.h>
+#include <Protocol.h>
+#include <Metrics.h>
+#include <Log.h>
+#include <Profiler.h>
+#include <MpscQueue.h>
 
 // STA监控间隔 (毫秒)
 #define STA_MONITOR_INTERVAL_MS 10000
 
+// [排插控制页面]功率曲线控件名称 (通道0-2对应插孔1-3)
+#define WAVEFORM_CONTROL "s0"
+// 功率曲线满量程 (mW)，对应曲线控件的最大值255
+#define WAVEFORM_FULL_SCALE_MW 2500000
+// 每个通道累积多少个数据点后批量推送一次
+#define WAVEFORM_PUSH_BLOCK 8
+
+// [主页面]每页显示的排插按钮数量
+#define HOME_SLOT_COUNT 3
+
+// [诊断页面]刷新间隔 (毫秒)
+#define DIAG_REFRESH_INTERVAL_MS 1000
+
+// [排插控制页面]请求/结果队列容量 (必须是2的幂)
+#define CONTROL_JOB_QUEUE_SIZE 8
+// [排插控制页面]进入页面时每个插孔每个汇总层级拉取的条数
+#define CONTROL_ROLLUP_FETCH_COUNT 4
+
+// 定义[排插控制页面请求类型]
+typedef enum
+{
+    CONTROL_JOB_ENTER_PAGE,       // 进入页面 (开启推送并拉取电能和汇总)
+    CONTROL_JOB_LEAVE_PAGE,       // 离开页面 (关闭推送)
+    CONTROL_JOB_SET_SOCKET_STATE, // 设置插孔开关状态
+    CONTROL_JOB_SET_MAX_POWER,    // 设置插孔最大功率
+} ControlJobType;
+
+// 定义[排插控制页面请求]: 需要等待STA应答的操作由 loop() 交给STA监控任务执行
+typedef struct
+{
+    uint8_t macAddress[6]; // 目标STA的MAC地址
+    ControlJobType type;   // 请求类型
+    uint8_t socketId;      // 插孔ID (设置插孔时有效)
+    uint16_t value;        // 开关状态或最大功率 (设置插孔时有效)
+} ControlPageJob;
+
+// 定义[排插控制页面结果]: STA监控任务执行完请求后交回 loop() 显示 (离开页面没有结果)
+typedef struct
+{
+    uint8_t macAddress[6]; // 目标STA的MAC地址
+    ControlJobType type;   // 请求类型
+    uint8_t socketId;      // 插孔ID (设置插孔时有效)
+    uint16_t value;        // 开关状态或最大功率 (设置插孔时有效)
+    bool success;          // 进入页面: 是否成功开启推送；设置插孔: STA是否应答
+    bool energyValid;      // 是否取到累计电能 (进入页面时有效)
+    uint32_t energyWh[3];  // 各插孔累计电能 (Wh)
+} ControlPageResult;
+
 // 目标通讯地址
 uint8_t TARGET_ADDRESS[6] = {0x00, 0x13, 0xd7, 0x63, 0x22, 0x03};
 // 当前页面对应的STA的MAC地址
 uint8_t currMacAddr[6];
+// [主页面]当前页码 (从0开始，仅在loop()中访问)
+size_t homePageIndex = 0;
+// STA监控任务是否请求刷新[主页面] (由 loop() 执行刷新)
+bool homePageRefreshRequested = false;
+// 等待推送到功率曲线的数据点 (仅在loop()中访问)
+uint8_t waveformPending[3][WAVEFORM_PUSH_BLOCK];
+// 各通道等待推送的数据点个数
+uint8_t waveformPendingCount[3];
+// 是否正在显示[诊断页面] (仅在loop()中访问)
+bool diagPageActive = false;
+// [诊断页面]上次刷新时间
+uint32_t diagRefreshedAt = 0;
+// loop() -> STA监控任务: [排插控制页面]请求
+MpscQueue<ControlPageJob, CONTROL_JOB_QUEUE_SIZE> controlJobQueue;
+// STA监控任务 -> loop(): [排插控制页面]结果
+MpscQueue<ControlPageResult, CONTROL_JOB_QUEUE_SIZE> controlResultQueue;
 
 // STA监控任务的任务句柄
 TaskHandle_t staMonitorTaskHandle = NULL;
-
-// TJC串口访问互斥锁
-SemaphoreHandle_t tjcMutex;
-// HPLC串口访问互斥锁
-SemaphoreHandle_t hplcMutex;
+// loop() 的耗时统计ID
+int8_t mainLoopProfile = -1;
 
 void monitorSTADevicesTask(void *pvParameters);
-void TJC_handle_valid_frame(FrameParser frameParser);
-void HPLC_handle_valid_frame(FrameParser frameParser);
+void tjc_handle_test_topo_num(const FrameView &frame);
+void tjc_handle_test_topo_info(const FrameView &frame);
+void tjc_handle_goto_wifi(const FrameView &frame);
+void tjc_handle_goto_control(const FrameView &frame);
+void tjc_handle_home_next_page(const FrameView &frame);
+void tjc_handle_home_prev_page(const FrameView &frame);
+void tjc_handle_goto_diag(const FrameView &frame);
+void tjc_handle_set_wifi_ssid(const FrameView &frame);
+void tjc_handle_set_wifi_password(const FrameView &frame);
+void tjc_handle_wifi_setting_back(const FrameView &frame);
+void tjc_handle_wifi_disconnect(const FrameView &frame);
+void tjc_handle_wifi_info_back(const FrameView &frame);
+void tjc_handle_set_strip_name(const FrameView &frame);
+void tjc_handle_set_socket_state(const FrameView &frame);
+void tjc_handle_set_max_power(const FrameView &frame);
+void tjc_handle_control_back(const FrameView &frame);
+void tjc_handle_diag_back(const FrameView &frame);
+void tjc_handle_diag_reset(const FrameView &frame);
+void hplc_handle_heart_beat(const FrameView &frame);
+void hplc_handle_power_exceed(const FrameView &frame);
+void hplc_handle_current_report(const FrameView &frame);
+void hplc_handle_power_report(const FrameView &frame);
+void push_pending_waveform();
+void refresh_home_page();
+void refresh_diag_page();
+void return_to_home_page();
+bool queue_control_page_job(const uint8_t macAddress[6], ControlJobType type, uint8_t socketId = 0, uint16_t value = 0);
+void serve_control_page_jobs();
+void apply_socket_result(const ControlPageResult &result);
+void apply_control_page_results();
 
 void setup()
 {
     // 初始化串口监视器
     Serial.begin(115200, SERIAL_8N1);
+    // 启动日志任务 (热路径上的日志由该任务延迟输出)
+    LOG_init();
+    // 启动剖析任务 (任务CPU占用和堆栈余量随 "metrics" 命令输出)
+    PROFILER_init();
+    mainLoopProfile = PROFILER_register_loop("loop");
 
     // 初始化串口屏
     TJC_init();
+    // 注册串口屏控制码处理函数
+    TJC_register_handler(0x01, tjc_handle_test_topo_num, TJC_LEN_ANY);
+    TJC_register_handler(0x02, tjc_handle_test_topo_info, TJC_LEN_ANY);
+    TJC_register_handler(0x11, tjc_handle_goto_wifi, TJC_LEN_ANY);
+    TJC_register_handler(0x12, tjc_handle_goto_control, 6);      // MAC地址
+    TJC_register_handler(0x13, tjc_handle_home_next_page, TJC_LEN_ANY);
+    TJC_register_handler(0x14, tjc_handle_home_prev_page, TJC_LEN_ANY);
+    TJC_register_handler(0x15, tjc_handle_goto_diag, TJC_LEN_ANY);
+    TJC_register_handler(0x21, tjc_handle_set_wifi_ssid, TJC_LEN_ANY);
+    TJC_register_handler(0x22, tjc_handle_set_wifi_password, TJC_LEN_ANY);
+    TJC_register_handler(0x23, tjc_handle_wifi_setting_back, TJC_LEN_ANY);
+    TJC_register_handler(0x31, tjc_handle_wifi_disconnect, TJC_LEN_ANY);
+    TJC_register_handler(0x32, tjc_handle_wifi_info_back, TJC_LEN_ANY);
+    TJC_register_handler(0x41, tjc_handle_set_strip_name, TJC_LEN_ANY); // MAC地址 + 名称 (变长)
+    TJC_register_handler(0x42, tjc_handle_set_socket_state, 8);  // MAC地址 + 插孔ID + 开关状态
+    TJC_register_handler(0x43, tjc_handle_set_max_power, 9);     // MAC地址 + 插孔ID + 最大功率
+    TJC_register_handler(0x44, tjc_handle_control_back, TJC_LEN_ANY);
+    TJC_register_handler(0x51, tjc_handle_diag_back, TJC_LEN_ANY);
+    TJC_register_handler(0x52, tjc_handle_diag_reset, TJC_LEN_ANY);
 
     // 初始化载波模块串口
     HPLC_init();
+    // 注册HPLC控制码处理函数
+    HPLC_register_message<MsgHeartBeat>(hplc_handle_heart_beat);
+    HPLC_register_message<MsgPowerExceed>(hplc_handle_power_exceed);
+    HPLC_register_message<MsgCurrentReport>(hplc_handle_current_report);
+    HPLC_register_message<MsgPowerReport>(hplc_handle_power_report);
 
     // 初始化排插管理器并加载数据
     PowerStrip_init();
 
-    // 创建TJC串口访问互斥锁
-    tjcMutex = xSemaphoreCreateMutex();
-    if (tjcMutex == NULL)
+    // 初始化遥测数据存储
+    if (!TELEMETRY_init())
     {
-        Serial.println("初始化 -> TJC互斥锁创建失败");
-        // 挂起
-        while (1)
-            ;
-    }
-    else
-    {
-        Serial.println("初始化 -> TJC互斥锁创建成功");
-    }
-
-    // 创建HPLC串口访问互斥锁
-    hplcMutex = xSemaphoreCreateMutex();
-    if (hplcMutex == NULL)
-    {
-        Serial.println("初始化 -> HPLC互斥锁创建失败");
-        // 挂起
-        while (1)
-            ;
-    }
-    else
-    {
-        Serial.println("初始化 -> HPLC互斥锁创建成功");
+        Serial.println("初始化 -> 遥测数据存储初始化失败");
     }
 
     // ESP32-S3：核心0 (PRO_CPU) 和核心1 (APP_CPU)【Arduino 的 loop 函数在核心1上运行】
@@ -90,33 +192,169 @@ void setup()
 
 void loop()
 {
-    // TJC触摸屏信息交互
-    // 尝试获取HPLC互斥锁，设置一个较短的超时时间以避免loop()长时间阻塞
-    if (xSemaphoreTake(tjcMutex, (TickType_t)10) == pdTRUE)
+    // 记录本次迭代的起始时间
+    uint32_t loopStart = micros();
+
+    // TJC触摸屏信息交互 (分发串口任务已解析的帧，命令交给串口任务写出)
+    TJC_poll(TJC_dispatch_frame);
+    // 批量推送累积的功率曲线数据点
+    push_pending_waveform();
+    // 显示STA监控任务交回的[排插控制页面]结果
+    apply_control_page_results();
+    // STA监控任务请求刷新[主页面]
+    if (__atomic_exchange_n(&homePageRefreshRequested, false, __ATOMIC_ACQ_REL))
     {
-        while (TJC.available())
+        refresh_home_page();
+    }
+    // 定时刷新[诊断页面]
+    if (diagPageActive && millis() - diagRefreshedAt >= DIAG_REFRESH_INTERVAL_MS)
+    {
+        refresh_diag_page();
+    }
+
+    // 载波模块信息交互 (分发串口任务已解析的帧，不会被STA监控任务的请求阻塞)
+    HPLC_poll(HPLC_dispatch_frame);
+
+    // 串口监视器命令 ("metrics" 输出链路指标)
+    METRICS_handle_serial();
+
+    PROFILER_record_loop(mainLoopProfile, micros() - loopStart);
+}
+
+/**
+ * @brief 将功率换算为功率曲线的数据点
+ * @param power_mw 功率 (mW)
+ * @return uint8_t 数据点 (0 - 255)
+ */
+uint8_t power_to_waveform_point(uint32_t power_mw)
+{
+    if (power_mw >= WAVEFORM_FULL_SCALE_MW)
+    {
+        return 255;
+    }
+    return (uint8_t)((uint64_t)power_mw * 255 / WAVEFORM_FULL_SCALE_MW);
+}
+
+/**
+ * @brief 将累积满一块的功率曲线数据点批量推送到串口屏
+ * @details 在 loop() 中调用，数据点拷贝到串口任务的发送队列后立即返回，不等待屏幕应答
+ */
+void push_pending_waveform()
+{
+    for (int i = 0; i < 3; i++)
+    {
+        if (waveformPendingCount[i] < WAVEFORM_PUSH_BLOCK)
         {
-            byte data = TJC.read();
-            // print_to_serial_monitor("TJC", data);
-            TJC_process_frame(data, TJC_handle_valid_frame);
+            continue;
         }
-        // 释放TJC互斥锁
-        xSemaphoreGive(tjcMutex);
+        // 无论能否入队都丢弃这一块，避免屏幕无应答时反复重试 (透传失败计入指标)
+        uint8_t count = waveformPendingCount[i];
+        waveformPendingCount[i] = 0;
+        TJC_waveform_add(WAVEFORM_CONTROL, i, waveformPending[i], count);
+    }
+}
+
+/**
+ * @brief 刷新[主页面]当前页的排插按钮
+ * @details 只从内存中的排插列表读取当前页的排插，且只推送这一页的控件属性，
+ *          所有命令合并为一次串口写入。在 loop() 中调用
+ */
+void refresh_home_page()
+{
+    size_t total = PowerStrip_count_online();
+    size_t pageCount = total == 0 ? 1 : (total + HOME_SLOT_COUNT - 1) / HOME_SLOT_COUNT;
+    // 排插下线后总页数可能减少
+    if (homePageIndex >= pageCount)
+    {
+        homePageIndex = pageCount - 1;
     }
 
-    // 载波模块信息交互
-    // 尝试获取HPLC互斥锁，设置一个较短的超时时间以避免loop()长时间阻塞
-    if (xSemaphoreTake(hplcMutex, (TickType_t)10) == pdTRUE)
+    PowerStrip window[HOME_SLOT_COUNT];
+    size_t count = PowerStrip_get_online_range(homePageIndex * HOME_SLOT_COUNT, window, HOME_SLOT_COUNT);
+
+    // 本次刷新的所有命令合并为一次串口写入
+    TJC_batch_begin();
+    // 控件名称缓冲区
+    char controlName[16];
+    for (size_t i = 0; i < HOME_SLOT_COUNT; i++)
     {
-        while (HPLC.available())
+        // TJC串口屏主页按钮下标从1开始
+        int slot = i + 1;
+        if (i < count)
+        {
+            LOG_DEBUG("主页面 -> 显示STA -> " LOG_MAC_FORMAT, LOG_MAC_ARGS(window[i].macAddress));
+
+            // 显示按钮
+            snprintf(controlName, sizeof(controlName), "p%d", slot);
+            TJC_set_property("Home", controlName, "y", "95");
+            snprintf(controlName, sizeof(controlName), "sname%d", slot);
+            TJC_set_property("Home", controlName, "y", "105");
+            TJC_set_property("Home", controlName, "txt", window[i].name);
+            snprintf(controlName, sizeof(controlName), "ps%d", slot);
+            TJC_set_property("Home", controlName, "y", "130");
+            snprintf(controlName, sizeof(controlName), "pmac%d", slot);
+            TJC_set_property("Home", controlName, "txt", mac_to_string(window[i].macAddress));
+        }
+        else
         {
-            byte data = HPLC.read();
-            // print_to_serial_monitor("HPLC", data);
-            HPLC_process_frame(data, HPLC_handle_valid_frame);
+            // 隐藏按钮
+            snprintf(controlName, sizeof(controlName), "p%d", slot);
+            TJC_set_property("Home", controlName, "y", "295");
+            snprintf(controlName, sizeof(controlName), "sname%d", slot);
+            TJC_set_property("Home", controlName, "y", "305");
+            TJC_set_property("Home", controlName, "txt", "排插");
+            snprintf(controlName, sizeof(controlName), "ps%d", slot);
+            TJC_set_property("Home", controlName, "y", "330");
+            snprintf(controlName, sizeof(controlName), "pmac%d", slot);
+            TJC_set_property("Home", controlName, "txt", "");
         }
-        // 释放HPLC互斥锁
-        xSemaphoreGive(hplcMutex);
     }
+
+    // 显示页码
+    char pageText[16];
+    snprintf(pageText, sizeof(pageText), "%u/%u", (unsigned)(homePageIndex + 1), (unsigned)pageCount);
+    TJC_set_property("Home", "pg", "txt", pageText);
+
+    // 一次写出本次刷新的全部命令 (串口任务写出后记录整页刷新耗时和波特率)
+    TJC_batch_flush();
+    LOG_DEBUG("主页面 -> 第 %u/%u 页", (unsigned)(homePageIndex + 1), (unsigned)pageCount);
+}
+
+/**
+ * @brief 回到[主页面]后重新推送当前页的排插按钮
+ * @details 页面加载时串口屏会把控件恢复为默认值，影子表中记录的值已不再是屏幕上的值，
+ *          必须先作废[主页面]的影子值，否则未变化的属性会被跳过。在 loop() 中调用
+ */
+void return_to_home_page()
+{
+    TJC_invalidate_page("Home");
+    refresh_home_page();
+}
+
+/**
+ * @brief 刷新[诊断页面]的链路指标
+ * @details 所有命令合并为一次串口写入。在 loop() 中调用
+ */
+void refresh_diag_page()
+{
+    MetricsSnapshot snapshot;
+    METRICS_snapshot(snapshot);
+    diagRefreshedAt = millis();
+
+    char line[64];
+    TJC_batch_begin();
+    snprintf(line, sizeof(line), "发送 %u  接收 %u", snapshot.txFrames, snapshot.rxFrames);
+    TJC_set_property("Diag", "t0", "txt", line);
+    snprintf(line, sizeof(line), "校验错 %u  失步 %u", snapshot.counters[METRIC_HPLC_CHECKSUM_FAIL], snapshot.counters[METRIC_HPLC_RESYNC]);
+    TJC_set_property("Diag", "t1", "txt", line);
+    snprintf(line, sizeof(line), "重发 %u  超时 %u  失败 %u", snapshot.counters[METRIC_HPLC_RETRY], snapshot.counters[METRIC_HPLC_ACK_TIMEOUT], snapshot.counters[METRIC_HPLC_SEND_FAIL]);
+    TJC_set_property("Diag", "t2", "txt", line);
+    snprintf(line, sizeof(line), "RTT 中位 %ums  平均 %ums  最大 %ums", METRICS_rtt_median_ms(snapshot.rtt), snapshot.rtt.count ? snapshot.rtt.sumMs / snapshot.rtt.count : 0, snapshot.rtt.maxMs);
+    TJC_set_property("Diag", "t3", "txt", line);
+    snprintf(line, sizeof(line), "积压 HPLC %u/%u  TJC %u/%u", snapshot.queues[METRIC_QUEUE_HPLC_RX].current, snapshot.queues[METRIC_QUEUE_HPLC_RX].peak,
+             snapshot.queues[METRIC_QUEUE_TJC_RX].current, snapshot.queues[METRIC_QUEUE_TJC_RX].peak);
+    TJC_set_property("Diag", "t4", "txt", line);
+    TJC_batch_flush();
 }
 
 /**
@@ -125,522 +363,786 @@ void loop()
  */
 void monitorSTADevicesTask(void *pvParameters)
 {
-    Serial.printf("STA监控任务 -> 在核心 %d 上启动\n", xPortGetCoreID());
+    LOG_INFO("STA监控任务 -> 在核心 %d 上启动", xPortGetCoreID());
 
-    // STA设备MAC地址列表(3个设备，每个mac地址6字节)
-    uint8_t sta_mac_list[3][6];
+    // STA设备MAC地址列表(每个mac地址6字节)，较大，不放在任务栈上
+    static uint8_t sta_mac_list[STA_MAX_COUNT][6];
     // STA设备数量
-    uint8_t sta_count;
+    uint16_t sta_count;
+    // 本任务的耗时统计ID
+    int8_t profile = PROFILER_register_loop("STAMonitorTask");
 
     for (;;)
     {
-        // 尝试获取HPLC互斥锁
-        if (xSemaphoreTake(hplcMutex, portMAX_DELAY) == pdTRUE)
+        // 记录本次监控周期的起始时间
+        uint32_t cycleStart = micros();
+        // 查询拓扑和心跳检测只在每个请求期间占用HPLC，接收和分发不受影响
+        LOG_DEBUG("STA监控任务 -> 从CCO获取STA列表...");
+        if (HPLC_get_topo_sta_mac_list(sta_mac_list, STA_MAX_COUNT, &sta_count))
         {
-            Serial.println("STA监控任务PART1启动 -> 已获取HPLC互斥锁");
-
-            Serial.println("STA监控任务 -> 从CCO获取STA列表...");
-            if (HPLC_get_topo_sta_mac_list(sta_mac_list, &sta_count))
+            LOG_INFO("STA监控任务 -> 获取到 %d 个STA", sta_count);
+            // 将新的STA添加到PowerStrip管理器
+            for (int i = 0; i < sta_count; i++)
             {
-                Serial.printf("STA监控任务 -> 获取到 %d 个STA\n", sta_count);
-                // 将新的STA添加到PowerStrip管理器
-                for (int i = 0; i < sta_count; i++)
+                PowerStrip strip;
+                bool found = PowerStrip_get(sta_mac_list[i], strip);
+                if (!found)
                 {
-                    PowerStrip strip;
-                    bool found = PowerStrip_get(sta_mac_list[i], strip);
-                    if (!found)
+                    LOG_INFO("STA监控任务 -> 添加STA -> " LOG_MAC_FORMAT, LOG_MAC_ARGS(sta_mac_list[i]));
+
+                    // 创建新的PowerStrip对象
+                    PowerStrip newStrip;
+                    memcpy(newStrip.macAddress, sta_mac_list[i], 6);
+                    char default_name[20];
+                    sprintf(default_name, "排插_%d", i + 1);
+                    newStrip.name = String(default_name);
+                    for (int k = 0; k < 3; k++)
+                    {
+                        newStrip.sockets[k] = {false, 0};
+                    }
+                    newStrip.isOnline = false;
+
+                    // 添加到管理器
+                    if (PowerStrip_add(newStrip))
+                    {
+                        LOG_INFO("STA监控任务 -> 成功添加新的排插到管理器");
+                    }
+                    else
                     {
-                        Serial.print("STA监控任务 -> 添加STA -> ");
-                        for (int j = 0; j < 6; j++)
-                            Serial.printf("%02X%s", sta_mac_list[i][j], j < 5 ? ":" : "");
-                        Serial.println();
-
-                        // 创建新的PowerStrip对象
-                        PowerStrip newStrip;
-                        memcpy(newStrip.macAddress, sta_mac_list[i], 6);
-                        char default_name[20];
-                        sprintf(default_name, "排插_%d", i + 1);
-                        newStrip.name = String(default_name);
-                        for (int k = 0; k < 3; k++)
-                        {
-                            newStrip.sockets[k] = {false, 0};
-                        }
-                        newStrip.isOnline = false;
-
-                        // 添加到管理器
-                        if (PowerStrip_add(newStrip))
-                        {
-                            Serial.println("STA监控任务 -> 成功添加新的排插到管理器");
-                        }
-                        else
-                        {
-                            Serial.println("STA监控任务 -> 添加新的排插到管理器失败");
-                        }
+                        LOG_WARN("STA监控任务 -> 添加新的排插到管理器失败");
                     }
                 }
             }
-            else
+        }
+        else
+        {
+            LOG_WARN("STA监控任务 -> 从CCO获取STA列表失败");
+        }
+
+        // 对所有已管理的STA设备进行心跳检测
+        std::vector<PowerStrip> allStrips = PowerStrip_get_all();
+        LOG_DEBUG("STA监控任务 -> 开始对内存中的 %d 个排插进行心跳检测", allStrips.size());
+        for (PowerStrip &strip_instance : allStrips)
+        {
+            // 排插数量较多时心跳检测耗时较长，每检测一个排插前先执行 loop() 交来的请求
+            serve_control_page_jobs();
+            // 发送心跳包进行检测
+            bool is_currently_online = HPLC_send_heart_beat(strip_instance.macAddress);
+            LOG_DEBUG("STA监控任务 -> 检测STA -> " LOG_MAC_FORMAT " -- %s", LOG_MAC_ARGS(strip_instance.macAddress), is_currently_online ? "Online" : "Offline");
+
+            // 仅当状态发生变化时更新 (只改在线状态，不覆盖期间被修改的插孔信息)
+            if (strip_instance.isOnline != is_currently_online)
             {
-                Serial.println("STA监控任务 -> 从CCO获取STA列表失败");
+                PowerStrip_set_online(strip_instance.macAddress, is_currently_online);
             }
+        }
 
-            // 对所有已管理的STA设备进行心跳检测
-            std::vector<PowerStrip> allStrips = PowerStrip_get_all();
-            Serial.printf("STA监控任务 -> 开始对内存中的 %d 个排插进行心跳检测\n", allStrips.size());
-            for (PowerStrip &strip_instance : allStrips)
-            {
-                Serial.print("STA监控任务 -> 检测STA -> ");
-                for (int j = 0; j < 6; j++)
-                    Serial.printf("%02X%s", strip_instance.macAddress[j], j < 5 ? ":" : "");
-                Serial.println();
-
-                // 发送心跳包进行检测
-                bool is_currently_online = HPLC_send_heart_beat(strip_instance.macAddress);
-                if (is_currently_online)
-                {
-                    Serial.println(" -- Online");
-                }
-                else
-                {
-                    Serial.println(" -- Offline");
-                }
+        // 更新TJC触摸屏上的STA列表 (串口屏只由 loop() 操作，这里只发出刷新请求)
+        LOG_DEBUG("STA监控任务 -> 请求更新TJC触摸屏上的STA列表");
+        __atomic_store_n(&homePageRefreshRequested, true, __ATOMIC_RELEASE);
 
-                // 仅当状态发生变化时更新
-                if (strip_instance.isOnline != is_currently_online)
-                {
-                    strip_instance.isOnline = is_currently_online;
-                    PowerStrip_update(strip_instance);
-                }
-            }
+        PROFILER_record_loop(profile, micros() - cycleStart);
 
-            // 释放HPLC互斥锁
-            xSemaphoreGive(hplcMutex);
-            Serial.println("STA监控任务PART1结束 -> 已释放HPLC互斥锁");
+        // 等待10秒后再次执行，期间由 loop() 入队时的任务通知唤醒执行请求
+        uint32_t waitStart = millis();
+        uint32_t elapsed;
+        while ((elapsed = millis() - waitStart) < STA_MONITOR_INTERVAL_MS)
+        {
+            serve_control_page_jobs();
+            ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(STA_MONITOR_INTERVAL_MS - elapsed));
+        }
+    }
+}
+
+/**
+ * @brief 将[排插控制页面]请求交给STA监控任务
+ * @details 在 loop() 中调用，不等待STA应答
+ * @param macAddress 目标STA的MAC地址
+ * @param type 请求类型
+ * @param socketId 插孔ID (设置插孔时有效)
+ * @param value 开关状态或最大功率 (设置插孔时有效)
+ * @return true 入队成功
+ * @return false 队列已满
+ */
+bool queue_control_page_job(const uint8_t macAddress[6], ControlJobType type, uint8_t socketId, uint16_t value)
+{
+    ControlPageJob job;
+    memcpy(job.macAddress, macAddress, 6);
+    job.type = type;
+    job.socketId = socketId;
+    job.value = value;
+    if (!controlJobQueue.push(job))
+    {
+        LOG_WARN("排插控制页面 -> 请求队列已满，已取消");
+        return false;
+    }
+    // 唤醒STA监控任务 (正在等待HPLC应答时只会让它多检查一次)
+    if (staMonitorTaskHandle != NULL)
+    {
+        xTaskNotifyGive(staMonitorTaskHandle);
+    }
+    return true;
+}
+
+/**
+ * @brief 执行 loop() 交来的[排插控制页面]请求
+ * @details 在STA监控任务中调用，等待STA应答期间不占用 loop()，结果交回 loop() 显示
+ */
+void serve_control_page_jobs()
+{
+    ControlPageJob job;
+    while (controlJobQueue.pop(job))
+    {
+        ControlPageResult result;
+        memcpy(result.macAddress, job.macAddress, 6);
+        result.type = job.type;
+        result.socketId = job.socketId;
+        result.value = job.value;
+        result.energyValid = false;
+
+        if (job.type == CONTROL_JOB_SET_SOCKET_STATE)
+        {
+            // 设置STA插孔状态
+            uint8_t request[protocol_frame_size<MsgSetSocketState>()];
+            MsgSetSocketState &msg = protocol_encode<MsgSetSocketState>(request);
+            msg.socketId = job.socketId;    // 插孔ID
+            msg.state = (uint8_t)job.value; // 插孔状态
+            result.success = HPLC_send_frame(job.macAddress, request, sizeof(request), true);
+        }
+        else if (job.type == CONTROL_JOB_SET_MAX_POWER)
+        {
+            // 设置STA插孔最大功率
+            uint8_t request[protocol_frame_size<MsgSetMaxPower>()];
+            MsgSetMaxPower &msg = protocol_encode<MsgSetMaxPower>(request);
+            msg.socketId = job.socketId; // 插孔ID
+            msg.maxPower = job.value;    // 最大功率
+            result.success = HPLC_send_frame(job.macAddress, request, sizeof(request), true);
         }
         else
         {
-            Serial.println("STA监控任务 -> 获取HPLC互斥锁超时或失败");
-            // 获取互斥锁失败，等待100ms重试
-            vTaskDelay(pdMS_TO_TICKS(100));
+            // 设置STA推送开关的数据帧
+            uint8_t pushFrame[protocol_frame_size<MsgSetPush>()];
+            MsgSetPush &pushMsg = protocol_encode<MsgSetPush>(pushFrame);
+            pushMsg.enabled = job.type == CONTROL_JOB_ENTER_PAGE ? 0x01 : 0x00;
+            result.success = HPLC_send_frame(job.macAddress, pushFrame, sizeof(pushFrame), true);
+            if (job.type == CONTROL_JOB_LEAVE_PAGE)
+            {
+                // 离开页面只需关闭推送
+                continue;
+            }
         }
 
-        // 尝试获取TJC互斥锁
-        if (xSemaphoreTake(tjcMutex, portMAX_DELAY) == pdTRUE)
+        if (job.type == CONTROL_JOB_ENTER_PAGE && result.success)
         {
-            Serial.println("STA监控任务PART2启动 -> 已获取TJC互斥锁");
-            // 更新TJC触摸屏上的STA列表
-            Serial.println("STA监控任务 -> 更新TJC触摸屏上的STA列表...");
-            // TJC串口屏主页按钮下标
-            int i = 1;
-            // 遍历所有排插
-            std::vector<PowerStrip> allStrips = PowerStrip_get_all();
-            for (PowerStrip &strip_instance : allStrips)
+            // 查询各插孔累计电能
+            uint8_t energyQueryFrame[protocol_frame_size<MsgEnergyQuery>()];
+            protocol_encode<MsgEnergyQuery>(energyQueryFrame);
+            FrameParser energyResponse;
+            const MsgEnergyReply *energyReply = nullptr;
+            if (HPLC_send_request(job.macAddress, energyQueryFrame, sizeof(energyQueryFrame), energyResponse) && (energyReply = protocol_view<MsgEnergyReply>(frame_view(energyResponse))) != nullptr)
             {
-                Serial.print("STA监控任务 -> 处理STA -> ");
-                for (int j = 0; j < 6; j++)
-                    Serial.printf("%02X%s", strip_instance.macAddress[j], j < 5 ? ":" : "");
-                Serial.println();
-
-                if (strip_instance.isOnline)
+                // ACK只按控制码匹配，应答必须来自被查询的STA
+                if (memcmp(energyReply->macAddress, job.macAddress, 6) != 0)
                 {
-                    // 更新TJC触摸屏上的STA列表
-                    TJC_set_property("Home", (String("p") + i).c_str(), "y", "95");
-                    TJC_set_property("Home", (String("sname") + i).c_str(), "y", "105");
-                    TJC_set_property("Home", (String("ps") + i).c_str(), "y", "130");
-
-                    TJC_set_property("Home", (String("sname") + i).c_str(), "txt", strip_instance.name);
-                    TJC_set_property("Home", (String("pmac") + i).c_str(), "txt", mac_to_string(strip_instance.macAddress));
-
-                    i++;
+                    LOG_WARN("排插控制页面 -> 电能应答的MAC地址不符，已丢弃");
+                }
+                else
+                {
+                    for (int i = 0; i < 3; i++)
+                    {
+                        result.energyWh[i] = BL_energyPulses2WattHours(energyReply->pulses[i]);
+                        TELEMETRY_record_energy(job.macAddress, i + 1, result.energyWh[i]);
+                    }
+                    result.energyValid = true;
                 }
             }
 
-            // 如果小于3个排插，则隐藏后续按钮
-            while (i <= 3)
+            // 批量拉取各插孔最近的1分钟和15分钟汇总，供页面和导出直接从内存读取
+            for (int i = 0; i < 3; i++)
             {
-                // 隐藏按钮
-                TJC_set_property("Home", (String("p") + i).c_str(), "y", "295");
-                TJC_set_property("Home", (String("sname") + i).c_str(), "y", "305");
-                TJC_set_property("Home", (String("ps") + i).c_str(), "y", "330");
-
-                TJC_set_property("Home", (String("sname") + i).c_str(), "txt", "排插");
-                TJC_set_property("Home", (String("pmac") + i).c_str(), "txt", "");
-
-                i++;
+                TELEMETRY_fetch_rollups(job.macAddress, i + 1, HISTORY_TIER_MINUTE, CONTROL_ROLLUP_FETCH_COUNT);
+                TELEMETRY_fetch_rollups(job.macAddress, i + 1, HISTORY_TIER_QUARTER, CONTROL_ROLLUP_FETCH_COUNT);
             }
-
-            // 释放TJC互斥锁
-            xSemaphoreGive(tjcMutex);
-            Serial.println("STA监控任务PART2结束 -> 已释放TJC互斥锁");
         }
-        else
+        if (!controlResultQueue.push(result))
         {
-            Serial.println("STA监控任务 -> 获取TJC互斥锁超时或失败");
-            // 获取互斥锁失败，等待100ms重试
-            vTaskDelay(pdMS_TO_TICKS(100));
+            LOG_WARN("排插控制页面 -> 结果队列已满，已丢弃");
         }
-
-        // 等待10秒后再次执行
-        vTaskDelay(pdMS_TO_TICKS(STA_MONITOR_INTERVAL_MS));
     }
 }
 
 /**
- * TJC模块处理有效帧
+ * @brief 应用STA监控任务交回的设置插孔结果
+ * @details 在 loop() 中调用。STA应答后更新排插信息；未应答时回滚串口屏上用户已修改的控件。
+ *          用户已离开或切换到其它排插时只更新排插信息，不操作串口屏
+ * @param result 设置插孔开关状态或最大功率的结果
  */
-void TJC_handle_valid_frame(FrameParser frameParser)
+void apply_socket_result(const ControlPageResult &result)
 {
-    // Serial.println("HANDLE_VALID_FRAME:");
-    // for (int i = 0; i < frameParser.index; i++)
-    // {
-    //     print_to_serial_monitor("TJC", frameParser.buffer[i]);
-    // }
-    // Serial.println();
-
-    // 临时变量
-    uint8_t macAddr[6]; // MAC地址Buffer
-    PowerStrip strip;   // 排插对象Buffer
-    // 设置STA推送开关的数据帧
-    uint8_t pushFrame[3] = {
-        0x13, // 控制码
-        0x01, // 数据域长度
-        0x00  // 推送开关状态
-    };
-
-    // 提取关键字段
-    uint8_t ctrlCode = frameParser.buffer[5]; // 控制码
-    uint8_t dataLen = frameParser.buffer[6];  // 数据域长度
-
-    // 针对不同帧控制码执行不同操作
-    switch (ctrlCode)
-    {
-    case 0x01:
-        // 测试1
-        Serial.println("测试1-获取网络拓扑节点数量");
-        // HPLC.print("AT+TOPONUM?\r\n");
-        break;
-
-    case 0x02:
-        // 测试2
-        Serial.println("测试2-获取网络拓扑节点信息");
-        // HPLC.print("AT+TOPOINFO=0,4\r\n");
-        break;
-
-    case 0x11:
-        // 请求前往[Wifi设置/信息页面]
-        Serial.println("请求前往[Wifi设置/信息页面]");
-        TJC_goto_page("Wifi");
-        break;
-
-    case 0x12:
-        // 前往[排插控制页面]
-        Serial.println("前往[排插控制页面]");
-        // 提取MAC地址
-        for (int i = 0; i < 6; i++)
+    PowerStrip strip; // 排插对象Buffer
+    if (!PowerStrip_get(result.macAddress, strip))
+    {
+        return;
+    }
+    bool onPage = memcmp(result.macAddress, currMacAddr, 6) == 0;
+    uint8_t socketId = result.socketId;
+    if (result.type == CONTROL_JOB_SET_SOCKET_STATE)
+    {
+        bool socketState = result.value == 0x01;
+        String button = String("bt") + socketId;
+        if (result.success)
         {
-            macAddr[i] = frameParser.buffer[7 + i];
+            // 发送成功，更新插孔状态
+            strip.sockets[socketId - 1].state = socketState;
+            PowerStrip_update(strip);
+            LOG_INFO("MAC -> " LOG_MAC_FORMAT " | SOCKET_ID -> %d | STATE -> %s", LOG_MAC_ARGS(result.macAddress), socketId, socketState ? "ON" : "OFF");
         }
-        // 获取排插信息
-        if (PowerStrip_get(macAddr, strip))
+        if (!onPage)
         {
-            // 属性设置给TJC串口屏
-            TJC_set_property("Control", "mac", "txt", mac_to_string(strip.macAddress));
-            TJC_set_property("Control", "sname", "txt", strip.name);
-            TJC_set_property("Control", "bt1", "val", strip.sockets[0].state ? "1" : "0");
-            TJC_set_property("Control", "bt2", "val", strip.sockets[1].state ? "1" : "0");
-            TJC_set_property("Control", "bt3", "val", strip.sockets[2].state ? "1" : "0");
-            TJC_set_property("Control", "xz1", "val", String(strip.sockets[0].maxPower));
-            TJC_set_property("Control", "xz2", "val", String(strip.sockets[1].maxPower));
-            TJC_set_property("Control", "xz3", "val", String(strip.sockets[2].maxPower));
-            Serial.printf("MAC -> %s\n", mac_to_string(macAddr).c_str());
+            return;
         }
-        // 设置STA推送开关 - 开启
-        pushFrame[2] = 0x01;
-        // 发送帧
-        if (HPLC_send_frame(macAddr, pushFrame, sizeof(pushFrame), true))
+        // 按钮状态由串口屏自身修改，作废影子值
+        TJC_invalidate_property("Control", button.c_str(), "val");
+        if (result.success)
         {
-            // 发送成功，设置当前页面的STA的MAC地址
-            memcpy(currMacAddr, macAddr, 6);
+            // 更新串口屏显示内容
+            TJC_set_property("Control", (String("dl") + socketId).c_str(), "txt", "-"); // 电流显示为"-"
+            TJC_set_property("Control", (String("gl") + socketId).c_str(), "txt", "-"); // 功率显示为"-"
         }
         else
         {
-            // 发送失败，回滚串口屏，返回主页面
-            TJC_click("back", "0");
+            // 发送失败，回滚串口屏对应按钮状态
+            TJC_set_property("Control", button.c_str(), "val", strip.sockets[socketId - 1].state ? "1" : "0");
         }
-        break;
+        return;
+    }
 
-    case 0x21:
-        // 设置 Wifi SSID
-        Serial.println("设置 Wifi SSID");
-        for (int i = 0; i < dataLen; i++)
+    String control = String("xz") + socketId;
+    if (result.success)
+    {
+        // 发送成功，更新插孔最大功率
+        strip.sockets[socketId - 1].maxPower = result.value;
+        PowerStrip_update(strip);
+        LOG_INFO("MAC -> " LOG_MAC_FORMAT " | SOCKET_ID -> %d | MAX_POWER -> %d", LOG_MAC_ARGS(result.macAddress), socketId, result.value);
+    }
+    if (!onPage)
+    {
+        return;
+    }
+    // 功率设置由串口屏自身修改，作废影子值
+    TJC_invalidate_property("Control", control.c_str(), "val");
+    if (!result.success)
+    {
+        // 发送失败，回滚串口屏对应功率设置
+        TJC_set_property("Control", control.c_str(), "val", String(strip.sockets[socketId - 1].maxPower));
+    }
+}
+
+/**
+ * @brief 显示STA监控任务交回的[排插控制页面]结果
+ * @details 在 loop() 中调用，用户已离开或切换到其它排插时丢弃进入页面的结果
+ */
+void apply_control_page_results()
+{
+    ControlPageResult result;
+    while (controlResultQueue.pop(result))
+    {
+        if (result.type == CONTROL_JOB_SET_SOCKET_STATE || result.type == CONTROL_JOB_SET_MAX_POWER)
         {
-            print_to_serial_monitor("SSID", frameParser.buffer[7 + i]);
+            apply_socket_result(result);
+            continue;
         }
-        break;
-
-    case 0x22:
-        // 设置 Wifi 密码
-        Serial.println("设置 Wifi 密码");
-        for (int i = 0; i < dataLen; i++)
+        if (memcmp(result.macAddress, currMacAddr, 6) != 0)
         {
-            print_to_serial_monitor("PWD", frameParser.buffer[7 + i]);
+            continue;
         }
-        break;
-
-    case 0x23:
-        // 从[Wifi设置页面]回到[主页面]
-        Serial.println("从[Wifi设置页面]回到[主页面]");
-        break;
-
-    case 0x31:
-        // 断开 Wifi 连接，前往[Wifi设置页面]
-        Serial.println("断开 Wifi 连接，前往[Wifi设置页面]");
-        break;
-
-    case 0x32:
-        // 从[Wifi信息页面]回到[主页面]
-        Serial.println("从[Wifi信息页面]回到[主页面]");
-        break;
-
-    case 0x41:
-        // 设置排插名称
-        Serial.println("设置排插名称");
-        // 提取MAC地址
-        for (int i = 0; i < 6; i++)
+        if (!result.success)
         {
-            macAddr[i] = frameParser.buffer[7 + i];
+            // 开启推送失败，回滚串口屏，返回主页面
+            TJC_click("back", "0");
+            continue;
         }
-        // 获取排插信息
-        if (PowerStrip_get(macAddr, strip))
+        if (result.energyValid)
         {
-            // 提取名称
-            char nameBuffer[dataLen - 6 + 1];
-            for (int i = 0; i < dataLen - 6; i++)
+            // 显示各插孔累计电能 (kWh)
+            for (int i = 0; i < 3; i++)
             {
-                nameBuffer[i] = frameParser.buffer[13 + i];
+                TJC_set_property("Control", (String("dn") + (i + 1)).c_str(), "txt", String(result.energyWh[i] / 1000.0f, 3));
             }
-            nameBuffer[dataLen - 6] = '\0';
-            // 更新排插名称
-            strip.name = String(nameBuffer);
-            PowerStrip_update(strip);
-            Serial.printf("MAC -> %s | NAME -> %s\n", mac_to_string(macAddr).c_str(), strip.name.c_str());
         }
-        break;
+    }
+}
 
-    case 0x42:
-        // 设置指定插孔开关状态
-        Serial.println("设置指定插孔开关状态");
-        // 提取MAC地址
-        for (int i = 0; i < 6; i++)
-        {
-            macAddr[i] = frameParser.buffer[7 + i];
-        }
-        // 获取排插信息
-        if (PowerStrip_get(macAddr, strip))
+/**
+ * @brief 测试1
+ * @param frame 完整帧
+ */
+void tjc_handle_test_topo_num(const FrameView &frame)
+{
+    // 测试1
+    LOG_INFO("测试1-获取网络拓扑节点数量");
+    // HPLC.print("AT+TOPONUM?\r\n");
+}
+
+/**
+ * @brief 测试2
+ * @param frame 完整帧
+ */
+void tjc_handle_test_topo_info(const FrameView &frame)
+{
+    // 测试2
+    LOG_INFO("测试2-获取网络拓扑节点信息");
+    // HPLC.print("AT+TOPOINFO=0,4\r\n");
+}
+
+/**
+ * @brief 请求前往[Wifi设置/信息页面]
+ * @param frame 完整帧
+ */
+void tjc_handle_goto_wifi(const FrameView &frame)
+{
+    // 请求前往[Wifi设置/信息页面]
+    LOG_INFO("请求前往[Wifi设置/信息页面]");
+    TJC_invalidate_page("Wifi");
+    TJC_goto_page("Wifi");
+}
+
+/**
+ * @brief 前往[排插控制页面]
+ * @param frame 完整帧
+ */
+void tjc_handle_goto_control(const FrameView &frame)
+{
+    uint8_t macAddr[6]; // MAC地址Buffer
+    PowerStrip strip;   // 排插对象Buffer
+
+    // 前往[排插控制页面]
+    LOG_INFO("前往[排插控制页面]");
+    // 提取MAC地址
+    for (int i = 0; i < 6; i++)
+    {
+        macAddr[i] = frame.data[i];
+    }
+    // 获取排插信息
+    if (PowerStrip_get(macAddr, strip))
+    {
+        // 上次离开后用户可能在屏幕上修改过控件，作废该页面的影子值
+        TJC_invalidate_page("Control");
+        // 页面初始内容合并为一次串口写入
+        TJC_batch_begin();
+        // 属性设置给TJC串口屏
+        TJC_set_property("Control", "mac", "txt", mac_to_string(strip.macAddress));
+        TJC_set_property("Control", "sname", "txt", strip.name);
+        TJC_set_property("Control", "bt1", "val", strip.sockets[0].state ? "1" : "0");
+        TJC_set_property("Control", "bt2", "val", strip.sockets[1].state ? "1" : "0");
+        TJC_set_property("Control", "bt3", "val", strip.sockets[2].state ? "1" : "0");
+        TJC_set_property("Control", "xz1", "val", String(strip.sockets[0].maxPower));
+        TJC_set_property("Control", "xz2", "val", String(strip.sockets[1].maxPower));
+        TJC_set_property("Control", "xz3", "val", String(strip.sockets[2].maxPower));
+        // 先显示内存中已有的最新遥测值，无需等待新的推送
+        for (int i = 0; i < 3; i++)
         {
-            // 提取插孔ID和开关状态
-            uint8_t socketId = frameParser.buffer[13];
-            bool socketState = (frameParser.buffer[14] == 0x01);
-            // 设置STA插孔状态
-            uint8_t frame[4] = {
-                0x11,                  // 控制码
-                0x02,                  // 数据域长度
-                socketId,              // 插孔ID
-                frameParser.buffer[14] // 插孔状态
-            };
-            // 发送帧
-            if (HPLC_send_frame(macAddr, frame, sizeof(frame), true))
-            {
-                // 发送成功，更新插孔状态
-                strip.sockets[socketId - 1].state = socketState;
-                PowerStrip_update(strip);
-                // 更新串口屏显示内容
-                TJC_set_property("Control", (String("dl") + socketId).c_str(), "txt", "-"); // 电流显示为"-"
-                TJC_set_property("Control", (String("gl") + socketId).c_str(), "txt", "-"); // 功率显示为"-"
-                Serial.printf("MAC -> %s | SOCKET_ID -> %d | STATE -> %s\n", mac_to_string(macAddr).c_str(), socketId, socketState ? "ON" : "OFF");
-            }
-            else
+            TelemetryLatest latest;
+            if (TELEMETRY_get_latest(strip.macAddress, i + 1, latest) && latest.updatedAt != 0 && strip.sockets[i].state)
             {
-                // 发送失败，回滚串口屏对应按钮状态
-                TJC_set_property("Control", (String("bt") + socketId).c_str(), "val", strip.sockets[socketId - 1].state ? "1" : "0");
+                TJC_set_property("Control", (String("dl") + (i + 1)).c_str(), "txt", String(latest.currentMilliAmps / 1000.0f));
+                TJC_set_property("Control", (String("gl") + (i + 1)).c_str(), "txt", String(latest.powerMilliWatts / 1000.0f));
             }
         }
-        break;
-
-    case 0x43:
-        // 设置指定插孔最大功率
-        Serial.println("设置指定插孔最大功率");
-        // 提取MAC地址
-        for (int i = 0; i < 6; i++)
+        TJC_batch_flush();
+        // 用内存中已缓存的采样回填功率曲线
+        TJC_waveform_clear(WAVEFORM_CONTROL, 255);
+        for (int i = 0; i < 3; i++)
         {
-            macAddr[i] = frameParser.buffer[7 + i];
-        }
-        // 获取排插信息
-        if (PowerStrip_get(macAddr, strip))
-        {
-            // 提取插孔ID和最大功率
-            uint8_t socketId = frameParser.buffer[13];
-            uint8_t powerLowByte = frameParser.buffer[14];
-            uint8_t powerHighByte = frameParser.buffer[15];
-            uint16_t maxPower = (powerHighByte << 8) | powerLowByte;
-            // 设置STA插孔最大功率
-            uint8_t frame[5] = {
-                0x12,         // 控制码
-                0x03,         // 数据域长度
-                socketId,     // 插孔ID
-                powerLowByte, // 最大功率低字节
-                powerHighByte // 最大功率高字节
-            };
-            // 发送帧
-            if (HPLC_send_frame(macAddr, frame, sizeof(frame), true))
+            TelemetrySample samples[TELEMETRY_RECENT_CAPACITY];
+            uint8_t points[TELEMETRY_RECENT_CAPACITY];
+            uint16_t count = TELEMETRY_read_recent(strip.macAddress, i + 1, 0, samples, TELEMETRY_RECENT_CAPACITY);
+            // 采样按从新到旧排列，曲线需要从旧到新写入
+            for (uint16_t j = 0; j < count; j++)
             {
-                // 发送成功，更新插孔最大功率
-                strip.sockets[socketId - 1].maxPower = maxPower;
-                PowerStrip_update(strip);
-                Serial.printf("MAC -> %s | SOCKET_ID -> %d | MAX_POWER -> %d\n", mac_to_string(macAddr).c_str(), socketId, maxPower);
+                points[j] = power_to_waveform_point(samples[count - 1 - j].powerMilliWatts);
             }
-            else
+            if (count > 0)
             {
-                // 发送失败，回滚串口屏对应功率设置
-                TJC_set_property("Control", (String("xz") + socketId).c_str(), "val", String(strip.sockets[socketId - 1].maxPower));
+                TJC_waveform_add(WAVEFORM_CONTROL, i, points, count);
             }
+            waveformPendingCount[i] = 0;
         }
-        break;
-
-    case 0x44:
-        // 从[排插控制页面]回到[主页面]
-        Serial.println("从[排插控制页面]回到[主页面]");
-        // 设置STA推送开关 - 关闭
-        pushFrame[2] = 0x00;
-        // 发送帧
-        HPLC_send_frame(currMacAddr, pushFrame, sizeof(pushFrame), true);
-        // 清空当前页面的STA的MAC地址
-        memset(currMacAddr, 0, sizeof(currMacAddr));
-        break;
-
-    default:
-        break;
-    }
-}
-
-/**
- * HPLC载波模块处理有效帧
- */
-void HPLC_handle_valid_frame(FrameParser frameParser)
-{
-    // Serial.println("HANDLE_VALID_FRAME:");
-    // for (int i = 0; i < frameParser.index; i++)
-    // {
-    //     print_to_serial_monitor("HPLC", frameParser.buffer[i]);
-    // }
-    // Serial.println();
-
-    // 临时变量
-    uint8_t macAddr[6];        // MAC地址Buffer
-    PowerStrip strip;          // 排插对象Buffer
-    uint8_t socketId;          // 插孔ID
-    uint8_t bl_data_buffer[3]; // BL0906 数据缓冲区 (3 字节)
-    // 响应ACK帧
-    uint8_t ackFrame[2] = {
-        0x00, // 控制码占位
-        0x00  // 数据域长度
-    };
-
-    // 提取关键字段
-    uint8_t ctrlCode = frameParser.buffer[5]; // 控制码
-    uint8_t dataLen = frameParser.buffer[6];  // 数据域长度
-
-    // 针对不同帧控制码执行不同操作
-    switch (ctrlCode)
-    {
-    case 0x66:
-        // 回复心跳包
-        HPLC_reply_heart_beat(TARGET_ADDRESS);
-        break;
-
-    case 0x13:
-        // 接收STA功率超限通知
-        Serial.println("接收STA功率超限通知");
-        // 提取MAC地址
-        for (int i = 0; i < 6; i++)
+        LOG_INFO("MAC -> " LOG_MAC_FORMAT, LOG_MAC_ARGS(macAddr));
+    }
+    // 设置当前页面的STA的MAC地址，开启推送、查询电能和拉取汇总交给STA监控任务，结果由 loop() 显示
+    memcpy(currMacAddr, macAddr, 6);
+    if (!queue_control_page_job(macAddr, CONTROL_JOB_ENTER_PAGE))
+    {
+        // 无法开启推送，回滚串口屏，返回主页面
+        TJC_click("back", "0");
+    }
+}
+
+/**
+ * @brief [主页面]下一页
+ * @param frame 完整帧
+ */
+void tjc_handle_home_next_page(const FrameView &frame)
+{
+    // [主页面]下一页
+    LOG_INFO("[主页面]下一页");
+    homePageIndex++;
+    refresh_home_page();
+}
+
+/**
+ * @brief [主页面]上一页
+ * @param frame 完整帧
+ */
+void tjc_handle_home_prev_page(const FrameView &frame)
+{
+    // [主页面]上一页
+    LOG_INFO("[主页面]上一页");
+    if (homePageIndex > 0)
+    {
+        homePageIndex--;
+    }
+    refresh_home_page();
+}
+
+/**
+ * @brief 前往[诊断页面]
+ * @param frame 完整帧
+ */
+void tjc_handle_goto_diag(const FrameView &frame)
+{
+    // 前往[诊断页面]
+    LOG_INFO("前往[诊断页面]");
+    // 页面加载时串口屏会把控件恢复为默认值，作废该页面的影子值后整页重新推送
+    TJC_invalidate_page("Diag");
+    TJC_goto_page("Diag");
+    diagPageActive = true;
+    refresh_diag_page();
+}
+
+/**
+ * @brief 设置 Wifi SSID
+ * @param frame 完整帧
+ */
+void tjc_handle_set_wifi_ssid(const FrameView &frame)
+{
+    uint8_t dataLen = frame.dataLen; // 数据域长度
+
+    // 设置 Wifi SSID
+    LOG_INFO("设置 Wifi SSID");
+    for (int i = 0; i < dataLen; i++)
+    {
+        print_to_serial_monitor("SSID", frame.data[i]);
+    }
+}
+
+/**
+ * @brief 设置 Wifi 密码
+ * @param frame 完整帧
+ */
+void tjc_handle_set_wifi_password(const FrameView &frame)
+{
+    uint8_t dataLen = frame.dataLen; // 数据域长度
+
+    // 设置 Wifi 密码
+    LOG_INFO("设置 Wifi 密码");
+    for (int i = 0; i < dataLen; i++)
+    {
+        print_to_serial_monitor("PWD", frame.data[i]);
+    }
+}
+
+/**
+ * @brief 从[Wifi设置页面]回到[主页面]
+ * @param frame 完整帧
+ */
+void tjc_handle_wifi_setting_back(const FrameView &frame)
+{
+    // 从[Wifi设置页面]回到[主页面]
+    LOG_INFO("从[Wifi设置页面]回到[主页面]");
+    return_to_home_page();
+}
+
+/**
+ * @brief 断开 Wifi 连接，前往[Wifi设置页面]
+ * @param frame 完整帧
+ */
+void tjc_handle_wifi_disconnect(const FrameView &frame)
+{
+    // 断开 Wifi 连接，前往[Wifi设置页面]
+    LOG_INFO("断开 Wifi 连接，前往[Wifi设置页面]");
+    TJC_invalidate_page("Wifi");
+}
+
+/**
+ * @brief 从[Wifi信息页面]回到[主页面]
+ * @param frame 完整帧
+ */
+void tjc_handle_wifi_info_back(const FrameView &frame)
+{
+    // 从[Wifi信息页面]回到[主页面]
+    LOG_INFO("从[Wifi信息页面]回到[主页面]");
+    return_to_home_page();
+}
+
+/**
+ * @brief 设置排插名称
+ * @param frame 完整帧
+ */
+void tjc_handle_set_strip_name(const FrameView &frame)
+{
+    uint8_t dataLen = frame.dataLen;       // 数据域长度
+    uint8_t macAddr[6];                    // MAC地址Buffer
+    PowerStrip strip;                      // 排插对象Buffer
+    char nameBuffer[TJC_MAX_DATA_LEN + 1]; // 名称Buffer (解析器保证数据域不超过 TJC_MAX_DATA_LEN)
+
+    // 设置排插名称
+    LOG_INFO("设置排插名称");
+    // 数据域: MAC地址(6) + 名称
+    if (dataLen < 6)
+    {
+        LOG_WARN("TJC -> 设置排插名称 -> 数据域长度 %d 过短，已忽略", dataLen);
+        return;
+    }
+    // 提取MAC地址
+    for (int i = 0; i < 6; i++)
+    {
+        macAddr[i] = frame.data[i];
+    }
+    // 获取排插信息
+    if (PowerStrip_get(macAddr, strip))
+    {
+        // 提取名称
+        uint8_t nameLen = dataLen - 6;
+        memcpy(nameBuffer, frame.data + 6, nameLen);
+        nameBuffer[nameLen] = '\0';
+        // 更新排插名称
+        strip.name = String(nameBuffer);
+        PowerStrip_update(strip);
+        Serial.printf("MAC -> %s | NAME -> %s\n", mac_to_string(macAddr).c_str(), strip.name.c_str());
+    }
+}
+
+/**
+ * @brief 设置指定插孔开关状态
+ * @param frame 完整帧
+ */
+void tjc_handle_set_socket_state(const FrameView &frame)
+{
+    uint8_t macAddr[6]; // MAC地址Buffer
+    PowerStrip strip;   // 排插对象Buffer
+
+    // 设置指定插孔开关状态
+    LOG_INFO("设置指定插孔开关状态");
+    // 提取MAC地址
+    for (int i = 0; i < 6; i++)
+    {
+        macAddr[i] = frame.data[i];
+    }
+    // 获取排插信息
+    if (PowerStrip_get(macAddr, strip))
+    {
+        // 提取插孔ID和开关状态
+        uint8_t socketId = frame.data[6];
+        if (!protocol_socket_valid(socketId))
         {
-            macAddr[i] = frameParser.buffer[7 + i];
+            LOG_WARN("TJC -> 插孔ID %d 无效，已忽略", socketId);
+            return;
         }
-        // 获取排插信息
-        if (PowerStrip_get(macAddr, strip))
+        // 设置STA插孔状态交给STA监控任务，结果由 loop() 更新排插信息或回滚串口屏
+        if (!queue_control_page_job(macAddr, CONTROL_JOB_SET_SOCKET_STATE, socketId, frame.data[7]))
         {
-            // 提取插孔ID
-            socketId = frameParser.buffer[13];
-            // 处理功率超限通知 -> 跳闸了
-            // 更新排插状态并保存
-            strip.sockets[socketId - 1].state = false;
-            PowerStrip_update(strip);
-            // 比较是否是当前页面的STA
-            if (memcmp(macAddr, currMacAddr, 6) == 0)
-            {
-                // 更新串口屏显示
-                TJC_set_property("Control", (String("bt") + socketId).c_str(), "val", "0"); // 关闭按钮
-                TJC_set_property("Control", (String("dl") + socketId).c_str(), "txt", "-"); // 电流显示为"-"
-                // 功率保留
-            }
+            // 无法发送，回滚串口屏对应按钮状态
+            TJC_invalidate_property("Control", (String("bt") + socketId).c_str(), "val");
+            TJC_set_property("Control", (String("bt") + socketId).c_str(), "val", strip.sockets[socketId - 1].state ? "1" : "0");
         }
-        // 响应ACK帧
-        ackFrame[0] = 0x93;
-        // 发送ACK帧
-        HPLC_send_frame(macAddr, ackFrame, sizeof(ackFrame), false);
-        break;
-
-    case 0x14:
-        // 接收STA插孔电流
-        Serial.println("接收STA插孔电流");
-        // 提取MAC地址
-        for (int i = 0; i < 6; i++)
+    }
+}
+
+/**
+ * @brief 设置指定插孔最大功率
+ * @param frame 完整帧
+ */
+void tjc_handle_set_max_power(const FrameView &frame)
+{
+    uint8_t macAddr[6]; // MAC地址Buffer
+    PowerStrip strip;   // 排插对象Buffer
+
+    // 设置指定插孔最大功率
+    LOG_INFO("设置指定插孔最大功率");
+    // 提取MAC地址
+    for (int i = 0; i < 6; i++)
+    {
+        macAddr[i] = frame.data[i];
+    }
+    // 获取排插信息
+    if (PowerStrip_get(macAddr, strip))
+    {
+        // 提取插孔ID和最大功率
+        uint8_t socketId = frame.data[6];
+        uint16_t maxPower = (frame.data[8] << 8) | frame.data[7];
+        if (!protocol_socket_valid(socketId))
         {
-            macAddr[i] = frameParser.buffer[7 + i];
+            LOG_WARN("TJC -> 插孔ID %d 无效，已忽略", socketId);
+            return;
         }
-        // 比较是否是当前页面的STA
-        if (memcmp(macAddr, currMacAddr, 6) == 0)
+        // 设置STA插孔最大功率交给STA监控任务，结果由 loop() 更新排插信息或回滚串口屏
+        if (!queue_control_page_job(macAddr, CONTROL_JOB_SET_MAX_POWER, socketId, maxPower))
         {
-            // 提取插孔ID
-            socketId = frameParser.buffer[13];
-            // 提取电流数据
-            bl_data_buffer[0] = frameParser.buffer[14];
-            bl_data_buffer[1] = frameParser.buffer[15];
-            bl_data_buffer[2] = frameParser.buffer[16];
-            float current_reg = ((uint32_t)bl_data_buffer[2] << 16) | ((uint32_t)bl_data_buffer[1] << 8) | bl_data_buffer[0];
-            // 转换为实际电流 (A)
-            float current = BL_currentRegister2ActualCurrent(current_reg);
-            // 显示到串口屏
-            TJC_set_property("Control", (String("dl") + socketId).c_str(), "txt", String(current));
+            // 无法发送，回滚串口屏对应功率设置
+            TJC_invalidate_property("Control", (String("xz") + socketId).c_str(), "val");
+            TJC_set_property("Control", (String("xz") + socketId).c_str(), "val", String(strip.sockets[socketId - 1].maxPower));
         }
-        break;
+    }
+}
+
+/**
+ * @brief 从[排插控制页面]回到[主页面]
+ * @param frame 完整帧
+ */
+void tjc_handle_control_back(const FrameView &frame)
+{
+    // 从[排插控制页面]回到[主页面]
+    LOG_INFO("从[排插控制页面]回到[主页面]");
+    // 关闭STA推送 (交给STA监控任务，排在进入页面的请求之后执行)
+    queue_control_page_job(currMacAddr, CONTROL_JOB_LEAVE_PAGE);
+    // 清空当前页面的STA的MAC地址
+    memset(currMacAddr, 0, sizeof(currMacAddr));
+    // 丢弃尚未推送的功率曲线数据点
+    memset(waveformPendingCount, 0, sizeof(waveformPendingCount));
+    return_to_home_page();
+}
 
-    case 0x15:
-        // 接收STA插孔功率
-        Serial.println("接收STA插孔功率");
-        // 提取MAC地址
-        for (int i = 0; i < 6; i++)
+/**
+ * @brief 从[诊断页面]回到[主页面]
+ * @param frame 完整帧
+ */
+void tjc_handle_diag_back(const FrameView &frame)
+{
+    // 从[诊断页面]回到[主页面]
+    LOG_INFO("从[诊断页面]回到[主页面]");
+    diagPageActive = false;
+    return_to_home_page();
+}
+
+/**
+ * @brief 清零链路指标
+ * @param frame 完整帧
+ */
+void tjc_handle_diag_reset(const FrameView &frame)
+{
+    // 清零链路指标
+    LOG_INFO("清零链路指标");
+    METRICS_reset();
+    refresh_diag_page();
+}
+
+/**
+ * @brief 回复心跳包
+ * @param frame 完整帧
+ */
+void hplc_handle_heart_beat(const FrameView &frame)
+{
+    // 回复心跳包
+    HPLC_reply_heart_beat(TARGET_ADDRESS);
+}
+
+/**
+ * @brief 接收STA功率超限通知
+ * @param frame 完整帧
+ */
+void hplc_handle_power_exceed(const FrameView &frame)
+{
+    PowerStrip strip; // 排插对象Buffer
+
+    // 响应ACK帧 (数据域为空)
+    uint8_t ackFrame[PROTOCOL_TX_DATA_OFFSET];
+
+    // 接收STA功率超限通知
+    LOG_INFO("接收STA功率超限通知");
+    const MsgPowerExceed *msg = protocol_view<MsgPowerExceed>(frame);
+    if (msg == nullptr || !protocol_socket_valid(msg->socketId))
+    {
+        return;
+    }
+    uint8_t socketId = msg->socketId;
+    // 获取排插信息
+    if (PowerStrip_get(msg->macAddress, strip))
+    {
+        // 处理功率超限通知 -> 跳闸了
+        // 更新排插状态并保存
+        strip.sockets[socketId - 1].state = false;
+        PowerStrip_update(strip);
+        // 比较是否是当前页面的STA
+        if (memcmp(msg->macAddress, currMacAddr, 6) == 0)
         {
-            macAddr[i] = frameParser.buffer[7 + i];
+            // 更新串口屏显示
+            TJC_set_property("Control", (String("bt") + socketId).c_str(), "val", "0"); // 关闭按钮
+            TJC_set_property("Control", (String("dl") + socketId).c_str(), "txt", "-"); // 电流显示为"-"
+            // 功率保留
         }
-        // 比较是否是当前页面的STA
-        if (memcmp(macAddr, currMacAddr, 6) == 0)
+    }
+    // 发送ACK帧
+    uint8_t macAddr[6];
+    memcpy(macAddr, msg->macAddress, 6);
+    protocol_encode<MsgPowerExceedAck>(ackFrame);
+    HPLC_send_frame(macAddr, ackFrame, sizeof(ackFrame), false);
+}
+
+/**
+ * @brief 接收STA插孔电流
+ * @param frame 完整帧
+ */
+void hplc_handle_current_report(const FrameView &frame)
+{
+    // 接收STA插孔电流
+    LOG_DEBUG("接收STA插孔电流");
+    const MsgCurrentReport *msg = protocol_view<MsgCurrentReport>(frame);
+    if (msg == nullptr || !protocol_socket_valid(msg->socketId))
+    {
+        return;
+    }
+    uint8_t socketId = msg->socketId;
+    // 转换为实际电流 (mA)
+    uint32_t current_ma = BL_currentRegister2MilliAmps(msg->current.value());
+    // 写入遥测数据存储
+    TELEMETRY_record_current(msg->macAddress, socketId, current_ma);
+    // 比较是否是当前页面的STA
+    if (memcmp(msg->macAddress, currMacAddr, 6) == 0)
+    {
+        // 显示到串口屏 (A，保留2位小数)
+        TJC_set_property("Control", (String("dl") + socketId).c_str(), "txt", String(current_ma / 1000.0f));
+    }
+}
+
+/**
+ * @brief 接收STA插孔功率
+ * @param frame 完整帧
+ */
+void hplc_handle_power_report(const FrameView &frame)
+{
+    // 接收STA插孔功率
+    LOG_DEBUG("接收STA插孔功率");
+    const MsgPowerReport *msg = protocol_view<MsgPowerReport>(frame);
+    if (msg == nullptr || !protocol_socket_valid(msg->socketId))
+    {
+        return;
+    }
+    uint8_t socketId = msg->socketId;
+    // 转换为实际功率 (mW)
+    uint32_t power_mw = BL_powerRegister2MilliWatts(msg->power.value());
+    // 写入遥测数据存储
+    TELEMETRY_record_power(msg->macAddress, socketId, power_mw);
+    // 比较是否是当前页面的STA
+    if (memcmp(msg->macAddress, currMacAddr, 6) == 0)
+    {
+        // 显示到串口屏 (W，保留2位小数)
+        TJC_set_property("Control", (String("gl") + socketId).c_str(), "txt", String(power_mw / 1000.0f));
+        // 累积功率曲线数据点，由loop()凑满一块后批量推送
+        if (waveformPendingCount[socketId - 1] < WAVEFORM_PUSH_BLOCK)
         {
-            // 提取插孔ID
-            socketId = frameParser.buffer[13];
-            // 提取功率数据
-            bl_data_buffer[0] = frameParser.buffer[14];
-            bl_data_buffer[1] = frameParser.buffer[15];
-            bl_data_buffer[2] = frameParser.buffer[16];
-            uint32_t power_reg = ((uint32_t)bl_data_buffer[2] << 16) | ((uint32_t)bl_data_buffer[1] << 8) | bl_data_buffer[0];
-            // 转换为实际功率 (W)
-            float power = BL_powerRegister2ActualPower(power_reg);
-            // 显示到串口屏
-            TJC_set_property("Control", (String("gl") + socketId).c_str(), "txt", String(power));
+            waveformPending[socketId - 1][waveformPendingCount[socketId - 1]++] = power_to_waveform_point(power_mw);
         }
-        break;
-        
-    default:
-        break;
     }
 }
\ No newline at end of file
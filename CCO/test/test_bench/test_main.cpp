@@ -0,0 +1,481 @@
+#include <Arduino.h>
+#include <BLRegConv.h>
+#include <HPLC.h>
+#include <Metrics.h>
+#include <NativeShims.h>
+#include <PowerStrip.h>
+#include <TJC.h>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <unity.h>
+#include <vector>
+
+/*
+ * 热路径基准测试 (native)
+ * 运行: pio test -e native_bench；设置环境变量 BENCH_OUTPUT 时结果同时写入该文件
+ *
+ * 每个用例输出一行 JSON (JSON Lines)，字段:
+ *   bench / case        基准名称和场景
+ *   ops                 每轮的操作次数 (解析器为字节数)
+ *   repeats             计时轮数 (另有一轮预热不计时)
+ *   median_ns / min_ns  每次操作耗时的中位数和最小值 (ns)
+ *   mb_per_s            按中位数计算的吞吐量 (仅解析器)
+ *   其余字段            确定性的计数 (帧数、失步次数等)，输入由固定种子生成，每次运行都相同，
+ *                       可直接比较；耗时随机器变化，只在同一台机器的不同版本之间比较
+ */
+
+// 计时轮数 (取中位数)
+#define BENCH_REPEATS 9
+// 解析器输入流的目标长度 (字节)
+#define BENCH_STREAM_BYTES 65536
+// 冲洗解析器的填充字节数 (大于一帧，保证任何状态下的解析器都回到初始状态)
+#define BENCH_FLUSH_BYTES (MAX_FRAME_LEN + 16)
+
+// 结果输出文件 (BENCH_OUTPUT 未设置时为 NULL)
+static FILE *output = NULL;
+// 防止被测函数的结果被优化掉
+static volatile uint32_t sink;
+
+// 定义[计时结果]
+typedef struct
+{
+    double medianNs; // 每次操作耗时的中位数 (ns)
+    double minNs;    // 每次操作耗时的最小值 (ns)
+} BenchTiming;
+
+/**
+ * 固定种子的 xorshift32 伪随机数，保证每次运行的输入相同
+ */
+static uint32_t rng_state = 0x2545F491;
+
+static uint32_t rng_next()
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+static void rng_seed(uint32_t seed)
+{
+    rng_state = seed;
+}
+
+/**
+ * 执行 body 一轮预热和 BENCH_REPEATS 轮计时，返回每次操作的耗时 (before 在每轮计时前执行，不计时)
+ */
+template <typename Before, typename Body>
+static BenchTiming bench_measure(uint32_t ops, Before before, Body body)
+{
+    std::vector<double> samples;
+    before();
+    body();
+    for (int i = 0; i < BENCH_REPEATS; i++)
+    {
+        before();
+        auto start = std::chrono::steady_clock::now();
+        body();
+        auto end = std::chrono::steady_clock::now();
+        samples.push_back(std::chrono::duration<double, std::nano>(end - start).count() / ops);
+    }
+    std::sort(samples.begin(), samples.end());
+    BenchTiming timing = {samples[BENCH_REPEATS / 2], samples[0]};
+    return timing;
+}
+
+template <typename Body>
+static BenchTiming bench_measure(uint32_t ops, Body body)
+{
+    return bench_measure(ops, []() {}, body);
+}
+
+/**
+ * 输出一行结果，extra 为附加的 JSON 字段 (以逗号开头，可为空字符串)
+ */
+static void bench_report(const char *bench, const char *scenario, uint32_t ops, const BenchTiming &timing, bool throughput, const char *extra)
+{
+    char line[384];
+    int n = snprintf(line, sizeof(line), "{\"bench\":\"%s\",\"case\":\"%s\",\"ops\":%lu,\"repeats\":%d,\"median_ns\":%.3f,\"min_ns\":%.3f",
+                     bench, scenario, (unsigned long)ops, BENCH_REPEATS, timing.medianNs, timing.minNs);
+    if (throughput)
+    {
+        n += snprintf(line + n, sizeof(line) - n, ",\"mb_per_s\":%.2f", 1000.0 / timing.medianNs);
+    }
+    snprintf(line + n, sizeof(line) - n, "%s}", extra);
+    printf("%s\n", line);
+    if (output)
+    {
+        fprintf(output, "%s\n", line);
+        fflush(output);
+    }
+}
+
+/**
+ * 追加一个完整帧 (前导字节 + 起始符 + 控制码 + 数据域长度 + 数据域 [+ 校验和] + 结束符)
+ */
+static void append_frame(std::vector<uint8_t> &stream, uint8_t ctrl_code, const uint8_t *data, uint8_t data_len, bool with_checksum)
+{
+    const size_t start = stream.size();
+    stream.insert(stream.end(), {FRAME_LEAD_BYTE, FRAME_LEAD_BYTE, FRAME_LEAD_BYTE, FRAME_LEAD_BYTE, FRAME_HEADER, ctrl_code, data_len});
+    stream.insert(stream.end(), data, data + data_len);
+    if (with_checksum)
+    {
+        uint8_t cs = 0;
+        for (size_t i = start + 4; i < stream.size(); i++)
+        {
+            cs += stream[i];
+        }
+        stream.push_back(cs);
+    }
+    stream.push_back(FRAME_END);
+}
+
+static void append_text(std::vector<uint8_t> &stream, const char *text)
+{
+    stream.insert(stream.end(), text, text + strlen(text));
+}
+
+// 混入帧之间的AT文本 (模块应答、回显和拓扑信息行)
+static const char *const AT_TEXT[] = {
+    "\r+ok\r\n",
+    "\r+ok=3\r\n",
+    "\r+ok=0013D7632202,2,1,-45\r\n",
+    "AT+SEND=0013d7632202,11,\r\n",
+    "\r+err=-1\r\n",
+};
+
+// 定义[解析器输入流]
+typedef struct
+{
+    std::vector<uint8_t> bytes; // 字节流
+    uint32_t frames;            // 其中的完整帧数 (含被破坏的帧)
+    uint32_t corrupted;         // 被破坏的帧数
+} BenchStream;
+
+/**
+ * 生成解析器输入流
+ * noise: 帧之间插入随机字节，每 16 帧破坏其中一个字节；at_text: 帧之间插入AT文本
+ * with_checksum: HPLC 帧带校验和，串口屏帧不带
+ */
+static BenchStream make_stream(uint32_t seed, bool noise, bool at_text, bool with_checksum)
+{
+    // 常见帧: 心跳 (空数据域)、功率上报 (10字节)、电能应答 (18字节)
+    static const uint8_t CTRL_CODES[] = {0x66, 0x15, 0x96};
+    static const uint8_t DATA_LENS[] = {0, 10, 18};
+
+    BenchStream stream = {{}, 0, 0};
+    rng_seed(seed);
+    while (stream.bytes.size() < BENCH_STREAM_BYTES)
+    {
+        if (noise)
+        {
+            uint32_t count = rng_next() % 8;
+            for (uint32_t i = 0; i < count; i++)
+            {
+                stream.bytes.push_back((uint8_t)rng_next());
+            }
+        }
+        if (at_text)
+        {
+            append_text(stream.bytes, AT_TEXT[rng_next() % ARRAY_LENGTH(AT_TEXT)]);
+        }
+
+        uint32_t kind = rng_next() % ARRAY_LENGTH(CTRL_CODES);
+        uint8_t data[18];
+        for (int i = 0; i < DATA_LENS[kind]; i++)
+        {
+            data[i] = (uint8_t)rng_next();
+        }
+        size_t start = stream.bytes.size();
+        append_frame(stream.bytes, CTRL_CODES[kind], data, DATA_LENS[kind], with_checksum);
+        stream.frames++;
+        if (noise && rng_next() % 16 == 0)
+        {
+            stream.bytes[start + rng_next() % (stream.bytes.size() - start)] ^= (uint8_t)(1 + rng_next() % 255);
+            stream.corrupted++;
+        }
+    }
+    return stream;
+}
+
+// 收到的完整帧数 (解析器回调中累加)
+static uint32_t parsedFrames = 0;
+
+static void count_frame(const FrameView &frame, void *context)
+{
+    parsedFrames++;
+    sink += frame.ctrlCode;
+}
+
+// 冲洗解析器用的填充字节 (不含前导字节，不会组成帧)
+static const uint8_t FLUSH_BYTES[BENCH_FLUSH_BYTES] = {0};
+
+// 解析器场景: 名称、随机种子、是否加入噪声、是否混入AT文本
+typedef struct
+{
+    const char *name;
+    uint32_t seed;
+    bool noise;
+    bool atText;
+} ParserScenario;
+
+static const ParserScenario PARSER_SCENARIOS[] = {
+    {"clean", 1, false, false},
+    {"noisy", 2, true, false},
+    {"at_mixed", 3, false, true},
+};
+
+/**
+ * 测量一个解析器在各场景下的吞吐量
+ * parse: 解析函数 (HPLC_parse / TJC_parse)
+ */
+static void bench_parser(const char *bench, void (*parse)(const uint8_t[], size_t, FrameCallbackFunc, void *), bool with_checksum)
+{
+    for (size_t s = 0; s < ARRAY_LENGTH(PARSER_SCENARIOS); s++)
+    {
+        const ParserScenario &scenario = PARSER_SCENARIOS[s];
+        BenchStream stream = make_stream(scenario.seed, scenario.noise, scenario.atText, with_checksum);
+        const uint32_t ops = stream.bytes.size();
+
+        BenchTiming timing = bench_measure(
+            ops,
+            [&]() {
+                // 每轮从初始状态开始，计数只保留最后一轮
+                parse(FLUSH_BYTES, sizeof(FLUSH_BYTES), NULL, NULL);
+                METRICS_reset();
+                parsedFrames = 0;
+            },
+            [&]() { parse(stream.bytes.data(), stream.bytes.size(), count_frame, NULL); });
+
+        MetricsSnapshot snapshot;
+        METRICS_snapshot(snapshot);
+        uint32_t resync = with_checksum ? snapshot.counters[METRIC_HPLC_RESYNC] : snapshot.counters[METRIC_TJC_RESYNC];
+        char extra[160];
+        snprintf(extra, sizeof(extra), ",\"frames_sent\":%lu,\"frames_corrupted\":%lu,\"frames_parsed\":%lu,\"resync\":%lu,\"checksum_fail\":%lu",
+                 (unsigned long)stream.frames, (unsigned long)stream.corrupted, (unsigned long)parsedFrames,
+                 (unsigned long)resync, (unsigned long)snapshot.counters[METRIC_HPLC_CHECKSUM_FAIL]);
+        bench_report(bench, scenario.name, ops, timing, true, extra);
+
+        if (!scenario.noise)
+        {
+            // 没有噪声时每个帧都应被解析出来
+            TEST_ASSERT_EQUAL_UINT32(stream.frames, parsedFrames);
+        }
+        else
+        {
+            // 噪声不会凭空组成帧；被破坏的帧和紧随噪声的帧可能丢失，但大部分帧应被解析出来
+            TEST_ASSERT_LESS_OR_EQUAL_UINT32(stream.frames, parsedFrames);
+            TEST_ASSERT_GREATER_THAN(stream.frames * 3 / 4, parsedFrames);
+        }
+    }
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+// HPLC 帧解析器 (含AT应答行匹配) 的吞吐量
+void test_hplc_parse(void)
+{
+    bench_parser("hplc_parse", HPLC_parse, true);
+}
+
+// 串口屏帧解析器的吞吐量
+void test_tjc_parse(void)
+{
+    bench_parser("tjc_parse", TJC_parse, false);
+}
+
+// 发送路径: 帧内容编码为完整[AT命令]的耗时
+void test_hplc_build_command(void)
+{
+    // 功率上报帧内容 (控制码 + 数据域长度 + 10字节数据域)
+    uint8_t frame[12] = {0x15, 10, 0x00, 0x13, 0xD7, 0x63, 0x22, 0x02, 0x01, 0x10, 0x27, 0x00};
+    uint8_t command[HPLC_AT_SEND_MAX_LEN];
+    const uint32_t ops = 100000;
+
+    // 同一组16个目标地址 (前缀缓存命中) 和 256 个末字节冲突的目标地址 (前缀缓存未命中)
+    static const struct
+    {
+        const char *name;
+        uint32_t targets;
+        uint32_t stride;
+    } SCENARIOS[] = {{"prefix_cache_hit", HPLC_PREFIX_CACHE_SIZE, 1}, {"prefix_cache_miss", 256, HPLC_PREFIX_CACHE_SIZE}};
+
+    for (size_t s = 0; s < ARRAY_LENGTH(SCENARIOS); s++)
+    {
+        std::vector<std::array<uint8_t, 6>> targets(SCENARIOS[s].targets);
+        for (uint32_t i = 0; i < SCENARIOS[s].targets; i++)
+        {
+            uint32_t id = i * SCENARIOS[s].stride;
+            targets[i] = {0x00, 0x13, 0xD7, (uint8_t)(id >> 16), (uint8_t)(id >> 8), (uint8_t)id};
+        }
+        size_t length = 0;
+        BenchTiming timing = bench_measure(ops, [&]() {
+            for (uint32_t i = 0; i < ops; i++)
+            {
+                length = HPLC_build_command(targets[i % targets.size()].data(), frame, sizeof(frame), command);
+                sink += command[length - 3];
+            }
+        });
+        char extra[48];
+        snprintf(extra, sizeof(extra), ",\"command_bytes\":%lu", (unsigned long)length);
+        bench_report("hplc_build_command", SCENARIOS[s].name, ops, timing, false, extra);
+        // "AT+SEND=<MAC>," + "19," + 19字节的完整帧 + "\r\n"
+        TEST_ASSERT_EQUAL_UINT32(8 + MAC_HEX_LEN + 1 + 3 + 19 + 2, length);
+    }
+}
+
+// MAC地址转字符串 (返回 String) 与写入调用方缓冲区的对比
+void test_mac_to_string(void)
+{
+    const uint32_t ops = 100000;
+    uint8_t mac[6] = {0x00, 0x13, 0xD7, 0x63, 0x22, 0x02};
+    BenchTiming timing = bench_measure(ops, [&]() {
+        for (uint32_t i = 0; i < ops; i++)
+        {
+            mac[5] = (uint8_t)i;
+            String text = mac_to_string(mac);
+            sink += text.length();
+        }
+    });
+    bench_report("mac_to_string", "string", ops, timing, false, "");
+
+    char hex[MAC_HEX_LEN + 1];
+    timing = bench_measure(ops, [&]() {
+        for (uint32_t i = 0; i < ops; i++)
+        {
+            mac[5] = (uint8_t)i;
+            mac_to_hex(mac, hex);
+            sink += hex[MAC_HEX_LEN - 1];
+        }
+    });
+    bench_report("mac_to_string", "mac_to_hex", ops, timing, false, "");
+    TEST_ASSERT_EQUAL_STRING("0013d763229f", hex);
+}
+
+// BL0906 寄存器定点转换
+void test_bl_reg_conv(void)
+{
+    const uint32_t ops = 1 << 18;
+    std::vector<uint32_t> registers(4096);
+    rng_seed(4);
+    for (size_t i = 0; i < registers.size(); i++)
+    {
+        registers[i] = rng_next() & 0x00FFFFFF;
+    }
+
+    static const struct
+    {
+        const char *name;
+        uint32_t (*convert)(uint32_t);
+    } CONVERSIONS[] = {
+        {"current_ma", BL_currentRegister2MilliAmps},
+        {"power_mw", BL_powerRegister2MilliWatts},
+        {"energy_wh", BL_energyPulses2WattHours},
+    };
+
+    for (size_t c = 0; c < ARRAY_LENGTH(CONVERSIONS); c++)
+    {
+        uint32_t checksum = 0;
+        BenchTiming timing = bench_measure(ops, [&]() {
+            checksum = 0;
+            for (uint32_t i = 0; i < ops; i++)
+            {
+                checksum += CONVERSIONS[c].convert(registers[i & (registers.size() - 1)]);
+            }
+            sink += checksum;
+        });
+        char extra[48];
+        snprintf(extra, sizeof(extra), ",\"checksum\":%lu", (unsigned long)checksum);
+        bench_report("bl_reg_conv", CONVERSIONS[c].name, ops, timing, false, extra);
+    }
+}
+
+// 按MAC地址查找排插，N = 3 / 100 / 1000 (含 1/8 查找不存在的地址)
+void test_power_strip_get(void)
+{
+    static const uint32_t COUNTS[] = {3, 100, 1000};
+    const uint32_t ops = 20000;
+
+    for (size_t c = 0; c < ARRAY_LENGTH(COUNTS); c++)
+    {
+        native_preferences_reset();
+        PowerStrip_init();
+        PowerStrip_delete_all();
+
+        std::vector<std::array<uint8_t, 6>> macs;
+        for (uint32_t i = 0; i < COUNTS[c]; i++)
+        {
+            PowerStrip strip;
+            uint8_t mac[6] = {0x00, 0x13, 0xD7, 0x63, (uint8_t)(i >> 8), (uint8_t)i};
+            memcpy(strip.macAddress, mac, 6);
+            strip.name = "strip";
+            for (int s = 0; s < 3; s++)
+            {
+                strip.sockets[s].state = true;
+                strip.sockets[s].maxPower = 2500;
+            }
+            strip.isOnline = true;
+            TEST_ASSERT_TRUE(PowerStrip_add(strip));
+            macs.push_back({mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]});
+        }
+
+        // 固定顺序的查找序列，每 8 次中有 1 次查找不存在的地址
+        std::vector<std::array<uint8_t, 6>> lookups(ops);
+        rng_seed(5 + c);
+        for (uint32_t i = 0; i < ops; i++)
+        {
+            lookups[i] = macs[rng_next() % macs.size()];
+            if (i % 8 == 7)
+            {
+                lookups[i][3] ^= 0xFF;
+            }
+        }
+
+        uint32_t found = 0;
+        BenchTiming timing = bench_measure(ops, [&]() {
+            found = 0;
+            PowerStrip strip;
+            for (uint32_t i = 0; i < ops; i++)
+            {
+                found += PowerStrip_get(lookups[i].data(), strip);
+            }
+        });
+        char scenario[16];
+        char extra[48];
+        snprintf(scenario, sizeof(scenario), "n%lu", (unsigned long)COUNTS[c]);
+        snprintf(extra, sizeof(extra), ",\"strips\":%lu,\"found\":%lu", (unsigned long)COUNTS[c], (unsigned long)found);
+        bench_report("power_strip_get", scenario, ops, timing, false, extra);
+        TEST_ASSERT_EQUAL_UINT32(ops - ops / 8, found);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    const char *path = getenv("BENCH_OUTPUT");
+    if (path != NULL && path[0] != '\0')
+    {
+        output = fopen(path, "w");
+    }
+
+    UNITY_BEGIN();
+    RUN_TEST(test_hplc_parse);
+    RUN_TEST(test_tjc_parse);
+    RUN_TEST(test_hplc_build_command);
+    RUN_TEST(test_mac_to_string);
+    RUN_TEST(test_bl_reg_conv);
+    RUN_TEST(test_power_strip_get);
+    int failures = UNITY_END();
+
+    if (output)
+    {
+        fclose(output);
+    }
+    return failures;
+}
\ No newline at end of file
@@ -0,0 +1,331 @@
+#include <Arduino.h>
+#include <FuzzDriver.h>
+#include <HPLC.h>
+#include <NativeShims.h>
+#include <PowerStrip.h>
+#include <Protocol.h>
+#include <TJC.h>
+#include <algorithm>
+#include <string.h>
+#include <unity.h>
+#include <vector>
+
+/*
+ * CCO控制码处理函数模糊测试 (native，需要 test_build_src)
+ * 运行: pio test -e native_fuzz -f test_fuzz_handlers，参数和 libFuzzer 编译方式见 native/FuzzDriver/src/FuzzDriver.h
+ *
+ * 固件 (src/main.cpp) 执行 setup() 后，把输入组装成帧交给 TJC_dispatch_frame() / HPLC_dispatch_frame()，
+ * 与 loop() 分发串口任务解析出的帧相同，之后再执行一次 loop() 处理后续工作。输入格式:
+ *   第1个字节   处理函数序号 (值 % HANDLER_COUNT，见 HANDLERS)
+ *   其余字节    数据域 (超过单帧容量的部分被截断)，长度与注册的长度不符的帧由分发函数丢弃
+ * 帧放在大小恰好的堆缓冲区中，处理函数读取帧以外的内存由 ASan 发现。
+ * Serial2 的发送钩子扮演载波模块 (应答需要ACK的请求)，Serial1 的发送钩子扮演串口屏 (应答曲线透传，
+ * 检查写入的插孔控件 bt/dl/gl 编号都是有效的插孔ID)，网络中有两个已保存的排插 (种子中使用它们的MAC地址)
+ */
+
+// 固件入口 (src/main.cpp)
+void setup();
+void loop();
+
+// 定义[处理函数]表项: 所在的串口和控制码 (与 setup() 中的注册一致)
+typedef struct
+{
+    bool isHplc;  // true: 载波帧, false: 串口屏帧
+    uint8_t ctrl; // 控制码
+} HandlerTarget;
+
+static const HandlerTarget HANDLERS[] = {
+    {false, 0x01}, {false, 0x02}, {false, 0x11}, {false, 0x12}, {false, 0x13}, {false, 0x14}, {false, 0x15},
+    {false, 0x21}, {false, 0x22}, {false, 0x23}, {false, 0x31}, {false, 0x32}, {false, 0x41}, {false, 0x42},
+    {false, 0x43}, {false, 0x44}, {false, 0x51}, {false, 0x52},
+    {true, MsgHeartBeat::CTRL}, {true, MsgPowerExceed::CTRL}, {true, MsgCurrentReport::CTRL}, {true, MsgPowerReport::CTRL},
+};
+#define HANDLER_COUNT (sizeof(HANDLERS) / sizeof(HANDLERS[0]))
+
+static const uint8_t STRIP_MACS[2][6] = {{0x00, 0x13, 0xD7, 0x63, 0x22, 0x02}, {0x00, 0x13, 0xD7, 0x63, 0x22, 0x03}};
+
+// 串口屏已收到曲线透传命令，下一次写入是数据点
+static bool screenAwaitingPoints = false;
+// 分发的帧数
+static uint32_t dispatchCount = 0;
+// 模拟载波模块应答的请求数 (处理函数向已保存的排插发出的命令)
+static uint32_t ackCount = 0;
+// 串口屏收到的插孔控件写入数
+static uint32_t socketWriteCount = 0;
+
+static void discard_tx(HardwareSerial &serial, const uint8_t *data, size_t length, void *context)
+{
+    (void)serial;
+    (void)data;
+    (void)length;
+    (void)context;
+}
+
+/**
+ * 模拟载波模块: 应答需要ACK的请求，拓扑查询回复两个排插
+ */
+static void fake_module_tx(HardwareSerial &serial, const uint8_t *data, size_t length, void *context)
+{
+    (void)context;
+    std::string command((const char *)data, length);
+    if (command == "AT+TOPONUM?\r\n")
+    {
+        serial.native_inject("\r+ok=2\r\n");
+        return;
+    }
+    if (command.compare(0, 12, "AT+TOPOINFO=") == 0)
+    {
+        serial.native_inject("\r+ok=0013d7632202,02,00,1,STA,0,0,1 \r\n\r+ok=0013d7632203,03,00,1,STA,0,0,1 \r\n");
+        return;
+    }
+    // "AT+SEND=<MAC>,<长度>,<帧>\r\n": 控制码在帧的第6个字节
+    size_t frameStart = command.find(',', 8 + MAC_HEX_LEN + 1);
+    if (command.compare(0, 8, "AT+SEND=") != 0 || frameStart == std::string::npos || frameStart + 1 + FRAME_CTRL_OFFSET >= command.size())
+    {
+        return;
+    }
+    uint8_t ack;
+    switch ((uint8_t)command[frameStart + 1 + FRAME_CTRL_OFFSET])
+    {
+    case MsgHeartBeat::CTRL:
+        ack = MsgHeartBeatAck::CTRL;
+        break;
+    case MsgSetSocketState::CTRL:
+        ack = MsgSetSocketStateAck::CTRL;
+        break;
+    case MsgSetMaxPower::CTRL:
+        ack = MsgSetMaxPowerAck::CTRL;
+        break;
+    case MsgSetPush::CTRL:
+        ack = MsgSetPushAck::CTRL;
+        break;
+    default:
+        return;
+    }
+    const uint8_t frame[] = {FRAME_LEAD_BYTE, FRAME_LEAD_BYTE, FRAME_LEAD_BYTE, FRAME_LEAD_BYTE, FRAME_HEADER, ack, 0x00, (uint8_t)(FRAME_HEADER + ack), FRAME_END};
+    serial.native_inject(frame, sizeof(frame));
+    ackCount++;
+}
+
+/**
+ * 检查写入 Control 页面插孔控件 (bt/dl/gl + 插孔ID) 的命令中插孔ID有效
+ */
+static void check_socket_controls(const uint8_t *data, size_t length)
+{
+    std::string commands((const char *)data, length);
+    for (const char *prefix : {"Control.bt", "Control.dl", "Control.gl"})
+    {
+        for (size_t pos = commands.find(prefix); pos != std::string::npos; pos = commands.find(prefix, pos + 1))
+        {
+            size_t digits = pos + strlen(prefix);
+            size_t end = commands.find('.', digits);
+            if (end == std::string::npos)
+            {
+                continue;
+            }
+            long socketId = strtol(commands.c_str() + digits, NULL, 10);
+            FUZZ_CHECK(end > digits && socketId >= 1 && socketId <= PROTOCOL_SOCKET_COUNT, "写入了不存在的插孔控件");
+            socketWriteCount++;
+        }
+    }
+}
+
+/**
+ * 模拟串口屏: 曲线透传命令回复"就绪"，数据点回复"完成"，其它命令不回复
+ */
+static void fake_screen_tx(HardwareSerial &serial, const uint8_t *data, size_t length, void *context)
+{
+    (void)context;
+    check_socket_controls(data, length);
+    if (screenAwaitingPoints)
+    {
+        screenAwaitingPoints = false;
+        const uint8_t done[] = {TJC_REPLY_TRANSPARENT_DONE, 0xFF, 0xFF, 0xFF};
+        serial.native_inject(done, sizeof(done));
+        return;
+    }
+    if (length >= 5 && memcmp(data, "addt ", 5) == 0)
+    {
+        screenAwaitingPoints = true;
+        const uint8_t ready[] = {TJC_REPLY_TRANSPARENT_READY, 0xFF, 0xFF, 0xFF};
+        serial.native_inject(ready, sizeof(ready));
+    }
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    static bool initialized = false;
+    if (!initialized)
+    {
+        // 数万次分发的日志没有意义，丢弃串口监视器输出
+        Serial.native_set_echo(false);
+        Serial.native_set_tx_hook(discard_tx, NULL);
+        Serial1.native_set_tx_hook(fake_screen_tx, NULL);
+        Serial2.native_set_tx_hook(fake_module_tx, NULL);
+        setup();
+        for (int i = 0; i < 2; i++)
+        {
+            PowerStrip strip = {};
+            memcpy(strip.macAddress, STRIP_MACS[i], 6);
+            strip.name = "fuzz";
+            strip.isOnline = true;
+            PowerStrip_add(strip);
+        }
+        initialized = true;
+    }
+    if (size == 0)
+    {
+        return 0;
+    }
+
+    const HandlerTarget &target = HANDLERS[data[0] % HANDLER_COUNT];
+    size_t maxLen = target.isHplc ? PROTOCOL_MAX_DATA_LEN : TJC_MAX_DATA_LEN;
+    uint8_t dataLen = (uint8_t)std::min(size - 1, maxLen);
+
+    // 完整帧: 前导字节 + 起始符 + 控制码 + 长度 + 数据域 (+ 载波帧的校验和) + 结束符
+    size_t length = FRAME_DATA_OFFSET + dataLen + (target.isHplc ? 2 : 1);
+    uint8_t *bytes = (uint8_t *)malloc(length);
+    memset(bytes, FRAME_LEAD_BYTE, 4);
+    bytes[4] = FRAME_HEADER;
+    bytes[FRAME_CTRL_OFFSET] = target.ctrl;
+    bytes[FRAME_LEN_OFFSET] = dataLen;
+    memcpy(bytes + FRAME_DATA_OFFSET, data + 1, dataLen);
+    if (target.isHplc)
+    {
+        uint8_t cs = 0;
+        for (int i = 4; i < FRAME_DATA_OFFSET + dataLen; i++)
+        {
+            cs += bytes[i];
+        }
+        bytes[length - 2] = cs;
+    }
+    bytes[length - 1] = FRAME_END;
+
+    FrameView frame;
+    frame.bytes = bytes;
+    frame.length = (uint8_t)length;
+    frame.ctrlCode = target.ctrl;
+    frame.dataLen = dataLen;
+    frame.data = bytes + FRAME_DATA_OFFSET;
+    if (target.isHplc)
+    {
+        HPLC_dispatch_frame(frame, NULL);
+    }
+    else
+    {
+        TJC_dispatch_frame(frame, NULL);
+    }
+    free(bytes);
+    dispatchCount++;
+
+    // 处理函数交给 loop() 和STA监控任务的后续工作
+    loop();
+    vTaskDelay(pdMS_TO_TICKS(1));
+    return 0;
+}
+
+#ifndef FUZZ_LIBFUZZER
+
+/**
+ * 组装输入: 处理函数序号 + 数据域
+ */
+static std::vector<uint8_t> make_input(uint8_t handler, std::vector<uint8_t> data)
+{
+    data.insert(data.begin(), handler);
+    return data;
+}
+
+/**
+ * 排插MAC地址 + 其余数据域
+ */
+static std::vector<uint8_t> with_mac(int strip, std::vector<uint8_t> rest)
+{
+    rest.insert(rest.begin(), STRIP_MACS[strip], STRIP_MACS[strip] + 6);
+    return rest;
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+// 种子和变异输入都不会让处理函数越界或触发未定义行为
+void test_handlers_survive_fuzzing(void)
+{
+    std::vector<std::vector<uint8_t>> inputs;
+    for (uint8_t i = 0; i < HANDLER_COUNT; i++)
+    {
+        const HandlerTarget &target = HANDLERS[i];
+        if (target.isHplc)
+        {
+            // 上报消息: MAC地址 + 插孔ID (+ 24位寄存器值)，插孔ID越界；截断到消息的数据域长度
+            uint8_t len = 0;
+            if (target.ctrl == MsgPowerExceed::CTRL)
+            {
+                len = protocol_data_len<MsgPowerExceed>();
+            }
+            else if (target.ctrl != MsgHeartBeat::CTRL)
+            {
+                len = protocol_data_len<MsgCurrentReport>();
+            }
+            inputs.push_back(make_input(i, with_mac(0, {0x01, 0x10, 0x20, 0x30})));
+            inputs.back().resize(1 + len);
+            inputs.push_back(make_input(i, with_mac(1, {0x04, 0xFF, 0xFF, 0xFF})));
+            inputs.back().resize(1 + len);
+            // 当前控制页面的排插上报越界的插孔ID (不写入遥测数据和串口屏)
+            for (uint8_t socketId : {0x00, PROTOCOL_SOCKET_COUNT + 1, 0xC8})
+            {
+                inputs.push_back(make_input(i, with_mac(0, {socketId, 0x10, 0x20, 0x30})));
+                inputs.back().resize(1 + len);
+            }
+            continue;
+        }
+        switch (target.ctrl)
+        {
+        case 0x12: // 前往排插控制页面
+            inputs.push_back(make_input(i, with_mac(0, {})));
+            break;
+        case 0x41: // 设置排插名称
+            inputs.push_back(make_input(i, with_mac(0, {'d', 'e', 's', 'k'})));
+            break;
+        case 0x42: // 开关插孔 (插孔ID越界)
+            inputs.push_back(make_input(i, with_mac(0, {0x02, 0x01})));
+            inputs.push_back(make_input(i, with_mac(1, {0x00, 0x01})));
+            break;
+        case 0x43: // 设置最大功率
+            inputs.push_back(make_input(i, with_mac(0, {0x03, 0xE8, 0x03})));
+            break;
+        default: // 没有数据域或数据域是文本 (Wifi名称和密码)
+            inputs.push_back(make_input(i, {'a', 'b', 'c'}));
+            break;
+        }
+    }
+
+    std::vector<FuzzSeed> seeds;
+    for (const std::vector<uint8_t> &input : inputs)
+    {
+        seeds.push_back({input.data(), input.size()});
+    }
+    FuzzResult result;
+    FUZZ_run(seeds.data(), seeds.size(), result);
+    printf("{\"fuzz\":\"cco_handlers\",\"seeds\":%u,\"corpus\":%u,\"mutated\":%u,\"bytes\":%llu,\"dispatched\":%u,\"acked\":%u,\"socket_writes\":%u,\"virtual_s\":%.1f}\n",
+           result.seedInputs, result.corpusInputs, result.mutatedInputs, (unsigned long long)result.totalBytes, dispatchCount,
+           ackCount, socketWriteCount, native_time_us() / 1e6);
+    // 只导出种子时不执行输入
+    if (result.seedInputs > 0)
+    {
+        TEST_ASSERT_GREATER_THAN(0, socketWriteCount);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_handlers_survive_fuzzing);
+    return UNITY_END();
+}
+
+#endif
\ No newline at end of file
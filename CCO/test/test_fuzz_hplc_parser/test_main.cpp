@@ -0,0 +1,153 @@
+#include <Arduino.h>
+#include <FuzzDriver.h>
+#include <HPLC.h>
+#include <Protocol.h>
+#include <string.h>
+#include <unity.h>
+#include <vector>
+
+/*
+ * HPLC 帧解析器模糊测试 (native)
+ * 运行: pio test -e native_fuzz -f test_fuzz_hplc_parser，参数和 libFuzzer 编译方式见 native/FuzzDriver/src/FuzzDriver.h
+ *
+ * 输入是载波串口收到的字节流 (帧、AT应答行和噪声混在一起)，直接送入 HPLC_parse()。
+ * 每个输入之前先冲洗解析器，输入之间互不影响；解析出的每个帧检查:
+ *   帧长度与数据域长度一致且不超过 MAX_FRAME_LEN，前导字节、起始符、结束符和校验和正确，帧是输入中连续的一段
+ */
+
+// 冲洗解析器的填充字节数 (大于一帧，保证任何状态下的解析器都回到初始状态)，之后的换行结束未完成的AT应答行
+#define FUZZ_FLUSH_BYTES (MAX_FRAME_LEN + 16)
+
+// 正在执行的输入 (帧回调检查帧是否来自输入)
+static const uint8_t *inputData;
+static size_t inputSize;
+// 解析出的帧数
+static uint32_t frameCount = 0;
+
+/**
+ * 组装完整帧 (前导字节 + 起始符 + 控制码 + 长度 + 数据域 + 校验和 + 结束符)
+ */
+static std::vector<uint8_t> make_frame(uint8_t ctrl, const uint8_t *data, uint8_t len)
+{
+    std::vector<uint8_t> frame = {FRAME_LEAD_BYTE, FRAME_LEAD_BYTE, FRAME_LEAD_BYTE, FRAME_LEAD_BYTE, FRAME_HEADER, ctrl, len};
+    frame.insert(frame.end(), data, data + len);
+    uint8_t cs = FRAME_HEADER + ctrl + len;
+    for (int i = 0; i < len; i++)
+    {
+        cs += data[i];
+    }
+    frame.push_back(cs);
+    frame.push_back(FRAME_END);
+    return frame;
+}
+
+static void check_frame(const FrameView &frame, void *context)
+{
+    (void)context;
+    FUZZ_CHECK(frame.length <= MAX_FRAME_LEN, "帧长度超过 MAX_FRAME_LEN");
+    FUZZ_CHECK(frame.dataLen <= PROTOCOL_MAX_DATA_LEN, "数据域长度超过 PROTOCOL_MAX_DATA_LEN");
+    FUZZ_CHECK(frame.length == FRAME_DATA_OFFSET + frame.dataLen + 2, "帧长度与数据域长度不符");
+    FUZZ_CHECK(frame.data == frame.bytes + FRAME_DATA_OFFSET, "数据域位置错误");
+    for (int i = 0; i < 4; i++)
+    {
+        FUZZ_CHECK(frame.bytes[i] == FRAME_LEAD_BYTE, "前导字节错误");
+    }
+    FUZZ_CHECK(frame.bytes[4] == FRAME_HEADER, "起始符错误");
+    FUZZ_CHECK(frame.ctrlCode == frame.bytes[FRAME_CTRL_OFFSET], "控制码与帧内容不符");
+    FUZZ_CHECK(frame.dataLen == frame.bytes[FRAME_LEN_OFFSET], "数据域长度与帧内容不符");
+    uint8_t cs = 0;
+    for (int i = 4; i < FRAME_DATA_OFFSET + frame.dataLen; i++)
+    {
+        cs += frame.bytes[i];
+    }
+    FUZZ_CHECK(frame.bytes[frame.length - 2] == cs, "校验和错误的帧被接受");
+    FUZZ_CHECK(frame.bytes[frame.length - 1] == FRAME_END, "结束符错误");
+    FUZZ_CHECK(memmem(inputData, inputSize, frame.bytes, frame.length) != NULL, "帧不是输入中连续的一段");
+    frameCount++;
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    uint8_t flush[FUZZ_FLUSH_BYTES + 1] = {0};
+    flush[FUZZ_FLUSH_BYTES] = '\n';
+    HPLC_parse(flush, sizeof(flush), NULL);
+
+    inputData = data;
+    inputSize = size;
+    HPLC_parse(data, size, check_frame);
+    return 0;
+}
+
+#ifndef FUZZ_LIBFUZZER
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+// 种子和变异输入都不会让解析器越界或接受错误的帧
+void test_hplc_parser_survives_fuzzing(void)
+{
+    std::vector<std::vector<uint8_t>> inputs;
+    uint8_t data[PROTOCOL_MAX_DATA_LEN];
+    for (size_t i = 0; i < sizeof(data); i++)
+    {
+        data[i] = (uint8_t)(i * 37 + 1);
+    }
+
+    // 各消息的合法帧 (数据域长度与协议一致)
+    inputs.push_back(make_frame(MsgHeartBeat::CTRL, data, protocol_data_len<MsgHeartBeat>()));
+    inputs.push_back(make_frame(MsgPowerExceed::CTRL, data, protocol_data_len<MsgPowerExceed>()));
+    inputs.push_back(make_frame(MsgCurrentReport::CTRL, data, protocol_data_len<MsgCurrentReport>()));
+    inputs.push_back(make_frame(MsgPowerReport::CTRL, data, protocol_data_len<MsgPowerReport>()));
+    // 最长的帧、空数据域
+    inputs.push_back(make_frame(0x14, data, PROTOCOL_MAX_DATA_LEN));
+    inputs.push_back(make_frame(MsgHeartBeatAck::CTRL, NULL, 0));
+    // 数据域长度超过单帧容量
+    std::vector<uint8_t> oversized = make_frame(0x14, data, PROTOCOL_MAX_DATA_LEN);
+    oversized[FRAME_LEN_OFFSET] = PROTOCOL_MAX_DATA_LEN + 1;
+    inputs.push_back(oversized);
+    // 噪声 + 被截断的帧 + 完整帧
+    std::vector<uint8_t> mixed = {'x', FRAME_LEAD_BYTE, 0x00, FRAME_LEAD_BYTE, FRAME_LEAD_BYTE, FRAME_LEAD_BYTE, FRAME_LEAD_BYTE, FRAME_LEAD_BYTE, FRAME_HEADER};
+    std::vector<uint8_t> frame = make_frame(0x15, data, 3);
+    mixed.insert(mixed.end(), frame.begin(), frame.begin() + 8);
+    mixed.insert(mixed.end(), frame.begin(), frame.end());
+    inputs.push_back(mixed);
+    // AT应答行和帧交错
+    const char *lines = "\r+ok=3\r\n\r+ok=0013d7632202,02,00,1,STA,0,0,1 \r\n";
+    std::vector<uint8_t> interleaved(lines, lines + strlen(lines));
+    interleaved.insert(interleaved.begin() + 9, frame.begin(), frame.end());
+    inputs.push_back(interleaved);
+    // 超过应答行缓冲区的AT应答
+    std::vector<uint8_t> longLine = {'\r', '+', 'o', 'k', '='};
+    longLine.insert(longLine.end(), HPLC_AT_LINE_SIZE * 2, 'a');
+    longLine.push_back('\n');
+    inputs.push_back(longLine);
+
+    std::vector<FuzzSeed> seeds;
+    for (const std::vector<uint8_t> &input : inputs)
+    {
+        seeds.push_back({input.data(), input.size()});
+    }
+    FuzzResult result;
+    FUZZ_run(seeds.data(), seeds.size(), result);
+    printf("{\"fuzz\":\"hplc_parser\",\"seeds\":%u,\"corpus\":%u,\"mutated\":%u,\"bytes\":%llu,\"frames\":%u}\n",
+           result.seedInputs, result.corpusInputs, result.mutatedInputs, (unsigned long long)result.totalBytes, frameCount);
+    // 只导出种子时不执行输入
+    if (result.seedInputs > 0)
+    {
+        TEST_ASSERT_GREATER_THAN(0, frameCount);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_hplc_parser_survives_fuzzing);
+    return UNITY_END();
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,138 @@
+#include <Arduino.h>
+#include <FuzzDriver.h>
+#include <TJC.h>
+#include <string.h>
+#include <unity.h>
+#include <vector>
+
+/*
+ * 串口屏帧解析器模糊测试 (native)
+ * 运行: pio test -e native_fuzz -f test_fuzz_tjc_parser，参数和 libFuzzer 编译方式见 native/FuzzDriver/src/FuzzDriver.h
+ *
+ * 输入是串口屏串口收到的字节流，直接送入 TJC_parse()。每个输入之前先冲洗解析器，输入之间互不影响；
+ * 解析出的每个帧检查: 帧长度与数据域长度一致且不超过 MAX_FRAME_LEN，前导字节、起始符、结束符正确，帧是输入中连续的一段
+ */
+
+// 冲洗解析器的填充字节数 (大于一帧，保证任何状态下的解析器都回到初始状态)
+#define FUZZ_FLUSH_BYTES (MAX_FRAME_LEN + 16)
+
+// 串口屏帧在数据域之外的长度: 前导字节(4) + 起始符(1) + 控制码(1) + 长度(1) + 结束符(1)
+#define TJC_FRAME_OVERHEAD 8
+
+// 正在执行的输入 (帧回调检查帧是否来自输入)
+static const uint8_t *inputData;
+static size_t inputSize;
+// 解析出的帧数
+static uint32_t frameCount = 0;
+
+/**
+ * 组装串口屏帧 (前导字节 + 起始符 + 控制码 + 长度 + 数据域 + 结束符，没有校验和)
+ */
+static std::vector<uint8_t> make_frame(uint8_t ctrl, const uint8_t *data, uint8_t len)
+{
+    std::vector<uint8_t> frame = {FRAME_LEAD_BYTE, FRAME_LEAD_BYTE, FRAME_LEAD_BYTE, FRAME_LEAD_BYTE, FRAME_HEADER, ctrl, len};
+    frame.insert(frame.end(), data, data + len);
+    frame.push_back(FRAME_END);
+    return frame;
+}
+
+static void check_frame(const FrameView &frame, void *context)
+{
+    (void)context;
+    FUZZ_CHECK(frame.length <= MAX_FRAME_LEN, "帧长度超过 MAX_FRAME_LEN");
+    FUZZ_CHECK(frame.dataLen <= TJC_MAX_DATA_LEN, "数据域长度超过 TJC_MAX_DATA_LEN");
+    FUZZ_CHECK(frame.length == TJC_FRAME_OVERHEAD + frame.dataLen, "帧长度与数据域长度不符");
+    FUZZ_CHECK(frame.data == frame.bytes + FRAME_DATA_OFFSET, "数据域位置错误");
+    for (int i = 0; i < 4; i++)
+    {
+        FUZZ_CHECK(frame.bytes[i] == FRAME_LEAD_BYTE, "前导字节错误");
+    }
+    FUZZ_CHECK(frame.bytes[4] == FRAME_HEADER, "起始符错误");
+    FUZZ_CHECK(frame.ctrlCode == frame.bytes[FRAME_CTRL_OFFSET], "控制码与帧内容不符");
+    FUZZ_CHECK(frame.dataLen == frame.bytes[FRAME_LEN_OFFSET], "数据域长度与帧内容不符");
+    FUZZ_CHECK(frame.bytes[frame.length - 1] == FRAME_END, "结束符错误");
+    FUZZ_CHECK(memmem(inputData, inputSize, frame.bytes, frame.length) != NULL, "帧不是输入中连续的一段");
+    frameCount++;
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    uint8_t flush[FUZZ_FLUSH_BYTES] = {0};
+    TJC_parse(flush, sizeof(flush), NULL);
+
+    inputData = data;
+    inputSize = size;
+    TJC_parse(data, size, check_frame);
+    return 0;
+}
+
+#ifndef FUZZ_LIBFUZZER
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+// 种子和变异输入都不会让解析器越界或接受错误的帧
+void test_tjc_parser_survives_fuzzing(void)
+{
+    std::vector<std::vector<uint8_t>> inputs;
+    uint8_t data[TJC_MAX_DATA_LEN];
+    for (size_t i = 0; i < sizeof(data); i++)
+    {
+        data[i] = (uint8_t)(i * 37 + 1);
+    }
+
+    // 各页面的按键帧: 无数据域、MAC地址、MAC地址 + 插孔ID + 开关状态/最大功率
+    inputs.push_back(make_frame(0x13, NULL, 0));
+    inputs.push_back(make_frame(0x12, data, 6));
+    inputs.push_back(make_frame(0x42, data, 8));
+    inputs.push_back(make_frame(0x43, data, 9));
+    // 最长的帧 (排插名称)、数据域长度超过单帧容量
+    inputs.push_back(make_frame(0x41, data, TJC_MAX_DATA_LEN));
+    std::vector<uint8_t> oversized = make_frame(0x41, data, TJC_MAX_DATA_LEN);
+    oversized[FRAME_LEN_OFFSET] = TJC_MAX_DATA_LEN + 1;
+    inputs.push_back(oversized);
+    // 曲线透传的应答、屏幕的指令执行结果 (非本协议帧) 和帧交错
+    std::vector<uint8_t> mixed = {TJC_REPLY_TRANSPARENT_READY, 0xFF, 0xFF, 0xFF, 0x1A, 0xFF, 0xFF, 0xFF};
+    std::vector<uint8_t> frame = make_frame(0x21, data, 3);
+    mixed.insert(mixed.end(), frame.begin(), frame.begin() + 6);
+    mixed.insert(mixed.end(), frame.begin(), frame.end());
+    mixed.insert(mixed.end(), {TJC_REPLY_TRANSPARENT_DONE, 0xFF, 0xFF, 0xFF});
+    inputs.push_back(mixed);
+    // 连续的帧
+    std::vector<uint8_t> burst;
+    for (uint8_t ctrl : {0x11, 0x44, 0x51, 0x52})
+    {
+        frame = make_frame(ctrl, data, ctrl & 0x0F);
+        burst.insert(burst.end(), frame.begin(), frame.end());
+    }
+    inputs.push_back(burst);
+
+    std::vector<FuzzSeed> seeds;
+    for (const std::vector<uint8_t> &input : inputs)
+    {
+        seeds.push_back({input.data(), input.size()});
+    }
+    FuzzResult result;
+    FUZZ_run(seeds.data(), seeds.size(), result);
+    printf("{\"fuzz\":\"tjc_parser\",\"seeds\":%u,\"corpus\":%u,\"mutated\":%u,\"bytes\":%llu,\"frames\":%u}\n",
+           result.seedInputs, result.corpusInputs, result.mutatedInputs, (unsigned long long)result.totalBytes, frameCount);
+    // 只导出种子时不执行输入
+    if (result.seedInputs > 0)
+    {
+        TEST_ASSERT_GREATER_THAN(0, frameCount);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_tjc_parser_survives_fuzzing);
+    return UNITY_END();
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,185 @@
+#include <Arduino.h>
+#include <FuzzDriver.h>
+#include <HPLC.h>
+#include <ctype.h>
+#include <string.h>
+#include <unity.h>
+#include <vector>
+
+/*
+ * 拓扑查询应答模糊测试 (native)
+ * 运行: pio test -e native_fuzz -f test_fuzz_topoinfo，参数和 libFuzzer 编译方式见 native/FuzzDriver/src/FuzzDriver.h
+ *
+ * Serial2 的发送钩子扮演载波模块，用输入回复 HPLC_get_topo_sta_mac_list() 的两条查询。输入格式:
+ *   第1个字节      MAC地址数组的容量 (1 + 值 % FUZZ_MAX_CAPACITY)
+ *   之后到第一个 0x00   AT+TOPONUM? 的应答字节流
+ *   0x00 之后      AT+TOPOINFO 的应答字节流
+ * 检查: 不越界写入MAC地址数组 (数组按容量分配，越界由 ASan 发现)，查询的节点数和解析出的数量不超过容量，
+ *       解析出的每个MAC地址都出现在应答中 (第1个字节以外的输入)
+ */
+
+// MAC地址数组的最大容量
+#define FUZZ_MAX_CAPACITY 8
+// 冲洗解析器的填充字节数 (大于一帧，保证任何状态下的解析器都回到初始状态)，之后的换行结束未完成的AT应答行
+#define FUZZ_FLUSH_BYTES (MAX_FRAME_LEN + 16)
+
+// 定义[模拟载波模块]状态
+typedef struct
+{
+    std::vector<uint8_t> topoNumReply;  // AT+TOPONUM? 的应答
+    std::vector<uint8_t> topoInfoReply; // AT+TOPOINFO 的应答
+    uint16_t capacity;                  // MAC地址数组的容量
+    int requestedCount;                 // AT+TOPOINFO 查询的节点数 (-1 表示没有查询)
+} FakeModule;
+
+static FakeModule module;
+// 查询成功的次数 (种子中的合法应答至少成功一次)
+static uint32_t successCount = 0;
+
+/**
+ * 模拟载波模块: 在串口任务写出命令时用输入回复
+ */
+static void fake_module_tx(HardwareSerial &serial, const uint8_t *data, size_t length, void *context)
+{
+    (void)context;
+    if (length == 13 && memcmp(data, "AT+TOPONUM?\r\n", 13) == 0)
+    {
+        serial.native_inject(module.topoNumReply.data(), module.topoNumReply.size());
+        return;
+    }
+    std::string command((const char *)data, length);
+    int start, count;
+    if (sscanf(command.c_str(), "AT+TOPOINFO=%d,%d", &start, &count) == 2)
+    {
+        module.requestedCount = count;
+        serial.native_inject(module.topoInfoReply.data(), module.topoInfoReply.size());
+    }
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    static bool initialized = false;
+    if (!initialized)
+    {
+        Serial2.native_set_tx_hook(fake_module_tx, NULL);
+        HPLC_init();
+        initialized = true;
+    }
+    if (size == 0)
+    {
+        return 0;
+    }
+
+    // 冲洗上一个输入留下的半行和半帧
+    uint8_t flush[FUZZ_FLUSH_BYTES + 1] = {0};
+    flush[FUZZ_FLUSH_BYTES] = '\n';
+    Serial2.native_inject(flush, sizeof(flush));
+    vTaskDelay(pdMS_TO_TICKS(HPLC_TASK_MAX_SLEEP_MS));
+    HPLC_poll(NULL);
+
+    module.capacity = 1 + data[0] % FUZZ_MAX_CAPACITY;
+    const uint8_t *separator = (const uint8_t *)memchr(data + 1, 0x00, size - 1);
+    const uint8_t *end = data + size;
+    module.topoNumReply.assign(data + 1, separator != NULL ? separator : end);
+    module.topoInfoReply.assign(separator != NULL ? separator + 1 : end, end);
+    module.requestedCount = -1;
+
+    // 容量恰好的堆数组，越界写入由 ASan 发现
+    uint8_t(*macs)[6] = (uint8_t(*)[6])malloc(module.capacity * 6);
+    uint16_t count = 0xFFFF;
+    bool ok = HPLC_get_topo_sta_mac_list(macs, module.capacity, &count);
+
+    FUZZ_CHECK(count <= module.capacity, "解析出的MAC地址数量超过数组容量");
+    FUZZ_CHECK(module.requestedCount <= (int)module.capacity, "AT+TOPOINFO 查询的节点数超过数组容量");
+    FUZZ_CHECK(!ok || module.requestedCount < 0 || count > 0, "查询成功但没有解析出MAC地址");
+    // 应答中的MAC地址不区分大小写 (TOPONUM 应答之后多出的行同样被当作拓扑信息行)
+    std::string reply((const char *)data + 1, size - 1);
+    for (char &c : reply)
+    {
+        c = (char)tolower((unsigned char)c);
+    }
+    for (uint16_t i = 0; i < count; i++)
+    {
+        char hex[13];
+        snprintf(hex, sizeof(hex), "%02x%02x%02x%02x%02x%02x", macs[i][0], macs[i][1], macs[i][2], macs[i][3], macs[i][4], macs[i][5]);
+        FUZZ_CHECK(reply.find(hex) != std::string::npos, "解析出的MAC地址不在应答中");
+    }
+    free(macs);
+    if (ok)
+    {
+        successCount++;
+    }
+    return 0;
+}
+
+#ifndef FUZZ_LIBFUZZER
+
+/**
+ * 组装输入: 容量字节 (容量为该值 + 1) + TOPONUM 应答 + 0x00 + TOPOINFO 应答
+ */
+static std::vector<uint8_t> make_input(uint8_t capacity_byte, const char *topo_num, const char *topo_info)
+{
+    std::vector<uint8_t> input = {capacity_byte};
+    input.insert(input.end(), topo_num, topo_num + strlen(topo_num));
+    input.push_back(0x00);
+    input.insert(input.end(), topo_info, topo_info + strlen(topo_info));
+    return input;
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+// 种子和变异输入都不会让拓扑查询越界或解析出应答中没有的MAC地址
+void test_topoinfo_survives_fuzzing(void)
+{
+    std::vector<std::vector<uint8_t>> inputs;
+    const char *rows = "\r+ok=0013d7632202,02,00,1,STA,0,0,1 \r\n"
+                       "\r+ok=0013d7632203,03,00,1,STA,0,0,1 \r\n"
+                       "\r+ok=0013D7632204,04,00,1,STA,0,0,1 \r\n";
+    // 合法应答、节点数超过容量、没有节点
+    inputs.push_back(make_input(2, "\r+ok=3\r\n", rows));
+    inputs.push_back(make_input(0, "\r+ok=3\r\n", rows));
+    inputs.push_back(make_input(2, "\r+ok=0\r\n", ""));
+    // 节点数无效: 非数字、负数、溢出、带多余字符
+    inputs.push_back(make_input(2, "\r+ok=abc\r\n", rows));
+    inputs.push_back(make_input(2, "\r+ok=-1\r\n", rows));
+    inputs.push_back(make_input(2, "\r+ok=99999999999999999999\r\n", rows));
+    inputs.push_back(make_input(2, "\r+ok=3x\r\n", rows));
+    // 拓扑信息行: 其它命令的应答穿插、MAC地址过短、不是十六进制、行超过缓冲区
+    inputs.push_back(make_input(2, "\r+ok=2\r\n", "\r+ok=1\r\n\r+ok=0013d7632202,02\r\n\r+ok=0013d76322,03\r\n"));
+    inputs.push_back(make_input(2, "\r+ok=1\r\n", "\r+ok=0013d76322zz,02,00,1,STA,0,0,1 \r\n"));
+    std::string longRow = "\r+ok=0013d7632202," + std::string(HPLC_AT_LINE_SIZE * 2, '9') + "\r\n";
+    inputs.push_back(make_input(2, "\r+ok=1\r\n", longRow.c_str()));
+    // 应答前有噪声和帧
+    const char noisy[] = "x\xfe\xfe\xfe\xfe\x68\x14\x01\x55\xd2\x16\r+ok=1\r\n";
+    inputs.push_back(make_input(2, noisy, rows));
+
+    std::vector<FuzzSeed> seeds;
+    for (const std::vector<uint8_t> &input : inputs)
+    {
+        seeds.push_back({input.data(), input.size()});
+    }
+    FuzzResult result;
+    FUZZ_run(seeds.data(), seeds.size(), result);
+    printf("{\"fuzz\":\"topoinfo\",\"seeds\":%u,\"corpus\":%u,\"mutated\":%u,\"bytes\":%llu,\"succeeded\":%u}\n",
+           result.seedInputs, result.corpusInputs, result.mutatedInputs, (unsigned long long)result.totalBytes, successCount);
+    // 只导出种子时不执行输入
+    if (result.seedInputs > 0)
+    {
+        TEST_ASSERT_GREATER_THAN(0, successCount);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_topoinfo_survives_fuzzing);
+    return UNITY_END();
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,263 @@
+#include <Arduino.h>
+#include <HPLC.h>
+#include <Metrics.h>
+#include <NativeShims.h>
+#include <string>
+#include <unity.h>
+#include <vector>
+
+/*
+ * HPLC 模块测试 (native)
+ * Serial2 的发送钩子扮演载波模块: 记录写出的命令，按需回复ACK帧和AT应答
+ */
+
+// 定义[模拟载波模块]状态
+typedef struct
+{
+    std::string pending;               // 尚未收到 "\r\n" 的命令
+    std::vector<std::string> commands; // 收到的完整命令
+    bool replyAck;                     // 收到 AT+SEND 心跳包时回复心跳应答
+    int nodeCount;                     // AT+TOPONUM? 回复的节点数量
+} FakeModule;
+
+static FakeModule module;
+
+// 已分发的帧 (控制码 + 数据域)
+static std::vector<std::vector<uint8_t>> received;
+
+static const uint8_t STA_MAC[6] = {0x00, 0x13, 0xD7, 0x63, 0x22, 0x02};
+
+/**
+ * 组装完整帧 (前导字节 + 起始符 + 控制码 + 长度 + 数据域 + 校验和 + 结束符)
+ */
+static std::vector<uint8_t> make_frame(uint8_t ctrl, const uint8_t *data, uint8_t len)
+{
+    std::vector<uint8_t> frame = {FRAME_LEAD_BYTE, FRAME_LEAD_BYTE, FRAME_LEAD_BYTE, FRAME_LEAD_BYTE, FRAME_HEADER, ctrl, len};
+    frame.insert(frame.end(), data, data + len);
+    uint8_t cs = FRAME_HEADER + ctrl + len;
+    for (int i = 0; i < len; i++)
+    {
+        cs += data[i];
+    }
+    frame.push_back(cs);
+    frame.push_back(FRAME_END);
+    return frame;
+}
+
+/**
+ * 载波串口收到字节，等待串口任务取走并解析
+ */
+static void inject(const std::vector<uint8_t> &bytes)
+{
+    Serial2.native_inject(bytes.data(), bytes.size());
+    vTaskDelay(pdMS_TO_TICKS(HPLC_TASK_MAX_SLEEP_MS) + 1);
+}
+
+/**
+ * 模拟载波模块: 收到完整命令时同步回复
+ */
+static void fake_module_tx(HardwareSerial &serial, const uint8_t *data, size_t length, void *context)
+{
+    module.pending.append((const char *)data, length);
+    if (module.pending.size() < 2 || module.pending.compare(module.pending.size() - 2, 2, "\r\n") != 0)
+    {
+        return;
+    }
+    std::string command = module.pending;
+    module.pending.clear();
+    module.commands.push_back(command);
+
+    char reply[64];
+    if (command == "AT+TOPONUM?\r\n")
+    {
+        snprintf(reply, sizeof(reply), "\r+ok=%d\r\n", module.nodeCount);
+        serial.native_inject(reply);
+        return;
+    }
+    int start, count;
+    if (sscanf(command.c_str(), "AT+TOPOINFO=%d,%d", &start, &count) == 2)
+    {
+        for (int i = 0; i < count && i < module.nodeCount; i++)
+        {
+            snprintf(reply, sizeof(reply), "\r+ok=0013d76322%02x,%02x,00,1,STA,0,0,1 \r\n", i + 2, i + 2);
+            serial.native_inject(reply);
+        }
+        return;
+    }
+    // "AT+SEND=<MAC>,<长度>,<帧>\r\n": 控制码在帧的第6个字节
+    size_t frameStart = command.find(',', 8 + MAC_HEX_LEN + 1);
+    if (module.replyAck && command.compare(0, 8, "AT+SEND=") == 0 && frameStart != std::string::npos &&
+        (uint8_t)command[frameStart + 1 + FRAME_CTRL_OFFSET] == MsgHeartBeat::CTRL)
+    {
+        std::vector<uint8_t> ack = make_frame(MsgHeartBeatAck::CTRL, NULL, 0);
+        serial.native_inject(ack.data(), ack.size());
+    }
+}
+
+static void collect_frame(const FrameView &frame, void *context)
+{
+    received.push_back(std::vector<uint8_t>(frame.bytes + FRAME_CTRL_OFFSET, frame.bytes + FRAME_DATA_OFFSET + frame.dataLen));
+}
+
+static uint32_t counter(MetricCounter which)
+{
+    MetricsSnapshot snapshot;
+    METRICS_snapshot(snapshot);
+    return snapshot.counters[which];
+}
+
+void setUp(void)
+{
+    static bool initialized = false;
+    if (!initialized)
+    {
+        Serial2.native_set_tx_hook(fake_module_tx, NULL);
+        HPLC_init();
+        initialized = true;
+    }
+    module.commands.clear();
+    module.replyAck = true;
+    module.nodeCount = 0;
+    HPLC_poll(NULL);
+    received.clear();
+}
+
+void tearDown(void)
+{
+}
+
+// 噪声之后的完整帧被解析并由 HPLC_poll 分发
+void test_frame_after_noise_is_dispatched(void)
+{
+    const uint8_t data[] = {0x01, 0x02, 0x03};
+    std::vector<uint8_t> bytes = {'x', 0xFE, 0x00, 0x55};
+    std::vector<uint8_t> frame = make_frame(0x14, data, sizeof(data));
+    bytes.insert(bytes.end(), frame.begin(), frame.end());
+    inject(bytes);
+
+    HPLC_poll(collect_frame);
+    TEST_ASSERT_EQUAL(1, received.size());
+    const uint8_t expected[] = {0x14, 0x03, 0x01, 0x02, 0x03};
+    TEST_ASSERT_EQUAL(sizeof(expected), received[0].size());
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, received[0].data(), sizeof(expected));
+}
+
+// 校验和错误的帧被丢弃并计数，之后的帧照常解析
+void test_bad_checksum_is_dropped(void)
+{
+    const uint8_t data[] = {0x07};
+    std::vector<uint8_t> bad = make_frame(0x14, data, sizeof(data));
+    bad[bad.size() - 2] ^= 0xFF;
+    uint32_t failures = counter(METRIC_HPLC_CHECKSUM_FAIL);
+    inject(bad);
+    inject(make_frame(0x15, data, sizeof(data)));
+
+    HPLC_poll(collect_frame);
+    TEST_ASSERT_EQUAL(failures + 1, counter(METRIC_HPLC_CHECKSUM_FAIL));
+    TEST_ASSERT_EQUAL(1, received.size());
+    TEST_ASSERT_EQUAL_HEX8(0x15, received[0][0]);
+}
+
+// 不需要ACK的帧组装为一条 AT+SEND 命令写出
+void test_send_without_ack_writes_at_send(void)
+{
+    uint8_t mac[6];
+    memcpy(mac, STA_MAC, 6);
+    uint8_t frame[] = {0x13, 0x01, 0x01};
+    TEST_ASSERT_TRUE(HPLC_send_frame(mac, frame, sizeof(frame), false));
+    // 命令排队后由串口任务写出
+    vTaskDelay(pdMS_TO_TICKS(HPLC_TASK_MAX_SLEEP_MS) + 1);
+
+    TEST_ASSERT_EQUAL(1, module.commands.size());
+    std::vector<uint8_t> encoded = make_frame(0x13, &frame[2], 1);
+    std::string expected = "AT+SEND=0013d7632202," + std::to_string(encoded.size()) + ",";
+    expected.append(encoded.begin(), encoded.end());
+    expected += "\r\n";
+    TEST_ASSERT_TRUE(module.commands[0] == expected);
+}
+
+// 需要ACK的请求收到应答后返回成功，ACK不进入接收帧队列
+void test_heart_beat_acked(void)
+{
+    uint8_t mac[6];
+    memcpy(mac, STA_MAC, 6);
+    TEST_ASSERT_TRUE(HPLC_send_heart_beat(mac));
+    TEST_ASSERT_EQUAL(1, module.commands.size());
+
+    HPLC_poll(collect_frame);
+    TEST_ASSERT_EQUAL(0, received.size());
+}
+
+// 没有应答时按 ACK_TIMEOUT_MS 重发，重试用尽后返回失败
+void test_heart_beat_retries_then_fails(void)
+{
+    uint8_t mac[6];
+    memcpy(mac, STA_MAC, 6);
+    module.replyAck = false;
+    uint32_t sendFailures = counter(METRIC_HPLC_SEND_FAIL);
+    unsigned long start = millis();
+
+    TEST_ASSERT_FALSE(HPLC_send_heart_beat(mac));
+    unsigned long elapsed = millis() - start;
+    TEST_ASSERT_EQUAL(3, module.commands.size());
+    TEST_ASSERT_GREATER_OR_EQUAL(3000, elapsed);
+    TEST_ASSERT_LESS_OR_EQUAL(3000 + 2 * HPLC_TASK_MAX_SLEEP_MS, elapsed);
+    TEST_ASSERT_EQUAL(sendFailures + 1, counter(METRIC_HPLC_SEND_FAIL));
+}
+
+// 拓扑查询: AT+TOPONUM? 得到节点数量，AT+TOPOINFO 逐行解析MAC地址
+void test_topology_lists_sta_macs(void)
+{
+    module.nodeCount = 3;
+    uint8_t macs[4][6];
+    uint16_t count = 0;
+
+    TEST_ASSERT_TRUE(HPLC_get_topo_sta_mac_list(macs, 4, &count));
+    TEST_ASSERT_EQUAL(3, count);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(STA_MAC, macs[0], 6);
+    TEST_ASSERT_EQUAL_HEX8(0x04, macs[2][5]);
+    TEST_ASSERT_EQUAL(2, module.commands.size());
+    TEST_ASSERT_TRUE(module.commands[1] == "AT+TOPOINFO=1,3\r\n");
+}
+
+// 节点数量超过数组容量时只查询前 max_count 个
+void test_topology_truncated_to_capacity(void)
+{
+    module.nodeCount = 5;
+    uint8_t macs[2][6];
+    uint16_t count = 0;
+
+    TEST_ASSERT_TRUE(HPLC_get_topo_sta_mac_list(macs, 2, &count));
+    TEST_ASSERT_EQUAL(2, count);
+    TEST_ASSERT_TRUE(module.commands[1] == "AT+TOPOINFO=1,2\r\n");
+}
+
+// 模块不应答 AT+TOPONUM? 时查询失败，之后的查询不受影响
+void test_topology_timeout_recovers(void)
+{
+    module.nodeCount = -1;
+    uint8_t macs[2][6];
+    uint16_t count = 0;
+    Serial2.native_set_tx_hook(NULL, NULL);
+    TEST_ASSERT_FALSE(HPLC_get_topo_sta_mac_list(macs, 2, &count));
+    Serial2.native_take_tx();
+    Serial2.native_set_tx_hook(fake_module_tx, NULL);
+
+    module.nodeCount = 1;
+    TEST_ASSERT_TRUE(HPLC_get_topo_sta_mac_list(macs, 2, &count));
+    TEST_ASSERT_EQUAL(1, count);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_frame_after_noise_is_dispatched);
+    RUN_TEST(test_bad_checksum_is_dropped);
+    RUN_TEST(test_send_without_ack_writes_at_send);
+    RUN_TEST(test_heart_beat_acked);
+    RUN_TEST(test_heart_beat_retries_then_fails);
+    RUN_TEST(test_topology_lists_sta_macs);
+    RUN_TEST(test_topology_truncated_to_capacity);
+    RUN_TEST(test_topology_timeout_recovers);
+    return UNITY_END();
+}
\ No newline at end of file
@@ -0,0 +1,125 @@
+#include <Arduino.h>
+#include <NativeShims.h>
+#include <PowerStrip.h>
+#include <unity.h>
+
+/*
+ * 排插管理器测试 (native)
+ * 每个用例从空的 NVS 开始；重新调用 PowerStrip_init() 相当于设备重启后从 NVS 加载
+ */
+
+static PowerStrip make_strip(uint8_t last, const char *name)
+{
+    PowerStrip strip;
+    const uint8_t mac[6] = {0x00, 0x13, 0xD7, 0x63, 0x22, last};
+    memcpy(strip.macAddress, mac, 6);
+    strip.name = name;
+    for (int i = 0; i < 3; i++)
+    {
+        strip.sockets[i].state = i == 1;
+        strip.sockets[i].maxPower = 1000 + i;
+    }
+    strip.isOnline = true;
+    return strip;
+}
+
+void setUp(void)
+{
+    native_preferences_reset();
+    PowerStrip_init();
+}
+
+void tearDown(void)
+{
+}
+
+// 添加后可按MAC地址取回，重复的MAC地址添加失败
+void test_add_and_get(void)
+{
+    PowerStrip strip = make_strip(0x02, "desk");
+    TEST_ASSERT_TRUE(PowerStrip_add(strip));
+    TEST_ASSERT_FALSE(PowerStrip_add(strip));
+
+    PowerStrip found;
+    TEST_ASSERT_TRUE(PowerStrip_get(strip.macAddress, found));
+    TEST_ASSERT_TRUE(found.name == "desk");
+    TEST_ASSERT_EQUAL_UINT16(1001, found.sockets[1].maxPower);
+    TEST_ASSERT_TRUE(found.sockets[1].state);
+
+    PowerStrip missing = make_strip(0x09, "");
+    TEST_ASSERT_FALSE(PowerStrip_get(missing.macAddress, found));
+}
+
+// 重启后从 NVS 恢复排插列表 (在线状态不持久化)
+void test_reload_from_persistence(void)
+{
+    TEST_ASSERT_TRUE(PowerStrip_add(make_strip(0x02, "desk")));
+    TEST_ASSERT_TRUE(PowerStrip_add(make_strip(0x03, "kitchen")));
+    PowerStrip updated = make_strip(0x03, "kitchen");
+    updated.sockets[0].maxPower = 500;
+    TEST_ASSERT_TRUE(PowerStrip_update(updated));
+
+    PowerStrip_init();
+    std::vector<PowerStrip> all = PowerStrip_get_all();
+    TEST_ASSERT_EQUAL(2, all.size());
+    TEST_ASSERT_TRUE(all[0].name == "desk");
+    TEST_ASSERT_TRUE(all[1].name == "kitchen");
+    TEST_ASSERT_EQUAL_UINT16(500, all[1].sockets[0].maxPower);
+    TEST_ASSERT_FALSE(all[0].isOnline);
+}
+
+// 删除后重启不再出现
+void test_delete_is_persisted(void)
+{
+    PowerStrip first = make_strip(0x02, "desk");
+    TEST_ASSERT_TRUE(PowerStrip_add(first));
+    TEST_ASSERT_TRUE(PowerStrip_add(make_strip(0x03, "kitchen")));
+    TEST_ASSERT_TRUE(PowerStrip_delete(first.macAddress));
+    TEST_ASSERT_FALSE(PowerStrip_delete(first.macAddress));
+
+    PowerStrip_init();
+    std::vector<PowerStrip> all = PowerStrip_get_all();
+    TEST_ASSERT_EQUAL(1, all.size());
+    TEST_ASSERT_TRUE(all[0].name == "kitchen");
+}
+
+// 在线排插按顺序分页获取
+void test_online_range_pages(void)
+{
+    for (uint8_t i = 0; i < 5; i++)
+    {
+        PowerStrip strip = make_strip(0x10 + i, "strip");
+        strip.isOnline = i != 1;
+        TEST_ASSERT_TRUE(PowerStrip_add(strip));
+    }
+    TEST_ASSERT_EQUAL(4, PowerStrip_count_online());
+
+    PowerStrip page[3];
+    TEST_ASSERT_EQUAL(3, PowerStrip_get_online_range(0, page, 3));
+    TEST_ASSERT_EQUAL_HEX8(0x10, page[0].macAddress[5]);
+    TEST_ASSERT_EQUAL_HEX8(0x12, page[1].macAddress[5]);
+    TEST_ASSERT_EQUAL(1, PowerStrip_get_online_range(3, page, 3));
+    TEST_ASSERT_EQUAL_HEX8(0x14, page[0].macAddress[5]);
+}
+
+// 删除全部后内存和 NVS 都为空
+void test_delete_all(void)
+{
+    TEST_ASSERT_TRUE(PowerStrip_add(make_strip(0x02, "desk")));
+    PowerStrip_delete_all();
+    TEST_ASSERT_EQUAL(0, PowerStrip_get_all().size());
+
+    PowerStrip_init();
+    TEST_ASSERT_EQUAL(0, PowerStrip_get_all().size());
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_add_and_get);
+    RUN_TEST(test_reload_from_persistence);
+    RUN_TEST(test_delete_is_persisted);
+    RUN_TEST(test_online_range_pages);
+    RUN_TEST(test_delete_all);
+    return UNITY_END();
+}
\ No newline at end of file
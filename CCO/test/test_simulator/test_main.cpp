@@ -0,0 +1,292 @@
+#include <Arduino.h>
+#include <HplcSim.h>
+#include <Metrics.h>
+#include <NativeShims.h>
+#include <PowerStrip.h>
+#include <Protocol.h>
+#include <chrono>
+#include <malloc.h>
+#include <unistd.h>
+#include <unity.h>
+#include <vector>
+
+/*
+ * HPLC 载波网络模拟 (native)
+ * 运行: 先在STA工程中执行 pio run -e native_station 编译STA镜像，再执行 pio test -e native_sim
+ *
+ * 模拟器为每个STA加载一份真实的STA固件，CCO固件 (src/main.cpp) 在模拟的载波网络上运行 SIM_SWEEPS 个STA监控周期，
+ * 第一个周期结束后通过串口屏帧 (0x42) 随机开关 SIM_COMMANDS 个STA插孔。网络参数见 HPLC_SIM_config_from_env()
+ *
+ * 结果输出一行 JSON (设置 SIM_OUTPUT 时同时写入该文件)，字段:
+ *   sweep_*           STA监控周期 (拓扑查询 + 心跳检测全部排插 + 刷新首页 + 监控间隔) 的耗时 (虚拟时间)，
+ *                     以相邻两次拓扑查询的间隔计时
+ *   heartbeat_* / socket_*  命令时延: CCO第一次发出命令到收到该STA的应答 (含重发)，*_failed 为重发后仍未应答的命令
+ *   rtt_median_ms     CCO固件记录的ACK往返时延中位数
+ *   heap_setup_bytes  CCO setup() 占用的堆；heap_run_bytes 为之后运行期间整个进程堆的增长
+ *   cco_tasks / cco_stack_bytes  CCO固件创建的任务数和声明的栈大小之和；rss_kb 为进程常驻内存 (含全部STA)
+ *   wall_ms           实际耗时
+ * 网络无丢包 (SIM_LOSS 为 0) 时还断言全部STA被发现且在线、全部插孔命令生效
+ */
+
+// 固件入口 (src/main.cpp)
+void setup();
+void loop();
+
+// 插孔命令生效的等待上限 (毫秒，虚拟时间)
+#define SIM_COMMAND_TIMEOUT_MS 5000
+
+static HplcSimConfig config;
+static uint32_t sweeps = 3;
+static uint32_t commands = 20;
+static FILE *output = NULL;
+
+static size_t heapBeforeSetup;
+static size_t heapAfterSetup;
+static uint32_t tasksBeforeSetup;
+static uint32_t stackBeforeSetup;
+static uint32_t ccoTasks;
+static uint32_t ccoStackBytes;
+static uint64_t startUs;
+static uint32_t commandsApplied = 0;
+// 模拟器已启动 (STA镜像加载失败时跳过后续用例)
+static bool simStarted = false;
+
+/**
+ * 固定种子的 xorshift32 伪随机数 (选择命令的目标)
+ */
+static uint32_t rng_state = 0x2545F491;
+
+static uint32_t rng_next()
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+static void discard_tx(HardwareSerial &serial, const uint8_t *data, size_t length, void *context)
+{
+    (void)serial;
+    (void)data;
+    (void)length;
+    (void)context;
+}
+
+// CCO完成的监控周期数
+static uint32_t sweep_count()
+{
+    HplcSimStats stats;
+    HPLC_SIM_get_stats(stats);
+    return stats.sweeps;
+}
+
+/**
+ * 像 Arduino 的 loopTask 一样执行 loop()，直到 done() 成立或超过 timeoutMs (虚拟时间)
+ */
+template <typename Done>
+static bool run_until(Done done, uint32_t timeoutMs)
+{
+    uint64_t deadlineUs = native_time_us() + (uint64_t)timeoutMs * 1000;
+    while (!done())
+    {
+        if (native_time_us() >= deadlineUs)
+        {
+            return false;
+        }
+        loop();
+        vTaskDelay(1);
+    }
+    return true;
+}
+
+// 一个监控周期的耗时上限: 每个STA最多重发到超时，另加监控间隔
+static uint32_t sweep_timeout_ms()
+{
+    return config.stationCount * 5000 + 30000;
+}
+
+static size_t heap_in_use()
+{
+    return mallinfo2().uordblks;
+}
+
+static uint32_t rss_kb()
+{
+    long pages = 0;
+    FILE *statm = fopen("/proc/self/statm", "r");
+    if (statm != NULL)
+    {
+        if (fscanf(statm, "%*ld %ld", &pages) != 1)
+        {
+            pages = 0;
+        }
+        fclose(statm);
+    }
+    return pages * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+// 第一个监控周期发现全部STA并标记在线
+void test_first_sweep_finds_all_stations(void)
+{
+    simStarted = HPLC_SIM_init(config);
+    TEST_ASSERT_TRUE_MESSAGE(simStarted, "STA镜像加载失败");
+    TEST_ASSERT_TRUE_MESSAGE(HPLC_SIM_wait_stations(10000), "STA启动超时");
+
+    heapBeforeSetup = heap_in_use();
+    tasksBeforeSetup = native_task_usage(&stackBeforeSetup);
+    startUs = native_time_us();
+    setup();
+    heapAfterSetup = heap_in_use();
+    ccoTasks = native_task_usage(&ccoStackBytes) - tasksBeforeSetup;
+    ccoStackBytes -= stackBeforeSetup;
+
+    TEST_ASSERT_TRUE_MESSAGE(run_until([]() { return sweep_count() >= 1; }, sweep_timeout_ms()), "第一个监控周期超时");
+    if (config.lossMax == 0)
+    {
+        TEST_ASSERT_EQUAL(config.stationCount, PowerStrip_get_all().size());
+        TEST_ASSERT_EQUAL(config.stationCount, PowerStrip_count_online());
+    }
+}
+
+// 串口屏的插孔开关命令经载波网络到达STA，继电器状态随之改变
+void test_socket_commands_reach_stations(void)
+{
+    if (!simStarted)
+    {
+        TEST_IGNORE_MESSAGE("模拟器未启动");
+    }
+    for (uint32_t i = 0; i < commands; i++)
+    {
+        uint16_t index = rng_next() % config.stationCount;
+        uint8_t socket = 1 + rng_next() % 3;
+        uint8_t state = HPLC_SIM_station_socket_state(index, socket) ? 0 : 1;
+
+        // 串口屏帧: 前导字节 + 起始符 + 0x42 + 长度 + MAC地址 + 插孔ID + 开关状态 + 结束符
+        uint8_t frame[] = {FRAME_LEAD_BYTE, FRAME_LEAD_BYTE, FRAME_LEAD_BYTE, FRAME_LEAD_BYTE, FRAME_HEADER, 0x42, 8, 0, 0, 0, 0, 0, 0, socket, state, FRAME_END};
+        HPLC_SIM_station_address(index, frame + FRAME_DATA_OFFSET);
+        Serial1.native_inject(frame, sizeof(frame));
+
+        if (run_until([&]() { return HPLC_SIM_station_socket_state(index, socket) == state; }, SIM_COMMAND_TIMEOUT_MS))
+        {
+            commandsApplied++;
+        }
+    }
+    if (config.lossMax == 0)
+    {
+        TEST_ASSERT_EQUAL(commands, commandsApplied);
+    }
+}
+
+// 之后的监控周期中全部STA保持在线
+void test_remaining_sweeps(void)
+{
+    if (!simStarted)
+    {
+        TEST_IGNORE_MESSAGE("模拟器未启动");
+    }
+    TEST_ASSERT_TRUE_MESSAGE(run_until([]() { return sweep_count() >= sweeps; }, sweep_timeout_ms() * sweeps), "监控周期超时");
+    if (config.lossMax == 0)
+    {
+        TEST_ASSERT_EQUAL(config.stationCount, PowerStrip_count_online());
+    }
+}
+
+static int append_latency(char *out, size_t size, const char *name, int ctrl_code)
+{
+    HplcSimLatency latency;
+    HPLC_SIM_command_latency(ctrl_code, latency);
+    return snprintf(out, size, ",\"%s_count\":%lu,\"%s_failed\":%lu,\"%s_p50_ms\":%.1f,\"%s_p95_ms\":%.1f,\"%s_p99_ms\":%.1f,\"%s_max_ms\":%.1f",
+                    name, (unsigned long)latency.count, name, (unsigned long)latency.failed, name, latency.p50Us / 1000.0,
+                    name, latency.p95Us / 1000.0, name, latency.p99Us / 1000.0, name, latency.maxUs / 1000.0);
+}
+
+/**
+ * 输出一行结果
+ */
+static void report(double wallMs)
+{
+    HplcSimStats stats;
+    HPLC_SIM_get_stats(stats);
+    MetricsSnapshot metrics;
+    METRICS_snapshot(metrics);
+
+    char line[1536];
+    int n = snprintf(line, sizeof(line),
+                     "{\"bench\":\"hplc_sim\",\"stations\":%u,\"latency_ms\":\"%lu-%lu\",\"jitter_ms\":\"%lu-%lu\",\"loss\":\"%g-%g\",\"seed\":%lu",
+                     config.stationCount, (unsigned long)config.latencyMinMs, (unsigned long)config.latencyMaxMs,
+                     (unsigned long)config.jitterMinMs, (unsigned long)config.jitterMaxMs, config.lossMin, config.lossMax, (unsigned long)config.seed);
+    n += snprintf(line + n, sizeof(line) - n, ",\"sweeps\":%lu,\"sweep_avg_ms\":%.1f,\"sweep_max_ms\":%.1f,\"sweep_last_ms\":%.1f,\"virtual_s\":%.1f",
+                  (unsigned long)stats.sweeps, stats.sweeps ? stats.sweepSumUs / 1000.0 / stats.sweeps : 0.0, stats.sweepMaxUs / 1000.0, stats.sweepLastUs / 1000.0,
+                  (native_time_us() - startUs) / 1e6);
+    n += append_latency(line + n, sizeof(line) - n, "heartbeat", MsgHeartBeat::CTRL);
+    n += append_latency(line + n, sizeof(line) - n, "socket", MsgSetSocketState::CTRL);
+    n += snprintf(line + n, sizeof(line) - n, ",\"socket_applied\":%lu,\"rtt_median_ms\":%lu,\"strips\":%u,\"online\":%u",
+                  (unsigned long)commandsApplied, (unsigned long)METRICS_rtt_median_ms(metrics.rtt),
+                  (unsigned)PowerStrip_get_all().size(), (unsigned)PowerStrip_count_online());
+    n += snprintf(line + n, sizeof(line) - n, ",\"frames_sent\":%lu,\"frames_delivered\":%lu,\"frames_lost\":%lu,\"frames_unroutable\":%lu,\"topo_rows\":%lu",
+                  (unsigned long)stats.framesSent, (unsigned long)stats.framesDelivered, (unsigned long)stats.framesLost,
+                  (unsigned long)stats.framesUnroutable, (unsigned long)stats.topoRows);
+    snprintf(line + n, sizeof(line) - n, ",\"heap_setup_bytes\":%ld,\"heap_run_bytes\":%ld,\"cco_tasks\":%lu,\"cco_stack_bytes\":%lu,\"image_bytes\":%lu,\"rss_kb\":%lu,\"wall_ms\":%.0f}",
+             (long)(heapAfterSetup - heapBeforeSetup), (long)(heap_in_use() - heapAfterSetup), (unsigned long)ccoTasks, (unsigned long)ccoStackBytes,
+             (unsigned long)stats.imageBytes, (unsigned long)rss_kb(), wallMs);
+    printf("%s\n", line);
+    if (output)
+    {
+        fprintf(output, "%s\n", line);
+        fflush(output);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    HPLC_SIM_config_from_env(config);
+    const char *text = getenv("SIM_SWEEPS");
+    if (text != NULL && text[0] != '\0')
+    {
+        sweeps = strtoul(text, NULL, 10);
+    }
+    text = getenv("SIM_COMMANDS");
+    if (text != NULL && text[0] != '\0')
+    {
+        commands = strtoul(text, NULL, 10);
+    }
+    text = getenv("SIM_OUTPUT");
+    if (text != NULL && text[0] != '\0')
+    {
+        output = fopen(text, "w");
+    }
+    rng_state ^= config.seed;
+
+    // CCO的串口监视器输出 (SIM_VERBOSE 未设置时) 和串口屏命令都丢弃
+    if (getenv("SIM_VERBOSE") == NULL)
+    {
+        Serial.native_set_echo(false);
+        Serial.native_set_tx_hook(discard_tx, NULL);
+    }
+    Serial1.native_set_tx_hook(discard_tx, NULL);
+
+    auto wallStart = std::chrono::steady_clock::now();
+    UNITY_BEGIN();
+    RUN_TEST(test_first_sweep_finds_all_stations);
+    RUN_TEST(test_socket_commands_reach_stations);
+    RUN_TEST(test_remaining_sweeps);
+    if (simStarted)
+    {
+        report(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - wallStart).count());
+    }
+    int failures = UNITY_END();
+
+    if (output)
+    {
+        fclose(output);
+    }
+    return failures;
+}
\ No newline at end of file
@@ -0,0 +1,246 @@
+#include <Arduino.h>
+#include <Metrics.h>
+#include <NativeShims.h>
+#include <TJC.h>
+#include <string>
+#include <unity.h>
+#include <vector>
+
+/*
+ * TJC 串口屏模块测试 (native)
+ * Serial1 的发送钩子扮演串口屏: 按自己的波特率接收命令 (波特率不一致时视为乱码)，
+ * 应答 sendme、baud= 和 addt 透传
+ */
+
+static const char END[] = "\xff\xff\xff";
+
+// 定义[模拟串口屏]状态
+typedef struct
+{
+    uint32_t baud;                     // 屏幕当前波特率
+    bool mute;                         // 不应答任何命令 (模拟断开)
+    int writes;                        // 串口任务的写出次数
+    std::string pending;               // 尚未收到结束符的命令
+    std::vector<std::string> commands; // 收到的命令 (不含结束符)
+    uint16_t transparentLeft;          // 透传模式下还要接收的数据点个数
+    std::vector<uint8_t> points;       // 透传收到的数据点
+} FakeScreen;
+
+static FakeScreen screen = {TJC_DEFAULT_BAUD};
+
+// 已分发的帧的控制码
+static std::vector<uint8_t> received;
+
+static void screen_reply(HardwareSerial &serial, uint8_t code, uint8_t value, bool withValue)
+{
+    uint8_t reply[5] = {code, value, 0xFF, 0xFF, 0xFF};
+    if (withValue)
+    {
+        serial.native_inject(reply, 5);
+    }
+    else
+    {
+        reply[1] = 0xFF;
+        serial.native_inject(reply, 4);
+    }
+}
+
+static void screen_command(HardwareSerial &serial, const std::string &command)
+{
+    screen.commands.push_back(command);
+    unsigned long baud;
+    unsigned channel, count;
+    char control[32];
+    if (command == "sendme")
+    {
+        screen_reply(serial, 0x66, 0x00, true);
+    }
+    else if (sscanf(command.c_str(), "baud=%lu", &baud) == 1)
+    {
+        screen.baud = baud;
+    }
+    else if (sscanf(command.c_str(), "addt %31[^.].id,%u,%u", control, &channel, &count) == 3)
+    {
+        screen.transparentLeft = count;
+        screen_reply(serial, TJC_REPLY_TRANSPARENT_READY, 0, false);
+    }
+}
+
+/**
+ * 模拟串口屏: 在串口任务写出时同步接收并应答
+ */
+static void fake_screen_tx(HardwareSerial &serial, const uint8_t *data, size_t length, void *context)
+{
+    screen.writes++;
+    if (screen.mute || serial.baudRate() != screen.baud)
+    {
+        return;
+    }
+    for (size_t i = 0; i < length; i++)
+    {
+        if (screen.transparentLeft > 0)
+        {
+            screen.points.push_back(data[i]);
+            if (--screen.transparentLeft == 0)
+            {
+                screen_reply(serial, TJC_REPLY_TRANSPARENT_DONE, 0, false);
+            }
+            continue;
+        }
+        screen.pending += (char)data[i];
+        if (screen.pending.size() >= 3 && screen.pending.compare(screen.pending.size() - 3, 3, END) == 0)
+        {
+            std::string command = screen.pending.substr(0, screen.pending.size() - 3);
+            screen.pending.clear();
+            screen_command(serial, command);
+        }
+    }
+}
+
+static int count_command(const std::string &command)
+{
+    int count = 0;
+    for (const std::string &c : screen.commands)
+    {
+        count += c == command ? 1 : 0;
+    }
+    return count;
+}
+
+static void collect_frame(const FrameView &frame, void *context)
+{
+    received.push_back(frame.ctrlCode);
+}
+
+static uint32_t counter(MetricCounter which)
+{
+    MetricsSnapshot snapshot;
+    METRICS_snapshot(snapshot);
+    return snapshot.counters[which];
+}
+
+/**
+ * 等待串口任务写出已排队的命令、取走收到的字节
+ */
+static void settle()
+{
+    vTaskDelay(pdMS_TO_TICKS(TJC_TASK_MAX_SLEEP_MS) + 1);
+}
+
+void setUp(void)
+{
+    static bool initialized = false;
+    if (!initialized)
+    {
+        Serial1.native_set_tx_hook(fake_screen_tx, NULL);
+        TJC_init();
+        initialized = true;
+    }
+    screen.mute = false;
+    screen.writes = 0;
+    screen.commands.clear();
+    screen.points.clear();
+    TJC_poll(NULL);
+    received.clear();
+}
+
+void tearDown(void)
+{
+}
+
+// 初始化时探测到屏幕后切换到高速波特率，然后跳转到主页面
+void test_init_switches_to_fast_baud(void)
+{
+    TEST_ASSERT_EQUAL_UINT32(TJC_FAST_BAUD, TJC_get_baud_rate());
+    TEST_ASSERT_EQUAL_UINT32(TJC_FAST_BAUD, screen.baud);
+}
+
+// 属性值未变化时不重复发送，页面失效后重新发送
+void test_set_property_uses_shadow(void)
+{
+    TJC_set_property("Home", "t0", "txt", String("abc"));
+    TJC_set_property("Home", "t0", "txt", String("abc"));
+    settle();
+    TEST_ASSERT_EQUAL(1, count_command("Home.t0.txt=\"abc\""));
+
+    TJC_set_property("Home", "n0", "val", String(12));
+    settle();
+    TEST_ASSERT_EQUAL(1, count_command("Home.n0.val=12"));
+
+    TJC_invalidate_page("Home");
+    TJC_set_property("Home", "t0", "txt", String("abc"));
+    settle();
+    TEST_ASSERT_EQUAL(2, count_command("Home.t0.txt=\"abc\""));
+}
+
+// 批量写入的命令合并为一次写出
+void test_batch_is_written_once(void)
+{
+    TJC_batch_begin();
+    TJC_set_property("Diag", "n0", "val", String(1));
+    TJC_set_property("Diag", "n1", "val", String(2));
+    TJC_goto_page("Diag");
+    TEST_ASSERT_EQUAL(0, screen.writes);
+    TEST_ASSERT_GREATER_THAN(0, TJC_batch_flush());
+    settle();
+
+    TEST_ASSERT_EQUAL(1, screen.writes);
+    TEST_ASSERT_EQUAL(3, screen.commands.size());
+    TEST_ASSERT_TRUE(screen.commands[2] == "page Diag");
+}
+
+// 曲线透传按块写出全部数据点 (数据点已拷贝，调用方返回后即可改写缓冲区)
+void test_waveform_add_transfers_blocks(void)
+{
+    uint8_t points[300];
+    uint8_t expected[300];
+    for (int i = 0; i < 300; i++)
+    {
+        points[i] = (uint8_t)i;
+        expected[i] = (uint8_t)i;
+    }
+    uint32_t failures = counter(METRIC_TJC_WAVEFORM_FAIL);
+    TEST_ASSERT_TRUE(TJC_waveform_add("s0", 0, points, 300));
+    memset(points, 0, sizeof(points));
+    settle();
+    TEST_ASSERT_EQUAL(failures, counter(METRIC_TJC_WAVEFORM_FAIL));
+    TEST_ASSERT_EQUAL(300, screen.points.size());
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, screen.points.data(), 300);
+    TEST_ASSERT_EQUAL(1, count_command("addt s0.id,0,44"));
+}
+
+// 调用方不等待屏幕应答，屏幕不应答时透传在超时后计入失败
+void test_waveform_add_does_not_wait(void)
+{
+    const uint8_t points[4] = {1, 2, 3, 4};
+    screen.mute = true;
+    uint32_t failures = counter(METRIC_TJC_WAVEFORM_FAIL);
+    unsigned long start = millis();
+    TEST_ASSERT_TRUE(TJC_waveform_add("s0", 0, points, 4));
+    TEST_ASSERT_LESS_THAN(TJC_TASK_MAX_SLEEP_MS, millis() - start);
+    vTaskDelay(pdMS_TO_TICKS(TJC_WAVEFORM_TIMEOUT + TJC_TASK_MAX_SLEEP_MS));
+    TEST_ASSERT_EQUAL(failures + 1, counter(METRIC_TJC_WAVEFORM_FAIL));
+}
+
+// 屏幕发来的帧 (没有校验和) 由 TJC_poll 分发
+void test_frame_is_dispatched(void)
+{
+    const uint8_t frame[] = {FRAME_LEAD_BYTE, FRAME_LEAD_BYTE, FRAME_LEAD_BYTE, FRAME_LEAD_BYTE, FRAME_HEADER, 0x21, 0x01, 0x02, FRAME_END};
+    Serial1.native_inject(frame, sizeof(frame));
+    settle();
+    TJC_poll(collect_frame);
+    TEST_ASSERT_EQUAL(1, received.size());
+    TEST_ASSERT_EQUAL_HEX8(0x21, received[0]);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_init_switches_to_fast_baud);
+    RUN_TEST(test_set_property_uses_shadow);
+    RUN_TEST(test_batch_is_written_once);
+    RUN_TEST(test_waveform_add_transfers_blocks);
+    RUN_TEST(test_waveform_add_does_not_wait);
+    RUN_TEST(test_frame_is_dispatched);
+    return UNITY_END();
+}
\ No newline at end of file
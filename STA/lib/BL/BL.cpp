@@ -7,6 +7,8 @@ void BL_init()
 {
     // 初始化串口
     BL.begin(19200, SERIAL_8N1, BL_RX, BL_TX);
+    // 设置读超时，readBytes() 将在UART驱动内阻塞等待，期间让出CPU
+    BL.setTimeout(BL0906_READ_TIMEOUT);
 
     // 延时确保串口初始化完成
     delay(500);
@@ -92,18 +94,11 @@ bool BL_read_register(uint8_t address, uint8_t *dataBuffer)
     BL.flush();
 
     // 2. 等待并读取BL0906返回的数据 (3字节数据 + 1字节校验和)
+    // readBytes() 由UART驱动带超时阻塞读取，等待期间任务挂起，不占用CPU
     uint8_t receivedBytes[4];
-    unsigned long startTime = millis();
-    int bytesRead = 0;
-    while (bytesRead < 4 && (millis() - startTime < BL0906_READ_TIMEOUT))
-    {
-        if (BL.available())
-        {
-            receivedBytes[bytesRead++] = BL.read();
-        }
-    }
+    size_t bytesRead = BL.readBytes(receivedBytes, sizeof(receivedBytes));
 
-    if (bytesRead < 4)
+    if (bytesRead < sizeof(receivedBytes))
     {
         // 超时或数据接收不完整
         return false;
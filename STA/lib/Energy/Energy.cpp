@@ -0,0 +1,126 @@
+#include <Energy.h>
+#include <Preferences.h> // 非易失性存储 (NVS)
+
+// 电能持久化[命名空间]
+#define ENERGY_PERSISTENCE_NS "Energy"
+// 持久化存储 累计脉冲数[键名] (3个插孔存为一个数据块，一次检查点只写一次)
+#define ENERGY_PULSES_KEY "cf_pulses"
+
+// 各插孔累计的 CF 脉冲总数
+static uint32_t total_pulses[ENERGY_SOCKET_COUNT] = {0, 0, 0};
+// 各插孔上一次读取的 CF_CNT 寄存器值
+static uint32_t last_cf_cnt[ENERGY_SOCKET_COUNT] = {0, 0, 0};
+// 各插孔是否已建立 CF_CNT 基准
+static bool baseline_valid[ENERGY_SOCKET_COUNT] = {false, false, false};
+// 自上次检查点以来新增的脉冲数
+static uint32_t unsaved_pulses = 0;
+// 上次检查点的时间 (毫秒)
+static unsigned long last_checkpoint_ms = 0;
+// 电能专用的 Preferences 对象 (检查点在功率监测任务中写入，不与 loop() 中使用的 Persistence 模块共用实例)
+static Preferences energyPreferences;
+// 电能命名空间是否已打开
+static bool storage_open = false;
+
+/**
+ * @brief 初始化电能累计模块
+ * @details 从持久化存储中加载各插孔已累计的脉冲总数，芯片计数器基准在第一次更新时建立
+ */
+void ENERGY_init()
+{
+    // 打开电能命名空间 (保持打开，检查点直接写入)
+    if (!storage_open)
+    {
+        storage_open = energyPreferences.begin(ENERGY_PERSISTENCE_NS, false);
+        if (!storage_open)
+        {
+            Serial.printf("为命名空间 %s 开启持久化失败\n", ENERGY_PERSISTENCE_NS);
+        }
+    }
+
+    // 加载累计脉冲数
+    if (!storage_open || energyPreferences.getBytes(ENERGY_PULSES_KEY, total_pulses, sizeof(total_pulses)) != sizeof(total_pulses))
+    {
+        memset(total_pulses, 0, sizeof(total_pulses)); // 默认从0开始累计
+    }
+
+    for (int i = 0; i < ENERGY_SOCKET_COUNT; i++)
+    {
+        baseline_valid[i] = false;
+    }
+    unsaved_pulses = 0;
+    last_checkpoint_ms = millis();
+}
+
+/**
+ * @brief 使用 BL0906 CF_CNT 寄存器的最新读数更新指定插孔的累计电能
+ * @details 处理 24 位计数器回绕，开机后的第一次读数只建立基准不计入累计
+ * @param socket_num 插孔编号 (1, 2, 3)
+ * @param cf_cnt 从 CF_CNT 寄存器读取的 24 位脉冲计数
+ */
+void ENERGY_update(uint8_t socket_num, uint32_t cf_cnt)
+{
+    if (socket_num < 1 || socket_num > ENERGY_SOCKET_COUNT)
+    {
+        return;
+    }
+    uint8_t socket_index = socket_num - 1;
+    cf_cnt &= ENERGY_CF_CNT_MASK;
+
+    if (baseline_valid[socket_index])
+    {
+        // 无符号减法取低 24 位，自然处理计数器回绕
+        uint32_t delta = (cf_cnt - last_cf_cnt[socket_index]) & ENERGY_CF_CNT_MASK;
+        if (delta <= ENERGY_MAX_PULSES_PER_UPDATE)
+        {
+            total_pulses[socket_index] += delta;
+            unsaved_pulses += delta;
+        }
+        // 否则视为芯片复位或读数异常，丢弃本次增量，仅重建基准
+    }
+
+    last_cf_cnt[socket_index] = cf_cnt;
+    baseline_valid[socket_index] = true;
+}
+
+/**
+ * @brief 获取指定插孔累计的电能脉冲总数
+ * @param socket_num 插孔编号 (1, 2, 3)
+ * @return uint32_t 累计的 CF 脉冲数 (使用 BLRegConv 换算为电能)
+ */
+uint32_t ENERGY_get_pulses(uint8_t socket_num)
+{
+    if (socket_num < 1 || socket_num > ENERGY_SOCKET_COUNT)
+    {
+        return 0;
+    }
+    return total_pulses[socket_num - 1];
+}
+
+/**
+ * @brief 按需将累计电能写入持久化存储 (低磨损检查点)
+ * @details 仅当存在未保存的增量，且增量达到 ENERGY_CHECKPOINT_PULSES 或距上次写入超过 ENERGY_CHECKPOINT_INTERVAL_MS 时才写入
+ * @param force 为 true 时只要存在未保存的增量就立即写入 (如插孔断开后保存最终读数)
+ * @return bool 本次发生写入且成功返回 true，否则返回 false
+ */
+bool ENERGY_checkpoint(bool force)
+{
+    // 没有新增量，不写 Flash
+    if (unsaved_pulses == 0)
+    {
+        return false;
+    }
+
+    // 未达到写入条件
+    if (!force && unsaved_pulses < ENERGY_CHECKPOINT_PULSES && millis() - last_checkpoint_ms < ENERGY_CHECKPOINT_INTERVAL_MS)
+    {
+        return false;
+    }
+
+    bool success = storage_open && energyPreferences.putBytes(ENERGY_PULSES_KEY, total_pulses, sizeof(total_pulses)) == sizeof(total_pulses);
+    if (success)
+    {
+        unsaved_pulses = 0;
+        last_checkpoint_ms = millis();
+    }
+    return success;
+}
\ No newline at end of file
@@ -0,0 +1,49 @@
+#ifndef ENERGY_H
+#define ENERGY_H
+
+#include <Arduino.h>
+
+// 插孔数量
+#define ENERGY_SOCKET_COUNT 3
+
+// CF_CNT 寄存器为 24 位计数器
+#define ENERGY_CF_CNT_MASK 0x00FFFFFF
+
+// 单个采样周期内允许的最大脉冲增量，超过视为芯片复位，仅重建基准
+#define ENERGY_MAX_PULSES_PER_UPDATE 0x1000
+
+// 检查点: 累计脉冲增量达到该值时写入持久化存储
+#define ENERGY_CHECKPOINT_PULSES 64
+// 检查点: 距上次写入超过该时间 (毫秒) 且有新增脉冲时写入持久化存储
+#define ENERGY_CHECKPOINT_INTERVAL_MS (15UL * 60UL * 1000UL)
+
+/**
+ * @brief 初始化电能累计模块
+ * @details 从持久化存储中加载各插孔已累计的脉冲总数，芯片计数器基准在第一次更新时建立
+ */
+void ENERGY_init();
+
+/**
+ * @brief 使用 BL0906 CF_CNT 寄存器的最新读数更新指定插孔的累计电能
+ * @details 处理 24 位计数器回绕，开机后的第一次读数只建立基准不计入累计
+ * @param socket_num 插孔编号 (1, 2, 3)
+ * @param cf_cnt 从 CF_CNT 寄存器读取的 24 位脉冲计数
+ */
+void ENERGY_update(uint8_t socket_num, uint32_t cf_cnt);
+
+/**
+ * @brief 获取指定插孔累计的电能脉冲总数
+ * @param socket_num 插孔编号 (1, 2, 3)
+ * @return uint32_t 累计的 CF 脉冲数 (使用 BLRegConv 换算为电能)
+ */
+uint32_t ENERGY_get_pulses(uint8_t socket_num);
+
+/**
+ * @brief 按需将累计电能写入持久化存储 (低磨损检查点)
+ * @details 仅当存在未保存的增量，且增量达到 ENERGY_CHECKPOINT_PULSES 或距上次写入超过 ENERGY_CHECKPOINT_INTERVAL_MS 时才写入
+ * @param force 为 true 时只要存在未保存的增量就立即写入 (如插孔断开后保存最终读数)
+ * @return bool 本次发生写入且成功返回 true，否则返回 false
+ */
+bool ENERGY_checkpoint(bool force);
+
+#endif
\ No newline at end of file
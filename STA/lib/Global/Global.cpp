@@ -11,21 +11,110 @@ void print_to_serial_monitor(const char *prefix, uint8_t data)
 }
 
 /**
- * @brief 将6字节的MAC地址转换为十六进制字符串表示
+ * @brief 为[帧解析器]缓冲区中保存的完整帧建立视图
+ * @param parser 保存完整帧的解析器 (如 HPLC_send_request 取回的应答帧)
+ * @return FrameView 帧视图，有效期与 parser 相同
+ */
+FrameView frame_view(const FrameParser &parser)
+{
+    FrameView frame;
+    frame.bytes = parser.buffer;
+    frame.length = parser.index;
+    frame.ctrlCode = parser.buffer[FRAME_CTRL_OFFSET];
+    frame.dataLen = parser.buffer[FRAME_LEN_OFFSET];
+    frame.data = parser.buffer + FRAME_DATA_OFFSET;
+    return frame;
+}
+
+/**
+ * @brief 为[帧数据]中保存的完整帧建立视图
+ * @param frame 保存完整帧的帧数据 (如接收帧队列的槽位)
+ * @return FrameView 帧视图，有效期与 frame 相同
+ */
+FrameView frame_view(const FrameBytes &frame)
+{
+    FrameView view;
+    view.bytes = frame.bytes;
+    view.length = frame.length;
+    view.ctrlCode = frame.bytes[FRAME_CTRL_OFFSET];
+    view.dataLen = frame.bytes[FRAME_LEN_OFFSET];
+    view.data = frame.bytes + FRAME_DATA_OFFSET;
+    return view;
+}
+
+// 半字节 -> 十六进制字符 (小写，与NVS中已保存的键名保持一致)
+static const char HEX_DIGITS[16] = {'0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f'};
+
+/**
+ * 十六进制字符 -> 半字节，非法字符返回 0xFF
+ */
+static inline uint8_t hex_value(char c)
+{
+    if (c >= '0' && c <= '9')
+    {
+        return c - '0';
+    }
+    // 转为小写后判断
+    c |= 0x20;
+    if (c >= 'a' && c <= 'f')
+    {
+        return c - 'a' + 10;
+    }
+    return 0xFF;
+}
+
+/**
+ * @brief 将6字节的MAC地址转换为十六进制字符串 (小写，写入调用方提供的缓冲区)
  * @param macAddress 6字节的MAC地址数组
- * @return String MAC地址的十六进制字符串形式 (如 "AABBCCDDEEFF")
+ * @param out 输出缓冲区，至少 MAC_HEX_LEN + 1 字节，结果以 '\0' 结尾 (如 "aabbccddeeff")
  */
-String mac_to_string(const uint8_t macAddress[6])
+void mac_to_hex(const uint8_t macAddress[6], char out[MAC_HEX_LEN + 1])
+{
+    for (int i = 0; i < 6; ++i)
+    {
+        out[i * 2] = HEX_DIGITS[macAddress[i] >> 4];
+        out[i * 2 + 1] = HEX_DIGITS[macAddress[i] & 0x0F];
+    }
+    out[MAC_HEX_LEN] = '\0';
+}
+
+/**
+ * @brief 将12字符的十六进制字符串转换为6字节的MAC地址 (大小写均可)
+ * @param hex 十六进制字符串，至少包含12个字符
+ * @param macAddress 输出参数，用于存储转换后的6字节MAC地址数组
+ * @return true 转换成功
+ * @return false 字符串中含有非十六进制字符 (macAddress 内容未定义)
+ */
+bool hex_to_mac(const char *hex, uint8_t macAddress[6])
 {
-    // 创建字符串流
-    std::stringstream ss;
     for (int i = 0; i < 6; ++i)
     {
-        // 将每个字节转换为2位十六进制数，不足两位前面补0
-        ss << std::hex << std::setw(2) << std::setfill('0') << (int)macAddress[i];
+        uint8_t high = hex_value(hex[i * 2]);
+        // 遇到结束符时 high 为 0xFF，不会再读取后面的字符
+        if (high == 0xFF)
+        {
+            return false;
+        }
+        uint8_t low = hex_value(hex[i * 2 + 1]);
+        if (low == 0xFF)
+        {
+            return false;
+        }
+        macAddress[i] = (high << 4) | low;
     }
-    // 返回转换后的 Arduino String 对象
-    return String(ss.str().c_str());
+    return true;
+}
+
+/**
+ * @brief 将6字节的MAC地址转换为十六进制字符串表示
+ * @param macAddress 6字节的MAC地址数组
+ * @return String MAC地址的十六进制字符串形式 (如 "AABBCCDDEEFF")
+ */
+String mac_to_string(const uint8_t macAddress[6])
+{
+    char hex[MAC_HEX_LEN + 1];
+    mac_to_hex(macAddress, hex);
+    return String(hex);
 }
 
 /**
@@ -35,11 +124,9 @@ String mac_to_string(const uint8_t macAddress[6])
  */
 void string_to_mac(const String &macString, uint8_t macAddress[6])
 {
-    for (int i = 0; i < 6; ++i)
+    if (macString.length() < MAC_HEX_LEN || !hex_to_mac(macString.c_str(), macAddress))
     {
-        // 取出两个字符组成一个字节的十六进制表示
-        char hex_pair[3] = {macString.charAt(i * 2), macString.charAt(i * 2 + 1), '\0'};
-        // 将十六进制字符串转换为字节
-        macAddress[i] = strtol(hex_pair, NULL, 16);
+        // 格式错误时输出全0地址，避免残留数据
+        memset(macAddress, 0, 6);
     }
 }
\ No newline at end of file
@@ -2,9 +2,6 @@
 #define GLOBAL_H
 
 #include <Arduino.h>
-#include <sstream>    // 将MAC地址转换为字符串
-#include <iomanip>    // 格式化十六进制输出
-#include <functional> // lambda函数std::function
 
 // 定义[获取数组长度]函数
 #define ARRAY_LENGTH(arr) (sizeof(arr) / sizeof(arr[0]))
@@ -15,6 +12,14 @@
 #define FRAME_END 0x16       // 帧结束符
 #define MAX_FRAME_LEN 64     // 最大帧长度
 
+// 载波网络中最多管理的STA数量
+#define STA_MAX_COUNT 256
+
+// 定义[历史记录层级](HPLC 0x17 查询使用)
+#define HISTORY_TIER_RAW 0x00     // 原始采样
+#define HISTORY_TIER_MINUTE 0x01  // 1分钟汇总 (最小/最大/平均)
+#define HISTORY_TIER_QUARTER 0x02 // 15分钟汇总 (最小/最大/平均)
+
 // 定义[帧解析状态枚举]类型
 typedef enum
 {
@@ -37,8 +42,44 @@ typedef struct
     byte checksum;              // 校验和
 } FrameParser;
 
-// 定义[帧回调函数]类型
-typedef std::function<void(FrameParser)> FrameCallbackFunc;
+// 完整帧中控制码、数据域长度、数据域的偏移 (前导字节(4) + 帧起始符(1) 之后)
+#define FRAME_CTRL_OFFSET 5
+#define FRAME_LEN_OFFSET 6
+#define FRAME_DATA_OFFSET 7
+
+// 定义[帧视图]类型: 指向解析器缓冲区中完整帧的只读视图，不拷贝帧内容
+typedef struct
+{
+    const uint8_t *bytes; // 完整帧 (前导字节 ~ 帧结束符)
+    uint8_t length;       // 完整帧长度
+    uint8_t ctrlCode;     // 控制码
+    uint8_t dataLen;      // 数据域长度
+    const uint8_t *data;  // 数据域 (dataLen 字节)
+} FrameView;
+
+// 定义[帧数据]类型: 只保存完整帧的字节，供队列在槽位内原地存放
+typedef struct
+{
+    uint8_t length;               // 完整帧长度
+    uint8_t bytes[MAX_FRAME_LEN]; // 完整帧 (前导字节 ~ 帧结束符)
+} FrameBytes;
+
+// 定义[帧回调函数]类型: frame 仅在回调期间有效，context 为调用方传入的上下文
+typedef void (*FrameCallbackFunc)(const FrameView &frame, void *context);
+
+/**
+ * @brief 为[帧解析器]缓冲区中保存的完整帧建立视图
+ * @param parser 保存完整帧的解析器 (如 HPLC_send_request 取回的应答帧)
+ * @return FrameView 帧视图，有效期与 parser 相同
+ */
+FrameView frame_view(const FrameParser &parser);
+
+/**
+ * @brief 为[帧数据]中保存的完整帧建立视图
+ * @param frame 保存完整帧的帧数据 (如接收帧队列的槽位)
+ * @return FrameView 帧视图，有效期与 frame 相同
+ */
+FrameView frame_view(const FrameBytes &frame);
 
 /**
  * @brief 将数据打印到串口监视器
@@ -47,6 +88,25 @@ typedef std::function<void(FrameParser)> FrameCallbackFunc;
  */
 void print_to_serial_monitor(const char *prefix, uint8_t data);
 
+// MAC地址十六进制字符串的长度 (不含结束符)
+#define MAC_HEX_LEN 12
+
+/**
+ * @brief 将6字节的MAC地址转换为十六进制字符串 (小写，写入调用方提供的缓冲区)
+ * @param macAddress 6字节的MAC地址数组
+ * @param out 输出缓冲区，至少 MAC_HEX_LEN + 1 字节，结果以 '\0' 结尾 (如 "aabbccddeeff")
+ */
+void mac_to_hex(const uint8_t macAddress[6], char out[MAC_HEX_LEN + 1]);
+
+/**
+ * @brief 将12字符的十六进制字符串转换为6字节的MAC地址 (大小写均可)
+ * @param hex 十六进制字符串，至少包含12个字符
+ * @param macAddress 输出参数，用于存储转换后的6字节MAC地址数组
+ * @return true 转换成功
+ * @return false 字符串中含有非十六进制字符 (macAddress 内容未定义)
+ */
+bool hex_to_mac(const char *hex, uint8_t macAddress[6]);
+
 /**
  * @brief 将6字节的MAC地址转换为十六进制字符串表示
  * @param macAddress 6字节的MAC地址数组
@@ -0,0 +1,157 @@
+#ifndef MPSC_QUEUE_H
+#define MPSC_QUEUE_H
+
+#include <Arduino.h>
+
+/**
+ * @brief 有界无锁队列 (多生产者、单消费者)
+ * @details 每个槽位带一个序号，生产者用 CAS 抢占写入位置，消费者按序号判断槽位是否已写完。
+ *          不加锁、不关中断，可在任意核心的任意任务中入队；同一时间只能有一个任务出队。
+ *          队列满时入队失败，由调用方决定丢弃或重试。
+ * @tparam T 元素类型 (按值拷贝)
+ * @tparam Capacity 容量，必须是2的幂
+ */
+template <typename T, uint32_t Capacity>
+class MpscQueue
+{
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "队列容量必须是2的幂");
+
+public:
+    MpscQueue() : enqueuePos(0), dequeuePos(0)
+    {
+        for (uint32_t i = 0; i < Capacity; i++)
+        {
+            cells[i].sequence = i;
+        }
+    }
+
+    /**
+     * @brief 入队 (可由多个任务同时调用)
+     * @param item 元素
+     * @return true 入队成功
+     * @return false 队列已满
+     */
+    bool push(const T &item)
+    {
+        uint32_t pos;
+        T *slot = reserve(pos);
+        if (slot == NULL)
+        {
+            return false;
+        }
+        *slot = item;
+        commit(pos);
+        return true;
+    }
+
+    /**
+     * @brief 抢占一个槽位，由生产者在槽位内原地写入元素 (可由多个任务同时调用)
+     * @details 写完后必须调用 commit() 发布，期间消费者看不到该元素及其后的元素
+     * @param pos 输出参数，抢占到的写入位置 (传给 commit())
+     * @return T* 槽位内的元素，队列已满时返回 NULL
+     */
+    T *reserve(uint32_t &pos)
+    {
+        pos = __atomic_load_n(&enqueuePos, __ATOMIC_RELAXED);
+        while (true)
+        {
+            Cell &cell = cells[pos & (Capacity - 1)];
+            uint32_t sequence = __atomic_load_n(&cell.sequence, __ATOMIC_ACQUIRE);
+            int32_t diff = (int32_t)(sequence - pos);
+            if (diff == 0)
+            {
+                // 槽位空闲，抢占写入位置，失败时 pos 被更新为最新值后重试
+                if (__atomic_compare_exchange_n(&enqueuePos, &pos, pos + 1, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+                {
+                    return &cell.data;
+                }
+            }
+            else if (diff < 0)
+            {
+                // 槽位尚未被消费者取走，队列已满
+                return NULL;
+            }
+            else
+            {
+                // 其它生产者已经占用该位置
+                pos = __atomic_load_n(&enqueuePos, __ATOMIC_RELAXED);
+            }
+        }
+    }
+
+    /**
+     * @brief 发布 reserve() 抢占并写完的槽位
+     * @param pos reserve() 返回的写入位置
+     */
+    void commit(uint32_t pos)
+    {
+        __atomic_store_n(&cells[pos & (Capacity - 1)].sequence, pos + 1, __ATOMIC_RELEASE);
+    }
+
+    /**
+     * @brief 出队 (同一时间只能由一个任务调用)
+     * @param item 输出参数，取出的元素
+     * @return true 取出成功
+     * @return false 队列为空 (或队首元素尚未写完)
+     */
+    bool pop(T &item)
+    {
+        Cell &cell = cells[dequeuePos & (Capacity - 1)];
+        uint32_t sequence = __atomic_load_n(&cell.sequence, __ATOMIC_ACQUIRE);
+        if (sequence != dequeuePos + 1)
+        {
+            return false;
+        }
+        item = cell.data;
+        pop_front();
+        return true;
+    }
+
+    /**
+     * @brief 原地查看队首元素，不拷贝 (同一时间只能由一个任务调用)
+     * @details 元素在调用 pop_front() 之前保持有效，生产者不会覆盖该槽位
+     * @return T* 队首元素，队列为空 (或队首元素尚未写完) 时返回 NULL
+     */
+    T *front()
+    {
+        Cell &cell = cells[dequeuePos & (Capacity - 1)];
+        if (__atomic_load_n(&cell.sequence, __ATOMIC_ACQUIRE) != dequeuePos + 1)
+        {
+            return NULL;
+        }
+        return &cell.data;
+    }
+
+    /**
+     * @brief 移除队首元素，槽位交还给生产者 (仅在 front() 返回非 NULL 后调用)
+     */
+    void pop_front()
+    {
+        Cell &cell = cells[dequeuePos & (Capacity - 1)];
+        // 序号前进一圈
+        __atomic_store_n(&cell.sequence, dequeuePos + Capacity, __ATOMIC_RELEASE);
+        __atomic_store_n(&dequeuePos, dequeuePos + 1, __ATOMIC_RELAXED);
+    }
+
+    /**
+     * @brief 当前元素个数 (近似值，仅用于统计)
+     */
+    uint32_t size() const
+    {
+        return __atomic_load_n(&enqueuePos, __ATOMIC_RELAXED) - __atomic_load_n(&dequeuePos, __ATOMIC_RELAXED);
+    }
+
+private:
+    // 定义[槽位]
+    struct Cell
+    {
+        uint32_t sequence; // 序号: 等于写入位置表示空闲，等于写入位置+1表示已写入
+        T data;            // 元素
+    };
+
+    Cell cells[Capacity];  // 槽位
+    uint32_t enqueuePos;   // 下一个写入位置
+    uint32_t dequeuePos;   // 下一个读取位置 (仅消费者修改)
+};
+
+#endif
\ No newline at end of file
@@ -3,23 +3,119 @@
 
 #include <Arduino.h>
 #include <Global.h>
+#include <Protocol.h>
 
 // IO口
 #define HPLC Serial2
 #define HPLC_TX 8
 #define HPLC_RX 3
 
+// [AT命令]前缀缓存的容量 (按目标地址直接映射)
+#define HPLC_PREFIX_CACHE_SIZE 16
+
+// AT应答行缓冲区大小 (超出的内容被截断)
+#define HPLC_AT_LINE_SIZE 64
+
+// 接收帧队列容量 (帧，必须是2的幂，队列满时新收到的帧被丢弃)
+#define HPLC_RX_QUEUE_SIZE 16
+// AT应答行队列容量 (行，必须是2的幂)
+#define HPLC_LINE_QUEUE_SIZE 16
+// 发送队列容量 (不需要应答的命令，必须是2的幂，队列满时发送失败)
+#define HPLC_TX_QUEUE_SIZE 8
+// 请求队列容量 (需要ACK的请求，必须是2的幂，每个任务同一时间最多一个)
+#define HPLC_REQUEST_QUEUE_SIZE 4
+// AT查询队列容量 (必须是2的幂，同一时间只有查询拓扑的任务使用)
+#define HPLC_AT_QUEUE_SIZE 2
+// 串口任务堆栈大小 (字节)
+#define HPLC_TASK_STACK_SIZE 3072
+// 串口任务优先级 (高于 loop() 和监控任务，串口数据总能被及时取走)
+#define HPLC_TASK_PRIORITY 3
+// 串口任务没有被唤醒时的最长休眠时间 (ms，收到串口数据或新的命令时立即唤醒，这里只是兜底轮询)
+#define HPLC_TASK_MAX_SLEEP_MS 10
+// 发送方等待请求完成时单次休眠的上限 (ms，请求完成时由串口任务直接唤醒，这里只是兜底)
+#define HPLC_WAIT_GUARD_MS 100
+
+// 完整[AT命令]的最大长度: "AT+SEND=<MAC>," + 长度(最多3位) + "," + 帧 + "\r\n"
+#define HPLC_AT_SEND_MAX_LEN (8 + MAC_HEX_LEN + 1 + 3 + 1 + MAX_FRAME_LEN + 2)
+
+// 处理函数表中表示"不校验数据域长度"的值 (变长消息由处理函数自行校验)
+#define HPLC_LEN_ANY 0xFF
+
+// 定义[帧处理函数]类型
+typedef void (*HPLCFrameHandler)(const FrameView &frame);
+
+// 定义[控制码处理表项]类型
+typedef struct
+{
+    HPLCFrameHandler handler; // 处理函数 (NULL 表示本机不处理该控制码)
+    uint8_t expectedLen;      // 期望的数据域长度 (HPLC_LEN_ANY 表示不校验)
+    uint8_t ackCode;          // 发送该控制码时期望的应答控制码 (0x00 表示无应答)
+} HPLCHandlerEntry;
+
+/*
+ * 串口只由串口任务读写，其它任务不加锁，只通过无锁队列与它交换消息:
+ * - 不需要应答的命令放入发送队列，由串口任务依次写出
+ * - 需要ACK的请求放入请求队列，由串口任务逐个写出、等待ACK和重发，
+ *   发送方在请求完成前阻塞，不影响接收和分发
+ * - AT查询放入AT查询队列，查询期间串口任务转发AT应答行；只在等待节点数量的一次应答期间
+ *   暂停需要ACK的请求，逐行读取拓扑信息时照常执行，读取耗时不会随STA数量推迟 loop() 的请求
+ * - 期望的ACK直接交给请求方，其它帧放入接收帧队列，由 loop() 调用 HPLC_poll 取出分发
+ * 等待都不轮询: 串口接收回调和入队方用任务通知唤醒串口任务，请求完成或收到AT应答行时
+ * 串口任务再用任务通知唤醒等待中的任务。
+ */
+
 /**
  * @brief 初始化HPLC模块
+ * @details 启动串口任务，此后串口只由串口任务读写
  */
 void HPLC_init();
 
 /**
- * @brief 处理接收到的数据帧
- * @param data 接收到的数据
- * @param callback 回调函数
+ * @brief 注册控制码的处理函数
+ * @param ctrl_code 控制码
+ * @param handler 处理函数 (NULL 表示只登记应答控制码)
+ * @param expected_len 期望的数据域长度，长度不符的帧不会交给处理函数 (HPLC_LEN_ANY 表示不校验)
+ * @param ack_code 发送该控制码时期望的应答控制码 (0x00 表示保持默认)
  */
-void HPLC_process_frame(uint8_t data, FrameCallbackFunc callback);
+void HPLC_register_handler(uint8_t ctrl_code, HPLCFrameHandler handler, uint8_t expected_len, uint8_t ack_code);
+
+/**
+ * @brief 按消息类型注册处理函数，控制码和数据域长度取自消息定义
+ * @param handler 处理函数
+ * @param ack_code 发送该消息时期望的应答控制码 (0x00 表示保持默认)
+ */
+template <typename T>
+void HPLC_register_message(HPLCFrameHandler handler, uint8_t ack_code = 0x00)
+{
+    HPLC_register_handler(T::CTRL, handler, protocol_data_len<T>(), ack_code);
+}
+
+/**
+ * @brief 将完整帧分发给已注册的处理函数
+ * @details 按控制码查表，校验数据域长度后调用处理函数，未注册或长度不符的帧被丢弃
+ * @param frame 完整帧
+ * @param context 未使用 (与[帧回调函数]类型一致，可直接传给 HPLC_poll)
+ */
+void HPLC_dispatch_frame(const FrameView &frame, void *context);
+
+/**
+ * @brief 将收到的字节依次送入帧解析器和AT应答行匹配
+ * @details 由串口任务调用；串口任务未启动时 (如 native 环境的基准测试) 也可直接调用，
+ *          解析器状态不加锁，不能与串口任务同时调用
+ * @param data 收到的字节
+ * @param length 字节数
+ * @param callback 回调函数，每个完整帧调用一次 (帧视图仅在回调期间有效)
+ * @param context 传给回调函数的上下文
+ */
+void HPLC_parse(const uint8_t data[], size_t length, FrameCallbackFunc callback, void *context = NULL);
+
+/**
+ * @brief 分发串口任务已解析的帧
+ * @details 在 loop() 中调用 (同一时间只能由一个任务调用)，不等待串口，也不会被其它任务的请求阻塞
+ * @param callback 回调函数，每个帧调用一次 (帧视图仅在回调期间有效)
+ * @param context 传给回调函数的上下文
+ */
+void HPLC_poll(FrameCallbackFunc callback, void *context = NULL);
 
 /**
  * @brief 发送数据帧
@@ -32,6 +128,27 @@ void HPLC_process_frame(uint8_t data, FrameCallbackFunc callback);
  */
 bool HPLC_send_frame(uint8_t target_address[], uint8_t frame[], int frame_length, bool is_ack_needed);
 
+/**
+ * @brief 将帧内容组装为完整的[AT命令] (与 HPLC_send_frame 写出的内容相同)
+ * @param target_address 目标地址
+ * @param frame 数据帧
+ * @param frame_length 数据帧长度
+ * @param out 输出缓冲区，至少 HPLC_AT_SEND_MAX_LEN 字节
+ * @return size_t 命令长度，数据帧长度非法时返回 0
+ */
+size_t HPLC_build_command(const uint8_t target_address[], const uint8_t frame[], int frame_length, uint8_t out[HPLC_AT_SEND_MAX_LEN]);
+
+/**
+ * @brief 发送请求帧并取回携带数据的ACK应答帧
+ * @param target_address 目标地址
+ * @param frame 数据帧
+ * @param frame_length 数据帧长度
+ * @param response 用于接收ACK应答帧的输出参数
+ * @return true 收到应答
+ * @return false 发送失败或应答超时
+ */
+bool HPLC_send_request(uint8_t target_address[], uint8_t frame[], int frame_length, FrameParser &response);
+
 /**
  * @brief 发送心跳包
  * @param target_address 目标地址
@@ -48,11 +165,13 @@ void HPLC_reply_heart_beat(uint8_t target_address[]);
 
 /**
  * @brief 获取网络拓扑中STA设备的MAC地址列表
+ * @details 同一时间只能由一个任务调用 (应答行队列只有一个读取方)
  * @param sta_mac_list 存储STA设备MAC地址的数组
+ * @param max_count sta_mac_list 数组的容量，超出的节点会被忽略
  * @param sta_count 存储STA设备数量的指针
  * @return true 获取成功
  * @return false 获取失败
  */
-bool HPLC_get_topo_sta_mac_list(uint8_t sta_mac_list[][6], uint8_t *sta_count);
+bool HPLC_get_topo_sta_mac_list(uint8_t sta_mac_list[][6], uint16_t max_count, uint16_t *sta_count);
 
 #endif
\ No newline at end of file
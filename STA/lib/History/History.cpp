@@ -0,0 +1,230 @@
+#include <History.h>
+
+// 定义[汇总累加器]，随采样到达增量更新
+struct RollupAccumulator
+{
+    uint64_t sum;         // 功率累加和 (mW)
+    uint32_t count;       // 累加的采样数
+    uint32_t min;         // 最小功率 (mW)
+    uint32_t max;         // 最大功率 (mW)
+    unsigned long period; // 当前所属周期编号 (时间 / 周期长度)
+};
+
+// 定义[单个插孔的历史记录]，整体分配在一块连续内存中
+struct SocketHistory
+{
+    HistorySample raw[HISTORY_RAW_CAPACITY];
+    HistoryRollup minute[HISTORY_MINUTE_CAPACITY];
+    HistoryRollup quarter[HISTORY_QUARTER_CAPACITY];
+    uint16_t rawHead, rawCount;         // 原始采样环形缓冲区 写入位置/有效条数
+    uint16_t minuteHead, minuteCount;   // 1分钟汇总环形缓冲区 写入位置/有效条数
+    uint16_t quarterHead, quarterCount; // 15分钟汇总环形缓冲区 写入位置/有效条数
+    RollupAccumulator minuteAcc;        // 当前1分钟周期累加器
+    RollupAccumulator quarterAcc;       // 当前15分钟周期累加器
+};
+
+// 各插孔的历史记录
+static SocketHistory *histories = nullptr;
+// 写入任务与查询任务运行在不同核心上，短临界区保护环形缓冲区
+static portMUX_TYPE historyMux = portMUX_INITIALIZER_UNLOCKED;
+
+/**
+ * 重置累加器并进入新的周期
+ */
+static void reset_accumulator(RollupAccumulator &acc, unsigned long period)
+{
+    acc.sum = 0;
+    acc.count = 0;
+    acc.min = UINT32_MAX;
+    acc.max = 0;
+    acc.period = period;
+}
+
+/**
+ * 将一个累加器的结果生成汇总记录
+ */
+static HistoryRollup accumulator_to_rollup(const RollupAccumulator &acc)
+{
+    HistoryRollup rollup;
+    rollup.minPowerMilliWatts = acc.min;
+    rollup.maxPowerMilliWatts = acc.max;
+    rollup.avgPowerMilliWatts = (uint32_t)(acc.sum / acc.count);
+    return rollup;
+}
+
+/**
+ * 向环形缓冲区写入一条记录
+ */
+template <typename T>
+static void ring_push(T *ring, uint16_t capacity, uint16_t &head, uint16_t &count, const T &item)
+{
+    ring[head] = item;
+    head = (head + 1) % capacity;
+    if (count < capacity)
+    {
+        count++;
+    }
+}
+
+/**
+ * 从环形缓冲区按从新到旧的顺序读取记录
+ */
+template <typename T>
+static uint16_t ring_read(const T *ring, uint16_t capacity, uint16_t head, uint16_t count, uint16_t offset, T *out, uint16_t max_count)
+{
+    uint16_t read = 0;
+    while (read < max_count && offset + read < count)
+    {
+        // 最新一条位于 head - 1
+        uint16_t index = (head + capacity - 1 - offset - read) % capacity;
+        out[read++] = ring[index];
+    }
+    return read;
+}
+
+/**
+ * @brief 初始化历史记录模块
+ * @details 为每个插孔分配固定大小的环形缓冲区，优先放在 PSRAM 中，PSRAM 不可用时退回内部 RAM
+ * @return bool 分配成功返回 true，失败返回 false (此后记录和查询均为空操作)
+ */
+bool HISTORY_init()
+{
+    if (histories != nullptr)
+    {
+        return true;
+    }
+
+    size_t size = sizeof(SocketHistory) * HISTORY_SOCKET_COUNT;
+    // 优先分配到 PSRAM
+    SocketHistory *buffer = (SocketHistory *)heap_caps_calloc(1, size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (buffer == nullptr)
+    {
+        // 退回内部 RAM
+        buffer = (SocketHistory *)calloc(1, size);
+    }
+    if (buffer == nullptr)
+    {
+        Serial.printf("历史记录 -> 分配 %u 字节失败\n", (unsigned)size);
+        return false;
+    }
+
+    unsigned long now = millis();
+    for (int i = 0; i < HISTORY_SOCKET_COUNT; i++)
+    {
+        reset_accumulator(buffer[i].minuteAcc, now / HISTORY_MINUTE_MS);
+        reset_accumulator(buffer[i].quarterAcc, now / HISTORY_QUARTER_MS);
+    }
+    histories = buffer;
+    return true;
+}
+
+/**
+ * @brief 记录一次采样，并增量更新1分钟和15分钟汇总
+ * @param socket_num 插孔编号 (1, 2, 3)
+ * @param current_ma 电流 (mA)
+ * @param power_mw 有功功率 (mW)
+ */
+void HISTORY_add_sample(uint8_t socket_num, uint32_t current_ma, uint32_t power_mw)
+{
+    if (histories == nullptr || socket_num < 1 || socket_num > HISTORY_SOCKET_COUNT)
+    {
+        return;
+    }
+    SocketHistory &h = histories[socket_num - 1];
+    unsigned long now = millis();
+    HistorySample sample = {current_ma, power_mw};
+
+    portENTER_CRITICAL(&historyMux);
+
+    // 1. 原始采样
+    ring_push(h.raw, HISTORY_RAW_CAPACITY, h.rawHead, h.rawCount, sample);
+
+    // 2. 1分钟周期结束 -> 生成1分钟汇总，并计入15分钟累加器
+    unsigned long minute = now / HISTORY_MINUTE_MS;
+    if (minute != h.minuteAcc.period)
+    {
+        if (h.minuteAcc.count > 0)
+        {
+            ring_push(h.minute, HISTORY_MINUTE_CAPACITY, h.minuteHead, h.minuteCount, accumulator_to_rollup(h.minuteAcc));
+
+            // 15分钟汇总直接合并1分钟累加器，平均值按采样数加权
+            h.quarterAcc.sum += h.minuteAcc.sum;
+            h.quarterAcc.count += h.minuteAcc.count;
+            h.quarterAcc.min = min(h.quarterAcc.min, h.minuteAcc.min);
+            h.quarterAcc.max = max(h.quarterAcc.max, h.minuteAcc.max);
+        }
+        reset_accumulator(h.minuteAcc, minute);
+    }
+
+    // 3. 15分钟周期结束 -> 生成15分钟汇总
+    unsigned long quarter = now / HISTORY_QUARTER_MS;
+    if (quarter != h.quarterAcc.period)
+    {
+        if (h.quarterAcc.count > 0)
+        {
+            ring_push(h.quarter, HISTORY_QUARTER_CAPACITY, h.quarterHead, h.quarterCount, accumulator_to_rollup(h.quarterAcc));
+        }
+        reset_accumulator(h.quarterAcc, quarter);
+    }
+
+    // 4. 计入当前1分钟累加器
+    h.minuteAcc.sum += power_mw;
+    h.minuteAcc.count++;
+    h.minuteAcc.min = min(h.minuteAcc.min, power_mw);
+    h.minuteAcc.max = max(h.minuteAcc.max, power_mw);
+
+    portEXIT_CRITICAL(&historyMux);
+}
+
+/**
+ * @brief 读取原始采样记录
+ * @param socket_num 插孔编号 (1, 2, 3)
+ * @param offset 从最新一条开始向前的偏移 (0 表示最新一条)
+ * @param out 用于接收记录的数组，按从新到旧排列
+ * @param max_count out 数组的最大容量
+ * @return uint16_t 实际读取的记录条数
+ */
+uint16_t HISTORY_read_samples(uint8_t socket_num, uint16_t offset, HistorySample *out, uint16_t max_count)
+{
+    if (histories == nullptr || socket_num < 1 || socket_num > HISTORY_SOCKET_COUNT)
+    {
+        return 0;
+    }
+    const SocketHistory &h = histories[socket_num - 1];
+
+    portENTER_CRITICAL(&historyMux);
+    uint16_t read = ring_read(h.raw, HISTORY_RAW_CAPACITY, h.rawHead, h.rawCount, offset, out, max_count);
+    portEXIT_CRITICAL(&historyMux);
+    return read;
+}
+
+/**
+ * @brief 读取汇总记录
+ * @param socket_num 插孔编号 (1, 2, 3)
+ * @param tier 汇总层级 (HISTORY_TIER_MINUTE 或 HISTORY_TIER_QUARTER)
+ * @param offset 从最新一条开始向前的偏移 (0 表示最新一条)
+ * @param out 用于接收记录的数组，按从新到旧排列
+ * @param max_count out 数组的最大容量
+ * @return uint16_t 实际读取的记录条数
+ */
+uint16_t HISTORY_read_rollups(uint8_t socket_num, uint8_t tier, uint16_t offset, HistoryRollup *out, uint16_t max_count)
+{
+    if (histories == nullptr || socket_num < 1 || socket_num > HISTORY_SOCKET_COUNT)
+    {
+        return 0;
+    }
+    const SocketHistory &h = histories[socket_num - 1];
+    uint16_t read = 0;
+
+    portENTER_CRITICAL(&historyMux);
+    if (tier == HISTORY_TIER_MINUTE)
+    {
+        read = ring_read(h.minute, HISTORY_MINUTE_CAPACITY, h.minuteHead, h.minuteCount, offset, out, max_count);
+    }
+    else if (tier == HISTORY_TIER_QUARTER)
+    {
+        read = ring_read(h.quarter, HISTORY_QUARTER_CAPACITY, h.quarterHead, h.quarterCount, offset, out, max_count);
+    }
+    portEXIT_CRITICAL(&historyMux);
+    return read;
+}
\ No newline at end of file
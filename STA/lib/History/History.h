@@ -0,0 +1,70 @@
+#ifndef HISTORY_H
+#define HISTORY_H
+
+#include <Arduino.h>
+#include <Global.h>
+
+// 插孔数量
+#define HISTORY_SOCKET_COUNT 3
+
+// 各层级环形缓冲区容量 (条)
+#define HISTORY_RAW_CAPACITY 300     // 原始采样: 2秒一条约10分钟
+#define HISTORY_MINUTE_CAPACITY 240  // 1分钟汇总: 4小时
+#define HISTORY_QUARTER_CAPACITY 672 // 15分钟汇总: 7天
+
+// 汇总周期 (毫秒)
+#define HISTORY_MINUTE_MS 60000UL
+#define HISTORY_QUARTER_MS (15UL * HISTORY_MINUTE_MS)
+
+// 定义[原始采样]
+struct HistorySample
+{
+    uint32_t currentMilliAmps; // 电流 (mA)
+    uint32_t powerMilliWatts;  // 有功功率 (mW)
+};
+
+// 定义[汇总记录]
+struct HistoryRollup
+{
+    uint32_t minPowerMilliWatts; // 周期内最小功率 (mW)
+    uint32_t maxPowerMilliWatts; // 周期内最大功率 (mW)
+    uint32_t avgPowerMilliWatts; // 周期内平均功率 (mW)
+};
+
+/**
+ * @brief 初始化历史记录模块
+ * @details 为每个插孔分配固定大小的环形缓冲区，优先放在 PSRAM 中，PSRAM 不可用时退回内部 RAM
+ * @return bool 分配成功返回 true，失败返回 false (此后记录和查询均为空操作)
+ */
+bool HISTORY_init();
+
+/**
+ * @brief 记录一次采样，并增量更新1分钟和15分钟汇总
+ * @param socket_num 插孔编号 (1, 2, 3)
+ * @param current_ma 电流 (mA)
+ * @param power_mw 有功功率 (mW)
+ */
+void HISTORY_add_sample(uint8_t socket_num, uint32_t current_ma, uint32_t power_mw);
+
+/**
+ * @brief 读取原始采样记录
+ * @param socket_num 插孔编号 (1, 2, 3)
+ * @param offset 从最新一条开始向前的偏移 (0 表示最新一条)
+ * @param out 用于接收记录的数组，按从新到旧排列
+ * @param max_count out 数组的最大容量
+ * @return uint16_t 实际读取的记录条数
+ */
+uint16_t HISTORY_read_samples(uint8_t socket_num, uint16_t offset, HistorySample *out, uint16_t max_count);
+
+/**
+ * @brief 读取汇总记录
+ * @param socket_num 插孔编号 (1, 2, 3)
+ * @param tier 汇总层级 (HISTORY_TIER_MINUTE 或 HISTORY_TIER_QUARTER)
+ * @param offset 从最新一条开始向前的偏移 (0 表示最新一条)
+ * @param out 用于接收记录的数组，按从新到旧排列
+ * @param max_count out 数组的最大容量
+ * @return uint16_t 实际读取的记录条数
+ */
+uint16_t HISTORY_read_rollups(uint8_t socket_num, uint8_t tier, uint16_t offset, HistoryRollup *out, uint16_t max_count);
+
+#endif
\ No newline at end of file
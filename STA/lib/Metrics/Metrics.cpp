@@ -0,0 +1,403 @@
+#include <Metrics.h>
+#include <Profiler.h>
+
+// 计数器存储
+uint32_t metricsCounters[METRIC_COUNTER_COUNT];
+uint32_t metricsTxFrames[256];
+uint32_t metricsRxFrames[256];
+MetricsQueueDepth metricsQueues[METRIC_QUEUE_COUNT];
+
+// ACK往返时间直方图各区间的上限 (ms，不含)
+static const uint32_t RTT_BUCKET_LIMITS[METRICS_RTT_BUCKETS] = {2, 5, 10, 20, 50, 100, 200, 500, 1000, UINT32_MAX};
+
+// 事件计数器名称 (与 MetricCounter 顺序一致)
+static const char *COUNTER_NAMES[METRIC_COUNTER_COUNT] = {
+    "HPLC校验和错误",
+    "HPLC解析失步",
+    "HPLC重发",
+    "HPLC ACK超时",
+    "HPLC发送失败",
+    "HPLC接收队列溢出",
+    "HPLC发送队列溢出",
+    "TJC解析失步",
+    "TJC接收队列溢出",
+    "TJC发送队列溢出",
+    "TJC曲线透传失败",
+    "日志丢弃",
+};
+
+// 队列名称 (与 MetricQueue 顺序一致)
+static const char *QUEUE_NAMES[METRIC_QUEUE_COUNT] = {
+    "HPLC接收缓冲",
+    "HPLC待分发帧",
+    "HPLC待发送命令",
+    "TJC接收缓冲",
+    "TJC待分发帧",
+    "TJC待发送命令",
+    "日志队列",
+};
+
+// 定义[对端表项状态]
+#define PEER_EMPTY 0    // 空闲
+#define PEER_CLAIMING 1 // 正在写入MAC地址
+#define PEER_READY 2    // 可用
+
+// 定义[对端表项]
+typedef struct
+{
+    uint8_t state;           // 表项状态
+    uint8_t macAddress[6];   // 对端MAC地址
+    MetricsRttHistogram rtt; // ACK往返时间
+} MetricsPeer;
+
+// 创建[对端表] (按MAC地址散列，线性探测)
+static MetricsPeer peers[METRICS_MAX_PEERS];
+// 全部对端的ACK往返时间
+static MetricsRttHistogram totalRtt;
+
+// 串口监视器命令缓冲区
+static char commandBuffer[METRICS_COMMAND_SIZE];
+// 串口监视器命令已读取长度
+static uint8_t commandLength = 0;
+
+/**
+ * 查找对端表项，不存在时占用一个空表项，表已满返回 NULL
+ */
+static MetricsPeer *find_peer(const uint8_t macAddress[6])
+{
+    uint16_t start = ((macAddress[4] << 8) | macAddress[5]) % METRICS_MAX_PEERS;
+    for (uint16_t probe = 0; probe < METRICS_MAX_PEERS; probe++)
+    {
+        MetricsPeer &peer = peers[(start + probe) % METRICS_MAX_PEERS];
+        uint8_t state = __atomic_load_n(&peer.state, __ATOMIC_ACQUIRE);
+        if (state == PEER_EMPTY)
+        {
+            // 抢占空表项，失败说明其它任务刚刚占用，重新读取状态
+            uint8_t expected = PEER_EMPTY;
+            if (__atomic_compare_exchange_n(&peer.state, &expected, PEER_CLAIMING, false, __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE))
+            {
+                memcpy(peer.macAddress, macAddress, 6);
+                __atomic_store_n(&peer.state, PEER_READY, __ATOMIC_RELEASE);
+                return &peer;
+            }
+            state = expected;
+        }
+        // 其它任务正在写入MAC地址，等待其完成 (只需写6字节)
+        while (state == PEER_CLAIMING)
+        {
+            state = __atomic_load_n(&peer.state, __ATOMIC_ACQUIRE);
+        }
+        if (memcmp(peer.macAddress, macAddress, 6) == 0)
+        {
+            return &peer;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * 向直方图加入一个样本
+ */
+static void add_rtt_sample(MetricsRttHistogram &histogram, uint32_t rtt_ms)
+{
+    uint8_t bucket = 0;
+    while (rtt_ms >= RTT_BUCKET_LIMITS[bucket])
+    {
+        bucket++;
+    }
+    __atomic_fetch_add(&histogram.count, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&histogram.sumMs, rtt_ms, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&histogram.buckets[bucket], 1, __ATOMIC_RELAXED);
+    uint32_t max = __atomic_load_n(&histogram.maxMs, __ATOMIC_RELAXED);
+    while (rtt_ms > max && !__atomic_compare_exchange_n(&histogram.maxMs, &max, rtt_ms, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+    {
+    }
+}
+
+/**
+ * 读取直方图 (逐个字段原子读取)
+ */
+static void load_rtt(const MetricsRttHistogram &histogram, MetricsRttHistogram &out)
+{
+    out.count = __atomic_load_n(&histogram.count, __ATOMIC_RELAXED);
+    out.sumMs = __atomic_load_n(&histogram.sumMs, __ATOMIC_RELAXED);
+    out.maxMs = __atomic_load_n(&histogram.maxMs, __ATOMIC_RELAXED);
+    for (int i = 0; i < METRICS_RTT_BUCKETS; i++)
+    {
+        out.buckets[i] = __atomic_load_n(&histogram.buckets[i], __ATOMIC_RELAXED);
+    }
+}
+
+/**
+ * 清零直方图
+ */
+static void clear_rtt(MetricsRttHistogram &histogram)
+{
+    __atomic_store_n(&histogram.count, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&histogram.sumMs, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&histogram.maxMs, 0, __ATOMIC_RELAXED);
+    for (int i = 0; i < METRICS_RTT_BUCKETS; i++)
+    {
+        __atomic_store_n(&histogram.buckets[i], 0, __ATOMIC_RELAXED);
+    }
+}
+
+/**
+ * 输出一行直方图
+ */
+static void print_rtt(Print &out, const MetricsRttHistogram &rtt)
+{
+    out.printf("n=%u 中位≈%ums 平均=%ums 最大=%ums |", rtt.count, METRICS_rtt_median_ms(rtt), rtt.count ? rtt.sumMs / rtt.count : 0, rtt.maxMs);
+    for (int i = 0; i < METRICS_RTT_BUCKETS; i++)
+    {
+        out.printf(" %u", rtt.buckets[i]);
+    }
+    out.println();
+}
+
+/**
+ * @brief 记录一次ACK往返时间
+ * @param target_address 对端MAC地址
+ * @param rtt_us 从发出请求到收到ACK的时间 (us)
+ */
+void METRICS_record_ack_rtt(const uint8_t target_address[6], uint32_t rtt_us)
+{
+    uint32_t rtt_ms = rtt_us / 1000;
+    add_rtt_sample(totalRtt, rtt_ms);
+    MetricsPeer *peer = find_peer(target_address);
+    if (peer != NULL)
+    {
+        add_rtt_sample(peer->rtt, rtt_ms);
+    }
+}
+
+/**
+ * @brief 由直方图估算ACK往返时间的中位数
+ * @details 假设样本在所在区间内均匀分布，在中位样本所在区间内线性插值 (区间上限不超过最大值)，精度取决于区间划分
+ * @param rtt 往返时间直方图
+ * @return uint32_t 中位数估计值 (ms)，没有样本时返回0
+ */
+uint32_t METRICS_rtt_median_ms(const MetricsRttHistogram &rtt)
+{
+    // 各字段分别读取，样本数以各区间之和为准
+    uint32_t total = 0;
+    for (int i = 0; i < METRICS_RTT_BUCKETS; i++)
+    {
+        total += rtt.buckets[i];
+    }
+    if (total == 0)
+    {
+        return 0;
+    }
+
+    // 中位样本的序号 (从1开始)
+    uint32_t target = (total + 1) / 2;
+    uint32_t seen = 0;
+    uint32_t lower = 0;
+    for (int i = 0; i < METRICS_RTT_BUCKETS; i++)
+    {
+        uint32_t count = rtt.buckets[i];
+        uint32_t upper = RTT_BUCKET_LIMITS[i];
+        if (count > 0 && seen + count >= target)
+        {
+            // 区间上限不超过最大值 (最后一个区间没有上限)
+            if (upper > rtt.maxMs + 1)
+            {
+                upper = rtt.maxMs + 1;
+            }
+            if (upper <= lower)
+            {
+                return lower;
+            }
+            // 第 k 个样本取区间内第 k 份的中点
+            uint32_t k = target - seen;
+            return lower + (uint32_t)((uint64_t)(upper - lower) * (2 * k - 1) / (2 * count));
+        }
+        seen += count;
+        lower = upper;
+    }
+    return rtt.maxMs;
+}
+
+/**
+ * @brief 获取ACK往返时间直方图某个区间的上限
+ * @param bucket 区间下标 (0 ~ METRICS_RTT_BUCKETS - 1)
+ * @return uint32_t 上限 (ms，不含)，最后一个区间返回 UINT32_MAX
+ */
+uint32_t METRICS_rtt_bucket_limit(uint8_t bucket)
+{
+    return bucket < METRICS_RTT_BUCKETS ? RTT_BUCKET_LIMITS[bucket] : UINT32_MAX;
+}
+
+/**
+ * @brief 获取指定控制码的收发帧数
+ * @param ctrl_code 控制码
+ * @param tx 输出参数，发送帧数
+ * @param rx 输出参数，接收帧数
+ */
+void METRICS_get_frames(uint8_t ctrl_code, uint32_t *tx, uint32_t *rx)
+{
+    *tx = __atomic_load_n(&metricsTxFrames[ctrl_code], __ATOMIC_RELAXED);
+    *rx = __atomic_load_n(&metricsRxFrames[ctrl_code], __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief 获取所有指标的快照
+ * @param snapshot 输出参数
+ */
+void METRICS_snapshot(MetricsSnapshot &snapshot)
+{
+    snapshot.uptimeMs = millis();
+    snapshot.txFrames = 0;
+    snapshot.rxFrames = 0;
+    for (int i = 0; i < 256; i++)
+    {
+        uint32_t tx, rx;
+        METRICS_get_frames(i, &tx, &rx);
+        snapshot.txFrames += tx;
+        snapshot.rxFrames += rx;
+    }
+    for (int i = 0; i < METRIC_COUNTER_COUNT; i++)
+    {
+        snapshot.counters[i] = __atomic_load_n(&metricsCounters[i], __ATOMIC_RELAXED);
+    }
+    for (int i = 0; i < METRIC_QUEUE_COUNT; i++)
+    {
+        snapshot.queues[i].current = __atomic_load_n(&metricsQueues[i].current, __ATOMIC_RELAXED);
+        snapshot.queues[i].peak = __atomic_load_n(&metricsQueues[i].peak, __ATOMIC_RELAXED);
+    }
+    load_rtt(totalRtt, snapshot.rtt);
+}
+
+/**
+ * @brief 获取指定对端的ACK往返时间直方图
+ * @param index 对端下标 (0 ~ METRICS_MAX_PEERS - 1)
+ * @param macAddress 输出参数，对端MAC地址
+ * @param rtt 输出参数，往返时间直方图
+ * @return true 该下标有对端
+ * @return false 该下标为空
+ */
+bool METRICS_get_peer(uint16_t index, uint8_t macAddress[6], MetricsRttHistogram &rtt)
+{
+    if (index >= METRICS_MAX_PEERS || __atomic_load_n(&peers[index].state, __ATOMIC_ACQUIRE) != PEER_READY)
+    {
+        return false;
+    }
+    memcpy(macAddress, peers[index].macAddress, 6);
+    load_rtt(peers[index].rtt, rtt);
+    return true;
+}
+
+/**
+ * @brief 将所有指标以文本形式输出
+ * @param out 输出目标 (如 Serial)
+ */
+void METRICS_print(Print &out)
+{
+    MetricsSnapshot snapshot;
+    METRICS_snapshot(snapshot);
+
+    out.printf("==== 链路指标 (运行 %u s) ====\n", snapshot.uptimeMs / 1000);
+    out.printf("HPLC帧: 发送 %u | 接收 %u\n", snapshot.txFrames, snapshot.rxFrames);
+    for (int i = 0; i < 256; i++)
+    {
+        uint32_t tx, rx;
+        METRICS_get_frames(i, &tx, &rx);
+        if (tx != 0 || rx != 0)
+        {
+            out.printf("  控制码 %02X: 发送 %u | 接收 %u\n", i, tx, rx);
+        }
+    }
+    for (int i = 0; i < METRIC_COUNTER_COUNT; i++)
+    {
+        out.printf("%s: %u\n", COUNTER_NAMES[i], snapshot.counters[i]);
+    }
+    for (int i = 0; i < METRIC_QUEUE_COUNT; i++)
+    {
+        out.printf("%s: 当前 %u | 峰值 %u\n", QUEUE_NAMES[i], snapshot.queues[i].current, snapshot.queues[i].peak);
+    }
+
+    // 直方图区间
+    out.print("ACK往返时间区间 (ms): ");
+    for (int i = 0; i < METRICS_RTT_BUCKETS - 1; i++)
+    {
+        out.printf("<%u ", RTT_BUCKET_LIMITS[i]);
+    }
+    out.printf(">=%u\n", RTT_BUCKET_LIMITS[METRICS_RTT_BUCKETS - 2]);
+    out.print("  全部: ");
+    print_rtt(out, snapshot.rtt);
+    for (uint16_t i = 0; i < METRICS_MAX_PEERS; i++)
+    {
+        uint8_t macAddress[6];
+        MetricsRttHistogram rtt;
+        if (METRICS_get_peer(i, macAddress, rtt))
+        {
+            char hex[MAC_HEX_LEN + 1];
+            mac_to_hex(macAddress, hex);
+            out.printf("  %s: ", hex);
+            print_rtt(out, rtt);
+        }
+    }
+    // 任务CPU占用、堆栈余量和主循环耗时
+    PROFILER_print(out);
+}
+
+/**
+ * @brief 清零所有指标 (对端列表保留)
+ */
+void METRICS_reset()
+{
+    for (int i = 0; i < 256; i++)
+    {
+        __atomic_store_n(&metricsTxFrames[i], 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&metricsRxFrames[i], 0, __ATOMIC_RELAXED);
+    }
+    for (int i = 0; i < METRIC_COUNTER_COUNT; i++)
+    {
+        __atomic_store_n(&metricsCounters[i], 0, __ATOMIC_RELAXED);
+    }
+    for (int i = 0; i < METRIC_QUEUE_COUNT; i++)
+    {
+        __atomic_store_n(&metricsQueues[i].current, 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&metricsQueues[i].peak, 0, __ATOMIC_RELAXED);
+    }
+    clear_rtt(totalRtt);
+    for (int i = 0; i < METRICS_MAX_PEERS; i++)
+    {
+        clear_rtt(peers[i].rtt);
+    }
+    // 主循环耗时
+    PROFILER_reset();
+}
+
+/**
+ * @brief 处理串口监视器命令
+ * @details 在 loop() 中调用。"metrics" 输出所有指标，"metrics reset" 清零所有指标
+ */
+void METRICS_handle_serial()
+{
+    while (Serial.available())
+    {
+        char c = Serial.read();
+        if (c != '\r' && c != '\n')
+        {
+            // 超长的命令截断，不会匹配任何命令
+            if (commandLength < METRICS_COMMAND_SIZE - 1)
+            {
+                commandBuffer[commandLength++] = c;
+            }
+            continue;
+        }
+        commandBuffer[commandLength] = '\0';
+        if (strcmp(commandBuffer, "metrics") == 0)
+        {
+            METRICS_print(Serial);
+        }
+        else if (strcmp(commandBuffer, "metrics reset") == 0)
+        {
+            METRICS_reset();
+            Serial.println("链路指标已清零");
+        }
+        commandLength = 0;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,190 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <Arduino.h>
+#include <Global.h>
+
+/*
+ * 链路运行指标 (CCO 与 STA 共用)
+ *
+ * 计数器均为 32 位整数，热路径上用 relaxed 原子加一更新，不加锁、不关中断，
+ * 读取时各计数器之间不保证严格一致，用于观察趋势足够。
+ */
+
+// ACK往返时间直方图的桶数
+#define METRICS_RTT_BUCKETS 10
+// 单独统计ACK往返时间的对端数量 (超出的对端只计入总体直方图)
+#define METRICS_MAX_PEERS 64
+// 串口监视器命令缓冲区大小
+#define METRICS_COMMAND_SIZE 32
+
+// 定义[事件计数器]枚举
+typedef enum
+{
+    METRIC_HPLC_CHECKSUM_FAIL, // HPLC帧校验和错误
+    METRIC_HPLC_RESYNC,        // HPLC解析器在帧中途失步 (含数据域超长)
+    METRIC_HPLC_RETRY,         // HPLC重发次数
+    METRIC_HPLC_ACK_TIMEOUT,   // HPLC等待ACK超时次数
+    METRIC_HPLC_SEND_FAIL,     // HPLC重试用尽仍未收到ACK的发送
+    METRIC_HPLC_RX_DROPPED,    // HPLC接收帧队列已满而丢弃的帧
+    METRIC_HPLC_TX_DROPPED,    // HPLC发送队列或请求队列已满而取消的发送
+    METRIC_TJC_RESYNC,         // 串口屏解析器在帧中途失步 (含数据域超长)
+    METRIC_TJC_RX_DROPPED,     // 串口屏接收帧队列已满而丢弃的帧
+    METRIC_TJC_TX_DROPPED,     // 串口屏发送队列已满而丢弃的命令块
+    METRIC_TJC_WAVEFORM_FAIL,  // 串口屏曲线透传失败的块 (屏幕未应答或发送队列已满)
+    METRIC_LOG_DROPPED,        // 日志队列已满而丢弃的日志条数
+    METRIC_COUNTER_COUNT
+} MetricCounter;
+
+// 定义[队列深度]枚举 (记录最近一次的值和峰值)
+typedef enum
+{
+    METRIC_QUEUE_HPLC_RX,     // HPLC串口接收缓冲区待处理字节数
+    METRIC_QUEUE_HPLC_FRAMES, // HPLC接收帧队列待分发帧数
+    METRIC_QUEUE_HPLC_TX,     // HPLC发送队列待写出命令数
+    METRIC_QUEUE_TJC_RX,      // 串口屏串口接收缓冲区待处理字节数
+    METRIC_QUEUE_TJC_FRAMES,  // 串口屏接收帧队列待分发帧数
+    METRIC_QUEUE_TJC_TX,      // 串口屏发送队列待写出命令块数
+    METRIC_QUEUE_LOG,         // 日志队列待输出条数
+    METRIC_QUEUE_COUNT
+} MetricQueue;
+
+// 定义[ACK往返时间直方图]
+typedef struct
+{
+    uint32_t count;                        // 样本数
+    uint32_t sumMs;                        // 往返时间之和 (ms)
+    uint32_t maxMs;                        // 最大往返时间 (ms)
+    uint32_t buckets[METRICS_RTT_BUCKETS]; // 各区间的样本数 (区间上限见 METRICS_rtt_bucket_limit)
+} MetricsRttHistogram;
+
+// 定义[队列深度]
+typedef struct
+{
+    uint32_t current; // 最近一次的值
+    uint32_t peak;    // 峰值
+} MetricsQueueDepth;
+
+// 定义[指标快照]
+typedef struct
+{
+    uint32_t uptimeMs;                            // 快照时间 (millis)
+    uint32_t txFrames;                            // HPLC发送帧总数 (含重发)
+    uint32_t rxFrames;                            // HPLC接收完整帧总数
+    uint32_t counters[METRIC_COUNTER_COUNT];      // 事件计数器
+    MetricsQueueDepth queues[METRIC_QUEUE_COUNT]; // 队列深度
+    MetricsRttHistogram rtt;                      // 全部对端的ACK往返时间
+} MetricsSnapshot;
+
+// 计数器存储 (仅供下面的内联函数使用，其它代码请通过函数访问)
+extern uint32_t metricsCounters[METRIC_COUNTER_COUNT];
+extern uint32_t metricsTxFrames[256];
+extern uint32_t metricsRxFrames[256];
+extern MetricsQueueDepth metricsQueues[METRIC_QUEUE_COUNT];
+
+/**
+ * @brief 事件计数器加一
+ * @param counter 计数器
+ */
+inline void METRICS_count(MetricCounter counter)
+{
+    __atomic_fetch_add(&metricsCounters[counter], 1, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief 记录发出一帧HPLC数据 (按控制码统计)
+ * @param ctrl_code 控制码
+ */
+inline void METRICS_count_tx(uint8_t ctrl_code)
+{
+    __atomic_fetch_add(&metricsTxFrames[ctrl_code], 1, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief 记录收到一帧完整的HPLC数据 (按控制码统计)
+ * @param ctrl_code 控制码
+ */
+inline void METRICS_count_rx(uint8_t ctrl_code)
+{
+    __atomic_fetch_add(&metricsRxFrames[ctrl_code], 1, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief 记录队列深度，同时更新峰值
+ * @param queue 队列
+ * @param depth 当前深度
+ */
+inline void METRICS_queue_depth(MetricQueue queue, uint32_t depth)
+{
+    MetricsQueueDepth &q = metricsQueues[queue];
+    __atomic_store_n(&q.current, depth, __ATOMIC_RELAXED);
+    uint32_t peak = __atomic_load_n(&q.peak, __ATOMIC_RELAXED);
+    while (depth > peak && !__atomic_compare_exchange_n(&q.peak, &peak, depth, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+    {
+    }
+}
+
+/**
+ * @brief 记录一次ACK往返时间
+ * @param target_address 对端MAC地址
+ * @param rtt_us 从最后一次写出请求到发送方收到ACK (被唤醒) 的时间 (us)
+ */
+void METRICS_record_ack_rtt(const uint8_t target_address[6], uint32_t rtt_us);
+
+/**
+ * @brief 由直方图估算ACK往返时间的中位数
+ * @details 假设样本在所在区间内均匀分布，在中位样本所在区间内线性插值 (区间上限不超过最大值)，精度取决于区间划分
+ * @param rtt 往返时间直方图
+ * @return uint32_t 中位数估计值 (ms)，没有样本时返回0
+ */
+uint32_t METRICS_rtt_median_ms(const MetricsRttHistogram &rtt);
+
+/**
+ * @brief 获取ACK往返时间直方图某个区间的上限
+ * @param bucket 区间下标 (0 ~ METRICS_RTT_BUCKETS - 1)
+ * @return uint32_t 上限 (ms，不含)，最后一个区间返回 UINT32_MAX
+ */
+uint32_t METRICS_rtt_bucket_limit(uint8_t bucket);
+
+/**
+ * @brief 获取指定控制码的收发帧数
+ * @param ctrl_code 控制码
+ * @param tx 输出参数，发送帧数
+ * @param rx 输出参数，接收帧数
+ */
+void METRICS_get_frames(uint8_t ctrl_code, uint32_t *tx, uint32_t *rx);
+
+/**
+ * @brief 获取所有指标的快照
+ * @param snapshot 输出参数
+ */
+void METRICS_snapshot(MetricsSnapshot &snapshot);
+
+/**
+ * @brief 获取指定对端的ACK往返时间直方图
+ * @param index 对端下标 (0 ~ METRICS_MAX_PEERS - 1)
+ * @param macAddress 输出参数，对端MAC地址
+ * @param rtt 输出参数，往返时间直方图
+ * @return true 该下标有对端
+ * @return false 该下标为空
+ */
+bool METRICS_get_peer(uint16_t index, uint8_t macAddress[6], MetricsRttHistogram &rtt);
+
+/**
+ * @brief 将所有指标以文本形式输出
+ * @param out 输出目标 (如 Serial)
+ */
+void METRICS_print(Print &out);
+
+/**
+ * @brief 清零所有指标 (对端列表保留)
+ */
+void METRICS_reset();
+
+/**
+ * @brief 处理串口监视器命令
+ * @details 在 loop() 中调用。"metrics" 输出所有指标，"metrics reset" 清零所有指标
+ */
+void METRICS_handle_serial();
+
+#endif
\ No newline at end of file
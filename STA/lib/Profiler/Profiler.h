@@ -0,0 +1,96 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <Arduino.h>
+
+/*
+ * 任务性能剖析 (CCO 与 STA 共用)
+ *
+ * 剖析任务每隔 PROFILER_SAMPLE_INTERVAL_MS 采样一次所有 FreeRTOS 任务的运行时间和堆栈余量，
+ * 计算出上一个采样周期内各任务的CPU占用；各任务的主循环通过 PROFILER_record_loop 记录单次迭代耗时。
+ * 结果随 "metrics" 命令一起输出，用于按数据调整任务堆栈大小和核心分配。
+ *
+ * CPU占用需要 configGENERATE_RUN_TIME_STATS (未启用时CPU占用输出为 n/a)，任务列表需要 configUSE_TRACE_FACILITY，
+ * 未启用时只输出主循环耗时。
+ */
+
+// 最多采样的任务数量 (系统任务数超过该值时采样失败，结果保持上一次)
+#define PROFILER_MAX_TASKS 24
+// 最多记录的主循环数量
+#define PROFILER_MAX_LOOPS 4
+// 采样间隔 (ms)
+#define PROFILER_SAMPLE_INTERVAL_MS 5000
+// 剖析任务堆栈大小 (字节)
+#define PROFILER_TASK_STACK_SIZE 2048
+// CPU占用不可用 (未启用 configGENERATE_RUN_TIME_STATS)
+#define PROFILER_CPU_UNAVAILABLE 0xFFFF
+
+// 定义[任务采样结果]
+typedef struct
+{
+    char name[configMAX_TASK_NAME_LEN]; // 任务名称
+    uint16_t cpuPermille;               // 上一个采样周期的CPU占用 (‰，相对单个核心，PROFILER_CPU_UNAVAILABLE 表示不可用)
+    uint32_t stackFreeBytes;            // 堆栈历史最小剩余 (字节)
+    int8_t core;                        // 固定运行的核心 (-1 表示不固定或未知)
+    uint8_t priority;                   // 当前优先级
+} ProfilerTaskStats;
+
+// 定义[主循环耗时统计]
+typedef struct
+{
+    const char *name; // 名称 (字符串常量)
+    uint32_t count;   // 迭代次数
+    uint32_t sumUs;   // 耗时之和 (us)
+    uint32_t maxUs;   // 最大耗时 (us)
+    uint32_t lastUs;  // 最近一次耗时 (us)
+} ProfilerLoopStats;
+
+/**
+ * @brief 启动剖析任务
+ */
+void PROFILER_init();
+
+/**
+ * @brief 注册一个需要记录耗时的主循环
+ * @param name 名称 (字符串常量)
+ * @return int8_t 主循环ID，注册已满时返回-1 (此后的记录会被忽略)
+ */
+int8_t PROFILER_register_loop(const char *name);
+
+/**
+ * @brief 记录一次主循环迭代的耗时
+ * @details 每个主循环只能由一个任务记录
+ * @param loop 主循环ID
+ * @param elapsed_us 本次迭代耗时 (us，不含迭代之间的主动延时)
+ */
+void PROFILER_record_loop(int8_t loop, uint32_t elapsed_us);
+
+/**
+ * @brief 获取最近一次采样的任务统计
+ * @param stats 输出参数
+ * @param max_count stats 的容量
+ * @return uint8_t 实际写入的任务数量
+ */
+uint8_t PROFILER_get_tasks(ProfilerTaskStats stats[], uint8_t max_count);
+
+/**
+ * @brief 获取主循环耗时统计
+ * @param loop 主循环ID
+ * @param stats 输出参数
+ * @return true 获取成功
+ * @return false 主循环ID无效
+ */
+bool PROFILER_get_loop(int8_t loop, ProfilerLoopStats &stats);
+
+/**
+ * @brief 将任务和主循环统计以文本形式输出
+ * @param out 输出目标 (如 Serial)
+ */
+void PROFILER_print(Print &out);
+
+/**
+ * @brief 清零主循环耗时统计 (任务采样在下一个周期自然刷新)
+ */
+void PROFILER_reset();
+
+#endif
\ No newline at end of file
@@ -0,0 +1,334 @@
+#include <FuzzDriver.h>
+#include <algorithm>
+#include <dirent.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+#if defined(__SANITIZE_ADDRESS__)
+#define FUZZ_HAS_SANITIZER 1
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer)
+#define FUZZ_HAS_SANITIZER 1
+#endif
+#endif
+
+#ifdef FUZZ_HAS_SANITIZER
+#include <sanitizer/common_interface_defs.h>
+#endif
+
+#define FUZZ_DEFAULT_ARTIFACT "fuzz-crash.bin" // 默认的崩溃输入文件
+#define FUZZ_MAX_MUTATIONS 4                   // 每个变异输入最多叠加的变异操作
+
+// 正在执行的输入 (进程终止时保存)
+static const uint8_t *currentData = NULL;
+static size_t currentSize = 0;
+
+// 变异时改写的特殊字节: 帧前导字节、起始符、结束符、AT应答的分隔符和边界值
+static const uint8_t INTERESTING_BYTES[] = {0x00, 0x01, 0x06, 0x08, 0x09, 0x16, 0x38, 0x39, 0x68, 0x7F, 0x80, 0xFE, 0xFF, '\r', '\n', ',', '+', '='};
+
+/**
+ * 固定种子的 xorshift32 伪随机数，同一 FUZZ_SEED 每次运行的变异输入相同
+ */
+static uint32_t rng_state = 1;
+
+static uint32_t rng_next()
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+// 返回 0 ~ bound-1 (bound 为 0 时返回 0)
+static uint32_t rng_below(uint32_t bound)
+{
+    return bound == 0 ? 0 : rng_next() % bound;
+}
+
+static uint32_t env_uint(const char *name, uint32_t fallback)
+{
+    const char *text = getenv(name);
+    if (text == NULL || *text == '\0')
+    {
+        return fallback;
+    }
+    char *end;
+    unsigned long value = strtoul(text, &end, 10);
+    return (*end == '\0') ? (uint32_t)value : fallback;
+}
+
+/**
+ * 保存正在执行的输入 (进程即将终止，只使用可重入的系统调用)
+ */
+static void save_current_input()
+{
+    if (currentData == NULL)
+    {
+        return;
+    }
+    const char *path = getenv("FUZZ_ARTIFACT");
+    if (path == NULL || *path == '\0')
+    {
+        path = FUZZ_DEFAULT_ARTIFACT;
+    }
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+    {
+        return;
+    }
+    size_t written = 0;
+    while (written < currentSize)
+    {
+        ssize_t n = write(fd, currentData + written, currentSize - written);
+        if (n <= 0)
+        {
+            break;
+        }
+        written += n;
+    }
+    close(fd);
+    char note[256];
+    int len = snprintf(note, sizeof(note), "FUZZ -> 当前输入 (%zu 字节) 已保存到 %s\n", currentSize, path);
+    if (len > 0)
+    {
+        ssize_t ignored = write(STDERR_FILENO, note, std::min((size_t)len, sizeof(note) - 1));
+        (void)ignored;
+    }
+    currentData = NULL;
+}
+
+/**
+ * 执行一个输入: 拷贝到大小恰好的堆缓冲区，越界读取输入会被 ASan 发现
+ */
+static void run_one(const uint8_t *data, size_t size, FuzzResult &result)
+{
+    uint8_t *copy = (uint8_t *)malloc(size > 0 ? size : 1);
+    if (size > 0)
+    {
+        memcpy(copy, data, size);
+    }
+    currentData = copy;
+    currentSize = size;
+    LLVMFuzzerTestOneInput(copy, size);
+    currentData = NULL;
+    free(copy);
+    result.totalBytes += size;
+}
+
+/**
+ * 按文件名顺序读取语料目录 (目录不存在时返回空)
+ */
+static std::vector<std::vector<uint8_t>> load_corpus(const char *directory)
+{
+    std::vector<std::vector<uint8_t>> corpus;
+    DIR *dir = opendir(directory);
+    if (dir == NULL)
+    {
+        fprintf(stderr, "FUZZ -> 无法打开语料目录 %s\n", directory);
+        return corpus;
+    }
+    std::vector<std::string> names;
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL)
+    {
+        if (entry->d_name[0] != '.')
+        {
+            names.push_back(entry->d_name);
+        }
+    }
+    closedir(dir);
+    std::sort(names.begin(), names.end());
+
+    for (const std::string &name : names)
+    {
+        std::string path = std::string(directory) + "/" + name;
+        FILE *file = fopen(path.c_str(), "rb");
+        if (file == NULL)
+        {
+            continue;
+        }
+        std::vector<uint8_t> bytes;
+        uint8_t chunk[4096];
+        size_t n;
+        while ((n = fread(chunk, 1, sizeof(chunk), file)) > 0)
+        {
+            bytes.insert(bytes.end(), chunk, chunk + n);
+        }
+        fclose(file);
+        corpus.push_back(bytes);
+    }
+    return corpus;
+}
+
+/**
+ * 对输入叠加 1 ~ FUZZ_MAX_MUTATIONS 个变异操作
+ */
+static void mutate(std::vector<uint8_t> &input, const std::vector<std::vector<uint8_t>> &pool, size_t max_len)
+{
+    uint32_t mutations = 1 + rng_below(FUZZ_MAX_MUTATIONS);
+    for (uint32_t m = 0; m < mutations; m++)
+    {
+        size_t size = input.size();
+        switch (rng_below(8))
+        {
+        case 0: // 翻转一位
+            if (size > 0)
+            {
+                input[rng_below(size)] ^= (uint8_t)(1 << rng_below(8));
+            }
+            break;
+        case 1: // 改写为随机字节
+            if (size > 0)
+            {
+                input[rng_below(size)] = (uint8_t)rng_next();
+            }
+            break;
+        case 2: // 改写为特殊字节
+            if (size > 0)
+            {
+                input[rng_below(size)] = INTERESTING_BYTES[rng_below(sizeof(INTERESTING_BYTES))];
+            }
+            break;
+        case 3: // 插入 1 ~ 4 个随机字节
+        {
+            size_t pos = rng_below(size + 1);
+            uint32_t count = 1 + rng_below(4);
+            for (uint32_t i = 0; i < count; i++)
+            {
+                input.insert(input.begin() + pos, (uint8_t)rng_next());
+            }
+            break;
+        }
+        case 4: // 删除 1 ~ 4 个字节
+            if (size > 0)
+            {
+                size_t pos = rng_below(size);
+                size_t count = std::min<size_t>(1 + rng_below(4), size - pos);
+                input.erase(input.begin() + pos, input.begin() + pos + count);
+            }
+            break;
+        case 5: // 截断
+            input.resize(rng_below(size + 1));
+            break;
+        case 6: // 复制一段到随机位置 (重复的帧、重复的行)
+            if (size > 0)
+            {
+                size_t from = rng_below(size);
+                size_t count = 1 + rng_below(size - from);
+                std::vector<uint8_t> chunk(input.begin() + from, input.begin() + from + count);
+                input.insert(input.begin() + rng_below(size + 1), chunk.begin(), chunk.end());
+            }
+            break;
+        default: // 保留前缀，拼接另一个输入的后缀
+        {
+            const std::vector<uint8_t> &other = pool[rng_below(pool.size())];
+            size_t keep = rng_below(size + 1);
+            size_t from = rng_below(other.size() + 1);
+            input.resize(keep);
+            input.insert(input.end(), other.begin() + from, other.end());
+            break;
+        }
+        }
+    }
+    if (input.size() > max_len)
+    {
+        input.resize(max_len);
+    }
+}
+
+/**
+ * 把种子写成语料目录 (每个种子一个文件)
+ */
+static bool write_seeds(const FuzzSeed seeds[], size_t seed_count, const char *directory)
+{
+    for (size_t i = 0; i < seed_count; i++)
+    {
+        char path[512];
+        snprintf(path, sizeof(path), "%s/seed-%03zu", directory, i);
+        FILE *file = fopen(path, "wb");
+        if (file == NULL)
+        {
+            return false;
+        }
+        bool ok = fwrite(seeds[i].data, 1, seeds[i].size, file) == seeds[i].size;
+        fclose(file);
+        if (!ok)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void FUZZ_run(const FuzzSeed seeds[], size_t seed_count, FuzzResult &result)
+{
+    memset(&result, 0, sizeof(result));
+#ifdef FUZZ_HAS_SANITIZER
+    __sanitizer_set_death_callback(save_current_input);
+#endif
+
+    // 只导出种子 (供 libFuzzer 使用)
+    const char *seedDir = getenv("FUZZ_WRITE_SEEDS");
+    if (seedDir != NULL && *seedDir != '\0')
+    {
+        if (!write_seeds(seeds, seed_count, seedDir))
+        {
+            fprintf(stderr, "FUZZ -> 无法写入种子目录 %s\n", seedDir);
+        }
+        return;
+    }
+
+    // 1. 种子
+    std::vector<std::vector<uint8_t>> pool;
+    for (size_t i = 0; i < seed_count; i++)
+    {
+        run_one(seeds[i].data, seeds[i].size, result);
+        result.seedInputs++;
+        pool.push_back(std::vector<uint8_t>(seeds[i].data, seeds[i].data + seeds[i].size));
+    }
+
+    // 2. 语料 (如 libFuzzer 产生的语料目录或之前保存的崩溃输入)
+    const char *corpusDir = getenv("FUZZ_CORPUS");
+    if (corpusDir != NULL && *corpusDir != '\0')
+    {
+        for (const std::vector<uint8_t> &input : load_corpus(corpusDir))
+        {
+            run_one(input.data(), input.size(), result);
+            result.corpusInputs++;
+            pool.push_back(input);
+        }
+    }
+    if (pool.empty())
+    {
+        return;
+    }
+
+    // 3. 变异输入
+    uint32_t runs = env_uint("FUZZ_RUNS", FUZZ_DEFAULT_RUNS);
+    size_t maxLen = env_uint("FUZZ_MAX_LEN", FUZZ_DEFAULT_MAX_LEN);
+    rng_state = env_uint("FUZZ_SEED", 1);
+    if (rng_state == 0)
+    {
+        rng_state = 1;
+    }
+    std::vector<uint8_t> input;
+    for (uint32_t i = 0; i < runs; i++)
+    {
+        input = pool[rng_below(pool.size())];
+        mutate(input, pool, maxLen);
+        run_one(input.data(), input.size(), result);
+        result.mutatedInputs++;
+    }
+}
+
+void FUZZ_fail(const char *file, int line, const char *message)
+{
+    fprintf(stderr, "FUZZ -> %s:%d: %s\n", file, line, message);
+    save_current_input();
+    abort();
+}
\ No newline at end of file
@@ -0,0 +1,79 @@
+#ifndef FUZZ_DRIVER_H
+#define FUZZ_DRIVER_H
+
+/*
+ * 模糊测试驱动 (只在 native 环境中存在)
+ * - 每个模糊测试用例实现 libFuzzer 的入口 LLVMFuzzerTestOneInput()，同一份用例有两种编译方式:
+ *   1. pio test -e native_fuzz (gcc + ASan/UBSan): 用例的 Unity main() 调用 FUZZ_run()，先执行种子和语料，
+ *      再执行由种子变异出的固定数量的输入 (没有覆盖率反馈，同一种子每次运行的输入相同)
+ *   2. clang + libFuzzer (-DFUZZ_LIBFUZZER): 用例不编译 main()，由 libFuzzer 驱动，在工程目录下执行
+ *        clang++ -std=gnu++17 -pthread -g -O1 -fsanitize=fuzzer,address,undefined -DFUZZ_LIBFUZZER \
+ *          -Inative/NativeShims/src -Inative/FuzzDriver/src -I.pio/libdeps/native_fuzz/Unity/src \
+ *          $(find lib -mindepth 1 -maxdepth 1 -type d -printf '-I%p ') \
+ *          $(find native/NativeShims native/FuzzDriver lib -name '*.cpp') [src/main.cpp] test/<用例>/test_main.cpp
+ *      处理函数的用例需要 src/main.cpp；种子可先用第1种方式设置 FUZZ_WRITE_SEEDS 导出为语料目录
+ * - 发现问题时进程直接终止 (ASan 报告或 abort)，驱动把当前输入写入 FUZZ_ARTIFACT (默认 fuzz-crash.bin)，
+ *   该文件可作为 FUZZ_CORPUS 或 libFuzzer 的参数复现
+ *
+ * 环境变量: FUZZ_RUNS (变异输入的数量，默认 20000)、FUZZ_SEED (变异的随机种子，默认 1)、
+ *           FUZZ_MAX_LEN (变异输入的最大长度，默认 256)、FUZZ_CORPUS (语料目录，每个文件一个输入)、FUZZ_ARTIFACT、
+ *           FUZZ_WRITE_SEEDS (只把种子写入该目录，不执行输入)
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define FUZZ_DEFAULT_RUNS 20000  // 默认的变异输入数量
+#define FUZZ_DEFAULT_MAX_LEN 256 // 默认的变异输入最大长度 (字节)
+
+// libFuzzer 的测试入口: 每个输入调用一次，返回 0
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size);
+
+// 定义[种子输入]类型
+typedef struct
+{
+    const uint8_t *data; // 输入
+    size_t size;         // 输入长度
+} FuzzSeed;
+
+// 定义[运行结果]类型
+typedef struct
+{
+    uint32_t seedInputs;    // 执行的种子
+    uint32_t corpusInputs;  // 执行的语料文件
+    uint32_t mutatedInputs; // 执行的变异输入
+    uint64_t totalBytes;    // 所有输入的总长度
+} FuzzResult;
+
+/**
+ * @brief 用例自检失败时终止进程
+ * @details 先输出 message 并保存当前输入 (同 ASan 报告)，再 abort()；libFuzzer 驱动时同样会记录崩溃输入
+ */
+#define FUZZ_CHECK(condition, message)              \
+    do                                              \
+    {                                               \
+        if (!(condition))                           \
+        {                                           \
+            FUZZ_fail(__FILE__, __LINE__, message); \
+        }                                           \
+    } while (0)
+
+/**
+ * @brief 执行种子、语料和变异输入
+ * @details 每个输入调用一次 LLVMFuzzerTestOneInput()，变异操作: 翻转位、改写字节、插入、删除、截断、
+ *          复制片段、与另一个输入拼接；语料目录中的文件同样作为变异的来源
+ * @param seeds 种子 (至少一个)
+ * @param seed_count 种子数量
+ * @param result 输出: 运行结果
+ */
+void FUZZ_run(const FuzzSeed seeds[], size_t seed_count, FuzzResult &result);
+
+/**
+ * @brief 输出失败原因，保存当前输入并终止进程 (由 FUZZ_CHECK 调用)
+ * @param file 源文件
+ * @param line 行号
+ * @param message 失败原因
+ */
+[[noreturn]] void FUZZ_fail(const char *file, int line, const char *message);
+
+#endif
\ No newline at end of file
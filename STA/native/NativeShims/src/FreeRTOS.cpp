@@ -0,0 +1,676 @@
+#include <Arduino.h>
+#include <NativeShims.h>
+
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+ * FreeRTOS 仿真内核
+ * - 所有状态由 kernelMutex 保护；只有 running 指向的任务可以调用内核接口
+ * - 任务切换: 把 running 指向下一个任务并唤醒它的条件变量，自己等待再次被选中
+ * - 内核对象只分配不释放 (不提供 vSemaphoreDelete 和 vQueueDelete): 进程退出时其它任务线程仍停在各自的条件变量上
+ * - 定义 NATIVE_SHIMS_NO_KERNEL 时不编译内核: 模拟器加载的STA镜像共用宿主程序的内核和虚拟时钟
+ */
+
+#ifndef NATIVE_SHIMS_NO_KERNEL
+
+#define NATIVE_BOOT_TIME_US 1000000ULL // 虚拟时钟初值 (1秒，避免 millis()==0 的特殊情况)
+
+// 定义[任务运行状态枚举]类型
+typedef enum
+{
+    TASK_READY,
+    TASK_RUNNING,
+    TASK_BLOCKED,
+    TASK_DELETED
+} NativeTaskState;
+
+struct NativeTask
+{
+    char name[configMAX_TASK_NAME_LEN];
+    TaskFunction_t function;
+    void *parameter;
+    UBaseType_t priority;
+    uint32_t stackDepth;
+    UBaseType_t number;
+    NativeTaskState state;
+    uint64_t readySeq;        // 就绪次序 (同优先级先就绪的先运行)
+    const void *waitObject;   // 阻塞时等待的对象
+    uint64_t wakeAtUs;        // 阻塞的截止时间
+    bool timedOut;            // 上次阻塞因超时结束
+    uint32_t notifyValue;     // 任务通知计数
+    std::condition_variable cv;
+};
+
+struct NativeSemaphore
+{
+    UBaseType_t count;
+    UBaseType_t maxCount;
+};
+
+struct NativeQueue
+{
+    UBaseType_t length;
+    UBaseType_t itemSize;
+    UBaseType_t head;
+    UBaseType_t count;
+    std::vector<uint8_t> storage;
+    char notEmpty; // 等待对象: 队列非空
+    char notFull;  // 等待对象: 队列未满
+};
+
+// 定义[调度器]类型
+typedef struct
+{
+    std::mutex mutex;
+    std::vector<NativeTask *> tasks;
+    std::vector<NativeSemaphore *> semaphores;
+    std::vector<NativeQueue *> queues;
+    NativeTask *running;
+    uint64_t nowUs;
+    uint64_t readySeq;
+    UBaseType_t nextNumber;
+} NativeKernel;
+
+static thread_local NativeTask *currentTask = NULL;
+
+/**
+ * @brief 获取调度器 (首次使用时创建，不随静态对象析构)
+ */
+static NativeKernel &kernel()
+{
+    static NativeKernel *k = []()
+    {
+        NativeKernel *created = new NativeKernel();
+        created->running = NULL;
+        created->nowUs = NATIVE_BOOT_TIME_US;
+        created->readySeq = 0;
+        created->nextNumber = 1;
+        return created;
+    }();
+    return *k;
+}
+
+static NativeTask *new_task_locked(const char *name, TaskFunction_t function, void *parameter, UBaseType_t priority, uint32_t stackDepth)
+{
+    NativeKernel &k = kernel();
+    NativeTask *task = new NativeTask();
+    snprintf(task->name, sizeof(task->name), "%s", name ? name : "");
+    task->function = function;
+    task->parameter = parameter;
+    task->priority = priority < configMAX_PRIORITIES ? priority : configMAX_PRIORITIES - 1;
+    task->stackDepth = stackDepth;
+    task->number = k.nextNumber++;
+    task->state = TASK_READY;
+    task->readySeq = ++k.readySeq;
+    task->waitObject = NULL;
+    task->wakeAtUs = NATIVE_WAIT_FOREVER;
+    task->timedOut = false;
+    task->notifyValue = 0;
+    k.tasks.push_back(task);
+    return task;
+}
+
+/**
+ * @brief 获取调用者对应的任务
+ * @details 第一个调用内核接口的宿主线程登记为 loopTask；其它非任务线程调用属于用法错误
+ */
+static NativeTask *self_locked()
+{
+    NativeKernel &k = kernel();
+    if (currentTask == NULL)
+    {
+        if (k.running != NULL)
+        {
+            fprintf(stderr, "[native] 非任务线程调用了FreeRTOS接口\n");
+            abort();
+        }
+        currentTask = new_task_locked("loopTask", NULL, NULL, 1, 8192);
+        currentTask->state = TASK_RUNNING;
+        k.running = currentTask;
+    }
+    if (k.running != currentTask)
+    {
+        fprintf(stderr, "[native] 任务 %s 未持有CPU却调用了FreeRTOS接口\n", currentTask->name);
+        abort();
+    }
+    return currentTask;
+}
+
+static void make_ready_locked(NativeTask *task, bool timedOut)
+{
+    task->state = TASK_READY;
+    task->readySeq = ++kernel().readySeq;
+    task->waitObject = NULL;
+    task->wakeAtUs = NATIVE_WAIT_FOREVER;
+    task->timedOut = timedOut;
+}
+
+static NativeTask *pick_ready_locked()
+{
+    NativeTask *best = NULL;
+    for (NativeTask *task : kernel().tasks)
+    {
+        if (task->state != TASK_READY)
+        {
+            continue;
+        }
+        if (best == NULL || task->priority > best->priority || (task->priority == best->priority && task->readySeq < best->readySeq))
+        {
+            best = task;
+        }
+    }
+    return best;
+}
+
+// 截止时间已到的阻塞任务转为就绪
+static void expire_timeouts_locked()
+{
+    NativeKernel &k = kernel();
+    for (NativeTask *task : k.tasks)
+    {
+        if (task->state == TASK_BLOCKED && task->wakeAtUs <= k.nowUs)
+        {
+            make_ready_locked(task, true);
+        }
+    }
+}
+
+static void report_deadlock_locked()
+{
+    fprintf(stderr, "[native] 死锁: 所有任务都在无限期等待\n");
+    for (NativeTask *task : kernel().tasks)
+    {
+        if (task->state == TASK_BLOCKED)
+        {
+            fprintf(stderr, "[native]   %-16s 优先级 %u 等待 %p\n", task->name, task->priority, task->waitObject);
+        }
+    }
+    abort();
+}
+
+/**
+ * @brief 选出下一个运行的任务并切换过去
+ * @param lock 已持有的内核锁
+ * @param self 调用者 (NULL 表示调用者已删除，不再等待)
+ * @details 没有就绪任务时把虚拟时钟推进到最早的截止时间
+ */
+static void reschedule_locked(std::unique_lock<std::mutex> &lock, NativeTask *self)
+{
+    NativeKernel &k = kernel();
+    NativeTask *next = pick_ready_locked();
+    while (next == NULL)
+    {
+        uint64_t earliest = NATIVE_WAIT_FOREVER;
+        for (NativeTask *task : k.tasks)
+        {
+            if (task->state == TASK_BLOCKED && task->wakeAtUs < earliest)
+            {
+                earliest = task->wakeAtUs;
+            }
+        }
+        if (earliest == NATIVE_WAIT_FOREVER)
+        {
+            report_deadlock_locked();
+        }
+        if (earliest > k.nowUs)
+        {
+            k.nowUs = earliest;
+        }
+        expire_timeouts_locked();
+        next = pick_ready_locked();
+    }
+
+    k.running = next;
+    next->state = TASK_RUNNING;
+    if (next != self)
+    {
+        next->cv.notify_one();
+    }
+    if (self == NULL)
+    {
+        return;
+    }
+    while (k.running != self)
+    {
+        self->cv.wait(lock);
+    }
+}
+
+// 有更高优先级的任务就绪时让出CPU
+static void preempt_locked(std::unique_lock<std::mutex> &lock, NativeTask *self)
+{
+    NativeTask *next = pick_ready_locked();
+    if (next != NULL && next->priority > self->priority)
+    {
+        make_ready_locked(self, false);
+        reschedule_locked(lock, self);
+    }
+}
+
+/**
+ * @brief 阻塞调用者
+ * @return true 被唤醒
+ * @return false 超时 (截止时间已过时不让出CPU，立即返回)
+ */
+static bool block_locked(std::unique_lock<std::mutex> &lock, NativeTask *self, const void *object, uint64_t deadlineUs)
+{
+    if (deadlineUs <= kernel().nowUs)
+    {
+        return false;
+    }
+    self->state = TASK_BLOCKED;
+    self->waitObject = object;
+    self->wakeAtUs = deadlineUs;
+    self->timedOut = false;
+    reschedule_locked(lock, self);
+    return !self->timedOut;
+}
+
+static void wake_locked(std::unique_lock<std::mutex> &lock, NativeTask *self, const void *object)
+{
+    for (NativeTask *task : kernel().tasks)
+    {
+        if (task->state == TASK_BLOCKED && task->waitObject == object)
+        {
+            make_ready_locked(task, false);
+        }
+    }
+    preempt_locked(lock, self);
+}
+
+static uint64_t ticks_to_deadline_locked(TickType_t ticks)
+{
+    if (ticks == portMAX_DELAY)
+    {
+        return NATIVE_WAIT_FOREVER;
+    }
+    return kernel().nowUs + (uint64_t)ticks * portTICK_PERIOD_MS * 1000;
+}
+
+static void task_entry(NativeTask *task)
+{
+    currentTask = task;
+    NativeKernel &k = kernel();
+    {
+        std::unique_lock<std::mutex> lock(k.mutex);
+        while (k.running != task)
+        {
+            task->cv.wait(lock);
+        }
+    }
+    task->function(task->parameter);
+
+    // FreeRTOS 任务函数不允许返回，这里按 vTaskDelete(NULL) 处理
+    vTaskDelete(NULL);
+}
+
+// ---------------------------------------------------------------- 仿真接口
+
+uint64_t native_time_us(void)
+{
+    NativeKernel &k = kernel();
+    std::lock_guard<std::mutex> lock(k.mutex);
+    return k.nowUs;
+}
+
+void native_advance_time_us(uint64_t us)
+{
+    NativeKernel &k = kernel();
+    std::unique_lock<std::mutex> lock(k.mutex);
+    NativeTask *self = self_locked();
+    k.nowUs += us;
+    expire_timeouts_locked();
+    preempt_locked(lock, self);
+}
+
+bool native_wait(const void *object, uint64_t deadlineUs)
+{
+    NativeKernel &k = kernel();
+    std::unique_lock<std::mutex> lock(k.mutex);
+    return block_locked(lock, self_locked(), object, deadlineUs);
+}
+
+void native_notify(const void *object)
+{
+    NativeKernel &k = kernel();
+    std::unique_lock<std::mutex> lock(k.mutex);
+    wake_locked(lock, self_locked(), object);
+}
+
+uint32_t native_task_usage(uint32_t *stackBytes)
+{
+    NativeKernel &k = kernel();
+    std::lock_guard<std::mutex> lock(k.mutex);
+    uint32_t count = 0;
+    uint32_t bytes = 0;
+    for (NativeTask *task : k.tasks)
+    {
+        if (task->state != TASK_DELETED)
+        {
+            count++;
+            bytes += task->stackDepth;
+        }
+    }
+    if (stackBytes != NULL)
+    {
+        *stackBytes = bytes;
+    }
+    return count;
+}
+
+// ---------------------------------------------------------------- 任务
+
+BaseType_t xPortGetCoreID(void)
+{
+    return 0;
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t pvTaskCode, const char *pcName, uint32_t usStackDepth, void *pvParameters, UBaseType_t uxPriority, TaskHandle_t *pvCreatedTask, BaseType_t xCoreID)
+{
+    (void)xCoreID;
+    NativeKernel &k = kernel();
+    std::unique_lock<std::mutex> lock(k.mutex);
+    NativeTask *self = self_locked();
+    NativeTask *task = new_task_locked(pcName, pvTaskCode, pvParameters, uxPriority, usStackDepth);
+    if (pvCreatedTask != NULL)
+    {
+        *pvCreatedTask = task;
+    }
+    std::thread(task_entry, task).detach();
+    preempt_locked(lock, self);
+    return pdPASS;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t pvTaskCode, const char *pcName, uint32_t usStackDepth, void *pvParameters, UBaseType_t uxPriority, TaskHandle_t *pvCreatedTask)
+{
+    return xTaskCreatePinnedToCore(pvTaskCode, pcName, usStackDepth, pvParameters, uxPriority, pvCreatedTask, tskNO_AFFINITY);
+}
+
+void vTaskDelete(TaskHandle_t xTaskToDelete)
+{
+    NativeKernel &k = kernel();
+    std::unique_lock<std::mutex> lock(k.mutex);
+    NativeTask *self = self_locked();
+    NativeTask *task = xTaskToDelete != NULL ? xTaskToDelete : self;
+    task->state = TASK_DELETED;
+    if (task != self)
+    {
+        return;
+    }
+
+    // 删除自己: 交出CPU后线程退出
+    reschedule_locked(lock, NULL);
+    lock.unlock();
+    currentTask = NULL;
+    if (task->function == NULL)
+    {
+        // loopTask (宿主 main 线程) 不能退出，永远停在这里
+        std::unique_lock<std::mutex> parked(k.mutex);
+        task->cv.wait(parked, []()
+                      { return false; });
+    }
+    pthread_exit(NULL);
+}
+
+void vTaskDelay(TickType_t xTicksToDelay)
+{
+    NativeKernel &k = kernel();
+    std::unique_lock<std::mutex> lock(k.mutex);
+    NativeTask *self = self_locked();
+    if (xTicksToDelay == 0)
+    {
+        // 让给同优先级的就绪任务
+        make_ready_locked(self, false);
+        reschedule_locked(lock, self);
+        return;
+    }
+    block_locked(lock, self, NULL, ticks_to_deadline_locked(xTicksToDelay));
+}
+
+TickType_t xTaskGetTickCount(void)
+{
+    return (TickType_t)(native_time_us() / 1000 / portTICK_PERIOD_MS);
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+    NativeKernel &k = kernel();
+    std::lock_guard<std::mutex> lock(k.mutex);
+    return self_locked();
+}
+
+const char *pcTaskGetName(TaskHandle_t xTaskToQuery)
+{
+    if (xTaskToQuery == NULL)
+    {
+        xTaskToQuery = xTaskGetCurrentTaskHandle();
+    }
+    return xTaskToQuery->name;
+}
+
+UBaseType_t uxTaskGetNumberOfTasks(void)
+{
+    return native_task_usage(NULL);
+}
+
+// 宿主线程栈无法按 FreeRTOS 的方式统计，报告声明的栈大小
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t xTask)
+{
+    if (xTask == NULL)
+    {
+        xTask = xTaskGetCurrentTaskHandle();
+    }
+    return xTask->stackDepth;
+}
+
+UBaseType_t uxTaskGetSystemState(TaskStatus_t *pxTaskStatusArray, UBaseType_t uxArraySize, uint32_t *pulTotalRunTime)
+{
+    NativeKernel &k = kernel();
+    std::lock_guard<std::mutex> lock(k.mutex);
+    UBaseType_t live = 0;
+    for (NativeTask *task : k.tasks)
+    {
+        if (task->state != TASK_DELETED)
+        {
+            live++;
+        }
+    }
+    if (live > uxArraySize)
+    {
+        return 0;
+    }
+
+    UBaseType_t count = 0;
+    for (NativeTask *task : k.tasks)
+    {
+        if (task->state == TASK_DELETED)
+        {
+            continue;
+        }
+        TaskStatus_t &status = pxTaskStatusArray[count++];
+        status.xHandle = task;
+        status.pcTaskName = task->name;
+        status.xTaskNumber = task->number;
+        status.eCurrentState = task->state == TASK_RUNNING ? eRunning : task->state == TASK_READY ? eReady
+                                                                                                    : eBlocked;
+        status.uxCurrentPriority = task->priority;
+        status.uxBasePriority = task->priority;
+        status.ulRunTimeCounter = 0;
+        status.pxStackBase = NULL;
+        status.usStackHighWaterMark = task->stackDepth;
+        status.xCoreID = tskNO_AFFINITY;
+    }
+    if (pulTotalRunTime != NULL)
+    {
+        *pulTotalRunTime = 0;
+    }
+    return count;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t xTaskToNotify)
+{
+    NativeKernel &k = kernel();
+    std::unique_lock<std::mutex> lock(k.mutex);
+    NativeTask *self = self_locked();
+    xTaskToNotify->notifyValue++;
+    wake_locked(lock, self, xTaskToNotify);
+    return pdPASS;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t xClearCountOnExit, TickType_t xTicksToWait)
+{
+    NativeKernel &k = kernel();
+    std::unique_lock<std::mutex> lock(k.mutex);
+    NativeTask *self = self_locked();
+    if (self->notifyValue == 0)
+    {
+        // 任务只在自己的句柄上等待通知
+        block_locked(lock, self, self, ticks_to_deadline_locked(xTicksToWait));
+    }
+    uint32_t value = self->notifyValue;
+    if (value > 0)
+    {
+        self->notifyValue = xClearCountOnExit ? 0 : value - 1;
+    }
+    return value;
+}
+
+// ---------------------------------------------------------------- 信号量
+
+static SemaphoreHandle_t create_semaphore(UBaseType_t count, UBaseType_t maxCount)
+{
+    NativeKernel &k = kernel();
+    std::lock_guard<std::mutex> lock(k.mutex);
+    NativeSemaphore *semaphore = new NativeSemaphore();
+    semaphore->count = count;
+    semaphore->maxCount = maxCount;
+    k.semaphores.push_back(semaphore);
+    return semaphore;
+}
+
+// 不模拟优先级继承
+SemaphoreHandle_t xSemaphoreCreateMutex(void)
+{
+    return create_semaphore(1, 1);
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary(void)
+{
+    return create_semaphore(0, 1);
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t xSemaphore, TickType_t xTicksToWait)
+{
+    NativeKernel &k = kernel();
+    std::unique_lock<std::mutex> lock(k.mutex);
+    NativeTask *self = self_locked();
+    uint64_t deadlineUs = ticks_to_deadline_locked(xTicksToWait);
+    while (xSemaphore->count == 0)
+    {
+        if (!block_locked(lock, self, xSemaphore, deadlineUs))
+        {
+            break;
+        }
+    }
+    if (xSemaphore->count == 0)
+    {
+        return pdFALSE;
+    }
+    xSemaphore->count--;
+    return pdTRUE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t xSemaphore)
+{
+    NativeKernel &k = kernel();
+    std::unique_lock<std::mutex> lock(k.mutex);
+    NativeTask *self = self_locked();
+    if (xSemaphore->count >= xSemaphore->maxCount)
+    {
+        return pdFALSE;
+    }
+    xSemaphore->count++;
+    wake_locked(lock, self, xSemaphore);
+    return pdTRUE;
+}
+
+// ---------------------------------------------------------------- 队列
+
+QueueHandle_t xQueueCreate(UBaseType_t uxQueueLength, UBaseType_t uxItemSize)
+{
+    if (uxQueueLength == 0)
+    {
+        return NULL;
+    }
+    NativeKernel &k = kernel();
+    std::lock_guard<std::mutex> lock(k.mutex);
+    NativeQueue *queue = new NativeQueue();
+    queue->length = uxQueueLength;
+    queue->itemSize = uxItemSize;
+    queue->head = 0;
+    queue->count = 0;
+    queue->storage.resize((size_t)uxQueueLength * uxItemSize);
+    k.queues.push_back(queue);
+    return queue;
+}
+
+BaseType_t xQueueSend(QueueHandle_t xQueue, const void *pvItemToQueue, TickType_t xTicksToWait)
+{
+    NativeKernel &k = kernel();
+    std::unique_lock<std::mutex> lock(k.mutex);
+    NativeTask *self = self_locked();
+    uint64_t deadlineUs = ticks_to_deadline_locked(xTicksToWait);
+    while (xQueue->count == xQueue->length)
+    {
+        if (!block_locked(lock, self, &xQueue->notFull, deadlineUs))
+        {
+            break;
+        }
+    }
+    if (xQueue->count == xQueue->length)
+    {
+        return pdFALSE;
+    }
+    UBaseType_t tail = (xQueue->head + xQueue->count) % xQueue->length;
+    memcpy(&xQueue->storage[(size_t)tail * xQueue->itemSize], pvItemToQueue, xQueue->itemSize);
+    xQueue->count++;
+    wake_locked(lock, self, &xQueue->notEmpty);
+    return pdTRUE;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t xQueue, void *pvBuffer, TickType_t xTicksToWait)
+{
+    NativeKernel &k = kernel();
+    std::unique_lock<std::mutex> lock(k.mutex);
+    NativeTask *self = self_locked();
+    uint64_t deadlineUs = ticks_to_deadline_locked(xTicksToWait);
+    while (xQueue->count == 0)
+    {
+        if (!block_locked(lock, self, &xQueue->notEmpty, deadlineUs))
+        {
+            break;
+        }
+    }
+    if (xQueue->count == 0)
+    {
+        return pdFALSE;
+    }
+    memcpy(pvBuffer, &xQueue->storage[(size_t)xQueue->head * xQueue->itemSize], xQueue->itemSize);
+    xQueue->head = (xQueue->head + 1) % xQueue->length;
+    xQueue->count--;
+    wake_locked(lock, self, &xQueue->notFull);
+    return pdTRUE;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t xQueue)
+{
+    NativeKernel &k = kernel();
+    std::lock_guard<std::mutex> lock(k.mutex);
+    return xQueue->count;
+}
+
+#endif
\ No newline at end of file
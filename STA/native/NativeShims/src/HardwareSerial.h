@@ -0,0 +1,81 @@
+#ifndef NATIVE_HARDWARE_SERIAL_H
+#define NATIVE_HARDWARE_SERIAL_H
+
+#include <deque>
+#include <functional>
+#include <vector>
+
+#include "Stream.h"
+
+#define SERIAL_8N1 0x800001c
+#define SERIAL_8E1 0x800001e
+
+class HardwareSerial;
+
+typedef std::function<void(void)> OnReceiveCb;
+
+// 定义[发送钩子]类型: 本端写出的字节立即交给对端仿真 (模拟器、测试桩)
+typedef void (*NativeSerialTxHook)(HardwareSerial &serial, const uint8_t *data, size_t length, void *context);
+
+/*
+ * HardwareSerial 的 native 仿真: 收发两个内存管道
+ * - native_inject() 写入接收管道，唤醒 readBytes 并触发 onReceive 回调
+ * - write() 写入发送管道，或交给 native_set_tx_hook() 设置的钩子
+ * - 传输不占用虚拟时间，波特率只做记录
+ */
+class HardwareSerial : public Stream
+{
+public:
+    explicit HardwareSerial(uint8_t uartNum);
+
+    void begin(unsigned long baud, uint32_t config = SERIAL_8N1, int8_t rxPin = -1, int8_t txPin = -1, bool invert = false, unsigned long timeoutMs = 20000UL, uint8_t rxfifoFullThrhd = 112);
+    void end(void);
+    void updateBaudRate(unsigned long baud) { currentBaud = baud; }
+    uint32_t baudRate(void) { return (uint32_t)currentBaud; }
+    operator bool() const { return started; }
+
+    void onReceive(OnReceiveCb function, bool onlyOnTimeout = false);
+    size_t setRxBufferSize(size_t newSize) { return newSize; }
+    size_t setTxBufferSize(size_t newSize) { return newSize; }
+
+    int available(void) override { return (int)rx.size(); }
+    int availableForWrite(void) { return 0x7FFF; }
+    int peek(void) override;
+    int read(void) override;
+    size_t read(uint8_t *buffer, size_t size);
+    size_t readBytes(uint8_t *buffer, size_t length) override;
+    size_t readBytes(char *buffer, size_t length) { return readBytes((uint8_t *)buffer, length); }
+    void flush(void) {}
+    void flush(bool txOnly) { (void)txOnly; }
+
+    size_t write(uint8_t c) override { return write(&c, 1); }
+    size_t write(const uint8_t *buffer, size_t size) override;
+    using Print::write;
+
+    // 仿真接口 (测试、基准和模拟器使用)
+    void native_inject(const uint8_t *data, size_t length);
+    void native_inject(const char *text);
+    size_t native_tx_size(void) const { return tx.size(); }
+    size_t native_take_tx(uint8_t *buffer, size_t size);
+    std::vector<uint8_t> native_take_tx(void);
+    void native_clear(void);
+    void native_set_tx_hook(NativeSerialTxHook hook, void *context);
+    void native_set_echo(bool enabled) { echo = enabled; }
+
+private:
+    uint8_t uartNum;
+    unsigned long currentBaud;
+    bool started;
+    bool echo; // 写出的字节同时输出到宿主机标准输出 (Serial 默认开启)
+    std::deque<uint8_t> rx;
+    std::vector<uint8_t> tx;
+    OnReceiveCb onReceiveCb;
+    NativeSerialTxHook txHook;
+    void *txHookContext;
+};
+
+extern HardwareSerial Serial;
+extern HardwareSerial Serial1;
+extern HardwareSerial Serial2;
+
+#endif
\ No newline at end of file
@@ -0,0 +1,182 @@
+#include "Preferences.h"
+
+#include <map>
+#include <string.h>
+#include <vector>
+
+#include <NativeShims.h>
+
+#define NVS_KEY_NAME_MAX_SIZE 16   // 键名最大长度 (含结束符)
+#define NVS_STRING_MAX_SIZE 4000   // 字符串最大长度 (含结束符)
+#define NVS_BLOB_MAX_SIZE 508000 // 字节数据最大长度
+
+// 定义[存储条目]类型
+typedef struct
+{
+    bool isString;
+    std::vector<uint8_t> bytes;
+} NativeNvsEntry;
+
+typedef std::map<std::string, NativeNvsEntry> NativeNvsNamespace;
+
+/**
+ * @brief 获取全部命名空间 (首次使用时创建，不随静态对象析构)
+ */
+static std::map<std::string, NativeNvsNamespace> &nvs_storage()
+{
+    static std::map<std::string, NativeNvsNamespace> *storage = new std::map<std::string, NativeNvsNamespace>();
+    return *storage;
+}
+
+static bool valid_name(const char *name)
+{
+    return name != NULL && name[0] != '\0' && strlen(name) < NVS_KEY_NAME_MAX_SIZE;
+}
+
+void native_preferences_reset()
+{
+    nvs_storage().clear();
+}
+
+Preferences::Preferences() : started(false), readOnly(false) {}
+
+Preferences::~Preferences()
+{
+    end();
+}
+
+bool Preferences::begin(const char *name, bool readOnly, const char *partition_label)
+{
+    (void)partition_label;
+    if (started || !valid_name(name))
+    {
+        return false;
+    }
+    this->name = name;
+    this->readOnly = readOnly;
+    if (readOnly && nvs_storage().find(this->name) == nvs_storage().end())
+    {
+        // 只读方式打开不存在的命名空间会失败 (ESP_ERR_NVS_NOT_FOUND)
+        return false;
+    }
+    nvs_storage()[this->name];
+    started = true;
+    return true;
+}
+
+void Preferences::end()
+{
+    started = false;
+}
+
+bool Preferences::writable(const char *key)
+{
+    return started && !readOnly && valid_name(key);
+}
+
+bool Preferences::clear()
+{
+    if (!started || readOnly)
+    {
+        return false;
+    }
+    nvs_storage()[name].clear();
+    return true;
+}
+
+bool Preferences::remove(const char *key)
+{
+    if (!writable(key))
+    {
+        return false;
+    }
+    return nvs_storage()[name].erase(key) > 0;
+}
+
+bool Preferences::isKey(const char *key)
+{
+    if (!started || !valid_name(key))
+    {
+        return false;
+    }
+    return nvs_storage()[name].count(key) > 0;
+}
+
+size_t Preferences::putBytes(const char *key, const void *value, size_t len)
+{
+    if (!writable(key) || value == NULL || len == 0 || len > NVS_BLOB_MAX_SIZE)
+    {
+        return 0;
+    }
+    NativeNvsEntry &entry = nvs_storage()[name][key];
+    entry.isString = false;
+    entry.bytes.assign((const uint8_t *)value, (const uint8_t *)value + len);
+    return len;
+}
+
+size_t Preferences::getBytesLength(const char *key)
+{
+    if (!isKey(key))
+    {
+        return 0;
+    }
+    const NativeNvsEntry &entry = nvs_storage()[name][key];
+    return entry.isString ? 0 : entry.bytes.size();
+}
+
+size_t Preferences::getBytes(const char *key, void *buf, size_t maxLen)
+{
+    size_t len = getBytesLength(key);
+    if (len == 0 || buf == NULL || len > maxLen)
+    {
+        return 0;
+    }
+    memcpy(buf, nvs_storage()[name][key].bytes.data(), len);
+    return len;
+}
+
+size_t Preferences::putString(const char *key, const char *value)
+{
+    if (!writable(key) || value == NULL || strlen(value) + 1 > NVS_STRING_MAX_SIZE)
+    {
+        return 0;
+    }
+    NativeNvsEntry &entry = nvs_storage()[name][key];
+    entry.isString = true;
+    entry.bytes.assign((const uint8_t *)value, (const uint8_t *)value + strlen(value) + 1);
+    return strlen(value);
+}
+
+size_t Preferences::putString(const char *key, String value)
+{
+    return putString(key, value.c_str());
+}
+
+size_t Preferences::getString(const char *key, char *value, size_t maxLen)
+{
+    if (!isKey(key) || value == NULL)
+    {
+        return 0;
+    }
+    const NativeNvsEntry &entry = nvs_storage()[name][key];
+    if (!entry.isString || entry.bytes.size() > maxLen)
+    {
+        return 0;
+    }
+    memcpy(value, entry.bytes.data(), entry.bytes.size());
+    return entry.bytes.size();
+}
+
+String Preferences::getString(const char *key, String defaultValue)
+{
+    if (!isKey(key))
+    {
+        return defaultValue;
+    }
+    const NativeNvsEntry &entry = nvs_storage()[name][key];
+    if (!entry.isString)
+    {
+        return defaultValue;
+    }
+    return String((const char *)entry.bytes.data());
+}
\ No newline at end of file
@@ -0,0 +1,43 @@
+#include "Print.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <vector>
+
+size_t Print::write(const uint8_t *buffer, size_t size)
+{
+    size_t n = 0;
+    while (size--)
+    {
+        if (write(*buffer++) == 0)
+        {
+            break;
+        }
+        n++;
+    }
+    return n;
+}
+
+size_t Print::printf(const char *format, ...)
+{
+    char text[128];
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(text, sizeof(text), format, args);
+    va_end(args);
+    if (length < 0)
+    {
+        return 0;
+    }
+    if ((size_t)length < sizeof(text))
+    {
+        return write((const uint8_t *)text, length);
+    }
+
+    // 超出栈缓冲区时改用堆缓冲区重新格式化
+    std::vector<char> longText(length + 1);
+    va_start(args, format);
+    vsnprintf(longText.data(), longText.size(), format, args);
+    va_end(args);
+    return write((const uint8_t *)longText.data(), length);
+}
\ No newline at end of file
@@ -0,0 +1,24 @@
+#include "Stream.h"
+
+#include <Arduino.h>
+
+size_t Stream::readBytes(uint8_t *buffer, size_t length)
+{
+    size_t count = 0;
+    unsigned long start = millis();
+    while (count < length)
+    {
+        int c = read();
+        if (c >= 0)
+        {
+            buffer[count++] = (uint8_t)c;
+            continue;
+        }
+        if (millis() - start >= _timeout)
+        {
+            break;
+        }
+        delay(1);
+    }
+    return count;
+}
\ No newline at end of file
@@ -0,0 +1,381 @@
+#include "WString.h"
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief 无符号整数按进制转换为字符串
+ * @param value 数值
+ * @param base 进制 (2~36)
+ * @return std::string 转换结果
+ */
+static std::string format_unsigned(unsigned long long value, unsigned char base)
+{
+    if (base < 2 || base > 36)
+    {
+        base = 10;
+    }
+    char digits[66];
+    int index = sizeof(digits) - 1;
+    digits[index] = '\0';
+    do
+    {
+        int digit = (int)(value % base);
+        digits[--index] = (char)(digit < 10 ? '0' + digit : 'a' + digit - 10);
+        value /= base;
+    } while (value != 0);
+    return std::string(&digits[index]);
+}
+
+/**
+ * @brief 有符号整数按进制转换为字符串 (只有十进制输出负号，与 Arduino 一致)
+ * @param value 数值
+ * @param base 进制
+ * @param width 数值的位宽 (非十进制时按补码输出)
+ * @return std::string 转换结果
+ */
+static std::string format_signed(long long value, unsigned char base, unsigned width)
+{
+    if (base == 10)
+    {
+        if (value < 0)
+        {
+            return "-" + format_unsigned(0ULL - (unsigned long long)value, 10);
+        }
+        return format_unsigned((unsigned long long)value, 10);
+    }
+    unsigned long long mask = width >= 64 ? ~0ULL : ((1ULL << width) - 1);
+    return format_unsigned((unsigned long long)value & mask, base);
+}
+
+/**
+ * @brief 浮点数按小数位数转换为字符串
+ * @param value 数值
+ * @param decimalPlaces 小数位数
+ * @return std::string 转换结果
+ */
+static std::string format_double(double value, unsigned int decimalPlaces)
+{
+    char text[64];
+    snprintf(text, sizeof(text), "%.*f", (int)decimalPlaces, value);
+    return std::string(text);
+}
+
+String::String(const char *cstr) : buffer(cstr ? cstr : "") {}
+String::String(const char *cstr, unsigned int length) : buffer(cstr ? std::string(cstr, length) : std::string()) {}
+String::String(char c) : buffer(1, c) {}
+String::String(unsigned char value, unsigned char base) : buffer(format_unsigned(value, base)) {}
+String::String(int value, unsigned char base) : buffer(format_signed(value, base, sizeof(int) * 8)) {}
+String::String(unsigned int value, unsigned char base) : buffer(format_unsigned(value, base)) {}
+String::String(long value, unsigned char base) : buffer(format_signed(value, base, sizeof(long) * 8)) {}
+String::String(unsigned long value, unsigned char base) : buffer(format_unsigned(value, base)) {}
+String::String(long long value, unsigned char base) : buffer(format_signed(value, base, 64)) {}
+String::String(unsigned long long value, unsigned char base) : buffer(format_unsigned(value, base)) {}
+String::String(float value, unsigned int decimalPlaces) : buffer(format_double(value, decimalPlaces)) {}
+String::String(double value, unsigned int decimalPlaces) : buffer(format_double(value, decimalPlaces)) {}
+
+String &String::operator=(const char *cstr)
+{
+    buffer = cstr ? cstr : "";
+    return *this;
+}
+
+bool String::reserve(unsigned int size)
+{
+    buffer.reserve(size);
+    return true;
+}
+
+bool String::concat(const String &str)
+{
+    buffer += str.buffer;
+    return true;
+}
+
+bool String::concat(const char *cstr)
+{
+    if (cstr == NULL)
+    {
+        return false;
+    }
+    buffer += cstr;
+    return true;
+}
+
+bool String::concat(const char *cstr, unsigned int length)
+{
+    if (cstr == NULL)
+    {
+        return false;
+    }
+    buffer.append(cstr, length);
+    return true;
+}
+
+bool String::concat(char c)
+{
+    buffer += c;
+    return true;
+}
+
+bool String::concat(unsigned char value) { return concat(String(value)); }
+bool String::concat(int value) { return concat(String(value)); }
+bool String::concat(unsigned int value) { return concat(String(value)); }
+bool String::concat(long value) { return concat(String(value)); }
+bool String::concat(unsigned long value) { return concat(String(value)); }
+bool String::concat(long long value) { return concat(String(value)); }
+bool String::concat(unsigned long long value) { return concat(String(value)); }
+bool String::concat(float value) { return concat(String(value)); }
+bool String::concat(double value) { return concat(String(value)); }
+
+bool String::equalsIgnoreCase(const String &str) const
+{
+    if (buffer.size() != str.buffer.size())
+    {
+        return false;
+    }
+    for (size_t i = 0; i < buffer.size(); i++)
+    {
+        if (tolower((unsigned char)buffer[i]) != tolower((unsigned char)str.buffer[i]))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool String::startsWith(const String &prefix) const
+{
+    return startsWith(prefix, 0);
+}
+
+bool String::startsWith(const String &prefix, unsigned int offset) const
+{
+    if (offset > buffer.size() || prefix.buffer.size() > buffer.size() - offset)
+    {
+        return false;
+    }
+    return buffer.compare(offset, prefix.buffer.size(), prefix.buffer) == 0;
+}
+
+bool String::endsWith(const String &suffix) const
+{
+    if (suffix.buffer.size() > buffer.size())
+    {
+        return false;
+    }
+    return buffer.compare(buffer.size() - suffix.buffer.size(), suffix.buffer.size(), suffix.buffer) == 0;
+}
+
+char String::charAt(unsigned int index) const
+{
+    return index < buffer.size() ? buffer[index] : '\0';
+}
+
+void String::setCharAt(unsigned int index, char c)
+{
+    if (index < buffer.size())
+    {
+        buffer[index] = c;
+    }
+}
+
+char &String::operator[](unsigned int index)
+{
+    static char dummy;
+    if (index >= buffer.size())
+    {
+        dummy = '\0';
+        return dummy;
+    }
+    return buffer[index];
+}
+
+void String::getBytes(unsigned char *buf, unsigned int bufsize, unsigned int index) const
+{
+    if (buf == NULL || bufsize == 0)
+    {
+        return;
+    }
+    if (index >= buffer.size())
+    {
+        buf[0] = '\0';
+        return;
+    }
+    size_t count = buffer.size() - index;
+    if (count > bufsize - 1)
+    {
+        count = bufsize - 1;
+    }
+    memcpy(buf, buffer.data() + index, count);
+    buf[count] = '\0';
+}
+
+int String::indexOf(char ch, unsigned int fromIndex) const
+{
+    size_t position = buffer.find(ch, fromIndex);
+    return position == std::string::npos ? -1 : (int)position;
+}
+
+int String::indexOf(const String &str, unsigned int fromIndex) const
+{
+    size_t position = buffer.find(str.buffer, fromIndex);
+    return position == std::string::npos ? -1 : (int)position;
+}
+
+int String::lastIndexOf(char ch) const
+{
+    size_t position = buffer.rfind(ch);
+    return position == std::string::npos ? -1 : (int)position;
+}
+
+int String::lastIndexOf(const String &str) const
+{
+    size_t position = buffer.rfind(str.buffer);
+    return position == std::string::npos ? -1 : (int)position;
+}
+
+String String::substring(unsigned int beginIndex, unsigned int endIndex) const
+{
+    if (beginIndex > endIndex)
+    {
+        unsigned int temp = beginIndex;
+        beginIndex = endIndex;
+        endIndex = temp;
+    }
+    if (beginIndex >= buffer.size())
+    {
+        return String();
+    }
+    if (endIndex > buffer.size())
+    {
+        endIndex = (unsigned int)buffer.size();
+    }
+    return String(buffer.data() + beginIndex, endIndex - beginIndex);
+}
+
+void String::replace(char find, char replace)
+{
+    for (size_t i = 0; i < buffer.size(); i++)
+    {
+        if (buffer[i] == find)
+        {
+            buffer[i] = replace;
+        }
+    }
+}
+
+void String::replace(const String &find, const String &replace)
+{
+    if (find.buffer.empty())
+    {
+        return;
+    }
+    size_t position = 0;
+    while ((position = buffer.find(find.buffer, position)) != std::string::npos)
+    {
+        buffer.replace(position, find.buffer.size(), replace.buffer);
+        position += replace.buffer.size();
+    }
+}
+
+void String::remove(unsigned int index)
+{
+    if (index < buffer.size())
+    {
+        buffer.erase(index);
+    }
+}
+
+void String::remove(unsigned int index, unsigned int count)
+{
+    if (index < buffer.size())
+    {
+        buffer.erase(index, count);
+    }
+}
+
+void String::toLowerCase()
+{
+    for (size_t i = 0; i < buffer.size(); i++)
+    {
+        buffer[i] = (char)tolower((unsigned char)buffer[i]);
+    }
+}
+
+void String::toUpperCase()
+{
+    for (size_t i = 0; i < buffer.size(); i++)
+    {
+        buffer[i] = (char)toupper((unsigned char)buffer[i]);
+    }
+}
+
+void String::trim()
+{
+    size_t begin = 0;
+    while (begin < buffer.size() && isspace((unsigned char)buffer[begin]))
+    {
+        begin++;
+    }
+    size_t end = buffer.size();
+    while (end > begin && isspace((unsigned char)buffer[end - 1]))
+    {
+        end--;
+    }
+    buffer = buffer.substr(begin, end - begin);
+}
+
+long String::toInt() const
+{
+    return atol(buffer.c_str());
+}
+
+float String::toFloat() const
+{
+    return (float)atof(buffer.c_str());
+}
+
+double String::toDouble() const
+{
+    return atof(buffer.c_str());
+}
+
+String operator+(const String &lhs, const String &rhs)
+{
+    String result(lhs);
+    result.concat(rhs);
+    return result;
+}
+
+String operator+(const char *lhs, const String &rhs)
+{
+    String result(lhs);
+    result.concat(rhs);
+    return result;
+}
+
+/**
+ * @brief String 与其它类型拼接 (按各自 concat 的规则转换)
+ */
+#define NATIVE_STRING_PLUS(Type)                     \
+    String operator+(const String &lhs, Type rhs)    \
+    {                                                \
+        String result(lhs);                          \
+        result.concat(rhs);                          \
+        return result;                               \
+    }
+
+NATIVE_STRING_PLUS(const char *)
+NATIVE_STRING_PLUS(char)
+NATIVE_STRING_PLUS(unsigned char)
+NATIVE_STRING_PLUS(int)
+NATIVE_STRING_PLUS(unsigned int)
+NATIVE_STRING_PLUS(long)
+NATIVE_STRING_PLUS(unsigned long)
+NATIVE_STRING_PLUS(long long)
+NATIVE_STRING_PLUS(unsigned long long)
+NATIVE_STRING_PLUS(float)
+NATIVE_STRING_PLUS(double)
\ No newline at end of file
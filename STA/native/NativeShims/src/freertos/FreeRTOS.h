@@ -0,0 +1,58 @@
+#ifndef NATIVE_FREERTOS_H
+#define NATIVE_FREERTOS_H
+
+/*
+ * FreeRTOS 的 native 仿真 (只实现本项目用到的接口)
+ *
+ * - 单CPU协作式调度: 每个任务是一个宿主线程，但同一时刻只有一个任务在运行
+ * - 就绪任务中优先级最高的先运行，同优先级按就绪先后轮流
+ * - 时间是虚拟的: 只有所有任务都阻塞时，时钟才跳到最早的到期时间
+ *   (测试结果与宿主机负载无关，可以重复)
+ * - 第一个调用仿真接口的宿主线程 (测试的 main) 登记为优先级1的 loopTask
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+
+typedef struct NativeTask *TaskHandle_t;
+typedef struct NativeSemaphore *SemaphoreHandle_t;
+typedef struct NativeQueue *QueueHandle_t;
+
+#define pdTRUE 1
+#define pdFALSE 0
+#define pdPASS pdTRUE
+#define pdFAIL pdFALSE
+
+#define configTICK_RATE_HZ 1000
+#define configMAX_PRIORITIES 25
+#define configMAX_TASK_NAME_LEN 16
+#define configUSE_TRACE_FACILITY 1
+#define configGENERATE_RUN_TIME_STATS 0
+
+#define portMAX_DELAY ((TickType_t)0xFFFFFFFFUL)
+#define portTICK_PERIOD_MS ((TickType_t)1000 / configTICK_RATE_HZ)
+#define pdMS_TO_TICKS(xTimeInMs) ((TickType_t)(((TickType_t)(xTimeInMs) * (TickType_t)configTICK_RATE_HZ) / (TickType_t)1000U))
+
+#define tskNO_AFFINITY ((BaseType_t)0x7FFFFFFF)
+#define tskIDLE_PRIORITY ((UBaseType_t)0U)
+
+// 临界区: 任意时刻只有一个任务在运行，不会被打断，故为空操作
+typedef struct
+{
+    uint32_t owner;
+    uint32_t count;
+} portMUX_TYPE;
+
+#define portMUX_INITIALIZER_UNLOCKED {0, 0}
+#define portENTER_CRITICAL(mux) ((void)(mux))
+#define portEXIT_CRITICAL(mux) ((void)(mux))
+#define portENTER_CRITICAL_ISR(mux) ((void)(mux))
+#define portEXIT_CRITICAL_ISR(mux) ((void)(mux))
+
+BaseType_t xPortGetCoreID(void);
+
+#endif
\ No newline at end of file
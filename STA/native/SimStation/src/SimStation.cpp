@@ -0,0 +1,83 @@
+#include <Arduino.h>
+#include <ElectricRelay.h>
+#include <HPLC.h>
+#include <SimStation.h>
+
+// STA固件 (src/main.cpp) 中的地址和入口
+extern uint8_t LOCAL_ADDRESS[6];
+extern uint8_t TARGET_ADDRESS[6];
+void setup();
+void loop();
+
+#define SIM_STATION_LOOP_STACK_SIZE 8192 // 与 Arduino 的 loopTask 相同
+
+static SimStationTxFunc txFunc = NULL;
+static void *txContext = NULL;
+static uint32_t loopIntervalMs = 1;
+static bool setupDone = false;
+
+static void forward_tx(HardwareSerial &serial, const uint8_t *data, size_t length, void *context)
+{
+    (void)serial;
+    (void)context;
+    if (txFunc != NULL)
+    {
+        txFunc(data, length, txContext);
+    }
+}
+
+static void discard_tx(HardwareSerial &serial, const uint8_t *data, size_t length, void *context)
+{
+    (void)serial;
+    (void)data;
+    (void)length;
+    (void)context;
+}
+
+/**
+ * STA的 loopTask: 与 Arduino 框架一样先执行 setup()，再循环执行 loop()
+ */
+static void station_loop_task(void *pvParameters)
+{
+    (void)pvParameters;
+    setup();
+    setupDone = true;
+    for (;;)
+    {
+        loop();
+        vTaskDelay(pdMS_TO_TICKS(loopIntervalMs));
+    }
+}
+
+void SIM_STATION_attach(SimStationTxFunc tx, void *context)
+{
+    txFunc = tx;
+    txContext = context;
+    HPLC.native_set_tx_hook(forward_tx, NULL);
+}
+
+void SIM_STATION_receive(const uint8_t *data, size_t length)
+{
+    HPLC.native_inject(data, length);
+}
+
+void SIM_STATION_start(const uint8_t local_address[6], const uint8_t cco_address[6], uint32_t loop_interval_ms)
+{
+    memcpy(LOCAL_ADDRESS, local_address, 6);
+    memcpy(TARGET_ADDRESS, cco_address, 6);
+    loopIntervalMs = loop_interval_ms > 0 ? loop_interval_ms : 1;
+    // 数百个STA的日志混在一起没有意义，丢弃串口监视器输出
+    Serial.native_set_echo(false);
+    Serial.native_set_tx_hook(discard_tx, NULL);
+    xTaskCreate(station_loop_task, "loopTask", SIM_STATION_LOOP_STACK_SIZE, NULL, 1, NULL);
+}
+
+bool SIM_STATION_ready(void)
+{
+    return setupDone;
+}
+
+uint8_t SIM_STATION_socket_state(uint8_t socket)
+{
+    return ELECTRIC_RELAY_get_state(socket);
+}
\ No newline at end of file
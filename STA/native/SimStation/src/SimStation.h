@@ -0,0 +1,57 @@
+#ifndef SIM_STATION_H
+#define SIM_STATION_H
+
+/*
+ * HPLC模拟器的STA镜像入口 (只在 native_station 环境中存在)
+ * - native_station 环境把STA固件编译成共享库 (STA镜像)，模拟器为每个STA加载一份副本，各副本的全局变量互相独立
+ * - 镜像不带仿真内核 (NATIVE_SHIMS_NO_KERNEL)，任务和虚拟时钟由加载它的宿主程序提供
+ * - 镜像内的符号默认隐藏，只导出下面的 C 接口 (宿主程序用 dlsym 按名称查找)
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define SIM_STATION_API extern "C" __attribute__((visibility("default")))
+
+// 定义[载波串口发送函数]类型: STA写往载波模块的字节交给宿主程序 (模拟的载波网络)
+typedef void (*SimStationTxFunc)(const uint8_t *data, size_t length, void *context);
+
+/**
+ * @brief 把STA的载波串口 (Serial2) 接到宿主程序
+ * @param tx 发送函数，在STA的任务中调用
+ * @param context 原样传给发送函数
+ */
+SIM_STATION_API void SIM_STATION_attach(SimStationTxFunc tx, void *context);
+
+/**
+ * @brief 载波模块向STA的载波串口送出字节 (相当于收到载波帧)
+ * @param data 数据
+ * @param length 数据长度
+ */
+SIM_STATION_API void SIM_STATION_receive(const uint8_t *data, size_t length);
+
+/**
+ * @brief 设置地址并启动STA固件
+ * @details 创建STA的 loopTask: 先执行 setup()，之后每隔 loop_interval_ms 执行一次 loop()。
+ *          STA的串口监视器输出被丢弃
+ * @param local_address 本机地址
+ * @param cco_address CCO地址
+ * @param loop_interval_ms loop() 的执行间隔 (至少1毫秒，虚拟时钟只在所有任务都阻塞时推进)
+ */
+SIM_STATION_API void SIM_STATION_start(const uint8_t local_address[6], const uint8_t cco_address[6], uint32_t loop_interval_ms);
+
+/**
+ * @brief STA固件是否已执行完 setup()
+ * @return true 已执行完
+ * @return false 尚未启动或仍在执行 setup()
+ */
+SIM_STATION_API bool SIM_STATION_ready(void);
+
+/**
+ * @brief 读取插孔的继电器状态
+ * @param socket 插孔ID (1 - 3)
+ * @return uint8_t 继电器状态 (0 断开, 1 吸合)
+ */
+SIM_STATION_API uint8_t SIM_STATION_socket_state(uint8_t socket);
+
+#endif
\ No newline at end of file
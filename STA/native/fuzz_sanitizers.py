@@ -0,0 +1,4 @@
+# 模糊测试环境: build_flags 只作用于编译，链接时同样需要 ASan/UBSan 的运行时
+Import("env")
+
+env.Append(LINKFLAGS=["-fsanitize=address,undefined"])
\ No newline at end of file
@@ -0,0 +1,4 @@
+# 把 native_station 环境的程序链接为共享库 (HPLC模拟器的STA镜像)
+Import("env")
+
+env.Append(LINKFLAGS=["-shared"])
\ No newline at end of file
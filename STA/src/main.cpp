@@ -3,6 +3,12 @@
 #include <BL.h>
 #include <BLRegConv.h>
 #include <ElectricRelay.h>
+#include <Energy.h>
+#include <History.h>
+#include <Protocol.h>
+#include <Metrics.h>
+#include <Log.h>
+#include <Profiler.h>
 
 // 电源监控间隔 (毫秒)
 #define POWER_MONITOR_INTERVAL_MS 2000
@@ -14,46 +20,59 @@ uint8_t TARGET_ADDRESS[6] = {0x00, 0x13, 0xd7, 0x63, 0x22, 0x01};
 
 // FreeRTOS 任务句柄
 TaskHandle_t powerMonitoringTaskHandle = NULL;
-
-// HPLC串口访问互斥锁
-SemaphoreHandle_t hplcMutex;
+// loop() 的耗时统计ID
+int8_t mainLoopProfile = -1;
 
 // 继电器 1, 2, 3 的 BL0906 电流寄存器地址
 const byte CURRENT_REGISTERS[] = {0x0D, 0x0E, 0x0F};
 // 继电器 1, 2, 3 的 BL0906 功率寄存器地址
 const byte POWER_REGISTERS[] = {0x23, 0x24, 0x25};
+// 继电器 1, 2, 3 的 BL0906 有功脉冲计数寄存器(CF_CNT)地址
+const byte CF_CNT_REGISTERS[] = {0x30, 0x31, 0x32};
 // 电能参数推送开关
 bool electricParamPush = false;
 
 void powerMonitoringTask(void *pvParameters);
-void HPLC_handle_valid_frame(FrameParser frameParser);
+void hplc_handle_heart_beat(const FrameView &frame);
+void hplc_handle_set_socket_state(const FrameView &frame);
+void hplc_handle_set_max_power(const FrameView &frame);
+void hplc_handle_set_push(const FrameView &frame);
+void hplc_handle_energy_query(const FrameView &frame);
+void hplc_handle_history_query(const FrameView &frame);
 
 void setup()
 {
     // 初始化串口监视器
     Serial.begin(115200, SERIAL_8N1);
+    // 启动日志任务 (热路径上的日志由该任务延迟输出)
+    LOG_init();
+    // 启动剖析任务 (任务CPU占用和堆栈余量随 "metrics" 命令输出)
+    PROFILER_init();
+    mainLoopProfile = PROFILER_register_loop("loop");
 
     // 初始化继电器控制
     ELECTRIC_RELAY_init();
 
     // 初始化载波模块串口
     HPLC_init();
+    // 注册HPLC控制码处理函数
+    HPLC_register_message<MsgHeartBeat>(hplc_handle_heart_beat);
+    HPLC_register_message<MsgSetSocketState>(hplc_handle_set_socket_state);
+    HPLC_register_message<MsgSetMaxPower>(hplc_handle_set_max_power);
+    HPLC_register_message<MsgSetPush>(hplc_handle_set_push);
+    HPLC_register_message<MsgEnergyQuery>(hplc_handle_energy_query);
+    HPLC_register_message<MsgHistoryQuery>(hplc_handle_history_query);
 
     // 初始化电能计量芯片串口
     BL_init();
 
-    // 创建HPLC串口访问互斥锁
-    hplcMutex = xSemaphoreCreateMutex();
-    if (hplcMutex == NULL)
-    {
-        Serial.println("初始化 -> HPLC互斥锁创建失败");
-        // 挂起
-        while (1)
-            ;
-    }
-    else
+    // 初始化电能累计并加载已保存的累计值
+    ENERGY_init();
+
+    // 初始化历史记录缓冲区 (PSRAM)
+    if (!HISTORY_init())
     {
-        Serial.println("初始化 -> HPLC互斥锁创建成功");
+        Serial.println("初始化 -> 历史记录缓冲区分配失败");
     }
 
     // ESP32-S3：核心0 (PRO_CPU) 和核心1 (APP_CPU)【Arduino 的 loop 函数在核心1上运行】
@@ -79,19 +98,16 @@ void setup()
 
 void loop()
 {
-    // 载波模块信息交互
-    // 尝试获取HPLC互斥锁，设置一个较短的超时时间以避免loop()长时间阻塞
-    if (xSemaphoreTake(hplcMutex, (TickType_t)10) == pdTRUE)
-    {
-        while (HPLC.available())
-        {
-            byte data = HPLC.read();
-            // print_to_serial_monitor("HPLC", data);
-            HPLC_process_frame(data, HPLC_handle_valid_frame);
-        }
-        // 释放HPLC互斥锁
-        xSemaphoreGive(hplcMutex);
-    }
+    // 记录本次迭代的起始时间
+    uint32_t loopStart = micros();
+
+    // 载波模块信息交互 (分发串口任务已解析的帧)
+    HPLC_poll(HPLC_dispatch_frame);
+
+    // 串口监视器命令 ("metrics" 输出链路指标)
+    METRICS_handle_serial();
+
+    PROFILER_record_loop(mainLoopProfile, micros() - loopStart);
 }
 
 /**
@@ -100,60 +116,66 @@ void loop()
  */
 void powerMonitoringTask(void *pvParameters)
 {
-    Serial.printf("功率监控任务 -> 在核心 %d 上启动\n", xPortGetCoreID());
+    LOG_INFO("功率监控任务 -> 在核心 %d 上启动", xPortGetCoreID());
 
     // BL0906 数据缓冲区 (3 字节)
     uint8_t bl_data_buffer[3];
+    // 本任务的耗时统计ID
+    int8_t profile = PROFILER_register_loop("PowerMonitor");
+    // 上一个周期结束时吸合的继电器 (位 n-1 对应插孔 n)
+    uint8_t previousRelayOnMask = 0;
 
     for (;;)
     {
-        Serial.println("功率监控任务启动");
+        // 记录本次监控周期的起始时间
+        uint32_t cycleStart = micros();
+        LOG_DEBUG("功率监控任务启动");
+        // 本周期结束时吸合的继电器
+        uint8_t relayOnMask = 0;
+
+        // 0. 读取所有插孔的有功脉冲计数并累计电能 (断开的插孔计数不变，增量为0)
+        for (uint8_t relay_num = 1; relay_num <= 3; relay_num++)
+        {
+            if (BL_read_register(CF_CNT_REGISTERS[relay_num - 1], bl_data_buffer))
+            {
+                uint32_t cf_cnt = ((uint32_t)bl_data_buffer[2] << 16) | ((uint32_t)bl_data_buffer[1] << 8) | bl_data_buffer[0];
+                ENERGY_update(relay_num, cf_cnt);
+            }
+        }
+
         for (uint8_t relay_num = 1; relay_num <= 3; relay_num++)
         {
             // 检查继电器是否激活 (ON)
             if (ELECTRIC_RELAY_get_state(relay_num) == 1)
             {
-                Serial.printf("功率监控任务 -> 处理吸合的继电器 -> %d \n", relay_num);
+                LOG_DEBUG("功率监控任务 -> 处理吸合的继电器 -> %d", relay_num);
                 uint8_t relay_idx = relay_num - 1;
+                // 本周期电流 (mA)，读取失败时记为0
+                uint32_t current_ma = 0;
 
                 // 1. 从 BL0906 读取电流
                 if (BL_read_register(CURRENT_REGISTERS[relay_idx], bl_data_buffer))
                 {
                     // bl_data_buffer[0] = LSB, bl_data_buffer[1] = MID, bl_data_buffer[2] = MSB
-                    float current_reg = ((uint32_t)bl_data_buffer[2] << 16) | ((uint32_t)bl_data_buffer[1] << 8) | bl_data_buffer[0];
-                    // 转换为实际电流 (A)
-                    float current = BL_currentRegister2ActualCurrent(current_reg);
+                    uint32_t current_reg = ((uint32_t)bl_data_buffer[2] << 16) | ((uint32_t)bl_data_buffer[1] << 8) | bl_data_buffer[0];
+                    // 转换为实际电流 (mA)
+                    current_ma = BL_currentRegister2MilliAmps(current_reg);
 
                     // 通过 HPLC 发送原始电流数据
-                    uint8_t currentFrame[] = {
-                        0x14,              // 控制码
-                        0x0A,              // 数据域长度
-                        LOCAL_ADDRESS[0],  // 本机地址
-                        LOCAL_ADDRESS[1],  // 本机地址
-                        LOCAL_ADDRESS[2],  // 本机地址
-                        LOCAL_ADDRESS[3],  // 本机地址
-                        LOCAL_ADDRESS[4],  // 本机地址
-                        LOCAL_ADDRESS[5],  // 本机地址
-                        relay_num,         // 插孔ID
-                        bl_data_buffer[0], // 电流低字节
-                        bl_data_buffer[1], // 电流中字节
-                        bl_data_buffer[2]  // 电流高字节
-                    };
+                    uint8_t currentFrame[protocol_frame_size<MsgCurrentReport>()];
+                    MsgCurrentReport &currentMsg = protocol_encode<MsgCurrentReport>(currentFrame);
+                    memcpy(currentMsg.macAddress, LOCAL_ADDRESS, 6);     // 本机地址
+                    currentMsg.socketId = relay_num;                     // 插孔ID
+                    memcpy(currentMsg.current.bytes, bl_data_buffer, 3); // 电流寄存器
                     if (electricParamPush)
                     {
-                        // 获取HPLC互斥锁后再发送
-                        if (xSemaphoreTake(hplcMutex, (TickType_t)10) == pdTRUE)
-                        {
-                            HPLC_send_frame(TARGET_ADDRESS, currentFrame, sizeof(currentFrame), false);
-                            // 释放HPLC互斥锁
-                            xSemaphoreGive(hplcMutex);
-                        }
+                        HPLC_send_frame(TARGET_ADDRESS, currentFrame, sizeof(currentFrame), false);
                     }
-                    Serial.printf("SOCKET_ID -> %d | CURRENT -> %.3f\n", relay_num, current);
+                    LOG_DEBUG("SOCKET_ID -> %d | CURRENT -> %u mA", relay_num, current_ma);
                 }
                 else
                 {
-                    Serial.printf("SOCKET_ID -> %d | CURRENT -> 读取失败\n", relay_num);
+                    LOG_WARN("SOCKET_ID -> %d | CURRENT -> 读取失败", relay_num);
                 }
 
                 // 2. 从 BL0906 读取功率
@@ -161,73 +183,66 @@ void powerMonitoringTask(void *pvParameters)
                 {
                     // bl_data_buffer[0] = LSB, bl_data_buffer[1] = MID, bl_data_buffer[2] = MSB
                     uint32_t power_reg = ((uint32_t)bl_data_buffer[2] << 16) | ((uint32_t)bl_data_buffer[1] << 8) | bl_data_buffer[0];
-                    // 转换为实际功率 (W)
-                    float power = BL_powerRegister2ActualPower(power_reg);
+                    // 转换为实际功率 (mW)
+                    uint32_t power_mw = BL_powerRegister2MilliWatts(power_reg);
 
                     // 通过 HPLC 发送原始功率数据
-                    uint8_t powerFrame[] = {
-                        0x15,              // 控制码
-                        0x0A,              // 数据域长度
-                        LOCAL_ADDRESS[0],  // 本机地址
-                        LOCAL_ADDRESS[1],  // 本机地址
-                        LOCAL_ADDRESS[2],  // 本机地址
-                        LOCAL_ADDRESS[3],  // 本机地址
-                        LOCAL_ADDRESS[4],  // 本机地址
-                        LOCAL_ADDRESS[5],  // 本机地址
-                        relay_num,         // 插孔ID
-                        bl_data_buffer[0], // 功率低字节
-                        bl_data_buffer[1], // 功率中字节
-                        bl_data_buffer[2]  // 功率高字节
-                    };
+                    uint8_t powerFrame[protocol_frame_size<MsgPowerReport>()];
+                    MsgPowerReport &powerMsg = protocol_encode<MsgPowerReport>(powerFrame);
+                    memcpy(powerMsg.macAddress, LOCAL_ADDRESS, 6);   // 本机地址
+                    powerMsg.socketId = relay_num;                   // 插孔ID
+                    memcpy(powerMsg.power.bytes, bl_data_buffer, 3); // 功率寄存器
                     if (electricParamPush)
                     {
-                        // 获取HPLC互斥锁后再发送
-                        if (xSemaphoreTake(hplcMutex, (TickType_t)10) == pdTRUE)
-                        {
-                            HPLC_send_frame(TARGET_ADDRESS, powerFrame, sizeof(powerFrame), false);
-                            // 释放HPLC互斥锁
-                            xSemaphoreGive(hplcMutex);
-                        }
+                        HPLC_send_frame(TARGET_ADDRESS, powerFrame, sizeof(powerFrame), false);
                     }
-                    Serial.printf("SOCKET_ID -> %d | POWER -> %.3f\n", relay_num, power);
+                    LOG_DEBUG("SOCKET_ID -> %d | POWER -> %u mW", relay_num, power_mw);
+                    // 记录历史采样
+                    HISTORY_add_sample(relay_num, current_ma, power_mw);
 
                     // 3. 检查功率限制
                     // 读取最大功率
                     uint16_t max_power = ELECTRIC_RELAY_get_max_power(relay_num);
-                    if (max_power > 0 && power > (float)max_power)
+                    if (max_power > 0 && power_mw > (uint32_t)max_power * 1000)
                     {
                         // 4. 超功率，关闭继电器
                         ELECTRIC_RELAY_control(relay_num, 0);
 
                         // 通过 HPLC 发送超功率事件
-                        uint8_t powerExceedFrame[] = {
-                            0x13,             // 控制码
-                            0x07,             // 数据域长度
-                            LOCAL_ADDRESS[0], // 本机地址
-                            LOCAL_ADDRESS[1], // 本机地址
-                            LOCAL_ADDRESS[2], // 本机地址
-                            LOCAL_ADDRESS[3], // 本机地址
-                            LOCAL_ADDRESS[4], // 本机地址
-                            LOCAL_ADDRESS[5], // 本机地址
-                            relay_num         // 插孔ID
-                        };
-                        // 获取HPLC互斥锁后再发送
-                        if (xSemaphoreTake(hplcMutex, (TickType_t)10) == pdTRUE)
-                        {
-                            HPLC_send_frame(TARGET_ADDRESS, powerExceedFrame, sizeof(powerExceedFrame), true);
-                            // 释放HPLC互斥锁
-                            xSemaphoreGive(hplcMutex);
-                        }
-                        Serial.printf("SOCKET_ID -> %d | POWER_EXCEED -> %.3f > %d\n", relay_num, power, max_power);
+                        uint8_t powerExceedFrame[protocol_frame_size<MsgPowerExceed>()];
+                        MsgPowerExceed &powerExceedMsg = protocol_encode<MsgPowerExceed>(powerExceedFrame);
+                        memcpy(powerExceedMsg.macAddress, LOCAL_ADDRESS, 6); // 本机地址
+                        powerExceedMsg.socketId = relay_num;                 // 插孔ID
+                        HPLC_send_frame(TARGET_ADDRESS, powerExceedFrame, sizeof(powerExceedFrame), true);
+                        LOG_WARN("SOCKET_ID -> %d | POWER_EXCEED -> %u mW > %d W", relay_num, power_mw, max_power);
                     }
                 }
                 else
                 {
-                    Serial.printf("SOCKET_ID -> %d | POWER -> 读取失败\n", relay_num);
+                    LOG_WARN("SOCKET_ID -> %d | POWER -> 读取失败", relay_num);
+                }
+                if (ELECTRIC_RELAY_get_state(relay_num) == 1)
+                {
+                    relayOnMask |= 1 << relay_idx;
                 }
             }
+            else
+            {
+                // 继电器断开，记录零功率采样，保持历史记录时间连续
+                HISTORY_add_sample(relay_num, 0, 0);
+            }
         }
-        Serial.println("功率监控任务结束");
+        // 5. 按需保存累计电能检查点 (低磨损，大多数周期不会写 Flash)
+        //    有继电器断开 (超功率跳闸或CCO关闭插孔) 时，该插孔不再有增量，立即保存最终读数
+        bool relayOpened = (previousRelayOnMask & ~relayOnMask) != 0;
+        previousRelayOnMask = relayOnMask;
+        if (ENERGY_checkpoint(relayOpened))
+        {
+            LOG_INFO("功率监控任务 -> 电能检查点已保存");
+        }
+        LOG_DEBUG("功率监控任务结束");
+
+        PROFILER_record_loop(profile, micros() - cycleStart);
 
         // 等待下一个监控周期
         vTaskDelay(pdMS_TO_TICKS(POWER_MONITOR_INTERVAL_MS));
@@ -235,90 +250,164 @@ void powerMonitoringTask(void *pvParameters)
 }
 
 /**
- * HPLC载波模块处理有效帧
+ * @brief 回复心跳包
+ * @param frame 完整帧
+ */
+void hplc_handle_heart_beat(const FrameView &frame)
+{
+    // 回复心跳包
+    HPLC_reply_heart_beat(TARGET_ADDRESS);
+}
+
+/**
+ * @brief 接收CCO设置插孔开关状态
+ * @param frame 完整帧
  */
-void HPLC_handle_valid_frame(FrameParser frameParser)
+void hplc_handle_set_socket_state(const FrameView &frame)
 {
-    // Serial.println("HANDLE_VALID_FRAME:");
-    // for (int i = 0; i < frameParser.index; i++)
-    // {
-    //     print_to_serial_monitor("HPLC", frameParser.buffer[i]);
-    // }
-    // Serial.println();
-
-    // 临时变量
-    // 响应ACK帧
-    uint8_t ackFrame[2] = {
-        0x00, // 控制码占位
-        0x00  // 数据域长度
-    };
-
-    // 提取关键字段
-    uint8_t ctrlCode = frameParser.buffer[5]; // 控制码
-    uint8_t dataLen = frameParser.buffer[6];  // 数据域长度
-
-    // 针对不同帧控制码执行不同操作
-    switch (ctrlCode)
+    // 响应ACK帧 (数据域为空)
+    uint8_t ackFrame[PROTOCOL_TX_DATA_OFFSET];
+
+    // 接收CCO设置插孔开关状态
+    LOG_INFO("接收CCO设置插孔开关状态");
+    const MsgSetSocketState *msg = protocol_view<MsgSetSocketState>(frame);
+    // 插孔ID无效时不应答，CCO 会按发送失败处理
+    if (msg == nullptr || !protocol_socket_valid(msg->socketId))
     {
-    case 0x66:
-        // 回复心跳包
-        HPLC_reply_heart_beat(TARGET_ADDRESS);
-        break;
+        return;
+    }
+    // 控制对应插孔的开关状态并持久化
+    ELECTRIC_RELAY_control(msg->socketId, msg->state);
+
+    // 发送ACK帧
+    protocol_encode<MsgSetSocketStateAck>(ackFrame);
+    HPLC_send_frame(TARGET_ADDRESS, ackFrame, sizeof(ackFrame), false);
+    LOG_INFO("SOCKET_ID -> %d | STATE -> %s", msg->socketId, msg->state == 0x01 ? "ON" : "OFF");
+}
 
-    case 0x11:
+/**
+ * @brief 接收CCO设置插孔最大功率
+ * @param frame 完整帧
+ */
+void hplc_handle_set_max_power(const FrameView &frame)
+{
+    // 响应ACK帧 (数据域为空)
+    uint8_t ackFrame[PROTOCOL_TX_DATA_OFFSET];
+
+    // 接收CCO设置插孔最大功率
+    LOG_INFO("接收CCO设置插孔最大功率");
+    const MsgSetMaxPower *msg = protocol_view<MsgSetMaxPower>(frame);
+    // 插孔ID无效时不应答，CCO 会按发送失败处理
+    if (msg == nullptr || !protocol_socket_valid(msg->socketId))
     {
-        // 接收CCO设置插孔开关状态
-        Serial.println("接收CCO设置插孔开关状态");
-        // 提取插孔ID和开关状态
-        uint8_t socketId = frameParser.buffer[7];
-        uint8_t socketState = frameParser.buffer[8];
-        // 控制对应插孔的开关状态并持久化
-        ELECTRIC_RELAY_control(socketId, socketState);
-
-        // 响应ACK帧
-        ackFrame[0] = 0x91;
-        // 发送ACK帧
-        HPLC_send_frame(TARGET_ADDRESS, ackFrame, sizeof(ackFrame), false);
-        Serial.printf("SOCKET_ID -> %d | STATE -> %s\n", socketId, socketState == 0x01 ? "ON" : "OFF");
-        break;
+        return;
     }
+    // 设置对应插孔的最大功率并持久化
+    uint16_t maxPower = msg->maxPower;
+    ELECTRIC_RELAY_set_max_power(msg->socketId, maxPower);
+
+    // 发送ACK帧
+    protocol_encode<MsgSetMaxPowerAck>(ackFrame);
+    HPLC_send_frame(TARGET_ADDRESS, ackFrame, sizeof(ackFrame), false);
+    LOG_INFO("SOCKET_ID -> %d | MAX_POWER -> %d", msg->socketId, maxPower);
+}
 
-    case 0x12:
+/**
+ * @brief 接收CCO设置推送开关
+ * @param frame 完整帧
+ */
+void hplc_handle_set_push(const FrameView &frame)
+{
+    // 响应ACK帧 (数据域为空)
+    uint8_t ackFrame[PROTOCOL_TX_DATA_OFFSET];
+
+    // 接收CCO设置推送开关
+    LOG_INFO("接收CCO设置推送开关");
+    const MsgSetPush *msg = protocol_view<MsgSetPush>(frame);
+    if (msg == nullptr)
     {
-        // 接收CCO设置插孔最大功率
-        Serial.println("接收CCO设置插孔最大功率");
-        // 提取插孔ID和最大功率
-        uint8_t socketId = frameParser.buffer[7];
-        uint8_t powerLowByte = frameParser.buffer[8];
-        uint8_t powerHighByte = frameParser.buffer[9];
-        uint16_t maxPower = (powerHighByte << 8) | powerLowByte;
-        // 设置对应插孔的最大功率并持久化
-        ELECTRIC_RELAY_set_max_power(socketId, maxPower);
-
-        // 响应ACK帧
-        ackFrame[0] = 0x92;
-        // 发送ACK帧
-        HPLC_send_frame(TARGET_ADDRESS, ackFrame, sizeof(ackFrame), false);
-        Serial.printf("SOCKET_ID -> %d | MAX_POWER -> %d\n", socketId, maxPower);
-        break;
+        return;
     }
+    // 更新开关状态
+    electricParamPush = msg->enabled == 0x01;
 
-    case 0x13:
+    // 发送ACK帧
+    protocol_encode<MsgSetPushAck>(ackFrame);
+    HPLC_send_frame(TARGET_ADDRESS, ackFrame, sizeof(ackFrame), false);
+    LOG_INFO("PUSH -> %d", electricParamPush);
+}
+
+/**
+ * @brief 接收CCO查询插孔累计电能
+ * @param frame 完整帧
+ */
+void hplc_handle_energy_query(const FrameView &frame)
+{
+    // 接收CCO查询插孔累计电能
+    LOG_INFO("接收CCO查询插孔累计电能");
+    // 应答帧携带本机地址和3个插孔的累计脉冲数
+    uint8_t energyAckFrame[protocol_frame_size<MsgEnergyReply>()];
+    MsgEnergyReply &reply = protocol_encode<MsgEnergyReply>(energyAckFrame);
+    memcpy(reply.macAddress, LOCAL_ADDRESS, 6);
+    for (uint8_t i = 0; i < 3; i++)
     {
-        // 接收CCO设置推送开关
-        Serial.println("接收CCO设置推送开关");
-        // 更新开关状态
-        electricParamPush = frameParser.buffer[7] == 0x01;
-
-        // 响应ACK帧
-        ackFrame[0] = 0x93;
-        // 发送ACK帧
-        HPLC_send_frame(TARGET_ADDRESS, ackFrame, sizeof(ackFrame), false);
-        Serial.printf("PUSH -> %d\n", electricParamPush);
-        break;
+        reply.pulses[i] = ENERGY_get_pulses(i + 1);
     }
+    // 发送应答帧
+    HPLC_send_frame(TARGET_ADDRESS, energyAckFrame, sizeof(energyAckFrame), false);
+}
 
-    default:
-        break;
+/**
+ * @brief 接收CCO查询插孔历史记录
+ * @param frame 完整帧
+ */
+void hplc_handle_history_query(const FrameView &frame)
+{
+    // 接收CCO查询插孔历史记录
+    const MsgHistoryQuery *query = protocol_view<MsgHistoryQuery>(frame);
+    if (query == nullptr)
+    {
+        return;
+    }
+    uint8_t socketId = query->socketId;
+    uint8_t tier = query->tier;
+    uint16_t offset = query->offset;
+    uint8_t count = query->count;
+
+    // 应答帧: 固定部分 + 实际读取到的记录
+    uint8_t historyAckFrame[protocol_frame_size<MsgHistoryReply>(PROTOCOL_MAX_DATA_LEN - protocol_data_len<MsgHistoryReply>())];
+    uint8_t read = 0;
+    uint8_t recordsLen = 0;
+    if (tier == HISTORY_TIER_RAW)
+    {
+        HistoryRawRecord *records = reinterpret_cast<HistoryRawRecord *>(protocol_encode_extra<MsgHistoryReply>(historyAckFrame));
+        HistorySample samples[protocol_max_records<MsgHistoryReply, HistoryRawRecord>()];
+        read = HISTORY_read_samples(socketId, offset, samples, min<uint8_t>(count, ARRAY_LENGTH(samples)));
+        for (uint8_t i = 0; i < read; i++)
+        {
+            records[i].currentMilliAmps = samples[i].currentMilliAmps;
+            records[i].powerMilliWatts = samples[i].powerMilliWatts;
+        }
+        recordsLen = read * sizeof(HistoryRawRecord);
+    }
+    else
+    {
+        HistoryRollupRecord *records = reinterpret_cast<HistoryRollupRecord *>(protocol_encode_extra<MsgHistoryReply>(historyAckFrame));
+        HistoryRollup rollups[protocol_max_records<MsgHistoryReply, HistoryRollupRecord>()];
+        read = HISTORY_read_rollups(socketId, tier, offset, rollups, min<uint8_t>(count, ARRAY_LENGTH(rollups)));
+        for (uint8_t i = 0; i < read; i++)
+        {
+            records[i].minPowerMilliWatts = rollups[i].minPowerMilliWatts;
+            records[i].maxPowerMilliWatts = rollups[i].maxPowerMilliWatts;
+            records[i].avgPowerMilliWatts = rollups[i].avgPowerMilliWatts;
+        }
+        recordsLen = read * sizeof(HistoryRollupRecord);
     }
+    MsgHistoryReply &reply = protocol_encode<MsgHistoryReply>(historyAckFrame, recordsLen);
+    reply.socketId = socketId;
+    reply.tier = tier;
+    reply.offset = offset;
+    reply.count = read;
+    // 发送应答帧
+    HPLC_send_frame(TARGET_ADDRESS, historyAckFrame, protocol_frame_size<MsgHistoryReply>(recordsLen), false);
 }
\ No newline at end of file
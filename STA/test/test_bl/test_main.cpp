@@ -0,0 +1,152 @@
+#include <Arduino.h>
+#include <BL.h>
+#include <NativeShims.h>
+#include <unity.h>
+
+/*
+ * BL0906 串口驱动测试 (native)
+ * Serial1 的发送钩子扮演 BL0906: 读命令 0x35 <地址> 应答 3 字节数据 + 校验和，
+ * 写命令 0xCA <地址> <3字节数据> <校验和> 在写保护解除后写入寄存器
+ */
+
+#define USR_WRPROT 0x9E
+
+// 定义[模拟计量芯片]状态
+typedef struct
+{
+    uint32_t registers[256]; // 寄存器 (24位)
+    uint8_t command[6];      // 正在接收的命令
+    int length;              // 已接收的命令长度
+    bool mute;               // 不应答 (模拟断线)
+    bool corrupt;            // 应答的校验和错误
+    int rejectedWrites;      // 校验和错误或被写保护拒绝的写命令
+} FakeBL0906;
+
+static FakeBL0906 chip;
+
+static uint8_t checksum(uint8_t address, uint8_t d0, uint8_t d1, uint8_t d2)
+{
+    return ~((address + d0 + d1 + d2) & 0xFF);
+}
+
+static void chip_command(HardwareSerial &serial)
+{
+    uint8_t address = chip.command[1];
+    if (chip.command[0] == BL0906_READ_CMD)
+    {
+        uint32_t value = chip.registers[address];
+        uint8_t reply[4] = {(uint8_t)value, (uint8_t)(value >> 8), (uint8_t)(value >> 16), 0};
+        reply[3] = checksum(address, reply[0], reply[1], reply[2]) ^ (chip.corrupt ? 0x01 : 0x00);
+        serial.native_inject(reply, sizeof(reply));
+        return;
+    }
+    const uint8_t *d = &chip.command[2];
+    bool unlocked = chip.registers[USR_WRPROT] == 0x5555 || address == USR_WRPROT;
+    if (chip.command[5] != checksum(address, d[0], d[1], d[2]) || !unlocked)
+    {
+        chip.rejectedWrites++;
+        return;
+    }
+    chip.registers[address] = d[0] | (uint32_t)d[1] << 8 | (uint32_t)d[2] << 16;
+}
+
+/**
+ * 模拟 BL0906: 逐字节接收命令，收齐后同步应答
+ */
+static void fake_chip_tx(HardwareSerial &serial, const uint8_t *data, size_t length, void *context)
+{
+    for (size_t i = 0; i < length; i++)
+    {
+        if (chip.length == 0 && data[i] != BL0906_READ_CMD && data[i] != BL0906_WRITE_CMD)
+        {
+            continue;
+        }
+        chip.command[chip.length++] = data[i];
+        int expected = chip.command[0] == BL0906_READ_CMD ? 2 : 6;
+        if (chip.length == expected)
+        {
+            chip.length = 0;
+            if (!chip.mute)
+            {
+                chip_command(serial);
+            }
+        }
+    }
+}
+
+void setUp(void)
+{
+    static bool initialized = false;
+    if (!initialized)
+    {
+        memset(&chip, 0, sizeof(chip));
+        Serial1.native_set_tx_hook(fake_chip_tx, NULL);
+        BL_init();
+        initialized = true;
+    }
+    chip.mute = false;
+    chip.corrupt = false;
+    chip.rejectedWrites = 0;
+}
+
+void tearDown(void)
+{
+}
+
+// 初始化时解除写保护并写入 ADC 关断和增益寄存器
+void test_init_configures_chip(void)
+{
+    TEST_ASSERT_EQUAL_HEX32(0x5555, chip.registers[USR_WRPROT]);
+    TEST_ASSERT_EQUAL_HEX32(0x07E2, chip.registers[0x93]);
+    TEST_ASSERT_EQUAL_HEX32(0x333300, chip.registers[0x60]);
+    TEST_ASSERT_EQUAL_HEX32(0x003300, chip.registers[0x61]);
+}
+
+// 读寄存器按小端返回3字节数据
+void test_read_register(void)
+{
+    chip.registers[0x0D] = 0x123456;
+    uint8_t data[3];
+    TEST_ASSERT_TRUE(BL_read_register(0x0D, data));
+    TEST_ASSERT_EQUAL_HEX8(0x56, data[0]);
+    TEST_ASSERT_EQUAL_HEX8(0x34, data[1]);
+    TEST_ASSERT_EQUAL_HEX8(0x12, data[2]);
+}
+
+// 写寄存器带正确的校验和
+void test_write_register(void)
+{
+    const uint8_t data[3] = {0x01, 0x02, 0x03};
+    TEST_ASSERT_TRUE(BL_write_register(0x22, data));
+    TEST_ASSERT_EQUAL(0, chip.rejectedWrites);
+    TEST_ASSERT_EQUAL_HEX32(0x030201, chip.registers[0x22]);
+}
+
+// 应答校验和错误时读取失败
+void test_read_rejects_bad_checksum(void)
+{
+    chip.corrupt = true;
+    uint8_t data[3];
+    TEST_ASSERT_FALSE(BL_read_register(0x0D, data));
+}
+
+// 芯片不应答时在读超时后失败
+void test_read_times_out(void)
+{
+    chip.mute = true;
+    uint8_t data[3];
+    unsigned long start = millis();
+    TEST_ASSERT_FALSE(BL_read_register(0x0D, data));
+    TEST_ASSERT_EQUAL(BL0906_READ_TIMEOUT, millis() - start);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_init_configures_chip);
+    RUN_TEST(test_read_register);
+    RUN_TEST(test_write_register);
+    RUN_TEST(test_read_rejects_bad_checksum);
+    RUN_TEST(test_read_times_out);
+    return UNITY_END();
+}
\ No newline at end of file
@@ -0,0 +1,106 @@
+#include <Arduino.h>
+#include <BLRegConv.h>
+#include <float.h>
+#include <unity.h>
+
+/*
+ * BL0906 寄存器定点转换测试 (native)
+ * 在整个 24 位寄存器范围内，将定点结果与原先的双精度浮点公式逐一比较
+ */
+
+// 原先的双精度转换系数 (与改为定点数之前的 BLRegConv.cpp 相同)
+static const double CURRENT_CONVERSION_COEFFICIENT = BL0906_VREF / (12875.0 * BL0906_GAIN_I * BL0906_RL_MOHM);
+static const double POWER_CONVERSION_COEFFICIENT = (BL0906_VREF * BL0906_VREF * BL0906_RF_PLUS_RV_KOHM) / (40.4125 * BL0906_RL_MOHM * BL0906_GAIN_I * BL0906_RV_KOHM * BL0906_GAIN_V * 1000.0);
+
+// 允许误差: 四舍五入 0.5 个单位，加上 Q32 系数量化误差 (最多 0.5 / 2^32 每 LSB) 在 24 位满量程上的累积
+static const double ROUNDING_TOLERANCE = 0.5 + 0.5 * 16777216.0 / 4294967296.0;
+
+#define REGISTER_COUNT 0x01000000
+
+// 定义[转换误差统计]
+typedef struct
+{
+    double worst;   // 最大绝对误差
+    uint32_t reg;   // 出现最大误差的寄存器值
+} ConvError;
+
+static void record(ConvError *error, uint32_t reg, uint32_t actual, double expected)
+{
+    double diff = fabs((double)actual - expected);
+    if (diff > error->worst)
+    {
+        error->worst = diff;
+        error->reg = reg;
+    }
+}
+
+static void check(const char *name, const ConvError *error)
+{
+    char message[96];
+    snprintf(message, sizeof(message), "%s: 最大误差 %.4f (寄存器 0x%06lX)", name, error->worst, (unsigned long)error->reg);
+    TEST_MESSAGE(message);
+    TEST_ASSERT_TRUE_MESSAGE(error->worst <= ROUNDING_TOLERANCE, message);
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+// 电流: 0 ~ 0xFFFFFF 全部寄存器值与 val * 系数 * 1000 比较
+void test_current_matches_double_formula(void)
+{
+    ConvError error = {0, 0};
+    for (uint32_t reg = 0; reg < REGISTER_COUNT; reg++)
+    {
+        record(&error, reg, BL_currentRegister2MilliAmps(reg), reg * CURRENT_CONVERSION_COEFFICIENT * 1000.0);
+    }
+    check("电流(mA)", &error);
+}
+
+// 功率: 正负两半全部寄存器值与 |有符号值 * 系数| * 1000 比较
+void test_power_matches_double_formula(void)
+{
+    ConvError error = {0, 0};
+    for (uint32_t reg = 0; reg < REGISTER_COUNT; reg++)
+    {
+        int32_t signed_reg = (reg & 0x00800000) ? (int32_t)(reg | 0xFF000000) : (int32_t)reg;
+        record(&error, reg, BL_powerRegister2MilliWatts(reg), fabs(signed_reg * POWER_CONVERSION_COEFFICIENT) * 1000.0);
+    }
+    check("功率(mW)", &error);
+}
+
+// 高 8 位不参与转换，功率符号位两侧对称
+void test_upper_bits_and_sign_ignored(void)
+{
+    TEST_ASSERT_EQUAL_UINT32(BL_currentRegister2MilliAmps(0x123456), BL_currentRegister2MilliAmps(0xFF123456));
+    TEST_ASSERT_EQUAL_UINT32(BL_powerRegister2MilliWatts(0x000100), BL_powerRegister2MilliWatts(0xFFFF00));
+    TEST_ASSERT_EQUAL_UINT32(BL_powerRegister2MilliWatts(0x7FFFFF), BL_powerRegister2MilliWatts(0x800001));
+    TEST_ASSERT_EQUAL_UINT32(0, BL_powerRegister2MilliWatts(0));
+}
+
+// 浮点接口与原先的单精度结果相差不超过 0.5 mA / 0.5 mW
+void test_float_helpers_match_old_results(void)
+{
+    for (uint32_t reg = 0; reg < REGISTER_COUNT; reg += 0x1F3)
+    {
+        float current = (float)(reg * CURRENT_CONVERSION_COEFFICIENT);
+        TEST_ASSERT_TRUE(fabs(BL_currentRegister2ActualCurrent(reg) - current) <= ROUNDING_TOLERANCE / 1000.0 + current * FLT_EPSILON);
+        int32_t signed_reg = (reg & 0x00800000) ? (int32_t)(reg | 0xFF000000) : (int32_t)reg;
+        float power = fabsf((float)(signed_reg * POWER_CONVERSION_COEFFICIENT));
+        TEST_ASSERT_TRUE(fabs(BL_powerRegister2ActualPower(reg) - power) <= ROUNDING_TOLERANCE / 1000.0 + power * FLT_EPSILON);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_current_matches_double_formula);
+    RUN_TEST(test_power_matches_double_formula);
+    RUN_TEST(test_upper_bits_and_sign_ignored);
+    RUN_TEST(test_float_helpers_match_old_results);
+    return UNITY_END();
+}
\ No newline at end of file
@@ -0,0 +1,68 @@
+#include <Arduino.h>
+#include <ElectricRelay.h>
+#include <NativeShims.h>
+#include <unity.h>
+
+/*
+ * 继电器控制测试 (native)
+ * 重新调用 ELECTRIC_RELAY_init() 相当于设备重启后从 NVS 恢复
+ */
+
+static const uint8_t PINS[3] = {ELECTRIC_RELAY_PIN_1, ELECTRIC_RELAY_PIN_2, ELECTRIC_RELAY_PIN_3};
+
+void setUp(void)
+{
+    native_preferences_reset();
+    ELECTRIC_RELAY_init();
+}
+
+void tearDown(void)
+{
+}
+
+// 首次上电 (NVS 为空) 时继电器全部断开，最大功率为0
+void test_defaults_on_first_boot(void)
+{
+    for (uint8_t relay = 1; relay <= 3; relay++)
+    {
+        TEST_ASSERT_EQUAL(0, ELECTRIC_RELAY_get_state(relay));
+        TEST_ASSERT_EQUAL(0, ELECTRIC_RELAY_get_max_power(relay));
+        TEST_ASSERT_EQUAL(LOW, digitalRead(PINS[relay - 1]));
+    }
+}
+
+// 控制继电器时同步改变IO口电平
+void test_control_drives_pin(void)
+{
+    ELECTRIC_RELAY_control(2, 1);
+    TEST_ASSERT_EQUAL(1, ELECTRIC_RELAY_get_state(2));
+    TEST_ASSERT_EQUAL(HIGH, digitalRead(ELECTRIC_RELAY_PIN_2));
+    TEST_ASSERT_EQUAL(LOW, digitalRead(ELECTRIC_RELAY_PIN_1));
+
+    ELECTRIC_RELAY_control(2, 0);
+    TEST_ASSERT_EQUAL(LOW, digitalRead(ELECTRIC_RELAY_PIN_2));
+}
+
+// 状态和最大功率在重启后恢复
+void test_state_survives_reboot(void)
+{
+    ELECTRIC_RELAY_control(1, 1);
+    ELECTRIC_RELAY_control(3, 1);
+    ELECTRIC_RELAY_set_max_power(3, 2200);
+
+    ELECTRIC_RELAY_init();
+    TEST_ASSERT_EQUAL(1, ELECTRIC_RELAY_get_state(1));
+    TEST_ASSERT_EQUAL(0, ELECTRIC_RELAY_get_state(2));
+    TEST_ASSERT_EQUAL(1, ELECTRIC_RELAY_get_state(3));
+    TEST_ASSERT_EQUAL(HIGH, digitalRead(ELECTRIC_RELAY_PIN_3));
+    TEST_ASSERT_EQUAL(2200, ELECTRIC_RELAY_get_max_power(3));
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_defaults_on_first_boot);
+    RUN_TEST(test_control_drives_pin);
+    RUN_TEST(test_state_survives_reboot);
+    return UNITY_END();
+}
\ No newline at end of file
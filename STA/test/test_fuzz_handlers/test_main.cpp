@@ -0,0 +1,216 @@
+#include <Arduino.h>
+#include <BL.h>
+#include <FuzzDriver.h>
+#include <HPLC.h>
+#include <NativeShims.h>
+#include <Protocol.h>
+#include <algorithm>
+#include <string.h>
+#include <string>
+#include <unity.h>
+#include <vector>
+
+/*
+ * STA控制码处理函数模糊测试 (native，需要 test_build_src)
+ * 运行: pio test -e native_fuzz -f test_fuzz_handlers，参数和 libFuzzer 编译方式见 native/FuzzDriver/src/FuzzDriver.h
+ *
+ * 固件 (src/main.cpp) 执行 setup() 后，把输入组装成载波帧交给 HPLC_dispatch_frame()，与 loop() 分发串口任务
+ * 解析出的帧相同，之后再执行一次 loop()。输入格式:
+ *   第1个字节   处理函数序号 (值 % HANDLER_COUNT，见 HANDLERS)
+ *   其余字节    数据域 (超过单帧容量的部分被截断)，长度与注册的长度不符的帧由分发函数丢弃
+ * 帧放在大小恰好的堆缓冲区中，处理函数读取帧以外的内存由 ASan 发现。
+ * Serial1 的发送钩子扮演 BL0906 (读寄存器应答固定值，功率监控任务照常记录历史)，
+ * Serial2 的发送钩子扮演载波模块: 检查STA发出的每条 AT+SEND 命令中的帧完整且不超过单帧容量
+ */
+
+// 固件入口 (src/main.cpp)
+void setup();
+void loop();
+
+// 与 setup() 中的注册一致
+static const uint8_t HANDLERS[] = {MsgHeartBeat::CTRL, MsgSetSocketState::CTRL, MsgSetMaxPower::CTRL, MsgSetPush::CTRL, MsgEnergyQuery::CTRL, MsgHistoryQuery::CTRL};
+#define HANDLER_COUNT (sizeof(HANDLERS) / sizeof(HANDLERS[0]))
+
+// BL0906 读寄存器的应答值 (24位)
+#define FAKE_REGISTER_VALUE 0x012345
+
+// 分发的帧数
+static uint32_t dispatchCount = 0;
+// STA发出的帧数
+static uint32_t sentCount = 0;
+
+static void discard_tx(HardwareSerial &serial, const uint8_t *data, size_t length, void *context)
+{
+    (void)serial;
+    (void)data;
+    (void)length;
+    (void)context;
+}
+
+/**
+ * 模拟 BL0906: 读命令 0x35 <地址> 应答固定值 + 校验和，写命令不应答
+ */
+static void fake_chip_tx(HardwareSerial &serial, const uint8_t *data, size_t length, void *context)
+{
+    (void)context;
+    for (size_t i = 0; i + 1 < length; i++)
+    {
+        if (data[i] == BL0906_READ_CMD)
+        {
+            uint8_t address = data[i + 1];
+            uint8_t reply[4] = {(uint8_t)FAKE_REGISTER_VALUE, (uint8_t)(FAKE_REGISTER_VALUE >> 8), (uint8_t)(FAKE_REGISTER_VALUE >> 16), 0};
+            reply[3] = ~((address + reply[0] + reply[1] + reply[2]) & 0xFF);
+            serial.native_inject(reply, sizeof(reply));
+            return;
+        }
+    }
+}
+
+/**
+ * 模拟载波模块: 检查 "AT+SEND=<MAC>,<长度>,<帧>\r\n" 中的帧
+ */
+static void fake_module_tx(HardwareSerial &serial, const uint8_t *data, size_t length, void *context)
+{
+    (void)serial;
+    (void)context;
+    std::string command((const char *)data, length);
+    if (command.compare(0, 8, "AT+SEND=") != 0)
+    {
+        return;
+    }
+    size_t lengthStart = 8 + MAC_HEX_LEN + 1;
+    size_t frameStart = command.find(',', lengthStart);
+    FUZZ_CHECK(frameStart != std::string::npos && command.size() >= frameStart + 3, "AT+SEND 命令格式错误");
+    long frameLength = strtol(command.c_str() + lengthStart, NULL, 10);
+    const uint8_t *frame = (const uint8_t *)command.data() + frameStart + 1;
+    FUZZ_CHECK(frameLength == (long)(command.size() - frameStart - 3), "AT+SEND 的长度与帧不符");
+    FUZZ_CHECK(frameLength >= FRAME_DATA_OFFSET + 2 && frameLength <= MAX_FRAME_LEN, "发出的帧超过单帧容量");
+    FUZZ_CHECK(frame[FRAME_LEN_OFFSET] <= PROTOCOL_MAX_DATA_LEN, "发出的帧数据域超过单帧容量");
+    FUZZ_CHECK(frameLength == FRAME_DATA_OFFSET + frame[FRAME_LEN_OFFSET] + 2, "发出的帧长度与数据域长度不符");
+    uint8_t cs = 0;
+    for (int i = 4; i < FRAME_DATA_OFFSET + frame[FRAME_LEN_OFFSET]; i++)
+    {
+        cs += frame[i];
+    }
+    FUZZ_CHECK(frame[frameLength - 2] == cs && frame[frameLength - 1] == FRAME_END, "发出的帧校验和或结束符错误");
+    sentCount++;
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    static bool initialized = false;
+    if (!initialized)
+    {
+        // 数万次分发的日志没有意义，丢弃串口监视器输出
+        Serial.native_set_echo(false);
+        Serial.native_set_tx_hook(discard_tx, NULL);
+        Serial1.native_set_tx_hook(fake_chip_tx, NULL);
+        Serial2.native_set_tx_hook(fake_module_tx, NULL);
+        setup();
+        initialized = true;
+    }
+    if (size == 0)
+    {
+        return 0;
+    }
+
+    uint8_t ctrl = HANDLERS[data[0] % HANDLER_COUNT];
+    uint8_t dataLen = (uint8_t)std::min<size_t>(size - 1, PROTOCOL_MAX_DATA_LEN);
+
+    // 完整帧: 前导字节 + 起始符 + 控制码 + 长度 + 数据域 + 校验和 + 结束符
+    size_t length = FRAME_DATA_OFFSET + dataLen + 2;
+    uint8_t *bytes = (uint8_t *)malloc(length);
+    memset(bytes, FRAME_LEAD_BYTE, 4);
+    bytes[4] = FRAME_HEADER;
+    bytes[FRAME_CTRL_OFFSET] = ctrl;
+    bytes[FRAME_LEN_OFFSET] = dataLen;
+    memcpy(bytes + FRAME_DATA_OFFSET, data + 1, dataLen);
+    uint8_t cs = 0;
+    for (int i = 4; i < FRAME_DATA_OFFSET + dataLen; i++)
+    {
+        cs += bytes[i];
+    }
+    bytes[length - 2] = cs;
+    bytes[length - 1] = FRAME_END;
+
+    FrameView frame;
+    frame.bytes = bytes;
+    frame.length = (uint8_t)length;
+    frame.ctrlCode = ctrl;
+    frame.dataLen = dataLen;
+    frame.data = bytes + FRAME_DATA_OFFSET;
+    HPLC_dispatch_frame(frame, NULL);
+    free(bytes);
+    dispatchCount++;
+
+    // 处理函数交给串口任务的应答帧在此期间写出
+    loop();
+    vTaskDelay(pdMS_TO_TICKS(1));
+    return 0;
+}
+
+#ifndef FUZZ_LIBFUZZER
+
+/**
+ * 组装输入: 处理函数序号 + 数据域
+ */
+static std::vector<uint8_t> make_input(uint8_t handler, std::vector<uint8_t> data)
+{
+    data.insert(data.begin(), handler);
+    return data;
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+// 种子和变异输入都不会让处理函数越界、触发未定义行为或发出错误的帧
+void test_handlers_survive_fuzzing(void)
+{
+    std::vector<std::vector<uint8_t>> inputs;
+    // 心跳包、电能查询 (没有数据域)
+    inputs.push_back(make_input(0, {}));
+    inputs.push_back(make_input(4, {}));
+    // 开关插孔、设置最大功率、推送开关 (含越界的插孔ID)
+    inputs.push_back(make_input(1, {0x01, 0x01}));
+    inputs.push_back(make_input(1, {0x04, 0x00}));
+    inputs.push_back(make_input(2, {0x02, 0xE8, 0x03}));
+    inputs.push_back(make_input(2, {0x00, 0xFF, 0xFF}));
+    inputs.push_back(make_input(3, {0x01}));
+    // 历史查询: 插孔ID + 层级 + 偏移(2) + 条数 (各层级、越界的插孔ID和层级、超过单帧容量的条数)
+    for (uint8_t tier = 0; tier < 4; tier++)
+    {
+        inputs.push_back(make_input(5, {0x01, tier, 0x00, 0x00, 0xFF}));
+    }
+    inputs.push_back(make_input(5, {0x00, 0x00, 0x00, 0x00, 0x05}));
+    inputs.push_back(make_input(5, {0x03, 0xFF, 0xFF, 0xFF, 0x05}));
+
+    std::vector<FuzzSeed> seeds;
+    for (const std::vector<uint8_t> &input : inputs)
+    {
+        seeds.push_back({input.data(), input.size()});
+    }
+    FuzzResult result;
+    FUZZ_run(seeds.data(), seeds.size(), result);
+    printf("{\"fuzz\":\"sta_handlers\",\"seeds\":%u,\"corpus\":%u,\"mutated\":%u,\"bytes\":%llu,\"dispatched\":%u,\"sent\":%u,\"virtual_s\":%.1f}\n",
+           result.seedInputs, result.corpusInputs, result.mutatedInputs, (unsigned long long)result.totalBytes, dispatchCount,
+           sentCount, native_time_us() / 1e6);
+    // 只导出种子时不执行输入
+    if (result.seedInputs > 0)
+    {
+        TEST_ASSERT_GREATER_THAN(0, sentCount);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_handlers_survive_fuzzing);
+    return UNITY_END();
+}
+
+#endif
\ No newline at end of file
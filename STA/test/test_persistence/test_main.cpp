@@ -0,0 +1,89 @@
+#include <Arduino.h>
+#include <NativeShims.h>
+#include <Persistence.h>
+#include <unity.h>
+
+/*
+ * 持久化模块测试 (native)
+ */
+
+void setUp(void)
+{
+    native_preferences_reset();
+    persistence_end();
+}
+
+void tearDown(void)
+{
+}
+
+// 未初始化时所有操作失败
+void test_requires_init(void)
+{
+    uint8_t value = 1;
+    TEST_ASSERT_FALSE(persistence_put_bytes("key", &value, 1));
+    TEST_ASSERT_EQUAL(0, persistence_get_bytes("key", &value, 1));
+    TEST_ASSERT_FALSE(persistence_clear());
+}
+
+// 字节数据和字符串的写入与读取
+void test_bytes_and_strings(void)
+{
+    persistence_init("test");
+    const uint16_t written = 0xBEEF;
+    TEST_ASSERT_TRUE(persistence_put_bytes("word", &written, sizeof(written)));
+    uint16_t read = 0;
+    TEST_ASSERT_EQUAL(sizeof(read), persistence_get_bytes("word", &read, sizeof(read)));
+    TEST_ASSERT_EQUAL_HEX32(0xBEEF, read);
+
+    TEST_ASSERT_TRUE(persistence_put_string("name", "kitchen"));
+    TEST_ASSERT_TRUE(persistence_get_string("name") == "kitchen");
+    TEST_ASSERT_TRUE(persistence_get_string("missing", "none") == "none");
+}
+
+// 缓冲区小于存储的数据时读取失败 (与 ESP32 Preferences 一致)
+void test_get_bytes_needs_room(void)
+{
+    persistence_init("test");
+    const uint8_t written[4] = {1, 2, 3, 4};
+    TEST_ASSERT_TRUE(persistence_put_bytes("blob", written, sizeof(written)));
+    uint8_t small[2];
+    TEST_ASSERT_EQUAL(0, persistence_get_bytes("blob", small, sizeof(small)));
+}
+
+// 键名超过15个字符时写入失败
+void test_rejects_long_key(void)
+{
+    persistence_init("test");
+    uint8_t value = 1;
+    TEST_ASSERT_TRUE(persistence_put_bytes("fifteen_chars__", &value, 1));
+    TEST_ASSERT_FALSE(persistence_put_bytes("sixteen_chars___", &value, 1));
+}
+
+// 切换命名空间后数据互不可见，清空只影响当前命名空间
+void test_namespaces_are_isolated(void)
+{
+    uint8_t value = 7;
+    persistence_init("first");
+    TEST_ASSERT_TRUE(persistence_put_bytes("key", &value, 1));
+    persistence_init("second");
+    TEST_ASSERT_EQUAL(0, persistence_get_bytes("key", &value, 1));
+    TEST_ASSERT_TRUE(persistence_put_bytes("key", &value, 1));
+    TEST_ASSERT_TRUE(persistence_clear());
+
+    persistence_init("first");
+    TEST_ASSERT_EQUAL(1, persistence_get_bytes("key", &value, 1));
+    TEST_ASSERT_TRUE(persistence_remove("key"));
+    TEST_ASSERT_EQUAL(0, persistence_get_bytes("key", &value, 1));
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_requires_init);
+    RUN_TEST(test_bytes_and_strings);
+    RUN_TEST(test_get_bytes_needs_room);
+    RUN_TEST(test_rejects_long_key);
+    RUN_TEST(test_namespaces_are_isolated);
+    return UNITY_END();
+}
\ No newline at end of file